@@ -0,0 +1,1172 @@
+#include "Factorization.h"
+#include "MatrixPrivate.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+
+/* the greatest multiplier of L Bennett's algorithm may leave, partial pivoting keeping them at most 1 */
+#define GROWTH_LIMIT 100
+
+/* refinement steps of solveMixed before it gives up on single precision, each one gaining about 7 digits */
+#define MIXED_ITERATIONS 30
+
+
+
+
+typedef enum
+{
+	LU,
+	QR
+} Kind;
+
+
+struct Factorization
+{
+	Kind kind;
+
+	size_t height;
+	size_t width;
+
+	/* A, row by row, which replaced rows and columns are told apart from, and LU is factored again from */
+	double * cells;
+
+	/* LU: L below the diagonal, its unit diagonal left implicit, and U from the diagonal, n*n
+	 * QR: R, m*n */
+	double * factors;
+
+	/* QR only: Q, m*m */
+	double * orthogonal;
+
+	/* LU only: row i of P A is row [permutation[i]] of A */
+	size_t * permutation;
+
+	/* LU: the parity of P, QR: det(Q), 1 or -1 either way */
+	int sign;
+};
+
+
+
+
+/**
+ * Allocates a factorization of [matrix], copying its cells, the factors being left to compute
+ *
+ * @return - the factorization, or NULL if allocation failed
+ */
+static Factorization * allocate(Kind kind, Matrix const * matrix);
+
+/**
+ * P A = L U, with partial pivoting, from the cells of A
+ * A column without any non-zero pivot is skipped, leaving a 0 on the diagonal of U
+ */
+static void factorLU(Factorization * this);
+
+/**
+ * A = Q R, zeroing each column below the diagonal by rotations from the bottom up
+ */
+static void factorQR(Factorization * this);
+
+/**
+ * L U + x ^t y, by Bennett's algorithm, in place
+ *
+ * @param x - P u, m cells, overwritten
+ * @param y - n cells, overwritten
+ *
+ * @return - 1, or 0 if a pivot or a multiplier went out of bounds, the factors then being garbage
+ */
+static int updateLU(Factorization * this, double * x, double * y);
+
+/**
+ * Q R + u ^t v: rotations reduce ^t Q u to a multiple of e1, making R upper Hessenberg,
+ * the update is added to the first row, then more rotations bring R back to triangular
+ *
+ * @param u - m cells
+ * @param v - n cells
+ * @param work - m cells
+ */
+static void updateQR(Factorization * this, double const * u, double const * v, double * work);
+
+/**
+ * Factors of A + u ^t v, A itself having been updated already
+ *
+ * @param u - m cells
+ * @param v - n cells, overwritten
+ * @param work - m cells
+ */
+static void update(Factorization * this, double const * u, double * v, double * work);
+
+/**
+ * G R and Q ^t G, G rotating rows [first] and [second] by an angle of cosine [cosine] and sine [sine]:
+ * Q R is left unchanged
+ */
+static void rotate(Factorization * this, size_t first, size_t second, double cosine, double sine);
+
+/**
+ * Zeroes R[second][column] with a rotation of rows [first] and [second]
+ */
+static void annihilate(Factorization * this, size_t first, size_t second, size_t column);
+
+/**
+ * @return - sqrt(a^2 + b^2), neither overflowing nor underflowing
+ */
+static double magnitude(double a, double b);
+
+/**
+ * Copies a [height]*[width] block, row by row, into a new one with a row and a column inserted or removed
+ *
+ * @param row - where a row is inserted or removed
+ * @param rowChange - 1 to insert a row of zeros, -1 to remove one, 0 to keep rows as they are
+ * @param column - where a column is inserted or removed
+ * @param columnChange - same as [rowChange], for columns
+ *
+ * @return - the new block, or NULL if allocation failed
+ */
+static double * splice(
+	double const * block,
+	size_t height,
+	size_t width,
+	size_t row,
+	int rowChange,
+	size_t column,
+	int columnChange);
+
+/**
+ * P A = L U in single precision, with partial pivoting, in place
+ *
+ * @param factors - A, [size]*[size] row by row, replaced with L and U
+ * @param permutation - receives P, row i of P A being row [permutation[i]] of A
+ *
+ * @return - 1, or 0 if a pivot is 0
+ */
+static int factorSingle(size_t size, float * factors, size_t * permutation);
+
+/**
+ * Solves L U d = P r in single precision
+ *
+ * @param vector - receives d
+ */
+static void solveSingle(size_t size, float const * factors, size_t const * permutation, double const * residual, float * vector);
+
+/**
+ * @return - max |cells[i]|, or HUGE_VAL if any cell is NaN
+ */
+static double largest(size_t size, double const * cells);
+
+/**
+ * Turns [permutation] into the successive row swaps producing it, as the factors of Matrix.c record them
+ *
+ * @param pivots - receives [size] swaps: row [index] with row [pivots[index]], in increasing order of [index]
+ * @param rows - 2 * [size] cells of work
+ */
+static void toPivots(size_t size, size_t const * permutation, size_t * pivots, size_t * rows);
+
+
+
+
+static Factorization * lu(Matrix const * const matrix)
+{
+	Factorization * this;
+
+	if (matrix == NULL)
+		return NULL;
+	if (matrix->height != matrix->width)
+		return NULL;
+
+	this = allocate(LU, matrix);
+	if (this == NULL)
+		return NULL;
+
+	factorLU(this);
+
+	return this;
+}
+
+
+static Factorization * qr(Matrix const * const matrix)
+{
+	Factorization * this;
+
+	if (matrix == NULL)
+		return NULL;
+
+	this = allocate(QR, matrix);
+	if (this == NULL)
+		return NULL;
+
+	factorQR(this);
+
+	return this;
+}
+
+
+static void delete(Factorization ** const this)
+{
+	if (this == NULL)
+		return;
+	if (* this == NULL)
+		return;
+
+	free((* this)->cells);
+	free((* this)->factors);
+	free((* this)->orthogonal);
+	free((* this)->permutation);
+	free(* this);
+	* this = NULL;
+}
+
+
+static size_t height(Factorization const * const this)
+{
+	if (this == NULL)
+		return 0;
+
+	return this->height;
+}
+
+
+static size_t width(Factorization const * const this)
+{
+	if (this == NULL)
+		return 0;
+
+	return this->width;
+}
+
+
+static int insertRow(Factorization * const this, size_t index, Vector const * const row)
+{
+	double * cells;
+	double * factors;
+	double * orthogonal;
+	size_t columnIndex, last;
+
+	if ((this == NULL) || (row == NULL))
+		return 0;
+	if ((this->kind != QR) || (index > this->height) || (_Vector->size(row) != this->width))
+		return 0;
+
+	/* Q grows by an identity row and column, the new row of A being first appended to R */
+	last = this->height;
+	cells = splice(this->cells, this->height, this->width, index, 1, 0, 0);
+	factors = splice(this->factors, this->height, this->width, last, 1, 0, 0);
+	orthogonal = splice(this->orthogonal, this->height, this->height, index, 1, last, 1);
+	if ((cells == NULL) || (factors == NULL) || (orthogonal == NULL))
+	{
+		free(cells);
+		free(factors);
+		free(orthogonal);
+		return 0;
+	}
+
+	for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+	{
+		cells[index * this->width + columnIndex] = _Vector->getCell(row, columnIndex);
+		factors[last * this->width + columnIndex] = cells[index * this->width + columnIndex];
+	}
+	orthogonal[index * (last + 1) + last] = 1;
+
+	free(this->cells);
+	free(this->factors);
+	free(this->orthogonal);
+	this->cells = cells;
+	this->factors = factors;
+	this->orthogonal = orthogonal;
+	this->height++;
+
+	/* the identity row went from the bottom of Q up to [index] */
+	if ((last - index) % 2 == 1)
+		this->sign = -this->sign;
+
+	for (columnIndex = 0; (columnIndex < last) && (columnIndex < this->width); columnIndex++)
+		annihilate(this, columnIndex, last, columnIndex);
+
+	return 1;
+}
+
+
+static int deleteRow(Factorization * const this, size_t index)
+{
+	double * cells;
+	double * factors;
+	double * orthogonal;
+	double * row;
+	double radius;
+	size_t columnIndex;
+
+	if (this == NULL)
+		return 0;
+	if ((this->kind != QR) || (index >= this->height) || (this->height == 1))
+		return 0;
+
+	/*
+	 * Rotations zero row [index] of Q from its end, until it is ±e1, then the first column of Q is ±e[index]:
+	 * both go away along with the first row of R, which has become upper Hessenberg, so triangular below it
+	 */
+	row = this->orthogonal + index * this->height;
+	for (columnIndex = this->height - 1; columnIndex > 0; columnIndex--)
+	{
+		if (row[columnIndex] == 0)
+			continue;
+
+		radius = magnitude(row[columnIndex - 1], row[columnIndex]);
+		rotate(this, columnIndex - 1, columnIndex, row[columnIndex - 1] / radius, row[columnIndex] / radius);
+		row[columnIndex] = 0;
+	}
+
+	/* A failed allocation leaves another factorization of the same A */
+	cells = splice(this->cells, this->height, this->width, index, -1, 0, 0);
+	factors = splice(this->factors, this->height, this->width, 0, -1, 0, 0);
+	orthogonal = splice(this->orthogonal, this->height, this->height, index, -1, 0, -1);
+	if ((cells == NULL) || (factors == NULL) || (orthogonal == NULL))
+	{
+		free(cells);
+		free(factors);
+		free(orthogonal);
+		return 0;
+	}
+
+	/* moving ±1 to the top left corner of Q takes [index] exchanges */
+	if ((index % 2 == 1) != (row[0] < 0))
+		this->sign = -this->sign;
+
+	free(this->cells);
+	free(this->factors);
+	free(this->orthogonal);
+	this->cells = cells;
+	this->factors = factors;
+	this->orthogonal = orthogonal;
+	this->height--;
+
+	return 1;
+}
+
+
+static int replaceRow(Factorization * const this, size_t index, Vector const * const row)
+{
+	double * buffer;
+	double * u;
+	double * v;
+	size_t rowIndex, columnIndex;
+
+	if ((this == NULL) || (row == NULL))
+		return 0;
+	if ((index >= this->height) || (_Vector->size(row) != this->width))
+		return 0;
+
+	buffer = malloc((2 * this->height + this->width) * sizeof(* buffer));
+	if (buffer == NULL)
+		return 0;
+
+	/* A + e[index] ^t (new - old) */
+	u = buffer;
+	v = u + this->height;
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+		u[rowIndex] = (rowIndex == index) ? 1 : 0;
+	for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+	{
+		v[columnIndex] = _Vector->getCell(row, columnIndex) - this->cells[index * this->width + columnIndex];
+		this->cells[index * this->width + columnIndex] = _Vector->getCell(row, columnIndex);
+	}
+
+	update(this, u, v, v + this->width);
+
+	free(buffer);
+
+	return 1;
+}
+
+
+static int insertColumn(Factorization * const this, size_t index, Vector const * const column)
+{
+	double * cells;
+	double * factors;
+	double value;
+	size_t rowIndex, columnIndex;
+
+	if ((this == NULL) || (column == NULL))
+		return 0;
+	if ((this->kind != QR) || (index > this->width) || (_Vector->size(column) != this->height))
+		return 0;
+
+	cells = splice(this->cells, this->height, this->width, 0, 0, index, 1);
+	factors = splice(this->factors, this->height, this->width, 0, 0, index, 1);
+	if ((cells == NULL) || (factors == NULL))
+	{
+		free(cells);
+		free(factors);
+		return 0;
+	}
+
+	/* ^t Q a is the new column of R, zeroed below the diagonal by rotations from the bottom up */
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		value = _Vector->getCell(column, rowIndex);
+		cells[rowIndex * (this->width + 1) + index] = value;
+		for (columnIndex = 0; columnIndex < this->height; columnIndex++)
+			factors[columnIndex * (this->width + 1) + index] += this->orthogonal[rowIndex * this->height + columnIndex] * value;
+	}
+
+	free(this->cells);
+	free(this->factors);
+	this->cells = cells;
+	this->factors = factors;
+	this->width++;
+
+	for (rowIndex = this->height - 1; rowIndex > index; rowIndex--)
+		annihilate(this, rowIndex - 1, rowIndex, index);
+
+	return 1;
+}
+
+
+static int deleteColumn(Factorization * const this, size_t index)
+{
+	double * cells;
+	double * factors;
+	size_t rowIndex;
+
+	if (this == NULL)
+		return 0;
+	if ((this->kind != QR) || (index >= this->width) || (this->width == 1))
+		return 0;
+
+	cells = splice(this->cells, this->height, this->width, 0, 0, index, -1);
+	factors = splice(this->factors, this->height, this->width, 0, 0, index, -1);
+	if ((cells == NULL) || (factors == NULL))
+	{
+		free(cells);
+		free(factors);
+		return 0;
+	}
+
+	free(this->cells);
+	free(this->factors);
+	this->cells = cells;
+	this->factors = factors;
+	this->width--;
+
+	/* columns right of [index] moved left, each over a cell below the diagonal */
+	for (rowIndex = index; (rowIndex + 1 < this->height) && (rowIndex < this->width); rowIndex++)
+		annihilate(this, rowIndex, rowIndex + 1, rowIndex);
+
+	return 1;
+}
+
+
+static int replaceColumn(Factorization * const this, size_t index, Vector const * const column)
+{
+	double * buffer;
+	double * u;
+	double * v;
+	size_t rowIndex, columnIndex;
+
+	if ((this == NULL) || (column == NULL))
+		return 0;
+	if ((index >= this->width) || (_Vector->size(column) != this->height))
+		return 0;
+
+	buffer = malloc((2 * this->height + this->width) * sizeof(* buffer));
+	if (buffer == NULL)
+		return 0;
+
+	/* A + (new - old) ^t e[index] */
+	u = buffer;
+	v = u + this->height;
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		u[rowIndex] = _Vector->getCell(column, rowIndex) - this->cells[rowIndex * this->width + index];
+		this->cells[rowIndex * this->width + index] = _Vector->getCell(column, rowIndex);
+	}
+	for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+		v[columnIndex] = (columnIndex == index) ? 1 : 0;
+
+	update(this, u, v, v + this->width);
+
+	free(buffer);
+
+	return 1;
+}
+
+
+static double determinant(Factorization const * const this)
+{
+	double determinant;
+	size_t index;
+
+	if (this == NULL)
+		return NO_VALUE;
+	if (this->height != this->width)
+		return MATRIX_IS_NOT_SQUARE;
+
+	determinant = this->sign;
+	for (index = 0; index < this->width; index++)
+		determinant *= this->factors[index * this->width + index];
+
+	return determinant;
+}
+
+
+static double rcond(Factorization const * const this)
+{
+	double * sums;
+	size_t * pivots;
+	double normA, estimate;
+	size_t rowIndex, index;
+
+	if ((this == NULL) || (this->kind != LU))
+		return NO_VALUE;
+
+	sums = calloc(this->width, sizeof(* sums));
+	pivots = malloc(3 * this->width * sizeof(* pivots));
+	if ((sums == NULL) || (pivots == NULL))
+	{
+		free(sums);
+		free(pivots);
+		return NO_VALUE;
+	}
+
+	/* ||A||1 from the cells kept along, column sums accumulated a row at a time */
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		for (index = 0; index < this->width; index++)
+			sums[index] += fabs(this->cells[rowIndex * this->width + index]);
+	}
+	normA = 0;
+	for (index = 0; index < this->width; index++)
+		normA = (sums[index] > normA) ? sums[index] : normA;
+
+	toPivots(this->width, this->permutation, pivots, pivots + this->width);
+	estimate = matrixRcondFactored(this->width, this->factors, pivots, 0, normA);
+
+	free(sums);
+	free(pivots);
+
+	return estimate;
+}
+
+
+static Vector * solve(Factorization const * const this, Vector const * const rightHand)
+{
+	Vector * copy;
+	Vector * solution;
+	double const * b;
+	double * x;
+	double const * row;
+	double value;
+	size_t rowIndex, index;
+
+	if ((this == NULL) || (rightHand == NULL))
+		return NULL;
+	if ((_Vector->size(rightHand) != this->height) || (this->height < this->width))
+		return NULL;
+
+	copy = _Vector->copy(rightHand);
+	solution = _Vector->create(this->width);
+	if ((copy == NULL) || (solution == NULL))
+	{
+		_Vector->delete(& copy);
+		_Vector->delete(& solution);
+		return NULL;
+	}
+	b = _Vector->cells(copy);
+	x = _Vector->cells(solution);
+
+	if (this->kind == LU)
+	{
+		/* L y = P b */
+		for (rowIndex = 0; rowIndex < this->width; rowIndex++)
+		{
+			row = this->factors + rowIndex * this->width;
+			value = b[this->permutation[rowIndex]];
+			for (index = 0; index < rowIndex; index++)
+				value -= row[index] * x[index];
+			x[rowIndex] = value;
+		}
+	}
+	else
+	{
+		/* the first n cells of ^t Q b, the others being the residual */
+		for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+		{
+			row = this->orthogonal + rowIndex * this->height;
+			for (index = 0; index < this->width; index++)
+				x[index] += row[index] * b[rowIndex];
+		}
+	}
+
+	_Vector->delete(& copy);
+
+	/* U x = y, or R x = ^t Q b, both upper triangular from the same row by row factors */
+	for (rowIndex = this->width; rowIndex-- > 0;)
+	{
+		row = this->factors + rowIndex * this->width;
+		if (row[rowIndex] == 0)
+		{
+			_Vector->delete(& solution);
+			return NULL;
+		}
+
+		value = x[rowIndex];
+		for (index = rowIndex + 1; index < this->width; index++)
+			value -= row[index] * x[index];
+		x[rowIndex] = value / row[rowIndex];
+	}
+
+	return solution;
+}
+
+
+static Vector * solveMixed(Matrix const * const matrix, Vector const * const rightHand, int * const iterations)
+{
+	Factorization * fallback;
+	Vector * solution;
+	Vector * residual;
+	float * factors;
+	float * correction;
+	size_t * permutation;
+	double * x;
+	double norm, sum, bound, solutionNorm;
+	size_t size, rowIndex, columnIndex;
+	int fits, step;
+
+	if (iterations != NULL)
+		* iterations = -1;
+	if ((matrix == NULL) || (rightHand == NULL))
+		return NULL;
+	if ((matrix->height != matrix->width) || (_Vector->size(rightHand) != matrix->height))
+		return NULL;
+
+	size = matrix->width;
+	factors = malloc(size * size * sizeof(* factors));
+	correction = malloc(size * sizeof(* correction));
+	permutation = malloc(size * sizeof(* permutation));
+	solution = _Vector->create(size);
+	residual = _Vector->copy(rightHand);
+	if ((factors == NULL) || (correction == NULL) || (permutation == NULL) || (solution == NULL) || (residual == NULL))
+	{
+		free(factors);
+		free(correction);
+		free(permutation);
+		_Vector->delete(& solution);
+		_Vector->delete(& residual);
+		return NULL;
+	}
+	x = _Vector->cells(solution);
+
+	/* ||A||, rounding A to float on the way */
+	norm = 0;
+	fits = 1;
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+	{
+		sum = 0;
+		for (columnIndex = 0; columnIndex < size; columnIndex++)
+		{
+			if (fabs(MATRIX_CELL(matrix, rowIndex, columnIndex)) > FLT_MAX)
+				fits = 0;
+			factors[rowIndex * size + columnIndex] = (float) MATRIX_CELL(matrix, rowIndex, columnIndex);
+			sum += fabs(MATRIX_CELL(matrix, rowIndex, columnIndex));
+		}
+		if (sum > norm)
+			norm = sum;
+	}
+	bound = sqrt((double) size) * norm * DBL_EPSILON;
+
+	/* x starts at 0, so that the residual is b, and the first correction the single precision solution */
+	if (fits && factorSingle(size, factors, permutation))
+	{
+		for (step = 0; step <= MIXED_ITERATIONS; step++)
+		{
+			solveSingle(size, factors, permutation, _Vector->cells(residual), correction);
+			for (rowIndex = 0; rowIndex < size; rowIndex++)
+				x[rowIndex] += correction[rowIndex];
+
+			/* b - A x, in double */
+			for (rowIndex = 0; rowIndex < size; rowIndex++)
+				_Vector->setCell(residual, rowIndex, _Vector->getCell(rightHand, rowIndex));
+			_Vector->gemv(-1, matrix, solution, 1, residual);
+
+			solutionNorm = largest(size, x);
+			if ((solutionNorm <= DBL_MAX) && (largest(size, _Vector->cells(residual)) <= bound * solutionNorm))
+			{
+				if (iterations != NULL)
+					* iterations = step;
+				free(factors);
+				free(correction);
+				free(permutation);
+				_Vector->delete(& residual);
+				return solution;
+			}
+		}
+	}
+
+	free(factors);
+	free(correction);
+	free(permutation);
+	_Vector->delete(& solution);
+	_Vector->delete(& residual);
+
+	/* single precision failed, [iterations] says so */
+	fallback = lu(matrix);
+	if (fallback == NULL)
+		return NULL;
+
+	solution = solve(fallback, rightHand);
+	delete(& fallback);
+
+	return solution;
+}
+
+
+
+
+static Factorization * allocate(Kind kind, Matrix const * const matrix)
+{
+	Factorization * this;
+	size_t rowIndex, columnIndex;
+
+	this = malloc(sizeof(* this));
+	if (this == NULL)
+		return NULL;
+
+	this->kind = kind;
+	this->height = matrix->height;
+	this->width = matrix->width;
+	this->cells = malloc(matrix->height * matrix->width * sizeof(* this->cells));
+	this->factors = malloc(matrix->height * matrix->width * sizeof(* this->factors));
+	this->orthogonal = (kind == QR) ? malloc(matrix->height * matrix->height * sizeof(* this->orthogonal)) : NULL;
+	this->permutation = (kind == LU) ? malloc(matrix->height * sizeof(* this->permutation)) : NULL;
+	this->sign = 1;
+
+	if ((this->cells == NULL) || (this->factors == NULL)
+		|| ((kind == QR) && (this->orthogonal == NULL))
+		|| ((kind == LU) && (this->permutation == NULL)))
+	{
+		delete(& this);
+		return NULL;
+	}
+
+	for (rowIndex = 0; rowIndex < matrix->height; rowIndex++)
+	{
+		if (matrix->layout == MATRIX_ROW_MAJOR)
+			memcpy(this->cells + rowIndex * matrix->width, matrix->cells[rowIndex], matrix->width * sizeof(* this->cells));
+		else for (columnIndex = 0; columnIndex < matrix->width; columnIndex++)
+			this->cells[rowIndex * matrix->width + columnIndex] = matrix->cells[columnIndex][rowIndex];
+	}
+
+	return this;
+}
+
+
+static void factorLU(Factorization * const this)
+{
+	double * const factors = this->factors;
+	size_t const size = this->width;
+	size_t rowIndex, columnIndex, index, best, swap;
+	double value;
+
+	memcpy(factors, this->cells, size * size * sizeof(* factors));
+	for (index = 0; index < size; index++)
+		this->permutation[index] = index;
+	this->sign = 1;
+
+	for (index = 0; index < size; index++)
+	{
+		best = index;
+		for (rowIndex = index + 1; rowIndex < size; rowIndex++)
+		{
+			if (fabs(factors[rowIndex * size + index]) > fabs(factors[best * size + index]))
+				best = rowIndex;
+		}
+
+		if (best != index)
+		{
+			for (columnIndex = 0; columnIndex < size; columnIndex++)
+			{
+				value = factors[index * size + columnIndex];
+				factors[index * size + columnIndex] = factors[best * size + columnIndex];
+				factors[best * size + columnIndex] = value;
+			}
+			swap = this->permutation[index];
+			this->permutation[index] = this->permutation[best];
+			this->permutation[best] = swap;
+			this->sign = -this->sign;
+		}
+
+		if (factors[index * size + index] == 0)
+			continue;
+
+		for (rowIndex = index + 1; rowIndex < size; rowIndex++)
+		{
+			value = factors[rowIndex * size + index] / factors[index * size + index];
+			factors[rowIndex * size + index] = value;
+			for (columnIndex = index + 1; columnIndex < size; columnIndex++)
+				factors[rowIndex * size + columnIndex] -= value * factors[index * size + columnIndex];
+		}
+	}
+}
+
+
+static void factorQR(Factorization * const this)
+{
+	size_t rowIndex, columnIndex;
+
+	memcpy(this->factors, this->cells, this->height * this->width * sizeof(* this->factors));
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		for (columnIndex = 0; columnIndex < this->height; columnIndex++)
+			this->orthogonal[rowIndex * this->height + columnIndex] = (rowIndex == columnIndex) ? 1 : 0;
+	}
+	this->sign = 1;
+
+	for (columnIndex = 0; (columnIndex < this->width) && (columnIndex + 1 < this->height); columnIndex++)
+	{
+		for (rowIndex = this->height - 1; rowIndex > columnIndex; rowIndex--)
+			annihilate(this, rowIndex - 1, rowIndex, columnIndex);
+	}
+}
+
+
+static int updateLU(Factorization * const this, double * const x, double * const y)
+{
+	double * const factors = this->factors;
+	size_t const size = this->width;
+	size_t rowIndex, columnIndex, index;
+	double pivot, diagonal, upper, lower;
+
+	/*
+	 * With L = [1 0; l L2], U = [p ^t u; 0 U2], x = [x1; x2] and y = [y1; y2], the first row and column become
+	 * p' = p + x1 y1, u' = u + x1 y2 and l' = (p l + y1 x2) / p', and what is left is L2 U2 + x2' ^t y2',
+	 * with x2' = x2 - x1 l and y2' = (p y2 - y1 u) / p'
+	 */
+	for (index = 0; index < size; index++)
+	{
+		pivot = factors[index * size + index];
+		diagonal = pivot + x[index] * y[index];
+		if (diagonal == 0)
+			return 0;
+		factors[index * size + index] = diagonal;
+
+		for (columnIndex = index + 1; columnIndex < size; columnIndex++)
+		{
+			upper = factors[index * size + columnIndex];
+			factors[index * size + columnIndex] = upper + x[index] * y[columnIndex];
+			y[columnIndex] = (pivot * y[columnIndex] - y[index] * upper) / diagonal;
+		}
+
+		for (rowIndex = index + 1; rowIndex < size; rowIndex++)
+		{
+			lower = factors[rowIndex * size + index];
+			factors[rowIndex * size + index] = (pivot * lower + y[index] * x[rowIndex]) / diagonal;
+			x[rowIndex] -= x[index] * lower;
+
+			/* without pivoting, nothing else bounds the growth of the factors */
+			if (fabs(factors[rowIndex * size + index]) > GROWTH_LIMIT)
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+
+static void updateQR(Factorization * const this, double const * const u, double const * const v, double * const work)
+{
+	double const * row;
+	double radius;
+	size_t rowIndex, columnIndex;
+
+	for (columnIndex = 0; columnIndex < this->height; columnIndex++)
+		work[columnIndex] = 0;
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		row = this->orthogonal + rowIndex * this->height;
+		for (columnIndex = 0; columnIndex < this->height; columnIndex++)
+			work[columnIndex] += row[columnIndex] * u[rowIndex];
+	}
+
+	for (rowIndex = this->height - 1; rowIndex > 0; rowIndex--)
+	{
+		if (work[rowIndex] == 0)
+			continue;
+
+		radius = magnitude(work[rowIndex - 1], work[rowIndex]);
+		rotate(this, rowIndex - 1, rowIndex, work[rowIndex - 1] / radius, work[rowIndex] / radius);
+		work[rowIndex - 1] = radius;
+		work[rowIndex] = 0;
+	}
+
+	for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+		this->factors[columnIndex] += work[0] * v[columnIndex];
+
+	for (rowIndex = 0; (rowIndex + 1 < this->height) && (rowIndex < this->width); rowIndex++)
+		annihilate(this, rowIndex, rowIndex + 1, rowIndex);
+}
+
+
+static void update(Factorization * const this, double const * const u, double * const v, double * const work)
+{
+	size_t index;
+
+	if (this->kind == QR)
+	{
+		updateQR(this, u, v, work);
+		return;
+	}
+
+	/* P (A + u ^t v) = L U + (P u) ^t v */
+	for (index = 0; index < this->height; index++)
+		work[index] = u[this->permutation[index]];
+
+	if (! updateLU(this, work, v))
+		factorLU(this);
+}
+
+
+static void rotate(Factorization * const this, size_t first, size_t second, double cosine, double sine)
+{
+	double * const top = this->factors + first * this->width;
+	double * const bottom = this->factors + second * this->width;
+	double * row;
+	double a, b;
+	size_t index;
+
+	for (index = 0; index < this->width; index++)
+	{
+		a = top[index];
+		b = bottom[index];
+		top[index] = cosine * a + sine * b;
+		bottom[index] = cosine * b - sine * a;
+	}
+
+	for (index = 0; index < this->height; index++)
+	{
+		row = this->orthogonal + index * this->height;
+		a = row[first];
+		b = row[second];
+		row[first] = cosine * a + sine * b;
+		row[second] = cosine * b - sine * a;
+	}
+}
+
+
+static void annihilate(Factorization * const this, size_t first, size_t second, size_t column)
+{
+	double a, b, radius;
+
+	a = this->factors[first * this->width + column];
+	b = this->factors[second * this->width + column];
+	if (b == 0)
+		return;
+
+	radius = magnitude(a, b);
+	rotate(this, first, second, a / radius, b / radius);
+	this->factors[second * this->width + column] = 0;
+}
+
+
+static double magnitude(double a, double b)
+{
+	double scale;
+
+	a = fabs(a);
+	b = fabs(b);
+	scale = (a > b) ? a : b;
+	if (scale == 0)
+		return 0;
+
+	return scale * sqrt((a / scale) * (a / scale) + (b / scale) * (b / scale));
+}
+
+
+static double * splice(
+	double const * const block,
+	size_t height,
+	size_t width,
+	size_t row,
+	int rowChange,
+	size_t column,
+	int columnChange)
+{
+	double * result;
+	size_t resultHeight, resultWidth, rowIndex, columnIndex, sourceRow, sourceColumn;
+
+	resultHeight = (rowChange < 0) ? height - 1 : height + rowChange;
+	resultWidth = (columnChange < 0) ? width - 1 : width + columnChange;
+
+	result = calloc(resultHeight * resultWidth, sizeof(* result));
+	if (result == NULL)
+		return NULL;
+
+	for (rowIndex = 0; rowIndex < resultHeight; rowIndex++)
+	{
+		if ((rowChange > 0) && (rowIndex == row))
+			continue;
+		sourceRow = rowIndex;
+		if ((rowChange > 0) && (rowIndex > row))
+			sourceRow--;
+		if ((rowChange < 0) && (rowIndex >= row))
+			sourceRow++;
+
+		for (columnIndex = 0; columnIndex < resultWidth; columnIndex++)
+		{
+			if ((columnChange > 0) && (columnIndex == column))
+				continue;
+			sourceColumn = columnIndex;
+			if ((columnChange > 0) && (columnIndex > column))
+				sourceColumn--;
+			if ((columnChange < 0) && (columnIndex >= column))
+				sourceColumn++;
+
+			result[rowIndex * resultWidth + columnIndex] = block[sourceRow * width + sourceColumn];
+		}
+	}
+
+	return result;
+}
+
+
+static int factorSingle(size_t size, float * const factors, size_t * const permutation)
+{
+	size_t rowIndex, columnIndex, index, best, swap;
+	float value;
+
+	for (index = 0; index < size; index++)
+		permutation[index] = index;
+
+	for (index = 0; index < size; index++)
+	{
+		best = index;
+		for (rowIndex = index + 1; rowIndex < size; rowIndex++)
+		{
+			if (fabs(factors[rowIndex * size + index]) > fabs(factors[best * size + index]))
+				best = rowIndex;
+		}
+
+		if (factors[best * size + index] == 0)
+			return 0;
+
+		if (best != index)
+		{
+			for (columnIndex = 0; columnIndex < size; columnIndex++)
+			{
+				value = factors[index * size + columnIndex];
+				factors[index * size + columnIndex] = factors[best * size + columnIndex];
+				factors[best * size + columnIndex] = value;
+			}
+			swap = permutation[index];
+			permutation[index] = permutation[best];
+			permutation[best] = swap;
+		}
+
+		for (rowIndex = index + 1; rowIndex < size; rowIndex++)
+		{
+			value = factors[rowIndex * size + index] / factors[index * size + index];
+			factors[rowIndex * size + index] = value;
+			for (columnIndex = index + 1; columnIndex < size; columnIndex++)
+				factors[rowIndex * size + columnIndex] -= value * factors[index * size + columnIndex];
+		}
+	}
+
+	return 1;
+}
+
+
+static void solveSingle(
+	size_t size,
+	float const * const factors,
+	size_t const * const permutation,
+	double const * const residual,
+	float * const vector)
+{
+	float const * row;
+	float value;
+	size_t rowIndex, index;
+
+	/* L y = P r */
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+	{
+		row = factors + rowIndex * size;
+		value = (float) residual[permutation[rowIndex]];
+		for (index = 0; index < rowIndex; index++)
+			value -= row[index] * vector[index];
+		vector[rowIndex] = value;
+	}
+
+	/* U d = y */
+	for (rowIndex = size; rowIndex-- > 0;)
+	{
+		row = factors + rowIndex * size;
+		value = vector[rowIndex];
+		for (index = rowIndex + 1; index < size; index++)
+			value -= row[index] * vector[index];
+		vector[rowIndex] = value / row[rowIndex];
+	}
+}
+
+
+static double largest(size_t size, double const * const cells)
+{
+	double result = 0;
+	size_t index;
+
+	for (index = 0; index < size; index++)
+	{
+		if (cells[index] != cells[index])
+			return HUGE_VAL;
+		if (fabs(cells[index]) > result)
+			result = fabs(cells[index]);
+	}
+
+	return result;
+}
+
+
+
+
+static void toPivots(size_t size, size_t const * const permutation, size_t * const pivots, size_t * const rows)
+{
+	size_t * const positions = rows + size;
+	size_t index, position;
+
+	/* rows[i] is the row of A at position i after the swaps so far, positions[] its inverse */
+	for (index = 0; index < size; index++)
+	{
+		rows[index] = index;
+		positions[index] = index;
+	}
+
+	for (index = 0; index < size; index++)
+	{
+		position = positions[permutation[index]];
+		pivots[index] = position;
+		rows[position] = rows[index];
+		positions[rows[position]] = position;
+		rows[index] = permutation[index];
+		positions[permutation[index]] = index;
+	}
+}
+
+
+static FactorizationMethods methods =
+{
+	lu,
+	qr,
+	delete,
+	height,
+	width,
+	insertRow,
+	deleteRow,
+	replaceRow,
+	insertColumn,
+	deleteColumn,
+	replaceColumn,
+	determinant,
+	rcond,
+	solve,
+	solveMixed
+};
+FactorizationMethods const * const _Factorization = & methods;
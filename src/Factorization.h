@@ -0,0 +1,181 @@
+#ifndef FACTORIZATION_HEADER
+#define FACTORIZATION_HEADER
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <stddef.h>
+
+
+
+
+/*
+ * A matrix kept along with its LU or QR factorization, which follows changes to its rows and columns
+ * in O(n^2) per change rather than being factored again in O(n^3)
+ */
+typedef struct Factorization Factorization;
+
+
+typedef struct
+{
+	/**
+	 * Factors a square matrix as P A = L U, with partial pivoting
+	 * Rows and columns can then be replaced, L and U being updated by Bennett's algorithm in O(n^2):
+	 * when it would need a pivot, or let a multiplier of L grow past what pivoting allows by far,
+	 * A is factored again instead
+	 *
+	 * @param matrix - A, copied
+	 *
+	 * @return - the factorization, or NULL if:
+	 * 		[matrix] is NULL, or isn't square,
+	 * 		allocation failed
+	 */
+	Factorization * (* lu)(Matrix const * matrix);
+
+	/**
+	 * Factors a m*n matrix as A = Q R, with Givens rotations, Q m*m orthogonal and R m*n upper triangular
+	 * Rows and columns can then be inserted, deleted and replaced, more Givens rotations
+	 * bringing R back to triangular in O(m^2 + m n), which is always stable
+	 *
+	 * @param matrix - A, copied
+	 *
+	 * @return - the factorization, or NULL if [matrix] is NULL or allocation failed
+	 */
+	Factorization * (* qr)(Matrix const * matrix);
+
+	/**
+	 * Deletes the factorization, and sets it to NULL
+	 *
+	 * @param this - pointer to pointer to factorization to delete
+	 */
+	void (* delete)(Factorization ** this);
+
+	/**
+	 * @return - m, the height of the factored matrix, or 0 if [this] is NULL
+	 */
+	size_t (* height)(Factorization const * this);
+
+	/**
+	 * @return - n, the width of the factored matrix, or 0 if [this] is NULL
+	 */
+	size_t (* width)(Factorization const * this);
+
+	/**
+	 * Inserts a row before row [index], or after the last one if [index] is m, for QR only
+	 *
+	 * @param row - n cells
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		any parameter is NULL,
+	 * 		[this] is a LU factorization, which must stay square,
+	 * 		[index] is greater than m, or [row] size isn't n,
+	 * 		allocation failed, the factorization being left as it was
+	 */
+	int (* insertRow)(Factorization * this, size_t index, Vector const * row);
+
+	/**
+	 * Deletes row [index], for QR only
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		[this] is NULL, or is a LU factorization,
+	 * 		[index] is out of bounds, or the row is the only one,
+	 * 		allocation failed, the factorization being left as it was
+	 */
+	int (* deleteRow)(Factorization * this, size_t index);
+
+	/**
+	 * Replaces row [index], a rank 1 update of A
+	 *
+	 * @param row - n cells
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		any parameter is NULL,
+	 * 		[index] is out of bounds, or [row] size isn't n,
+	 * 		allocation failed, the factorization being left as it was
+	 */
+	int (* replaceRow)(Factorization * this, size_t index, Vector const * row);
+
+	/**
+	 * Inserts a column before column [index], or after the last one if [index] is n, for QR only
+	 * @see insertRow
+	 *
+	 * @param column - m cells
+	 */
+	int (* insertColumn)(Factorization * this, size_t index, Vector const * column);
+
+	/**
+	 * Deletes column [index], for QR only
+	 * @see deleteRow
+	 */
+	int (* deleteColumn)(Factorization * this, size_t index);
+
+	/**
+	 * Replaces column [index], a rank 1 update of A
+	 * @see replaceRow
+	 *
+	 * @param column - m cells
+	 */
+	int (* replaceColumn)(Factorization * this, size_t index, Vector const * column);
+
+	/**
+	 * det(A), ± the product of the diagonal of U or R, in O(n)
+	 *
+	 * @return - the determinant, or NO_VALUE if [this] is NULL, or MATRIX_IS_NOT_SQUARE if A isn't square
+	 */
+	double (* determinant)(Factorization const * this);
+
+	/**
+	 * Estimates the reciprocal condition number 1 / (||A||1 * ||A^(-1)||1) from the factors of P A = L U,
+	 * as _Matrix->rcond does, without factoring A again: O(n^2) rather than O(n^3), for LU only
+	 *
+	 * @return - the estimate, between 0 for singular matrices and 1, or NO_VALUE if:
+	 * 		[this] is NULL, or is a QR factorization,
+	 * 		allocation failed
+	 */
+	double (* rcond)(Factorization const * this);
+
+	/**
+	 * Solves A x = b by substitution, in O(m^2)
+	 * For QR and m > n, x is the least squares solution, minimizing ||A x - b||
+	 *
+	 * @param rightHand - b, m cells
+	 *
+	 * @return - x as a new vector of n cells, or NULL if:
+	 * 		any parameter is NULL,
+	 * 		[rightHand] size isn't m,
+	 * 		m < n, or a diagonal cell of U or R is 0,
+	 * 		allocation failed
+	 */
+	Vector * (* solve)(Factorization const * this, Vector const * rightHand);
+
+	/**
+	 * Solves A x = b without keeping a factorization: P A = L U is factored in single precision,
+	 * for half the time and memory traffic, then x is refined in double, correcting it with
+	 * L U d = b - A x until the residual is as small as a double precision solve leaves it,
+	 * ||b - A x|| <= sqrt(n) ||A|| ||x|| ε, infinity norms, within MIXED_ITERATIONS steps
+	 * A is factored again in double instead when its cells don't fit in a float, a single precision pivot is 0,
+	 * or refinement doesn't converge, A being too ill-conditioned for single precision, κ(A) beyond about 1e7
+	 *
+	 * @param matrix - A, square
+	 * @param rightHand - b, n cells
+	 * @param iterations - receives the refinement steps taken, or -1 if x was solved in double, may be NULL
+	 *
+	 * @return - x as a new vector of n cells, or NULL if:
+	 * 		[matrix] or [rightHand] is NULL,
+	 * 		[matrix] isn't square, or [rightHand] size isn't n,
+	 * 		A is singular,
+	 * 		allocation failed
+	 */
+	Vector * (* solveMixed)(Matrix const * matrix, Vector const * rightHand, int * iterations);
+
+} FactorizationMethods;
+
+
+
+
+extern FactorizationMethods const * const _Factorization;
+
+
+
+
+#endif /* FACTORIZATION_HEADER */
@@ -0,0 +1,2063 @@
+#include "Krylov.h"
+#include "MatrixPrivate.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+
+/* below this fraction of A x left by orthogonalization, the basis spans an invariant subspace */
+#define INVARIANCE 1e-12
+
+/* Jacobi sweeps at most, quadratic convergence needing far fewer */
+#define JACOBI_SWEEPS 50
+
+/* QR steps at most per eigenvalue of a Hessenberg matrix */
+#define HESSENBERG_ITERATIONS 30
+
+
+
+
+/**
+ * A resolution in progress, shared by the solvers
+ */
+typedef struct
+{
+	KrylovOperator const * matrix;
+	KrylovOperator const * preconditioner;
+	size_t size;
+	double tolerance;
+	size_t maximumIterations;
+
+	/* b, as a vector of its own so that its cells can be read */
+	Vector * rightHand;
+	double const * b;
+	double rightHandNorm;
+
+	/* the iterate, returned to the caller */
+	Vector * solution;
+	double * x;
+
+	/* [vectors] * [size] values, for the solver to use */
+	double * work;
+
+	KrylovStatistics statistics;
+} Resolution;
+
+
+/**
+ * Sparse rows of non-zero cells, the L and U factors of ilu0 sharing them
+ */
+typedef struct
+{
+	size_t size;
+
+	/* cells of row i are [rowStarts[i], rowStarts[i + 1]), by increasing column */
+	size_t * rowStarts;
+	size_t * columns;
+	double * values;
+
+	/* position of the diagonal cell of each row */
+	size_t * diagonals;
+} SparseRows;
+
+
+/**
+ * A decomposition A V = V H + h v e^T, grown then restarted by the eigensolvers
+ */
+typedef struct
+{
+	KrylovOperator const * matrix;
+	size_t size;
+	double tolerance;
+	size_t maximumIterations;
+
+	/* m, the most vectors in V */
+	size_t dimension;
+
+	/* the m vectors of V then v, orthonormal, then 4 vectors of work memory */
+	double * basis;
+	double * work;
+
+	/* (m + 1) * m values by rows, H then h e^T */
+	double * projected;
+
+	/* the m Ritz values, by decreasing magnitude, conjugates being consecutive with the positive imaginary part first */
+	double * real;
+	double * imaginary;
+
+	/* the m Ritz vectors, m values each, in V */
+	double * vectorsReal;
+	double * vectorsImaginary;
+
+	/* 3 m * m + 2 m values, and m indexes, of work memory for the projected problem */
+	double * scratch;
+	size_t * indexes;
+
+	unsigned long seed;
+	KrylovStatistics statistics;
+} Decomposition;
+
+
+
+
+/**
+ * Checks the arguments, and allocates what every solver needs, [vectors] work vectors and [extra] values after them
+ *
+ * @return - 1 on success, 0 if arguments are invalid or allocation failed, nothing being left allocated
+ */
+static int begin(
+	Resolution * this,
+	KrylovOperator const * matrix,
+	KrylovOperator const * preconditioner,
+	Vector const * rightHand,
+	Vector const * guess,
+	KrylovSettings const * settings,
+	size_t vectors,
+	size_t extra);
+
+/**
+ * Recomputes the residual from the iterate, frees what begin allocated but the solution,
+ * and copies the statistics
+ *
+ * @param residual - a work vector, overwritten
+ *
+ * @return - the solution
+ */
+static Vector * end(Resolution * this, double * residual, KrylovStatistics * statistics);
+
+/**
+ * y = A x
+ */
+static void multiply(Resolution * this, double const * x, double * y);
+
+/**
+ * y = M^(-1) x, or a copy of x without preconditioner
+ */
+static void precondition(Resolution * this, double const * x, double * y);
+
+/**
+ * residual = b - A x
+ *
+ * @return - ||b - A x||
+ */
+static double computeResidual(Resolution * this, double * residual);
+
+/**
+ * @return - ∑ x[i] * y[i], over 4 independent sums so that they can be vectorized
+ */
+static double dot(size_t size, double const * x, double const * y);
+
+/**
+ * y += alpha x
+ */
+static void axpy(size_t size, double alpha, double const * x, double * y);
+
+/**
+ * Applies A, for dense
+ *
+ * @param context - the Matrix
+ */
+static void applyDense(double const * x, double * y, size_t size, void * context);
+
+/**
+ * Applies M^(-1), for jacobi
+ *
+ * @param context - the inverted diagonal
+ */
+static void applyJacobi(double const * x, double * y, size_t size, void * context);
+
+/**
+ * Applies M^(-1) = U^(-1) L^(-1), for ilu0
+ *
+ * @param context - the SparseRows holding both factors
+ */
+static void applyILU(double const * x, double * y, size_t size, void * context);
+
+/**
+ * Allocates an operator, and [bytes] more for its context, in a single block
+ *
+ * @return - the operator, with [context] pointing to the extra bytes, or NULL if allocation failed
+ */
+static KrylovOperator * allocateOperator(size_t size, void (* apply)(double const *, double *, size_t, void *), size_t bytes);
+
+/**
+ * Shared by lanczos and arnoldi
+ *
+ * @param symmetric - 1 to solve the projected problem as symmetric
+ * @param imaginary - where the imaginary parts go, may be NULL if [symmetric]
+ */
+static Matrix * eigenpairs(
+	KrylovOperator const * matrix,
+	size_t count,
+	KrylovSettings const * settings,
+	int symmetric,
+	double * real,
+	double * imaginary,
+	KrylovStatistics * statistics);
+
+/**
+ * Allocates a decomposition for [count] eigenpairs, and starts V from a pseudo-random vector
+ *
+ * @return - 1 on success, 0 if allocation failed, nothing being left allocated
+ */
+static int beginDecomposition(Decomposition * this, KrylovOperator const * matrix, size_t count, KrylovSettings const * settings);
+
+/**
+ * Frees what beginDecomposition allocated
+ */
+static void endDecomposition(Decomposition * this);
+
+/**
+ * Arnoldi steps, from V having [from] vectors and v, until it has m
+ * An invariant subspace is left with h = 0, and a pseudo-random v orthogonal to V
+ */
+static void expand(Decomposition * this, size_t from);
+
+/**
+ * Sets the Ritz values and vectors from H
+ *
+ * @return - 1 on success, 0 if the eigenvalues of H didn't converge
+ */
+static int findRitzPairs(Decomposition * this, int symmetric);
+
+/**
+ * @return - 1 if the [count] first Ritz pairs have h |y[m - 1]| <= tolerance |λ|
+ */
+static int hasConverged(Decomposition const * this, size_t count);
+
+/**
+ * Restarts from V Q and v, Q being an orthonormal basis of the [kept] first Ritz vectors,
+ * H becoming Q^T H Q and h Q[m - 1]
+ *
+ * @return - the vectors kept, fewer than [kept] if some Ritz vectors were dependent
+ */
+static size_t restart(Decomposition * this, size_t kept);
+
+/**
+ * Writes the [count] first Ritz pairs, normalized, and the greatest relative residual into the statistics
+ *
+ * @param imaginary - may be NULL, for symmetric problems
+ */
+static void writeRitzPairs(Decomposition * this, size_t count, Matrix * vectors, double * real, double * imaginary);
+
+/**
+ * @return - |λ| of Ritz value [index], or of the first if it's 0, or 1 if both are
+ */
+static double magnitudeOf(Decomposition const * this, size_t index);
+
+/**
+ * x = V y
+ */
+static void combine(Decomposition const * this, double const * y, double * x);
+
+/**
+ * Modified Gram-Schmidt, twice, against [count] orthonormal vectors
+ *
+ * @param coefficients - [count] values, to which components are added, may be NULL
+ *
+ * @return - the norm left to [vector]
+ */
+static double orthogonalize(size_t size, size_t count, double const * basis, double * vector, double * coefficients);
+
+/**
+ * Fills [x] with values in [-1, 1), from a linear congruential generator so that runs repeat
+ */
+static void randomize(unsigned long * seed, size_t size, double * x);
+
+/**
+ * @return - 1 if the first value comes before the second: greater magnitude, then real part, then imaginary part
+ */
+static int precedes(double real, double imaginary, double otherReal, double otherImaginary);
+
+/**
+ * Cyclic Jacobi rotations, until off-diagonal cells are negligible
+ *
+ * @param cells - [size] * [size] symmetric values by rows, whose diagonal ends holding the eigenvalues
+ * @param vectors - receives the eigenvectors, as columns
+ */
+static void symmetricEigen(size_t size, double * cells, double * vectors);
+
+/**
+ * Reduces to upper Hessenberg form by eliminations with pivoting, keeping the eigenvalues
+ *
+ * @param cells - [size] * [size] values by rows
+ */
+static void reduceToHessenberg(size_t size, double * cells);
+
+/**
+ * Eigenvalues of an upper Hessenberg matrix, by Francis double shift QR steps, destroying it
+ *
+ * @return - 1 on success, 0 if an eigenvalue wasn't found in HESSENBERG_ITERATIONS steps
+ */
+static int hessenbergEigenvalues(size_t size, double * cells, double * real, double * imaginary);
+
+/**
+ * Eigenvector of λ = [real] + i [imaginary], by inverse iteration on cells - λ I
+ *
+ * @param work - 2 [size] * [size] values
+ * @param pivots - [size] indexes
+ * @param vectorReal, vectorImaginary - receive the vector, of norm 1
+ */
+static void inverseIteration(
+	size_t size,
+	double const * cells,
+	double real,
+	double imaginary,
+	double * work,
+	size_t * pivots,
+	double * vectorReal,
+	double * vectorImaginary);
+
+/**
+ * [real] + i [imaginary] /= [byReal] + i [byImaginary]
+ */
+static void divideComplex(double * real, double * imaginary, double byReal, double byImaginary);
+
+
+
+
+static KrylovOperator * dense(Matrix const * const matrix)
+{
+	KrylovOperator * this;
+
+	if (matrix == NULL)
+		return NULL;
+	if (matrix->width != matrix->height)
+		return NULL;
+
+	this = allocateOperator(matrix->height, applyDense, 0);
+	if (this == NULL)
+		return NULL;
+
+	this->context = (void *) matrix;
+
+	return this;
+}
+
+
+static KrylovOperator * jacobi(Matrix const * const matrix)
+{
+	KrylovOperator * this;
+	double * inverted;
+	size_t index;
+
+	if (matrix == NULL)
+		return NULL;
+	if (matrix->width != matrix->height)
+		return NULL;
+
+	for (index = 0; index < matrix->height; index++)
+	{
+		if (matrix->cells[index][index] == 0)
+			return NULL;
+	}
+
+	this = allocateOperator(matrix->height, applyJacobi, matrix->height * sizeof(double));
+	if (this == NULL)
+		return NULL;
+
+	inverted = this->context;
+	for (index = 0; index < matrix->height; index++)
+		inverted[index] = 1 / matrix->cells[index][index];
+
+	return this;
+}
+
+
+static KrylovOperator * ilu0(Matrix const * const matrix)
+{
+	KrylovOperator * this;
+	SparseRows * rows;
+	size_t size, count, rowIndex, columnIndex, position, pivotPosition, other;
+	size_t * marks;
+	double factor;
+
+	if (matrix == NULL)
+		return NULL;
+	if (matrix->width != matrix->height)
+		return NULL;
+
+	size = matrix->height;
+
+	/* the diagonal is kept even when zero, so that its pivot is found, and rejected */
+	count = 0;
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+	{
+		for (columnIndex = 0; columnIndex < size; columnIndex++)
+		{
+			if ((MATRIX_CELL(matrix, rowIndex, columnIndex) != 0) || (columnIndex == rowIndex))
+				count++;
+		}
+	}
+
+	/* sizes and columns first, values last, so that every array is suitably aligned */
+	this = allocateOperator(size, applyILU,
+		sizeof(SparseRows) + (3 * size + 1 + count) * sizeof(size_t) + count * sizeof(double));
+	if (this == NULL)
+		return NULL;
+
+	rows = this->context;
+	rows->size = size;
+	rows->rowStarts = (size_t *) (rows + 1);
+	rows->diagonals = rows->rowStarts + size + 1;
+	rows->columns = rows->diagonals + size;
+	marks = rows->columns + count;
+	rows->values = (double *) (marks + size);
+
+	position = 0;
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+	{
+		rows->rowStarts[rowIndex] = position;
+		for (columnIndex = 0; columnIndex < size; columnIndex++)
+		{
+			if ((MATRIX_CELL(matrix, rowIndex, columnIndex) == 0) && (columnIndex != rowIndex))
+				continue;
+
+			if (columnIndex == rowIndex)
+				rows->diagonals[rowIndex] = position;
+			rows->columns[position] = columnIndex;
+			rows->values[position] = MATRIX_CELL(matrix, rowIndex, columnIndex);
+			position++;
+		}
+	}
+	rows->rowStarts[size] = position;
+
+	/* IKJ elimination, updates only land on cells which are already non-zero */
+	for (columnIndex = 0; columnIndex < size; columnIndex++)
+		marks[columnIndex] = count;
+
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+	{
+		for (position = rows->rowStarts[rowIndex]; position < rows->rowStarts[rowIndex + 1]; position++)
+			marks[rows->columns[position]] = position;
+
+		for (position = rows->rowStarts[rowIndex]; position < rows->diagonals[rowIndex]; position++)
+		{
+			pivotPosition = rows->diagonals[rows->columns[position]];
+			factor = rows->values[position] / rows->values[pivotPosition];
+			rows->values[position] = factor;
+
+			for (other = pivotPosition + 1; other < rows->rowStarts[rows->columns[position] + 1]; other++)
+			{
+				if (marks[rows->columns[other]] != count)
+					rows->values[marks[rows->columns[other]]] -= factor * rows->values[other];
+			}
+		}
+
+		if (rows->values[rows->diagonals[rowIndex]] == 0)
+		{
+			free(this);
+			return NULL;
+		}
+
+		for (position = rows->rowStarts[rowIndex]; position < rows->rowStarts[rowIndex + 1]; position++)
+			marks[rows->columns[position]] = count;
+	}
+
+	return this;
+}
+
+
+static void delete(KrylovOperator ** const this)
+{
+	if (this == NULL)
+		return;
+
+	free(* this);
+	* this = NULL;
+}
+
+
+static Vector * cg(
+	KrylovOperator const * const matrix,
+	KrylovOperator const * const preconditioner,
+	Vector const * const rightHand,
+	Vector const * const guess,
+	KrylovSettings const * const settings,
+	KrylovStatistics * const statistics)
+{
+	Resolution this;
+	double * r;
+	double * z;
+	double * p;
+	double * q;
+	double rz, previous, curvature, alpha, norm;
+	size_t index;
+
+	if (! begin(& this, matrix, preconditioner, rightHand, guess, settings, 4, 0))
+		return NULL;
+
+	r = this.work;
+	z = r + this.size;
+	p = z + this.size;
+	q = p + this.size;
+
+	norm = computeResidual(& this, r);
+	precondition(& this, r, z);
+	memcpy(p, z, this.size * sizeof(double));
+	rz = dot(this.size, r, z);
+
+	while (norm > this.tolerance * this.rightHandNorm)
+	{
+		if (this.statistics.iterations == this.maximumIterations)
+		{
+			this.statistics.status = KRYLOV_NOT_CONVERGED;
+			break;
+		}
+		this.statistics.iterations++;
+
+		multiply(& this, p, q);
+		curvature = dot(this.size, p, q);
+		if (curvature <= 0)
+		{
+			this.statistics.status = KRYLOV_BREAKDOWN;
+			break;
+		}
+
+		alpha = rz / curvature;
+		axpy(this.size, alpha, p, this.x);
+		axpy(this.size, -alpha, q, r);
+		norm = sqrt(dot(this.size, r, r));
+
+		/* the updated residual drifts from the true one, which has the last word */
+		if (norm <= this.tolerance * this.rightHandNorm)
+		{
+			norm = computeResidual(& this, r);
+			if (norm <= this.tolerance * this.rightHandNorm)
+				break;
+		}
+
+		precondition(& this, r, z);
+		previous = rz;
+		rz = dot(this.size, r, z);
+		for (index = 0; index < this.size; index++)
+			p[index] = z[index] + rz / previous * p[index];
+	}
+
+	return end(& this, r, statistics);
+}
+
+
+static Vector * bicgstab(
+	KrylovOperator const * const matrix,
+	KrylovOperator const * const preconditioner,
+	Vector const * const rightHand,
+	Vector const * const guess,
+	KrylovSettings const * const settings,
+	KrylovStatistics * const statistics)
+{
+	Resolution this;
+	double * r;
+	double * shadow;
+	double * p;
+	double * v;
+	double * preconditionedP;
+	double * s;
+	double * preconditionedS;
+	double * t;
+	double rho, previousRho, alpha, omega, beta, norm;
+	size_t index;
+
+	if (! begin(& this, matrix, preconditioner, rightHand, guess, settings, 8, 0))
+		return NULL;
+
+	r = this.work;
+	shadow = r + this.size;
+	p = shadow + this.size;
+	v = p + this.size;
+	preconditionedP = v + this.size;
+	s = preconditionedP + this.size;
+	preconditionedS = s + this.size;
+	t = preconditionedS + this.size;
+
+	norm = computeResidual(& this, r);
+	memcpy(shadow, r, this.size * sizeof(double));
+	memset(p, 0, this.size * sizeof(double));
+	memset(v, 0, this.size * sizeof(double));
+	previousRho = 1;
+	alpha = 1;
+	omega = 1;
+
+	while (norm > this.tolerance * this.rightHandNorm)
+	{
+		if (this.statistics.iterations == this.maximumIterations)
+		{
+			this.statistics.status = KRYLOV_NOT_CONVERGED;
+			break;
+		}
+		this.statistics.iterations++;
+
+		rho = dot(this.size, shadow, r);
+		if (rho == 0)
+		{
+			this.statistics.status = KRYLOV_BREAKDOWN;
+			break;
+		}
+
+		beta = (rho / previousRho) * (alpha / omega);
+		for (index = 0; index < this.size; index++)
+			p[index] = r[index] + beta * (p[index] - omega * v[index]);
+
+		precondition(& this, p, preconditionedP);
+		multiply(& this, preconditionedP, v);
+		alpha = dot(this.size, shadow, v);
+		if (alpha == 0)
+		{
+			this.statistics.status = KRYLOV_BREAKDOWN;
+			break;
+		}
+		alpha = rho / alpha;
+
+		for (index = 0; index < this.size; index++)
+			s[index] = r[index] - alpha * v[index];
+		axpy(this.size, alpha, preconditionedP, this.x);
+
+		/* half a step may be enough */
+		norm = sqrt(dot(this.size, s, s));
+		if (norm <= this.tolerance * this.rightHandNorm)
+		{
+			norm = computeResidual(& this, r);
+			if (norm <= this.tolerance * this.rightHandNorm)
+				break;
+			memcpy(s, r, this.size * sizeof(double));
+		}
+
+		precondition(& this, s, preconditionedS);
+		multiply(& this, preconditionedS, t);
+		omega = dot(this.size, t, t);
+		if (omega == 0)
+		{
+			this.statistics.status = KRYLOV_BREAKDOWN;
+			break;
+		}
+		omega = dot(this.size, t, s) / omega;
+		if (omega == 0)
+		{
+			this.statistics.status = KRYLOV_BREAKDOWN;
+			break;
+		}
+
+		axpy(this.size, omega, preconditionedS, this.x);
+		for (index = 0; index < this.size; index++)
+			r[index] = s[index] - omega * t[index];
+		norm = sqrt(dot(this.size, r, r));
+
+		if (norm <= this.tolerance * this.rightHandNorm)
+			norm = computeResidual(& this, r);
+		previousRho = rho;
+	}
+
+	return end(& this, r, statistics);
+}
+
+
+static Vector * gmres(
+	KrylovOperator const * const matrix,
+	KrylovOperator const * const preconditioner,
+	Vector const * const rightHand,
+	Vector const * const guess,
+	KrylovSettings const * const settings,
+	KrylovStatistics * const statistics)
+{
+	Resolution this;
+	size_t restart, column, row, index;
+	double * basis;
+	double * w;
+	double * z;
+	double * hessenberg;
+	double * cosines;
+	double * sines;
+	double * g;
+	double norm, value, subdiagonal, radius;
+
+	restart = ((settings == NULL) || (settings->restart == 0)) ? KRYLOV_DEFAULT_RESTART : settings->restart;
+	if ((matrix != NULL) && (restart > matrix->size))
+		restart = matrix->size;
+
+	/* the basis and 2 vectors, then the Hessenberg matrix, rotations and the right-hand side of the least squares */
+	if (! begin(& this, matrix, preconditioner, rightHand, guess, settings, restart + 3, (restart + 1) * (restart + 4)))
+		return NULL;
+
+	basis = this.work;
+	w = basis + (restart + 1) * this.size;
+	z = w + this.size;
+	hessenberg = z + this.size;
+	cosines = hessenberg + (restart + 1) * restart;
+	sines = cosines + restart;
+	g = sines + restart;
+
+	norm = computeResidual(& this, basis);
+
+	while ((this.statistics.status == KRYLOV_CONVERGED) && (norm > this.tolerance * this.rightHandNorm))
+	{
+		if (this.statistics.iterations == this.maximumIterations)
+		{
+			this.statistics.status = KRYLOV_NOT_CONVERGED;
+			break;
+		}
+
+		/* Arnoldi on A M^(-1), from the normalized residual, the least squares problem kept triangular by Givens rotations */
+		for (index = 0; index < this.size; index++)
+			basis[index] /= norm;
+		g[0] = norm;
+		for (column = 0; (column < restart) && (this.statistics.iterations < this.maximumIterations); column++)
+		{
+			this.statistics.iterations++;
+
+			precondition(& this, basis + column * this.size, z);
+			multiply(& this, z, w);
+			for (row = 0; row <= column; row++)
+			{
+				value = dot(this.size, w, basis + row * this.size);
+				hessenberg[row * restart + column] = value;
+				axpy(this.size, -value, basis + row * this.size, w);
+			}
+			subdiagonal = sqrt(dot(this.size, w, w));
+			hessenberg[(column + 1) * restart + column] = subdiagonal;
+			if (subdiagonal != 0)
+			{
+				for (index = 0; index < this.size; index++)
+					basis[(column + 1) * this.size + index] = w[index] / subdiagonal;
+			}
+
+			for (row = 0; row < column; row++)
+			{
+				value = cosines[row] * hessenberg[row * restart + column] + sines[row] * hessenberg[(row + 1) * restart + column];
+				hessenberg[(row + 1) * restart + column] =
+					-sines[row] * hessenberg[row * restart + column] + cosines[row] * hessenberg[(row + 1) * restart + column];
+				hessenberg[row * restart + column] = value;
+			}
+
+			radius = sqrt(hessenberg[column * restart + column] * hessenberg[column * restart + column]
+				+ hessenberg[(column + 1) * restart + column] * hessenberg[(column + 1) * restart + column]);
+			if (radius == 0)
+			{
+				this.statistics.status = KRYLOV_BREAKDOWN;
+				break;
+			}
+			cosines[column] = hessenberg[column * restart + column] / radius;
+			sines[column] = hessenberg[(column + 1) * restart + column] / radius;
+			hessenberg[column * restart + column] = radius;
+			hessenberg[(column + 1) * restart + column] = 0;
+			g[column + 1] = -sines[column] * g[column];
+			g[column] *= cosines[column];
+
+			/* |g[column + 1]| is the residual norm, a zero subdiagonal means the solution is in the basis */
+			if ((fabs(g[column + 1]) <= this.tolerance * this.rightHandNorm) || (subdiagonal == 0))
+			{
+				column++;
+				break;
+			}
+		}
+
+		/* x += M^(-1) V y, with H y = g */
+		for (row = column; row-- > 0;)
+		{
+			value = g[row];
+			for (index = row + 1; index < column; index++)
+				value -= hessenberg[row * restart + index] * g[index];
+			g[row] = value / hessenberg[row * restart + row];
+		}
+		memset(w, 0, this.size * sizeof(double));
+		for (row = 0; row < column; row++)
+			axpy(this.size, g[row], basis + row * this.size, w);
+		precondition(& this, w, z);
+		axpy(this.size, 1, z, this.x);
+
+		norm = computeResidual(& this, basis);
+	}
+
+	return end(& this, basis, statistics);
+}
+
+static Vector * powerIteration(
+	KrylovOperator const * const matrix,
+	Vector const * const guess,
+	KrylovSettings const * const settings,
+	double * const value,
+	KrylovStatistics * const statistics)
+{
+	KrylovStatistics progress;
+	Vector * solution;
+	double * x;
+	double * y;
+	double tolerance, rayleigh, norm, residual, difference;
+	size_t maximumIterations, index;
+	unsigned long seed;
+
+	if ((matrix == NULL) || (matrix->apply == NULL) || (value == NULL))
+		return NULL;
+	if ((guess != NULL) && (_Vector->size(guess) != matrix->size))
+		return NULL;
+
+	solution = (guess == NULL) ? _Vector->create(matrix->size) : _Vector->copy(guess);
+	if (solution == NULL)
+		return NULL;
+
+	y = malloc(matrix->size * sizeof(double));
+	if (y == NULL)
+	{
+		_Vector->delete(& solution);
+		return NULL;
+	}
+
+	tolerance = (settings == NULL) ? KRYLOV_DEFAULT_TOLERANCE : settings->tolerance;
+	maximumIterations = ((settings == NULL) || (settings->maximumIterations == 0))
+		? KRYLOV_DEFAULT_EIGEN_ITERATIONS : settings->maximumIterations;
+
+	x = _Vector->cells(solution);
+	norm = sqrt(dot(matrix->size, x, x));
+	if (norm == 0)
+	{
+		seed = 1;
+		randomize(& seed, matrix->size, x);
+		norm = sqrt(dot(matrix->size, x, x));
+	}
+	for (index = 0; index < matrix->size; index++)
+		x[index] /= norm;
+
+	progress.status = KRYLOV_NOT_CONVERGED;
+	progress.iterations = 0;
+	progress.products = 0;
+	progress.preconditionings = 0;
+
+	for (;;)
+	{
+		progress.iterations++;
+		matrix->apply(x, y, matrix->size, matrix->context);
+		progress.products++;
+
+		/* x has norm 1, so that x·A x is the best λ for it, and A x - λ x its true residual */
+		rayleigh = dot(matrix->size, x, y);
+		residual = 0;
+		for (index = 0; index < matrix->size; index++)
+		{
+			difference = y[index] - rayleigh * x[index];
+			residual += difference * difference;
+		}
+		residual = sqrt(residual);
+		progress.residual = (residual == 0) ? 0 : ((rayleigh == 0) ? HUGE_VAL : residual / fabs(rayleigh));
+
+		if (residual <= tolerance * fabs(rayleigh))
+		{
+			progress.status = KRYLOV_CONVERGED;
+			break;
+		}
+		if (progress.iterations == maximumIterations)
+			break;
+
+		/* A x isn't 0, or x would have converged with λ = 0 */
+		norm = sqrt(dot(matrix->size, y, y));
+		for (index = 0; index < matrix->size; index++)
+			x[index] = y[index] / norm;
+	}
+
+	free(y);
+
+	* value = rayleigh;
+	if (statistics != NULL)
+		* statistics = progress;
+
+	return solution;
+}
+
+
+static Matrix * lanczos(
+	KrylovOperator const * const matrix,
+	size_t count,
+	KrylovSettings const * const settings,
+	double * const values,
+	KrylovStatistics * const statistics)
+{
+	return eigenpairs(matrix, count, settings, 1, values, NULL, statistics);
+}
+
+
+static Matrix * arnoldi(
+	KrylovOperator const * const matrix,
+	size_t count,
+	KrylovSettings const * const settings,
+	double * const real,
+	double * const imaginary,
+	KrylovStatistics * const statistics)
+{
+	if (imaginary == NULL)
+		return NULL;
+
+	return eigenpairs(matrix, count, settings, 0, real, imaginary, statistics);
+}
+
+
+
+
+
+static int begin(
+	Resolution * const this,
+	KrylovOperator const * const matrix,
+	KrylovOperator const * const preconditioner,
+	Vector const * const rightHand,
+	Vector const * const guess,
+	KrylovSettings const * const settings,
+	size_t vectors,
+	size_t extra)
+{
+	if ((matrix == NULL) || (matrix->apply == NULL) || (rightHand == NULL))
+		return 0;
+	if (_Vector->size(rightHand) != matrix->size)
+		return 0;
+	if ((guess != NULL) && (_Vector->size(guess) != matrix->size))
+		return 0;
+	if ((preconditioner != NULL) && ((preconditioner->apply == NULL) || (preconditioner->size != matrix->size)))
+		return 0;
+	if ((matrix->size != 0) && (vectors > (((size_t) -1) / sizeof(double) - extra) / matrix->size))
+		return 0;
+
+	this->matrix = matrix;
+	this->preconditioner = preconditioner;
+	this->size = matrix->size;
+	this->tolerance = (settings == NULL) ? KRYLOV_DEFAULT_TOLERANCE : settings->tolerance;
+	this->maximumIterations = ((settings == NULL) || (settings->maximumIterations == 0)) ? matrix->size : settings->maximumIterations;
+
+	this->rightHand = _Vector->copy(rightHand);
+	this->solution = (guess == NULL) ? _Vector->create(matrix->size) : _Vector->copy(guess);
+	this->work = malloc((vectors * matrix->size + extra + 1) * sizeof(double));
+	if ((this->rightHand == NULL) || (this->solution == NULL) || (this->work == NULL))
+	{
+		_Vector->delete(& this->rightHand);
+		_Vector->delete(& this->solution);
+		free(this->work);
+		return 0;
+	}
+
+	this->b = _Vector->cells(this->rightHand);
+	this->x = _Vector->cells(this->solution);
+	this->rightHandNorm = _Vector->norm(this->rightHand);
+
+	/* b = 0 has x = 0 for solution, whatever the guess */
+	if (this->rightHandNorm == 0)
+		memset(this->x, 0, this->size * sizeof(double));
+
+	this->statistics.status = KRYLOV_CONVERGED;
+	this->statistics.iterations = 0;
+	this->statistics.products = 0;
+	this->statistics.preconditionings = 0;
+	this->statistics.residual = 0;
+
+	return 1;
+}
+
+
+static Vector * end(Resolution * const this, double * const residual, KrylovStatistics * const statistics)
+{
+	double norm;
+
+	norm = computeResidual(this, residual);
+	this->statistics.residual = (this->rightHandNorm == 0) ? 0 : norm / this->rightHandNorm;
+
+	_Vector->delete(& this->rightHand);
+	free(this->work);
+
+	if (statistics != NULL)
+		* statistics = this->statistics;
+
+	return this->solution;
+}
+
+
+static void multiply(Resolution * const this, double const * const x, double * const y)
+{
+	this->matrix->apply(x, y, this->size, this->matrix->context);
+	this->statistics.products++;
+}
+
+
+static void precondition(Resolution * const this, double const * const x, double * const y)
+{
+	if (this->preconditioner == NULL)
+	{
+		memcpy(y, x, this->size * sizeof(double));
+		return;
+	}
+
+	this->preconditioner->apply(x, y, this->size, this->preconditioner->context);
+	this->statistics.preconditionings++;
+}
+
+
+static double computeResidual(Resolution * const this, double * const residual)
+{
+	size_t index;
+
+	multiply(this, this->x, residual);
+	for (index = 0; index < this->size; index++)
+		residual[index] = this->b[index] - residual[index];
+
+	return sqrt(dot(this->size, residual, residual));
+}
+
+
+static double dot(size_t size, double const * const x, double const * const y)
+{
+	double sums[4] = { 0, 0, 0, 0 };
+	size_t index;
+
+	for (index = 0; index + 4 <= size; index += 4)
+	{
+		sums[0] += x[index] * y[index];
+		sums[1] += x[index + 1] * y[index + 1];
+		sums[2] += x[index + 2] * y[index + 2];
+		sums[3] += x[index + 3] * y[index + 3];
+	}
+	for (; index < size; index++)
+		sums[0] += x[index] * y[index];
+
+	return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+
+static void axpy(size_t size, double alpha, double const * const x, double * const y)
+{
+	size_t index;
+
+	for (index = 0; index < size; index++)
+		y[index] += alpha * x[index];
+}
+
+
+static void applyDense(double const * const x, double * const y, size_t size, void * const context)
+{
+	Matrix const * const matrix = context;
+	size_t rowIndex, columnIndex;
+
+	/* y accumulates the columns of a column-major A, weighted by x */
+	if (matrix->layout == MATRIX_COLUMN_MAJOR)
+	{
+		memset(y, 0, size * sizeof(* y));
+		for (columnIndex = 0; columnIndex < size; columnIndex++)
+			axpy(size, x[columnIndex], matrix->cells[columnIndex], y);
+		return;
+	}
+
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+		y[rowIndex] = dot(size, matrix->cells[rowIndex], x);
+}
+
+
+static void applyJacobi(double const * const x, double * const y, size_t size, void * const context)
+{
+	double const * const inverted = context;
+	size_t index;
+
+	for (index = 0; index < size; index++)
+		y[index] = inverted[index] * x[index];
+}
+
+
+static void applyILU(double const * const x, double * const y, size_t size, void * const context)
+{
+	SparseRows const * const rows = context;
+	size_t rowIndex, position;
+	double value;
+
+	/* L z = x, L having a unit diagonal */
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+	{
+		value = x[rowIndex];
+		for (position = rows->rowStarts[rowIndex]; position < rows->diagonals[rowIndex]; position++)
+			value -= rows->values[position] * y[rows->columns[position]];
+		y[rowIndex] = value;
+	}
+
+	/* U y = z */
+	for (rowIndex = size; rowIndex-- > 0;)
+	{
+		value = y[rowIndex];
+		for (position = rows->diagonals[rowIndex] + 1; position < rows->rowStarts[rowIndex + 1]; position++)
+			value -= rows->values[position] * y[rows->columns[position]];
+		y[rowIndex] = value / rows->values[rows->diagonals[rowIndex]];
+	}
+}
+
+
+static KrylovOperator * allocateOperator(size_t size, void (* const apply)(double const *, double *, size_t, void *), size_t bytes)
+{
+	KrylovOperator * this;
+
+	if (bytes > ((size_t) -1) - sizeof(KrylovOperator) - sizeof(double))
+		return NULL;
+
+	/* the context starts on a multiple of double's size, after the operator */
+	this = malloc(sizeof(KrylovOperator) + sizeof(double) + bytes);
+	if (this == NULL)
+		return NULL;
+
+	this->size = size;
+	this->apply = apply;
+	this->context = (char *) this + (sizeof(KrylovOperator) + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+
+	return this;
+}
+
+
+static Matrix * eigenpairs(
+	KrylovOperator const * const matrix,
+	size_t count,
+	KrylovSettings const * const settings,
+	int symmetric,
+	double * const real,
+	double * const imaginary,
+	KrylovStatistics * const statistics)
+{
+	Decomposition this;
+	Matrix * vectors;
+	size_t wanted, kept;
+
+	if ((matrix == NULL) || (matrix->apply == NULL) || (real == NULL))
+		return NULL;
+	if ((count == 0) || (count > matrix->size))
+		return NULL;
+
+	vectors = _Matrix->create(matrix->size, count);
+	if (vectors == NULL)
+		return NULL;
+
+	if (! beginDecomposition(& this, matrix, count, settings))
+	{
+		_Matrix->delete(& vectors);
+		return NULL;
+	}
+
+	kept = 0;
+	for (;;)
+	{
+		expand(& this, kept);
+		this.statistics.iterations++;
+
+		if (! findRitzPairs(& this, symmetric))
+		{
+			this.statistics.status = KRYLOV_BREAKDOWN;
+			_Matrix->delete(& vectors);
+			break;
+		}
+
+		/* a conjugate pair is wanted whole, its other value being in H whenever the first is */
+		wanted = count + ((this.imaginary[count - 1] > 0) ? 1 : 0);
+		if (hasConverged(& this, wanted))
+			break;
+
+		/* with m = n, H holds every eigenvalue already */
+		if ((this.dimension == this.size) || (this.statistics.iterations == this.maximumIterations))
+		{
+			this.statistics.status = KRYLOV_NOT_CONVERGED;
+			break;
+		}
+
+		/* the wanted vectors, and half of the others, which speeds convergence up, m >= k + 2 leaving room */
+		kept = (this.dimension + wanted) / 2;
+		if ((this.imaginary[kept - 1] > 0) && (kept + 1 < this.dimension))
+			kept++;
+		else if (this.imaginary[kept - 1] > 0)
+			kept--;
+		kept = restart(& this, kept);
+	}
+
+	if (vectors != NULL)
+		writeRitzPairs(& this, count, vectors, real, imaginary);
+
+	if (statistics != NULL)
+		* statistics = this.statistics;
+	endDecomposition(& this);
+
+	return vectors;
+}
+
+
+static int beginDecomposition(
+	Decomposition * const this,
+	KrylovOperator const * const matrix,
+	size_t count,
+	KrylovSettings const * const settings)
+{
+	size_t dimension;
+	double norm;
+
+	if ((settings == NULL) || (settings->restart == 0))
+		dimension = (2 * count + 1 > KRYLOV_DEFAULT_RESTART) ? 2 * count + 1 : KRYLOV_DEFAULT_RESTART;
+	else
+		dimension = settings->restart;
+	if (dimension < count + 2)
+		dimension = count + 2;
+	if (dimension > matrix->size)
+		dimension = matrix->size;
+
+	if (dimension + 5 > ((size_t) -1) / sizeof(double) / matrix->size)
+		return 0;
+	if (6 * dimension + 5 > ((size_t) -1) / sizeof(double) / dimension)
+		return 0;
+
+	this->basis = malloc((dimension + 5) * matrix->size * sizeof(double));
+	this->projected = malloc((6 * dimension + 5) * dimension * sizeof(double));
+	this->indexes = malloc(dimension * sizeof(size_t));
+	if ((this->basis == NULL) || (this->projected == NULL) || (this->indexes == NULL))
+	{
+		endDecomposition(this);
+		return 0;
+	}
+
+	this->matrix = matrix;
+	this->size = matrix->size;
+	this->tolerance = (settings == NULL) ? KRYLOV_DEFAULT_TOLERANCE : settings->tolerance;
+	this->maximumIterations = ((settings == NULL) || (settings->maximumIterations == 0))
+		? KRYLOV_DEFAULT_EIGEN_ITERATIONS : settings->maximumIterations;
+	this->dimension = dimension;
+
+	this->work = this->basis + (dimension + 1) * matrix->size;
+	this->real = this->projected + (dimension + 1) * dimension;
+	this->imaginary = this->real + dimension;
+	this->vectorsReal = this->imaginary + dimension;
+	this->vectorsImaginary = this->vectorsReal + dimension * dimension;
+	this->scratch = this->vectorsImaginary + dimension * dimension;
+	memset(this->projected, 0, (dimension + 1) * dimension * sizeof(double));
+
+	this->statistics.status = KRYLOV_CONVERGED;
+	this->statistics.iterations = 0;
+	this->statistics.products = 0;
+	this->statistics.preconditionings = 0;
+	this->statistics.residual = 0;
+
+	this->seed = 1;
+	randomize(& this->seed, this->size, this->basis);
+	norm = sqrt(dot(this->size, this->basis, this->basis));
+	for (dimension = 0; dimension < this->size; dimension++)
+		this->basis[dimension] /= norm;
+
+	return 1;
+}
+
+
+static void endDecomposition(Decomposition * const this)
+{
+	free(this->basis);
+	free(this->projected);
+	free(this->indexes);
+}
+
+
+static void expand(Decomposition * const this, size_t from)
+{
+	size_t column, row;
+	double * vector;
+	double * coefficients;
+	double before, norm;
+
+	coefficients = this->scratch;
+	for (column = from; column < this->dimension; column++)
+	{
+		vector = this->basis + (column + 1) * this->size;
+		this->matrix->apply(this->basis + column * this->size, vector, this->size, this->matrix->context);
+		this->statistics.products++;
+
+		before = sqrt(dot(this->size, vector, vector));
+		memset(coefficients, 0, (column + 1) * sizeof(double));
+		norm = orthogonalize(this->size, column + 1, this->basis, vector, coefficients);
+		for (row = 0; row <= column; row++)
+			this->projected[row * this->dimension + column] = coefficients[row];
+
+		if (norm > INVARIANCE * before)
+		{
+			this->projected[(column + 1) * this->dimension + column] = norm;
+			for (row = 0; row < this->size; row++)
+				vector[row] /= norm;
+			continue;
+		}
+
+		/* A V = V H exactly, the basis goes on with any vector orthogonal to it, if some is left */
+		this->projected[(column + 1) * this->dimension + column] = 0;
+		randomize(& this->seed, this->size, vector);
+		before = sqrt(dot(this->size, vector, vector));
+		norm = orthogonalize(this->size, column + 1, this->basis, vector, NULL);
+		for (row = 0; row < this->size; row++)
+			vector[row] = (norm > INVARIANCE * before) ? vector[row] / norm : 0;
+	}
+}
+
+
+static int findRitzPairs(Decomposition * const this, int symmetric)
+{
+	size_t size, row, column, index, other;
+	double * cells;
+	double * eigenvectors;
+	double * values;
+
+	size = this->dimension;
+	cells = this->scratch;
+	eigenvectors = cells + size * size;
+	values = cells + 3 * size * size;
+
+	if (symmetric)
+	{
+		/* H is only symmetric up to rounding */
+		for (row = 0; row < size; row++)
+		{
+			for (column = 0; column < size; column++)
+				cells[row * size + column] = (this->projected[row * size + column] + this->projected[column * size + row]) / 2;
+		}
+		symmetricEigen(size, cells, eigenvectors);
+		for (index = 0; index < size; index++)
+		{
+			values[index] = cells[index * size + index];
+			values[size + index] = 0;
+		}
+	}
+	else
+	{
+		memcpy(cells, this->projected, size * size * sizeof(double));
+		reduceToHessenberg(size, cells);
+		if (! hessenbergEigenvalues(size, cells, values, values + size))
+			return 0;
+	}
+
+	for (index = 0; index < size; index++)
+	{
+		for (other = index; (other > 0)
+			&& precedes(values[index], values[size + index], values[this->indexes[other - 1]], values[size + this->indexes[other - 1]]); other--)
+		{
+			this->indexes[other] = this->indexes[other - 1];
+		}
+		this->indexes[other] = index;
+	}
+	for (index = 0; index < size; index++)
+	{
+		this->real[index] = values[this->indexes[index]];
+		this->imaginary[index] = values[size + this->indexes[index]];
+	}
+
+	for (index = 0; index < size; index++)
+	{
+		if (symmetric)
+		{
+			for (row = 0; row < size; row++)
+			{
+				this->vectorsReal[index * size + row] = eigenvectors[row * size + this->indexes[index]];
+				this->vectorsImaginary[index * size + row] = 0;
+			}
+		}
+		else if ((this->imaginary[index] < 0) && (index > 0))
+		{
+			for (row = 0; row < size; row++)
+			{
+				this->vectorsReal[index * size + row] = this->vectorsReal[(index - 1) * size + row];
+				this->vectorsImaginary[index * size + row] = -this->vectorsImaginary[(index - 1) * size + row];
+			}
+		}
+		else
+		{
+			/* the sorting indexes are no longer needed, and become pivots */
+			inverseIteration(size, this->projected, this->real[index], this->imaginary[index], cells, this->indexes,
+				this->vectorsReal + index * size, this->vectorsImaginary + index * size);
+		}
+	}
+
+	return 1;
+}
+
+
+static int hasConverged(Decomposition const * const this, size_t count)
+{
+	size_t index, last;
+	double h, estimate;
+
+	last = this->dimension - 1;
+	h = fabs(this->projected[this->dimension * this->dimension + last]);
+	for (index = 0; index < count; index++)
+	{
+		/* ||A V y - λ V y|| = h |y[m - 1]|, y having norm 1 */
+		estimate = h * sqrt(this->vectorsReal[index * this->dimension + last] * this->vectorsReal[index * this->dimension + last]
+			+ this->vectorsImaginary[index * this->dimension + last] * this->vectorsImaginary[index * this->dimension + last]);
+		if (estimate > this->tolerance * magnitudeOf(this, index))
+			return 0;
+	}
+
+	return 1;
+}
+
+
+static size_t restart(Decomposition * const this, size_t kept)
+{
+	size_t size, column, source, index, other;
+	double * q;
+	double * hq;
+	double * cells;
+	double * components;
+	double h, norm;
+
+	size = this->dimension;
+	q = this->scratch;
+	hq = q + size * size;
+	cells = hq + size * size;
+	components = cells + size * size;
+
+	/* real vectors spanning the kept Ritz vectors, the real and imaginary parts for a pair */
+	column = 0;
+	for (source = 0; source < kept; source++)
+	{
+		memcpy(q + column * size,
+			(this->imaginary[source] < 0) ? this->vectorsImaginary + source * size : this->vectorsReal + source * size,
+			size * sizeof(double));
+		norm = orthogonalize(size, column, q, q + column * size, NULL);
+		if (norm <= INVARIANCE)
+			continue;
+
+		for (index = 0; index < size; index++)
+			q[column * size + index] /= norm;
+		column++;
+	}
+	kept = column;
+
+	/* H = Q^T H Q, and the last row h Q[m - 1] */
+	for (column = 0; column < kept; column++)
+	{
+		for (index = 0; index < size; index++)
+			hq[column * size + index] = dot(size, this->projected + index * size, q + column * size);
+	}
+	for (index = 0; index < kept; index++)
+	{
+		for (column = 0; column < kept; column++)
+			cells[index * kept + column] = dot(size, q + index * size, hq + column * size);
+	}
+
+	h = this->projected[size * size + size - 1];
+	memset(this->projected, 0, (size + 1) * size * sizeof(double));
+	for (index = 0; index < kept; index++)
+	{
+		for (column = 0; column < kept; column++)
+			this->projected[index * size + column] = cells[index * kept + column];
+	}
+	for (column = 0; column < kept; column++)
+		this->projected[kept * size + column] = h * q[column * size + size - 1];
+
+	/* V Q in place, component by component, then v after it */
+	for (index = 0; index < this->size; index++)
+	{
+		for (other = 0; other < size; other++)
+			components[other] = this->basis[other * this->size + index];
+		for (column = 0; column < kept; column++)
+			this->basis[column * this->size + index] = dot(size, components, q + column * size);
+	}
+	memcpy(this->basis + kept * this->size, this->basis + size * this->size, this->size * sizeof(double));
+
+	return kept;
+}
+
+
+static void writeRitzPairs(Decomposition * const this, size_t count, Matrix * const vectors, double * const real, double * const imaginary)
+{
+	size_t column, first, index;
+	double * xReal;
+	double * xImaginary;
+	double * yReal;
+	double * yImaginary;
+	double norm, residual, a, b, differenceReal, differenceImaginary;
+
+	xReal = this->work;
+	xImaginary = xReal + this->size;
+	yReal = xImaginary + this->size;
+	yImaginary = yReal + this->size;
+
+	this->statistics.residual = 0;
+	for (column = 0; column < count; column++)
+	{
+		real[column] = this->real[column];
+		if (imaginary != NULL)
+			imaginary[column] = this->imaginary[column];
+
+		/* the second of a pair shares the vector of the first, and its residual */
+		first = ((this->imaginary[column] < 0) && (column > 0)) ? column - 1 : column;
+
+		combine(this, this->vectorsReal + first * this->dimension, xReal);
+		combine(this, this->vectorsImaginary + first * this->dimension, xImaginary);
+		norm = sqrt(dot(this->size, xReal, xReal) + dot(this->size, xImaginary, xImaginary));
+		for (index = 0; index < this->size; index++)
+		{
+			xReal[index] /= norm;
+			xImaginary[index] /= norm;
+			vectors->cells[index][column] = (first == column) ? xReal[index] : xImaginary[index];
+		}
+
+		if (first != column)
+			continue;
+
+		/* A (xr + i xi) - (a + i b) (xr + i xi) */
+		a = this->real[column];
+		b = this->imaginary[column];
+		this->matrix->apply(xReal, yReal, this->size, this->matrix->context);
+		this->statistics.products++;
+		if (b == 0)
+			memset(yImaginary, 0, this->size * sizeof(double));
+		else
+		{
+			this->matrix->apply(xImaginary, yImaginary, this->size, this->matrix->context);
+			this->statistics.products++;
+		}
+
+		residual = 0;
+		for (index = 0; index < this->size; index++)
+		{
+			differenceReal = yReal[index] - a * xReal[index] + b * xImaginary[index];
+			differenceImaginary = yImaginary[index] - b * xReal[index] - a * xImaginary[index];
+			residual += differenceReal * differenceReal + differenceImaginary * differenceImaginary;
+		}
+		residual = sqrt(residual) / magnitudeOf(this, column);
+		if (residual > this->statistics.residual)
+			this->statistics.residual = residual;
+	}
+}
+
+
+static double magnitudeOf(Decomposition const * const this, size_t index)
+{
+	double magnitude;
+
+	magnitude = sqrt(this->real[index] * this->real[index] + this->imaginary[index] * this->imaginary[index]);
+	if (magnitude == 0)
+		magnitude = sqrt(this->real[0] * this->real[0] + this->imaginary[0] * this->imaginary[0]);
+
+	return (magnitude == 0) ? 1 : magnitude;
+}
+
+
+static void combine(Decomposition const * const this, double const * const y, double * const x)
+{
+	size_t index;
+
+	memset(x, 0, this->size * sizeof(double));
+	for (index = 0; index < this->dimension; index++)
+		axpy(this->size, y[index], this->basis + index * this->size, x);
+}
+
+
+static double orthogonalize(size_t size, size_t count, double const * const basis, double * const vector, double * const coefficients)
+{
+	size_t pass, index;
+	double coefficient;
+
+	/* a second pass restores the orthogonality the first lost to cancellation */
+	for (pass = 0; pass < 2; pass++)
+	{
+		for (index = 0; index < count; index++)
+		{
+			coefficient = dot(size, basis + index * size, vector);
+			axpy(size, -coefficient, basis + index * size, vector);
+			if (coefficients != NULL)
+				coefficients[index] += coefficient;
+		}
+	}
+
+	return sqrt(dot(size, vector, vector));
+}
+
+
+static void randomize(unsigned long * const seed, size_t size, double * const x)
+{
+	size_t index;
+
+	for (index = 0; index < size; index++)
+	{
+		* seed = (* seed * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+		x[index] = (double) ((* seed >> 8) & 0xFFFF) / 32768 - 1;
+	}
+}
+
+
+static int precedes(double real, double imaginary, double otherReal, double otherImaginary)
+{
+	double magnitude, otherMagnitude;
+
+	magnitude = real * real + imaginary * imaginary;
+	otherMagnitude = otherReal * otherReal + otherImaginary * otherImaginary;
+	if (magnitude != otherMagnitude)
+		return magnitude > otherMagnitude;
+	if (real != otherReal)
+		return real > otherReal;
+
+	return imaginary > otherImaginary;
+}
+
+
+static void symmetricEigen(size_t size, double * const cells, double * const vectors)
+{
+	size_t sweep, p, q, index;
+	double diagonal, off, theta, t, c, s, left, right;
+
+	for (p = 0; p < size; p++)
+	{
+		for (q = 0; q < size; q++)
+			vectors[p * size + q] = (p == q) ? 1 : 0;
+	}
+
+	for (sweep = 0; sweep < JACOBI_SWEEPS; sweep++)
+	{
+		diagonal = 0;
+		off = 0;
+		for (p = 0; p < size; p++)
+		{
+			diagonal += cells[p * size + p] * cells[p * size + p];
+			for (q = p + 1; q < size; q++)
+				off += cells[p * size + q] * cells[p * size + q];
+		}
+		if (off <= DBL_EPSILON * DBL_EPSILON * diagonal)
+			break;
+
+		for (p = 0; p < size; p++)
+		{
+			for (q = p + 1; q < size; q++)
+			{
+				if (cells[p * size + q] == 0)
+					continue;
+
+				/* the rotation of angle atan(t) which zeroes cell (p, q) */
+				theta = (cells[q * size + q] - cells[p * size + p]) / (2 * cells[p * size + q]);
+				t = 1 / (fabs(theta) + sqrt(theta * theta + 1));
+				if (theta < 0)
+					t = -t;
+				c = 1 / sqrt(t * t + 1);
+				s = t * c;
+
+				for (index = 0; index < size; index++)
+				{
+					left = cells[index * size + p];
+					right = cells[index * size + q];
+					cells[index * size + p] = c * left - s * right;
+					cells[index * size + q] = s * left + c * right;
+				}
+				for (index = 0; index < size; index++)
+				{
+					left = cells[p * size + index];
+					right = cells[q * size + index];
+					cells[p * size + index] = c * left - s * right;
+					cells[q * size + index] = s * left + c * right;
+				}
+				for (index = 0; index < size; index++)
+				{
+					left = vectors[index * size + p];
+					right = vectors[index * size + q];
+					vectors[index * size + p] = c * left - s * right;
+					vectors[index * size + q] = s * left + c * right;
+				}
+			}
+		}
+	}
+}
+
+
+static void reduceToHessenberg(size_t size, double * const cells)
+{
+	size_t column, row, pivot, index;
+	double x, y, swap;
+
+	for (column = 1; column + 1 < size; column++)
+	{
+		x = 0;
+		pivot = column;
+		for (row = column; row < size; row++)
+		{
+			if (fabs(cells[row * size + column - 1]) > fabs(x))
+			{
+				x = cells[row * size + column - 1];
+				pivot = row;
+			}
+		}
+
+		/* P A P^(-1), the rows then the columns */
+		if (pivot != column)
+		{
+			for (index = column - 1; index < size; index++)
+			{
+				swap = cells[pivot * size + index];
+				cells[pivot * size + index] = cells[column * size + index];
+				cells[column * size + index] = swap;
+			}
+			for (index = 0; index < size; index++)
+			{
+				swap = cells[index * size + pivot];
+				cells[index * size + pivot] = cells[index * size + column];
+				cells[index * size + column] = swap;
+			}
+		}
+
+		if (x == 0)
+			continue;
+
+		/* L A L^(-1), each row elimination undone on the columns */
+		for (row = column + 1; row < size; row++)
+		{
+			y = cells[row * size + column - 1];
+			if (y == 0)
+				continue;
+
+			y /= x;
+			cells[row * size + column - 1] = 0;
+			for (index = column; index < size; index++)
+				cells[row * size + index] -= y * cells[column * size + index];
+			for (index = 0; index < size; index++)
+				cells[index * size + column] += y * cells[index * size + row];
+		}
+	}
+}
+
+
+static int hessenbergEigenvalues(size_t size, double * const cells, double * const real, double * const imaginary)
+{
+	long n, last, low, middle, k, i, j, limit;
+	int iterations;
+	double norm, shift, p, q, r, s, u, v, w, x, y, z;
+
+	n = (long) size;
+	norm = 0;
+	for (i = 0; i < n; i++)
+	{
+		for (j = (i > 0) ? i - 1 : 0; j < n; j++)
+			norm += fabs(cells[i * n + j]);
+	}
+
+	p = 0;
+	q = 0;
+	r = 0;
+	last = n - 1;
+	shift = 0;
+	while (last >= 0)
+	{
+		iterations = 0;
+		do
+		{
+			/* the lowest row of the unreduced block ending at [last] */
+			for (low = last; low >= 1; low--)
+			{
+				s = fabs(cells[(low - 1) * n + low - 1]) + fabs(cells[low * n + low]);
+				if (s == 0)
+					s = norm;
+				if (fabs(cells[low * n + low - 1]) <= DBL_EPSILON * s)
+				{
+					cells[low * n + low - 1] = 0;
+					break;
+				}
+			}
+			if (low < 0)
+				low = 0;
+
+			x = cells[last * n + last];
+			if (low == last)
+			{
+				real[last] = x + shift;
+				imaginary[last] = 0;
+				last--;
+				continue;
+			}
+
+			y = cells[(last - 1) * n + last - 1];
+			w = cells[last * n + last - 1] * cells[(last - 1) * n + last];
+			if (low == last - 1)
+			{
+				/* the eigenvalues of the trailing 2 * 2 block */
+				p = (y - x) / 2;
+				q = p * p + w;
+				z = sqrt(fabs(q));
+				x += shift;
+				if (q >= 0)
+				{
+					z = p + ((p >= 0) ? z : -z);
+					real[last - 1] = x + z;
+					real[last] = (z != 0) ? x - w / z : x + z;
+					imaginary[last - 1] = 0;
+					imaginary[last] = 0;
+				}
+				else
+				{
+					real[last - 1] = x + p;
+					real[last] = x + p;
+					imaginary[last - 1] = -z;
+					imaginary[last] = z;
+				}
+				last -= 2;
+				continue;
+			}
+
+			if (iterations == HESSENBERG_ITERATIONS)
+				return 0;
+
+			/* exceptional shifts, out of cycles */
+			if ((iterations == 10) || (iterations == 20))
+			{
+				shift += x;
+				for (i = 0; i <= last; i++)
+					cells[i * n + i] -= x;
+				s = fabs(cells[last * n + last - 1]) + fabs(cells[(last - 1) * n + last - 2]);
+				x = 0.75 * s;
+				y = x;
+				w = -0.4375 * s * s;
+			}
+			iterations++;
+
+			/* where two consecutive small subdiagonal cells let the step start */
+			for (middle = last - 2; middle >= low; middle--)
+			{
+				z = cells[middle * n + middle];
+				r = x - z;
+				s = y - z;
+				p = (r * s - w) / cells[(middle + 1) * n + middle] + cells[middle * n + middle + 1];
+				q = cells[(middle + 1) * n + middle + 1] - z - r - s;
+				r = cells[(middle + 2) * n + middle + 1];
+				s = fabs(p) + fabs(q) + fabs(r);
+				p /= s;
+				q /= s;
+				r /= s;
+				if (middle == low)
+					break;
+				u = fabs(cells[middle * n + middle - 1]) * (fabs(q) + fabs(r));
+				v = fabs(p) * (fabs(cells[(middle - 1) * n + middle - 1]) + fabs(z) + fabs(cells[(middle + 1) * n + middle + 1]));
+				if (u <= DBL_EPSILON * v)
+					break;
+			}
+
+			for (i = middle + 2; i <= last; i++)
+			{
+				cells[i * n + i - 2] = 0;
+				if (i != middle + 2)
+					cells[i * n + i - 3] = 0;
+			}
+
+			/* the double shift step, by Householder reflections chasing the bulge down */
+			for (k = middle; k <= last - 1; k++)
+			{
+				if (k != middle)
+				{
+					p = cells[k * n + k - 1];
+					q = cells[(k + 1) * n + k - 1];
+					r = (k != last - 1) ? cells[(k + 2) * n + k - 1] : 0;
+					x = fabs(p) + fabs(q) + fabs(r);
+					if (x != 0)
+					{
+						p /= x;
+						q /= x;
+						r /= x;
+					}
+				}
+
+				s = sqrt(p * p + q * q + r * r);
+				if (p < 0)
+					s = -s;
+				if (s == 0)
+					continue;
+
+				if (k == middle)
+				{
+					if (low != middle)
+						cells[k * n + k - 1] = -cells[k * n + k - 1];
+				}
+				else
+					cells[k * n + k - 1] = -s * x;
+
+				p += s;
+				x = p / s;
+				y = q / s;
+				z = r / s;
+				q /= p;
+				r /= p;
+				for (j = k; j <= last; j++)
+				{
+					p = cells[k * n + j] + q * cells[(k + 1) * n + j];
+					if (k != last - 1)
+					{
+						p += r * cells[(k + 2) * n + j];
+						cells[(k + 2) * n + j] -= p * z;
+					}
+					cells[(k + 1) * n + j] -= p * y;
+					cells[k * n + j] -= p * x;
+				}
+
+				limit = (last < k + 3) ? last : k + 3;
+				for (i = low; i <= limit; i++)
+				{
+					p = x * cells[i * n + k] + y * cells[i * n + k + 1];
+					if (k != last - 1)
+					{
+						p += z * cells[i * n + k + 2];
+						cells[i * n + k + 2] -= p * r;
+					}
+					cells[i * n + k + 1] -= p * q;
+					cells[i * n + k] -= p;
+				}
+			}
+		} while (low < last - 1);
+	}
+
+	return 1;
+}
+
+
+static void inverseIteration(
+	size_t size,
+	double const * const cells,
+	double real,
+	double imaginary,
+	double * const work,
+	size_t * const pivots,
+	double * const vectorReal,
+	double * const vectorImaginary)
+{
+	double * factorsReal;
+	double * factorsImaginary;
+	double scale, tiny, best, magnitude, multiplierReal, multiplierImaginary, swap, norm;
+	size_t row, column, index, pivot, pass;
+
+	factorsReal = work;
+	factorsImaginary = work + size * size;
+
+	scale = fabs(real) + fabs(imaginary);
+	for (index = 0; index < size * size; index++)
+	{
+		if (fabs(cells[index]) > scale)
+			scale = fabs(cells[index]);
+	}
+	tiny = DBL_EPSILON * ((scale == 0) ? 1 : scale);
+
+	for (row = 0; row < size; row++)
+	{
+		for (column = 0; column < size; column++)
+		{
+			factorsReal[row * size + column] = cells[row * size + column] - ((row == column) ? real : 0);
+			factorsImaginary[row * size + column] = (row == column) ? -imaginary : 0;
+		}
+	}
+
+	/* LU with partial pivoting of A - λ I, which is singular up to rounding: a zero pivot becomes tiny */
+	for (column = 0; column < size; column++)
+	{
+		pivot = column;
+		best = 0;
+		for (row = column; row < size; row++)
+		{
+			magnitude = fabs(factorsReal[row * size + column]) + fabs(factorsImaginary[row * size + column]);
+			if (magnitude > best)
+			{
+				best = magnitude;
+				pivot = row;
+			}
+		}
+		pivots[column] = pivot;
+
+		if (pivot != column)
+		{
+			for (index = 0; index < size; index++)
+			{
+				swap = factorsReal[pivot * size + index];
+				factorsReal[pivot * size + index] = factorsReal[column * size + index];
+				factorsReal[column * size + index] = swap;
+				swap = factorsImaginary[pivot * size + index];
+				factorsImaginary[pivot * size + index] = factorsImaginary[column * size + index];
+				factorsImaginary[column * size + index] = swap;
+			}
+		}
+		if (best == 0)
+			factorsReal[column * size + column] = tiny;
+
+		for (row = column + 1; row < size; row++)
+		{
+			multiplierReal = factorsReal[row * size + column];
+			multiplierImaginary = factorsImaginary[row * size + column];
+			divideComplex(& multiplierReal, & multiplierImaginary, factorsReal[column * size + column], factorsImaginary[column * size + column]);
+			factorsReal[row * size + column] = multiplierReal;
+			factorsImaginary[row * size + column] = multiplierImaginary;
+
+			for (index = column + 1; index < size; index++)
+			{
+				factorsReal[row * size + index] -= multiplierReal * factorsReal[column * size + index]
+					- multiplierImaginary * factorsImaginary[column * size + index];
+				factorsImaginary[row * size + index] -= multiplierReal * factorsImaginary[column * size + index]
+					+ multiplierImaginary * factorsReal[column * size + index];
+			}
+		}
+	}
+
+	for (index = 0; index < size; index++)
+	{
+		vectorReal[index] = 1;
+		vectorImaginary[index] = 0;
+	}
+
+	/* the first solve already points to the eigenvector, the second cleans what the start vector left */
+	for (pass = 0; pass < 2; pass++)
+	{
+		for (index = 0; index < size; index++)
+		{
+			swap = vectorReal[index];
+			vectorReal[index] = vectorReal[pivots[index]];
+			vectorReal[pivots[index]] = swap;
+			swap = vectorImaginary[index];
+			vectorImaginary[index] = vectorImaginary[pivots[index]];
+			vectorImaginary[pivots[index]] = swap;
+		}
+
+		for (row = 0; row < size; row++)
+		{
+			for (column = 0; column < row; column++)
+			{
+				vectorReal[row] -= factorsReal[row * size + column] * vectorReal[column]
+					- factorsImaginary[row * size + column] * vectorImaginary[column];
+				vectorImaginary[row] -= factorsReal[row * size + column] * vectorImaginary[column]
+					+ factorsImaginary[row * size + column] * vectorReal[column];
+			}
+		}
+		for (row = size; row-- > 0;)
+		{
+			for (column = row + 1; column < size; column++)
+			{
+				vectorReal[row] -= factorsReal[row * size + column] * vectorReal[column]
+					- factorsImaginary[row * size + column] * vectorImaginary[column];
+				vectorImaginary[row] -= factorsReal[row * size + column] * vectorImaginary[column]
+					+ factorsImaginary[row * size + column] * vectorReal[column];
+			}
+			divideComplex(vectorReal + row, vectorImaginary + row, factorsReal[row * size + row], factorsImaginary[row * size + row]);
+		}
+
+		norm = sqrt(dot(size, vectorReal, vectorReal) + dot(size, vectorImaginary, vectorImaginary));
+		for (index = 0; index < size; index++)
+		{
+			vectorReal[index] /= norm;
+			vectorImaginary[index] /= norm;
+		}
+	}
+}
+
+
+static void divideComplex(double * const real, double * const imaginary, double byReal, double byImaginary)
+{
+	double square, resultReal;
+
+	square = byReal * byReal + byImaginary * byImaginary;
+	resultReal = (* real * byReal + * imaginary * byImaginary) / square;
+	* imaginary = (* imaginary * byReal - * real * byImaginary) / square;
+	* real = resultReal;
+}
+
+
+
+
+static KrylovMethods methods =
+{
+	dense,
+	jacobi,
+	ilu0,
+	delete,
+	cg,
+	bicgstab,
+	gmres,
+	powerIteration,
+	lanczos,
+	arnoldi
+};
+KrylovMethods const * const _Krylov = & methods;
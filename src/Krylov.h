@@ -0,0 +1,255 @@
+#ifndef KRYLOV_HEADER
+#define KRYLOV_HEADER
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <stddef.h>
+
+
+
+
+/* relative residual reached when no settings are given */
+#define KRYLOV_DEFAULT_TOLERANCE 1e-10
+
+/* vectors GMRES keeps before restarting, and the least basis of lanczos and arnoldi, when no settings are given */
+#define KRYLOV_DEFAULT_RESTART 30
+
+/* power iterations, or restart cycles of lanczos and arnoldi, when no settings are given */
+#define KRYLOV_DEFAULT_EIGEN_ITERATIONS 1000
+
+
+
+
+/*
+ * Iterative solvers of A x = b and A x = λ x, which only see A through products with vectors:
+ * a dense Matrix, a sparse structure, or no stored matrix at all
+ *
+ * Preconditioners are operators too, applying M^(-1) with M close to A,
+ * CG expects both A and M to be symmetric positive definite
+ */
+typedef struct
+{
+	/* n, the number of unknowns */
+	size_t size;
+
+	/**
+	 * y = A x, or y = M^(-1) x for a preconditioner
+	 *
+	 * @param x - [size] values, to read
+	 * @param y - [size] values, to write, never [x]
+	 * @param context - the context of the operator
+	 */
+	void (* apply)(double const * x, double * y, size_t size, void * context);
+
+	/* handed to [apply] as is */
+	void * context;
+} KrylovOperator;
+
+
+typedef struct
+{
+	/* ||b - A x|| / ||b||, or ||A x - λ x|| / |λ| for eigenpairs, to reach */
+	double tolerance;
+
+	/* the most iterations, 0 for as many as unknowns, or KRYLOV_DEFAULT_EIGEN_ITERATIONS for eigenpairs */
+	size_t maximumIterations;
+
+	/* for GMRES, iterations between restarts, 0 for KRYLOV_DEFAULT_RESTART
+	 * for lanczos and arnoldi, the largest basis, 0 for the greater of 2 k + 1 and KRYLOV_DEFAULT_RESTART */
+	size_t restart;
+} KrylovSettings;
+
+
+typedef enum
+{
+	KRYLOV_CONVERGED,
+
+	/* the most iterations were done without reaching the tolerance */
+	KRYLOV_NOT_CONVERGED,
+
+	/* a division by zero would have followed: A isn't SPD for CG, or BiCGSTAB stagnated */
+	KRYLOV_BREAKDOWN
+} KrylovStatus;
+
+
+typedef struct
+{
+	KrylovStatus status;
+
+	size_t iterations;
+
+	/* calls to [apply] of the operator and of the preconditioner */
+	size_t products;
+	size_t preconditionings;
+
+	/* ||b - A x|| / ||b||, recomputed from the returned solution,
+	 * or the greatest ||A x - λ x|| / |λ| of the returned eigenpairs */
+	double residual;
+} KrylovStatistics;
+
+
+typedef struct
+{
+	/**
+	 * Wraps a square matrix, which must outlive the operator and isn't copied
+	 *
+	 * @return - the operator, or NULL if [matrix] is NULL, isn't square, or allocation failed
+	 */
+	KrylovOperator * (* dense)(Matrix const * matrix);
+
+	/**
+	 * M = diag(A), applied by scaling with the inverted diagonal
+	 *
+	 * @return - the preconditioner, or NULL if:
+	 * 		[matrix] is NULL, or isn't square,
+	 * 		a diagonal cell is 0,
+	 * 		allocation failed
+	 */
+	KrylovOperator * (* jacobi)(Matrix const * matrix);
+
+	/**
+	 * M = L U, the incomplete factorization keeping only the non-zero cells of A,
+	 * stored by rows of non-zero cells and applied by substitution, in O(non-zero cells)
+	 *
+	 * @return - the preconditioner, or NULL if:
+	 * 		[matrix] is NULL, or isn't square,
+	 * 		a pivot is 0,
+	 * 		allocation failed
+	 */
+	KrylovOperator * (* ilu0)(Matrix const * matrix);
+
+	/**
+	 * Deletes an operator made by dense, jacobi or ilu0, and sets it to NULL
+	 *
+	 * @param this - pointer to pointer to operator to delete
+	 */
+	void (* delete)(KrylovOperator ** this);
+
+	/**
+	 * Preconditioned conjugate gradient, for symmetric positive definite A and M
+	 * Needs 4 vectors of work memory
+	 *
+	 * @param matrix - A
+	 * @param preconditioner - M^(-1), NULL for none
+	 * @param rightHand - b
+	 * @param guess - where iterations start from, NULL for 0
+	 * @param settings - NULL for KRYLOV_DEFAULT_TOLERANCE, and as many iterations as unknowns
+	 * @param statistics - receives how the resolution went, may be NULL
+	 *
+	 * @return - the last iterate, converged or not, or NULL if:
+	 * 		[matrix], its [apply] or [rightHand] is NULL,
+	 * 		sizes of operators and vectors don't match,
+	 * 		allocation failed
+	 */
+	Vector * (* cg)(
+		KrylovOperator const * matrix,
+		KrylovOperator const * preconditioner,
+		Vector const * rightHand,
+		Vector const * guess,
+		KrylovSettings const * settings,
+		KrylovStatistics * statistics);
+
+	/**
+	 * Right-preconditioned BiCGSTAB, for any invertible A, with a fixed 8 vectors of work memory
+	 * @see cg
+	 */
+	Vector * (* bicgstab)(
+		KrylovOperator const * matrix,
+		KrylovOperator const * preconditioner,
+		Vector const * rightHand,
+		Vector const * guess,
+		KrylovSettings const * settings,
+		KrylovStatistics * statistics);
+
+	/**
+	 * Right-preconditioned restarted GMRES(m), for any invertible A
+	 * Its residual never grows, at the cost of m + 4 vectors of work memory
+	 * @see cg
+	 */
+	Vector * (* gmres)(
+		KrylovOperator const * matrix,
+		KrylovOperator const * preconditioner,
+		Vector const * rightHand,
+		Vector const * guess,
+		KrylovSettings const * settings,
+		KrylovStatistics * statistics);
+
+	/**
+	 * The eigenvalue of greatest magnitude, and its eigenvector, by power iteration:
+	 * x = A x / ||A x||, λ being the Rayleigh quotient x·A x
+	 * Converges at the rate of |λ2 / λ1|, and not at all if another eigenvalue has the same magnitude
+	 * One product per iteration, and a single vector of work memory
+	 *
+	 * @param matrix - A
+	 * @param guess - where iterations start from, NULL or 0 for a fixed pseudo-random vector
+	 * @param settings - NULL for KRYLOV_DEFAULT_TOLERANCE and KRYLOV_DEFAULT_EIGEN_ITERATIONS, [restart] is unused
+	 * @param value - receives λ
+	 * @param statistics - receives how the resolution went, may be NULL
+	 *
+	 * @return - x, of norm 1, converged or not, or NULL if:
+	 * 		[matrix], its [apply] or [value] is NULL,
+	 * 		sizes of [matrix] and [guess] don't match,
+	 * 		allocation failed
+	 */
+	Vector * (* powerIteration)(
+		KrylovOperator const * matrix,
+		Vector const * guess,
+		KrylovSettings const * settings,
+		double * value,
+		KrylovStatistics * statistics);
+
+	/**
+	 * The k eigenvalues of greatest magnitude of a symmetric A, and their eigenvectors,
+	 * by Lanczos with full reorthogonalization, restarted from the best Ritz vectors
+	 * [iterations] counts restart cycles, of at most m products each
+	 * Needs m + 5 vectors of work memory
+	 *
+	 * @param matrix - A, symmetric
+	 * @param count - k, at most the size of A
+	 * @param settings - @see KrylovSettings
+	 * @param values - receives the k eigenvalues, by decreasing magnitude
+	 * @param statistics - receives how the resolution went, may be NULL
+	 *
+	 * @return - the n * k orthonormal eigenvectors, as columns in the order of [values], or NULL if:
+	 * 		[matrix], its [apply] or [values] is NULL,
+	 * 		[count] is 0, or greater than the size of A,
+	 * 		the eigenvalues of the projected matrix weren't found, KRYLOV_BREAKDOWN being reported,
+	 * 		allocation failed
+	 */
+	Matrix * (* lanczos)(
+		KrylovOperator const * matrix,
+		size_t count,
+		KrylovSettings const * settings,
+		double * values,
+		KrylovStatistics * statistics);
+
+	/**
+	 * Same as lanczos, by Arnoldi for any A, whose eigenvalues may be complex
+	 * Complex conjugate values are consecutive, the positive imaginary part first, and their columns
+	 * hold the real then the imaginary part of the eigenvector of the first, both of norm 1 together
+	 * If the last value is the first of a pair, its column only holds the real part: ask for k + 1 values
+	 * @see lanczos
+	 *
+	 * @param real - receives the real parts of the k eigenvalues
+	 * @param imaginary - receives their imaginary parts
+	 */
+	Matrix * (* arnoldi)(
+		KrylovOperator const * matrix,
+		size_t count,
+		KrylovSettings const * settings,
+		double * real,
+		double * imaginary,
+		KrylovStatistics * statistics);
+
+} KrylovMethods;
+
+
+
+
+extern KrylovMethods const * const _Krylov;
+
+
+
+
+#endif /* KRYLOV_HEADER */
@@ -1,6 +1,8 @@
 
-#include "Matrix.h"
+#include "MatrixPrivate.h"
+#include "TaskGraph.h"
 
+#include <float.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -9,13 +11,143 @@
 
 
 
-struct Matrix
+/*
+ * This file is compiled once per precision, MatrixF.c instantiates it for float
+ * Macros are the ones expected by MatrixMethods.h, plus the scalar and table of the other precision
+ */
+#ifdef MATRIX_SINGLE_PRECISION
+	#define MATRIX MatrixF
+	#define MATRIX_SCALAR float
+	#define MATRIX_METHODS MatrixFMethods
+	#define MATRIX_SELF _MatrixF
+	#define MATRIX_SPAN MatrixFSpan
+	#define MATRIX_FROM_LINES matrixFFromLines
+	#define MATRIX_RCOND_FACTORED matrixFRcondFactored
+	#define MATRIX_THREADS matrixFThreads
+	#define MATRIX_CONVERTED Matrix
+	#define MATRIX_CONVERTED_SCALAR double
+	#define MATRIX_CONVERTED_SELF _Matrix
+	#define MATRIX_CONVERSION toDouble
+	#define MATRIX_EPSILON FLT_EPSILON
+#else
+	#define MATRIX Matrix
+	#define MATRIX_SCALAR double
+	#define MATRIX_METHODS MatrixMethods
+	#define MATRIX_SELF _Matrix
+	#define MATRIX_SPAN MatrixSpan
+	#define MATRIX_FROM_LINES matrixFromLines
+	#define MATRIX_RCOND_FACTORED matrixRcondFactored
+	#define MATRIX_THREADS matrixThreads
+	#define MATRIX_CONVERTED MatrixF
+	#define MATRIX_CONVERTED_SCALAR float
+	#define MATRIX_CONVERTED_SELF _MatrixF
+	#define MATRIX_CONVERSION toFloat
+	#define MATRIX_EPSILON DBL_EPSILON
+#endif
+
+
+
+
+/* edge of the square tiles the classical product kernel works on */
+#define PRODUCT_TILE 64
+
+/* degree of the diagonal Padé approximant of the exponential, accurate for norms up to 1/2 */
+#define PADE_DEGREE 6
+
+/* edge of the square blocks the LU factorization is split in, panels are a column of blocks */
+#define LU_PANEL 64
+
+/* edge of the tiles of C a parallel product computes as separate tasks */
+#define TASK_TILE 128
+
+/* iterations of Hager's estimator at most, as LAPACK's */
+#define RCOND_ITERATIONS 5
+
+/* independent partial sums of the reduction kernels, 8 doubles fill the widest vector registers */
+#define FOLD_LANES 8
+
+/* one-sided Jacobi sweeps at most, convergence being quadratic once columns are nearly orthogonal */
+#define JACOBI_SWEEPS 60
+
+/* reference counts are changed from any thread, with the atomic builtins of GCC and Clang, C89 having none */
+#define INCREMENT(count) __atomic_add_fetch(& (count), 1, __ATOMIC_RELAXED)
+#define DECREMENT(count) __atomic_sub_fetch(& (count), 1, __ATOMIC_ACQ_REL)
+#define LOAD(count) __atomic_load_n(& (count), __ATOMIC_ACQUIRE)
+
+/* tuning settings are set and read from any thread, each one on its own, read once per call */
+#define TUNE(setting, value) __atomic_store_n(& (setting), (value), __ATOMIC_RELAXED)
+#define TUNED(setting) __atomic_load_n(& (setting), __ATOMIC_RELAXED)
+
+/* cells read across the lines of the other layout are a square tile at a time, each line staying cached */
+#define LAYOUT_TILE 32
+
+
+
+
+/**
+ * What the tasks of a factorization or substitution share
+ */
+typedef struct
+{
+	/* P A = L U, as a contiguous size * size block, L below the diagonal */
+	size_t size;
+	MATRIX_SCALAR * factors;
+
+	/* the row exchanged with each row, in order */
+	size_t * pivots;
+
+	/* number of panels, and of blocks in each of them */
+	size_t blocks;
+
+	/* set by the panel meeting a zero pivot, panels run one after the other */
+	int singular;
+
+	/* right-hand side replaced by the solution, size rows [stride] cells apart */
+	MATRIX_SCALAR * solution;
+	size_t stride;
+} Factorization;
+
+
+/**
+ * Arguments of scaledMultiplyAccumulate, which the tasks of a parallel product split in tiles of C
+ */
+typedef struct
 {
-	size_t width;
 	size_t height;
+	size_t depth;
+	size_t width;
+	MATRIX_SCALAR alpha;
+	MATRIX_SCALAR const * left;
+	size_t leftRowStep;
+	size_t leftColumnStep;
+	MATRIX_SCALAR const * right;
+	size_t rightRowStep;
+	size_t rightColumnStep;
+	MATRIX_SCALAR beta;
+	MATRIX_SCALAR * result;
+	size_t resultStride;
+} TiledProduct;
 
-	double ** cells;
-};
+
+/**
+ * What the tasks of a one-sided Jacobi round share, each rotating one pair of columns
+ */
+typedef struct
+{
+	/* W, [count] columns of [length] contiguous cells, made orthogonal */
+	size_t length;
+	size_t count;
+	MATRIX_SCALAR * columns;
+
+	/* J, [count] columns of [count] contiguous cells, accumulating the rotations */
+	MATRIX_SCALAR * vectors;
+
+	/* 2 column indexes per pair of the round, an index of [count] or more pairing with none */
+	size_t * pairs;
+
+	/* set for each pair which was rotated */
+	unsigned char * rotated;
+} JacobiRound;
 
 
 
@@ -32,79 +164,446 @@ struct Matrix
  *
  * @return - the [rowIndex][columnIndex] cofactor, or NO VALUE if allocation failed
  */
-static double cofactor(Matrix const * this, size_t rowIndex, size_t columIndex);
+static MATRIX_SCALAR cofactor(MATRIX const * this, size_t rowIndex, size_t columIndex);
 
+/**
+ * C += A * B, for row-major blocks of cells with the given row strides
+ * Loops are tiled so that a tile of B stays in cache while rows of A and C stream through it
+ *
+ * @param height - the height of A and C
+ * @param depth - the width of A, and height of B
+ * @param width - the width of B and C
+ * @param left - A
+ * @param leftStride - the distance between 2 rows of A
+ * @param right - B
+ * @param rightStride - the distance between 2 rows of B
+ * @param result - C
+ * @param resultStride - the distance between 2 rows of C
+ */
+static void multiplyAccumulate(
+	size_t height, size_t depth, size_t width,
+	MATRIX_SCALAR const * left, size_t leftStride,
+	MATRIX_SCALAR const * right, size_t rightStride,
+	MATRIX_SCALAR * result, size_t resultStride);
 
+/**
+ * C = alpha * A * B + beta * C, with A and B read through steps so that they can be transposed views,
+ * Ai,k being left[i * leftRowStep + k * leftColumnStep], and Bk,j likewise
+ * Same tiling as multiplyAccumulate, C tiles are scaled by beta the first time they are visited,
+ * and tiles of B are packed when its rows aren't contiguous
+ */
+static void scaledMultiplyAccumulate(
+	size_t height, size_t depth, size_t width,
+	MATRIX_SCALAR alpha,
+	MATRIX_SCALAR const * left, size_t leftRowStep, size_t leftColumnStep,
+	MATRIX_SCALAR const * right, size_t rightRowStep, size_t rightColumnStep,
+	MATRIX_SCALAR beta,
+	MATRIX_SCALAR * result, size_t resultStride);
 
+/**
+ * Z = X + sign * Y, for row-major blocks of cells with the given row strides
+ * [result] may be one of the operands
+ */
+static void combine(
+	size_t height, size_t width,
+	MATRIX_SCALAR const * left, size_t leftStride,
+	MATRIX_SCALAR sign,
+	MATRIX_SCALAR const * right, size_t rightStride,
+	MATRIX_SCALAR * result, size_t resultStride);
 
-static Matrix * create(size_t height, size_t width)
-{
-	size_t rowIndex;
-	Matrix * this;
+/**
+ * C = A * B with Strassen-Winograd recursion, A being height*depth and B depth*width
+ * Recursion stops when a dimension is odd or reaches [crossover], the classical kernel takes over
+ *
+ * @param workspace - at least strassenWorkspace(height, depth, width, crossover) cells, reused by every level
+ * @param crossover - the crossover read once by the caller, so that the workspace is sized for the same one
+ */
+static void strassenWinograd(
+	size_t height, size_t depth, size_t width,
+	MATRIX_SCALAR const * left, size_t leftStride,
+	MATRIX_SCALAR const * right, size_t rightStride,
+	MATRIX_SCALAR * result, size_t resultStride,
+	MATRIX_SCALAR * workspace,
+	size_t crossover);
 
-	if ((width == 0) || (height == 0))
-		return NULL;
+/**
+ * @return - how many cells of workspace strassenWinograd needs for the given dimensions and [crossover]
+ */
+static size_t strassenWorkspace(size_t height, size_t depth, size_t width, size_t crossover);
 
-	this = malloc(sizeof(* this));
-	if (this == NULL)
-		return NULL;
+/**
+ * @return - [value] rounded up to a multiple of [unit]
+ */
+static size_t roundUp(size_t value, size_t unit);
 
-	this->cells = calloc(height, sizeof(* this->cells));
-	if (this->cells == NULL)
-	{
-		_Matrix->delete(& this);
-		return NULL;
-	}
+/**
+ * C = A * B, for contiguous [size]*[size] blocks of cells, with the same choice of kernel as product()
+ * [result] must not overlap any operand
+ *
+ * @param workspace - productWorkspace(size, crossover) cells for the Strassen-Winograd recursion,
+ *                    NULL to use the parallel tiled product
+ * @param crossover - the one the workspace was sized for
+ */
+static void multiplyInto(
+	size_t size,
+	MATRIX_SCALAR const * left,
+	MATRIX_SCALAR const * right,
+	MATRIX_SCALAR * result,
+	MATRIX_SCALAR * workspace,
+	size_t crossover);
 
-	for (rowIndex = 0; rowIndex < height; rowIndex++)
-	{
-		this->cells[rowIndex] = calloc(width, sizeof(this->cells[rowIndex]));
-		if (this->cells[rowIndex] == NULL)
-		{
-			_Matrix->delete(& this);
-			return NULL;
-		}
-	}
+/**
+ * @return - how many cells of workspace multiplyInto needs for [size]*[size] products with [crossover],
+ *           0 when they are below the Strassen threshold or too small to recurse
+ */
+static size_t productWorkspace(size_t size, size_t crossover);
 
-	this->width = width;
-	this->height = height;
+/**
+ * Solves A X = B in place with the blocked LU factorization, for contiguous [size]*[size] blocks of cells
+ * Substitution runs on ranges of LU_PANEL columns of B in parallel
+ *
+ * @param system - A, replaced with its LU factors
+ * @param rightHand - B, replaced with X
+ * @param pivots - [size] cells to hold the row exchanges
+ *
+ * @return - 1 on success, 0 if A is singular
+ */
+static int solveInPlace(size_t size, MATRIX_SCALAR * system, MATRIX_SCALAR * rightHand, size_t * pivots);
 
-	return this;
+/**
+ * Lays a matrix out in one block from [allocator]: structure, row pointers, then zeroed cells
+ * Rows are padded to a multiple of the alignment, so that each one starts aligned
+ *
+ * @return - the matrix, or NULL if dimensions are 0, their size overflows, or allocation failed
+ */
+static MATRIX * allocate(size_t height, size_t width, MatrixAllocator const * allocator);
+
+/**
+ * @return - 1 if [allocator] has both functions and a power of 2 alignment, 0 otherwise
+ */
+static int isValidAllocator(MatrixAllocator const * allocator);
+
+/**
+ * Lays a matrix out over the caller's [cells]: one block from the current allocator, structure then row pointers
+ *
+ * @return - the matrix, or NULL if [cells] is NULL, dimensions are 0, [stride] is too short, or allocation failed
+ */
+static MATRIX * wrapCells(size_t height, size_t width, MATRIX_SCALAR * cells, size_t stride, MatrixLayout layout);
+
+/**
+ * Line [index] of [this], one it points to if [stored] is set, else the cells at [index] across them
+ */
+static MATRIX_SPAN span(MATRIX const * this, size_t index, int stored);
+
+/**
+ * Writes [values] to line [index] of [this], as span reads it
+ */
+static void writeLine(MATRIX * this, size_t index, MATRIX_SCALAR const * values, int stored);
+
+/**
+ * Gives back a reference to the cells of [block], the last one freeing it
+ */
+static void dropReference(MATRIX * block);
+
+/**
+ * Frees [block], handing the buffer it adopted to its deleter first
+ */
+static void freeBlock(MATRIX * block);
+
+/**
+ * The default deleter of adopted buffers
+ */
+static void freeCells(void * cells, void * context);
+
+/**
+ * The default alloc: over-allocates with malloc, and keeps what malloc returned right before the aligned block
+ */
+static void * alignedAlloc(size_t bytes, size_t alignment, void * context);
+
+/**
+ * The default free, for blocks from alignedAlloc
+ */
+static void alignedFree(void * block, void * context);
+
+/**
+ * @return - [count] cells of workspace from the current allocator, or NULL if allocation failed
+ */
+static MATRIX_SCALAR * allocateWorkspace(size_t count);
+
+/**
+ * Gives workspace from allocateWorkspace back to the current allocator
+ */
+static void freeWorkspace(MATRIX_SCALAR * workspace);
+
+/**
+ * Copies the cells of [this] into a contiguous height * width block, dropping row padding
+ */
+static void packCells(MATRIX const * this, MATRIX_SCALAR * block);
+
+/**
+ * Copies a contiguous height * width block into the cells of [this]
+ */
+static void unpackCells(MATRIX_SCALAR const * block, MATRIX * this);
+
+/**
+ * Factors P A = L U in place, for a contiguous [size]*[size] block, L having a unit diagonal
+ * Each panel of LU_PANEL columns is factored with partial pivoting, then every block right of it
+ * is updated with the product kernel, as a graph of tasks: a block is updated once the panel
+ * and its previous update are done, and the next panel starts as soon as its own block is
+ *
+ * @param factors - A, replaced with L below the diagonal and U on and above it
+ * @param pivots - receives the row exchanged with each row, in order
+ *
+ * @return - the parity of row exchanges, 1 or -1, or 0 if A is singular
+ */
+static int factorLU(size_t size, MATRIX_SCALAR * factors, size_t * pivots);
+
+/**
+ * Task [index] of a factorization, the (panel * blocks + block)-th, for block >= panel:
+ * 	the panel is factored if block is the panel itself, its rows exchanged within the panel,
+ * 	otherwise the block gets these exchanges, U12 = L11^(-1) A12, then A22 -= L21 U12
+ *
+ * @param job - the Factorization being computed
+ */
+static void factorTile(void * job, size_t index);
+
+/**
+ * Solves L U X = B for the [index]-th range of LU_PANEL columns of the right-hand side, in place
+ *
+ * @param job - the Factorization to solve with
+ */
+static void substitute(void * job, size_t index);
+
+/**
+ * Computes scaledMultiplyAccumulate for the [index]-th tile of C, tiles being numbered by rows
+ *
+ * @param job - the TiledProduct being computed
+ */
+static void multiplyTile(void * job, size_t index);
+
+/**
+ * Computes a product as independent tiles of C when there are several threads,
+ * with the same operations on every cell as a single call to scaledMultiplyAccumulate
+ */
+static void multiplyInParallel(TiledProduct * job);
+
+/**
+ * Runs [count] independent tasks on the threads set, or in order on the calling thread
+ * if there is a single one, or if the graph couldn't be built
+ */
+static void inParallel(size_t count, void (* task)(void * job, size_t index), void * job);
+
+/**
+ * @return - 1 if the cells of [this] are a single contiguous run, rows or columns not being padded
+ */
+static int isContiguous(MATRIX const * this);
+
+/**
+ * @return - 1 if [this] isn't NULL, and is column-major
+ */
+static int isColumnMajor(MATRIX const * this);
+
+/**
+ * Reads a column-major A as the row-major ^t A its cells are, in O(1), for methods f such that f(A) = ^t f(^t A)
+ *
+ * @param view - filled in with ^t A if [this] is column-major, never to be deleted
+ *
+ * @return - [this] if it is row-major, [view] otherwise
+ */
+static MATRIX const * stored(MATRIX const * this, MATRIX * view);
+
+/**
+ * Turns [this] into its transpose in O(1), its cells being read in the other layout
+ *
+ * @return - [this], NULL if NULL
+ */
+static MATRIX * relabel(MATRIX * this);
+
+/**
+ * Copies the [lines]*[length] cells of [source] into their [length]*[lines] transpose, a LAYOUT_TILE square at a time
+ *
+ * @param destination - receives the transpose, its rows [stride] cells apart
+ */
+static void transposeCells(size_t lines, size_t length, MATRIX_SCALAR * const * source, MATRIX_SCALAR * destination, size_t stride);
+
+/**
+ * Folds the cells of [this] into [accumulator], in memory order, a row or a column at a time, or all at once if contiguous
+ */
+static MATRIX_SCALAR fold(
+	MATRIX const * this,
+	MATRIX_SCALAR (* function)(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * cells, size_t count, void * context),
+	MATRIX_SCALAR accumulator,
+	void * context);
+
+/**
+ * Kernels of the built-in reductions, for fold
+ * Sums are split across FOLD_LANES independent accumulators, which the compiler keeps in vector registers
+ * foldMagnitude keeps the greatest absolute value, foldScaledSquares divides cells by the scale [context]
+ * points to before squaring them
+ */
+static MATRIX_SCALAR foldMinimum(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * cells, size_t count, void * context);
+static MATRIX_SCALAR foldMaximum(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * cells, size_t count, void * context);
+static MATRIX_SCALAR foldMagnitude(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * cells, size_t count, void * context);
+static MATRIX_SCALAR foldTotal(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * cells, size_t count, void * context);
+static MATRIX_SCALAR foldScaledSquares(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * cells, size_t count, void * context);
+
+/**
+ * Copies every block into a new row-major matrix, a row or a column at a time, for blockAssemble, hconcat and vconcat
+ *
+ * @return - the block matrix, or NULL if sizes don't match or allocation failed
+ */
+static MATRIX * assemble(size_t rows, size_t columns, MATRIX const * const * blocks);
+
+/**
+ * @return - the determinant as the signed product of the pivots of P A = L U,
+ * 		or NO_VALUE if allocation failed
+ */
+static MATRIX_SCALAR determinantLU(MATRIX const * this);
+
+/**
+ * @return - A^(-1), solving L U X = P, or NULL if A is singular or allocation failed
+ */
+static MATRIX * inverseLU(MATRIX const * this);
+
+/**
+ * Solves A x = b in place, or ^t A x = b if [transposed], with the [size]*[size] factors of P A = L U
+ *
+ * @param vector - b, replaced with x
+ */
+static void solveFactored(
+	size_t size,
+	MATRIX_SCALAR const * factors,
+	size_t const * pivots,
+	MATRIX_SCALAR * vector,
+	int transposed);
+
+/**
+ * One-sided Jacobi: rotates pairs of columns of W until all are orthogonal, W J then having
+ * the singular values of the original W as column norms
+ * Each round rotates disjoint pairs, as parallel tasks for long enough columns
+ *
+ * @param columns - W, [count] columns of [length] cells
+ * @param vectors - receives J, [count] columns of [count] cells
+ *
+ * @return - 1 on success, 0 if allocation failed
+ */
+static int orthogonalizeColumns(size_t length, size_t count, MATRIX_SCALAR * columns, MATRIX_SCALAR * vectors);
+
+/**
+ * Task rotating pair [index] of a JacobiRound, if its columns aren't orthogonal yet
+ */
+static void rotatePair(void * job, size_t index);
+
+/**
+ * @return - ∑ x[i] * y[i], over 4 independent sums
+ */
+static MATRIX_SCALAR dotColumns(size_t length, MATRIX_SCALAR const * x, MATRIX_SCALAR const * y);
+
+/**
+ * Checks that U ^t V, with U and V both n*k, can update the n*n inverse A^(-1)
+ */
+static int isRankUpdate(MATRIX const * inverse, MATRIX const * left, MATRIX const * right);
+
+/**
+ * C = Id(k) + ^t V A^(-1) U, the capacitance matrix of the update A + U ^t V, factored as P C = L U
+ *
+ * @param product - receives A^(-1) U, n*k
+ * @param factors - receives the k*k factors
+ * @param pivots - receives the k pivots
+ * @param magnitude - receives 1 + ||^t V A^(-1) U||1, which C is computed from
+ *
+ * @return - the sign of the permutation, or 0 if C is singular
+ */
+static int factorCapacitance(
+	MATRIX const * inverse,
+	MATRIX const * left,
+	MATRIX const * right,
+	MATRIX * product,
+	MATRIX_SCALAR * factors,
+	size_t * pivots,
+	MATRIX_SCALAR * magnitude);
+
+
+
+
+/* sub-products with a dimension lesser than or equal to this use the classical kernel */
+static size_t strassenCrossover = STRASSEN_DEFAULT_CROSSOVER;
+
+/* product() switches to strassenProduct() when every dimension reaches this, 0 never */
+static size_t strassenThreshold = STRASSEN_DEFAULT_THRESHOLD;
+
+/* determinant(), inverse() and isInvertible() factor square matrices from this size, 0 never */
+static size_t luThreshold = LU_DEFAULT_THRESHOLD;
+
+/* threads running the tasks of products and factorizations, the calling thread included */
+static size_t threads = 1;
+
+/* where create() and workspaces get memory from */
+static MatrixAllocator currentAllocator = { alignedAlloc, alignedFree, MATRIX_DEFAULT_ALIGNMENT, NULL };
+
+
+
+
+static MATRIX * create(size_t height, size_t width)
+{
+	return allocate(height, width, & currentAllocator);
 }
 
 
-static void delete(Matrix ** this)
+static MATRIX * createWith(size_t height, size_t width, MatrixAllocator const * const allocator)
 {
-	size_t rowIndex;
+	if (allocator == NULL)
+		return allocate(height, width, & currentAllocator);
+
+	if (! isValidAllocator(allocator))
+		return NULL;
 
+	return allocate(height, width, allocator);
+}
+
+
+static void delete(MATRIX ** this)
+{
 	if (this == NULL)
 		return;
 	if (* this == NULL)
 		return;
 
-	for (rowIndex = 0; rowIndex < (* this)->height; rowIndex++)
+	MATRIX_SELF->release(* this);
+
+	* this = NULL;
+}
+
+
+static int setAllocator(MatrixAllocator const * const allocator)
+{
+	if (allocator == NULL)
 	{
-		free((* this)->cells[rowIndex]);
-		(* this)->cells[rowIndex] = NULL;
+		currentAllocator.alloc = alignedAlloc;
+		currentAllocator.free = alignedFree;
+		currentAllocator.alignment = MATRIX_DEFAULT_ALIGNMENT;
+		currentAllocator.context = NULL;
+		return 1;
 	}
 
-	free((* this)->cells);
-	(* this)->cells = NULL;
+	if (! isValidAllocator(allocator))
+		return 0;
 
-	free(* this);
-	* this = NULL;
+	currentAllocator = * allocator;
+
+	return 1;
 }
 
 
-static Matrix * identity(size_t size)
+static MATRIX * identity(size_t size)
 {
-	Matrix * this = NULL;
+	MATRIX * this = NULL;
 	size_t coord;
 
 	if (size == 0)
 		return NULL;
 
-	this = _Matrix->create(size, size);
+	this = MATRIX_SELF->create(size, size);
 	if (this == NULL)
 		return NULL;
 
@@ -115,10 +614,10 @@ static Matrix * identity(size_t size)
 }
 
 
-static int isIdentity(Matrix const * const this)
+static int isIdentity(MATRIX const * const this)
 {
 	size_t rowIndex, columnIndex;
-	double expectedValue;
+	MATRIX_SCALAR expectedValue;
 
 	if (this == NULL)
 		return 0;
@@ -144,75 +643,205 @@ static int isIdentity(Matrix const * const this)
 }
 
 
-static Matrix * copy(Matrix const * const this)
+static MATRIX * copy(MATRIX const * const this)
 {
-	Matrix * copy;
-	size_t rowIndex;
+	MATRIX * copy;
 
 	if (this == NULL)
 		return NULL;
 
-	copy = _Matrix->create(this->height, this->width);
+	/* a structure alone, reading the cells of the same owner until either matrix is detached */
+	copy = this->allocator.alloc(sizeof(* copy), this->allocator.alignment, this->allocator.context);
 	if (copy == NULL)
 		return NULL;
 
-	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
-		memcpy(copy->cells[rowIndex], this->cells[rowIndex], this->width * sizeof(this->cells[rowIndex][0]));
+	copy->width = this->width;
+	copy->height = this->height;
+	copy->stride = this->stride;
+	copy->layout = this->layout;
+	copy->allocator = this->allocator;
+	copy->cells = this->cells;
+	copy->owner = this->owner;
+	copy->references = 0;
+	copy->retains = 1;
+	copy->buffer = NULL;
+	copy->deleter = NULL;
+	copy->deleterContext = NULL;
+	INCREMENT(copy->owner->references);
 
 	return copy;
 }
 
 
-static Matrix * fromRows(size_t height, size_t width, double const * const rows, ...)
+static MATRIX const * retain(MATRIX const * const this)
 {
-	va_list variadic;
-	size_t rowIndex;
-	double const * row;
-
-	Matrix * this = _Matrix->create(height, width);
-	if (this == NULL)
-		return NULL;
-
-	row = rows;
-	va_start(variadic, rows);
-	for (rowIndex = 0; rowIndex < height; rowIndex++)
-	{
-		memcpy(this->cells[rowIndex], row, width * sizeof(this->cells[rowIndex][0]));
-		row = va_arg(variadic, double *);
-	}
-	va_end(variadic);
+	if (this != NULL)
+		INCREMENT(((MATRIX *) this)->retains);
 
 	return this;
 }
 
 
-static Matrix * fromColumns(size_t height, size_t width, double const * const columns, ...)
+static void release(MATRIX const * const this)
 {
-	va_list variadic;
-	size_t rowIndex, columnIndex;
-	double const * column;
+	MATRIX * const matrix = (MATRIX *) this;
 
-	Matrix * this = _Matrix->create(height, width);
-	if (this == NULL)
-		return NULL;
+	if (matrix == NULL)
+		return;
+	if (DECREMENT(matrix->retains) > 0)
+		return;
 
-	column = columns;
-	va_start(variadic, columns);
-	for (columnIndex = 0; columnIndex < width; columnIndex++)
+	/* cells it was detached into first, then the block of its structure */
+	if (matrix->owner != matrix)
+		dropReference(matrix->owner);
+
+	if (LOAD(matrix->references) > 0)
 	{
-		for (rowIndex = 0; rowIndex < height; rowIndex++)
-		{
-			this->cells[rowIndex][columnIndex] = column[rowIndex];
-		}
-		column = va_arg(variadic, double *);
+		dropReference(matrix);
+		return;
+	}
+
+	freeBlock(matrix);
+}
+
+
+static int isShared(MATRIX const * const this)
+{
+	if (this == NULL)
+		return 0;
+
+	return LOAD(this->owner->references) > 1;
+}
+
+
+static int detach(MATRIX * const this)
+{
+	MATRIX * owner;
+	MATRIX * cells;
+	size_t rowIndex;
+
+	if (this == NULL)
+		return 0;
+
+	owner = this->owner;
+	if (LOAD(owner->references) == 1)
+		return 1;
+
+	/* a whole block, whose structure is never used, the cells it holds being read by [this] only, in its layout */
+	cells = allocate(MATRIX_LINES(this), MATRIX_LENGTH(this), & this->allocator);
+	if (cells == NULL)
+		return 0;
+
+	for (rowIndex = 0; rowIndex < MATRIX_LINES(this); rowIndex++)
+		memcpy(cells->cells[rowIndex], this->cells[rowIndex], MATRIX_LENGTH(this) * sizeof(this->cells[rowIndex][0]));
+
+	/* wrapped cells may be laid out [stride] apart other than the allocator pads them */
+	this->cells = cells->cells;
+	this->stride = cells->stride;
+	this->owner = cells;
+
+	/* the structure of [this] keeps its block counting it */
+	if (owner != this)
+		dropReference(owner);
+
+	return 1;
+}
+
+
+static MATRIX_CONVERTED * convert(MATRIX const * const this)
+{
+	MATRIX_CONVERTED * converted;
+	size_t rowIndex, columnIndex;
+
+	if (this == NULL)
+		return NULL;
+
+	/* the copy keeps the layout of [this], its cells being converted in memory order */
+	converted = MATRIX_CONVERTED_SELF->create(MATRIX_LINES(this), MATRIX_LENGTH(this));
+	if (converted == NULL)
+		return NULL;
+
+	for (rowIndex = 0; rowIndex < MATRIX_LINES(this); rowIndex++)
+	{
+		for (columnIndex = 0; columnIndex < MATRIX_LENGTH(this); columnIndex++)
+			converted->cells[rowIndex][columnIndex] = (MATRIX_CONVERTED_SCALAR) this->cells[rowIndex][columnIndex];
 	}
+
+	converted->height = this->height;
+	converted->width = this->width;
+	converted->layout = this->layout;
+
+	return converted;
+}
+
+
+static MATRIX * fromRows(size_t height, size_t width, MATRIX_SCALAR const * const rows, ...)
+{
+	va_list variadic;
+	MATRIX * this;
+
+	va_start(variadic, rows);
+	this = MATRIX_FROM_LINES(height, width, MATRIX_ROW_MAJOR, rows, variadic);
+	va_end(variadic);
+
+	return this;
+}
+
+
+static MATRIX * fromColumns(size_t height, size_t width, MATRIX_SCALAR const * const columns, ...)
+{
+	va_list variadic;
+	MATRIX * this;
+
+	va_start(variadic, columns);
+	this = MATRIX_FROM_LINES(height, width, MATRIX_COLUMN_MAJOR, columns, variadic);
 	va_end(variadic);
 
 	return this;
 }
 
 
-static size_t width(Matrix const * const this)
+static MATRIX * fromBuffer(size_t height, size_t width, MATRIX_SCALAR const * const cells, size_t stride)
+{
+	MATRIX * this;
+	size_t rowIndex;
+
+	if ((cells == NULL) || (stride < width))
+		return NULL;
+
+	this = MATRIX_SELF->create(height, width);
+	if (this == NULL)
+		return NULL;
+
+	for (rowIndex = 0; rowIndex < height; rowIndex++)
+		memcpy(this->cells[rowIndex], cells + rowIndex * stride, width * sizeof(this->cells[rowIndex][0]));
+
+	return this;
+}
+
+
+static MATRIX * wrap(size_t height, size_t width, MATRIX_SCALAR * const cells, size_t stride, MatrixLayout layout)
+{
+	return wrapCells(height, width, cells, stride, layout);
+}
+
+
+static MATRIX * adopt(
+	size_t height, size_t width, MATRIX_SCALAR * const cells, size_t stride, MatrixLayout layout,
+	MatrixDeleter deleter, void * const context)
+{
+	MATRIX * this = wrapCells(height, width, cells, stride, layout);
+	if (this == NULL)
+		return NULL;
+
+	this->deleter = (deleter == NULL) ? freeCells : deleter;
+	this->deleterContext = context;
+
+	return this;
+}
+
+
+static size_t width(MATRIX const * const this)
 {
 	if (this == NULL)
 		return NO_VALUE;
@@ -220,349 +849,3204 @@ static size_t width(Matrix const * const this)
 }
 
 
-static size_t height(Matrix const * const this)
+static size_t height(MATRIX const * const this)
+{
+	if (this == NULL)
+		return NO_VALUE;
+	return this->height;
+}
+
+
+static MatrixLayout layout(MATRIX const * const this)
+{
+	if (this == NULL)
+		return MATRIX_ROW_MAJOR;
+	return this->layout;
+}
+
+
+static MATRIX * toLayout(MATRIX const * const this, MatrixLayout layout)
+{
+	MATRIX * result;
+
+	if (this == NULL)
+		return NULL;
+
+	if (this->layout == layout)
+		return MATRIX_SELF->copy(this);
+
+	/* the lines of [this] become the cells across the lines of the result */
+	result = MATRIX_SELF->create(MATRIX_LENGTH(this), MATRIX_LINES(this));
+	if (result == NULL)
+		return NULL;
+
+	transposeCells(MATRIX_LINES(this), MATRIX_LENGTH(this), this->cells, result->cells[0], result->stride);
+
+	return (layout == MATRIX_COLUMN_MAJOR) ? relabel(result) : result;
+}
+
+
+static void print(MATRIX const * const this)
+{
+	size_t rowIndex, columnIndex;
+	int isFirstCell;
+
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		isFirstCell = 1;
+		for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+		{
+			if (! isFirstCell)
+				printf("\t");
+			printf("%.2f", MATRIX_CELL(this, rowIndex, columnIndex));
+			isFirstCell = 0;
+		}
+		printf("\n");
+	}
+}
+
+
+static MATRIX_SCALAR getCell(MATRIX const * const this, size_t ordinate, size_t abscissa)
+{
+	if (this == NULL)
+		return NO_VALUE;
+
+	if ((abscissa >= this->width) || (ordinate >= this->height))
+		return NO_VALUE;
+
+	return MATRIX_CELL(this, ordinate, abscissa);
+}
+
+
+static int setCell(MATRIX * const this, size_t ordinate, size_t abscissa, MATRIX_SCALAR value)
+{
+	if (this == NULL)
+		return 0;
+
+	if ((abscissa >= this->width) || (ordinate >= this->height))
+		return 0;
+
+	if (! MATRIX_SELF->detach(this))
+		return 0;
+
+	MATRIX_CELL(this, ordinate, abscissa) = value;
+
+	return 1;
+}
+
+
+static MATRIX_SPAN row(MATRIX const * const this, size_t index)
+{
+	if ((this == NULL) || (index >= this->height))
+		return span(NULL, 0, 0);
+
+	return span(this, index, this->layout == MATRIX_ROW_MAJOR);
+}
+
+
+static MATRIX_SPAN column(MATRIX const * const this, size_t index)
+{
+	if ((this == NULL) || (index >= this->width))
+		return span(NULL, 0, 0);
+
+	return span(this, index, this->layout == MATRIX_COLUMN_MAJOR);
+}
+
+
+static int setRow(MATRIX * const this, size_t index, MATRIX_SCALAR const * const values)
+{
+	if ((this == NULL) || (values == NULL))
+		return 0;
+
+	if (index >= this->height)
+		return 0;
+
+	if (! MATRIX_SELF->detach(this))
+		return 0;
+
+	writeLine(this, index, values, this->layout == MATRIX_ROW_MAJOR);
+
+	return 1;
+}
+
+
+static int setColumn(MATRIX * const this, size_t index, MATRIX_SCALAR const * const values)
+{
+	if ((this == NULL) || (values == NULL))
+		return 0;
+
+	if (index >= this->width)
+		return 0;
+
+	if (! MATRIX_SELF->detach(this))
+		return 0;
+
+	writeLine(this, index, values, this->layout == MATRIX_COLUMN_MAJOR);
+
+	return 1;
+}
+
+
+static int fill(MATRIX * const this, MATRIX_SCALAR value)
+{
+	size_t rowIndex, columnIndex;
+
+	if (this == NULL)
+		return 0;
+
+	if (! MATRIX_SELF->detach(this))
+		return 0;
+
+	for (rowIndex = 0; rowIndex < MATRIX_LINES(this); rowIndex++)
+	{
+		for (columnIndex = 0; columnIndex < MATRIX_LENGTH(this); columnIndex++)
+			this->cells[rowIndex][columnIndex] = value;
+	}
+
+	return 1;
+}
+
+
+static int copyRegion(
+	MATRIX * const destination, size_t destinationRow, size_t destinationColumn,
+	MATRIX const * const source, size_t sourceRow, size_t sourceColumn,
+	size_t height, size_t width)
+{
+	size_t rowIndex, columnIndex, index, swapped;
+
+	if ((destination == NULL) || (source == NULL))
+		return 0;
+	if ((height == 0) || (width == 0))
+		return 0;
+	if ((height > source->height) || (sourceRow > source->height - height))
+		return 0;
+	if ((width > source->width) || (sourceColumn > source->width - width))
+		return 0;
+	if ((height > destination->height) || (destinationRow > destination->height - height))
+		return 0;
+	if ((width > destination->width) || (destinationColumn > destination->width - width))
+		return 0;
+
+	if (! MATRIX_SELF->detach(destination))
+		return 0;
+
+	if (source->layout != destination->layout)
+	{
+		for (rowIndex = 0; rowIndex < height; rowIndex++)
+		{
+			for (columnIndex = 0; columnIndex < width; columnIndex++)
+			{
+				MATRIX_CELL(destination, destinationRow + rowIndex, destinationColumn + columnIndex)
+					= MATRIX_CELL(source, sourceRow + rowIndex, sourceColumn + columnIndex);
+			}
+		}
+		return 1;
+	}
+
+	/* both are read as the lines they point to, the block of a column-major matrix being transposed */
+	if (isColumnMajor(source))
+	{
+		swapped = destinationRow;
+		destinationRow = destinationColumn;
+		destinationColumn = swapped;
+
+		swapped = sourceRow;
+		sourceRow = sourceColumn;
+		sourceColumn = swapped;
+
+		swapped = height;
+		height = width;
+		width = swapped;
+	}
+
+	/* lines are moved away from the ones still to read when [source] is [destination] */
+	for (index = 0; index < height; index++)
+	{
+		rowIndex = (destinationRow > sourceRow) ? height - 1 - index : index;
+		memmove(
+			destination->cells[destinationRow + rowIndex] + destinationColumn,
+			source->cells[sourceRow + rowIndex] + sourceColumn,
+			width * sizeof(** destination->cells));
+	}
+
+	return 1;
+}
+
+
+static MATRIX_SCALAR trace(MATRIX const * const this)
+{
+	size_t coord;
+	MATRIX_SCALAR trace;
+
+	if (this == NULL)
+		return NO_VALUE;
+
+	if (this->height != this->width)
+		return MATRIX_IS_NOT_SQUARE;
+
+	trace = 0;
+	for (coord = 0; coord < this->height; coord++)
+		trace += this->cells[coord][coord];
+
+	return trace;
+}
+
+
+static MATRIX_SCALAR determinant(MATRIX const * const this)
+{
+	size_t rowIndex, columnIndex, threshold;
+	MATRIX * cofactorsMatrix;
+	MATRIX view;
+	MATRIX_SCALAR determinant = 0;
+
+	if (isColumnMajor(this))
+		return MATRIX_SELF->determinant(stored(this, & view));
+
+	if (this->width != this->height)
+		return MATRIX_IS_NOT_SQUARE;
+
+	if (this->height == 1)
+		return this->cells[0][0];
+	if (this->height == 2)
+		return this->cells[0][0] * this->cells[1][1] - this->cells[0][1] * this->cells[1][0];
+
+	threshold = TUNED(luThreshold);
+	if ((threshold != 0) && (this->height >= threshold))
+		return determinantLU(this);
+
+	/* TODO: we don't need the FULL cofactors matrix, only 1 row or column */
+	/* TODO: rows permutation for faster processing, instead of Laplace expansion */
+
+	cofactorsMatrix = MATRIX_SELF->cofactors(this);
+	if (cofactorsMatrix == NULL)
+		return NO_VALUE;
+
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		for (columnIndex = 0; columnIndex < cofactorsMatrix->width; columnIndex++)
+			determinant += this->cells[rowIndex][columnIndex] * cofactorsMatrix->cells[0][columnIndex];
+	}
+
+	MATRIX_SELF->delete(& cofactorsMatrix);
+
+	return determinant;
+}
+
+
+static MATRIX * minor(MATRIX const * const this, size_t rowIndex, size_t columnIndex)
+{
+	MATRIX * minor;
+	MATRIX view;
+	size_t sourceRowIndex, sourceColumnIndex;
+	size_t destRowIndex, destColumnIndex;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->minor(stored(this, & view), columnIndex, rowIndex));
+
+	if (this->height < 2)
+		return NULL;
+
+	minor = MATRIX_SELF->create(this->height - 1, this->width - 1);
+	if (minor == NULL)
+		return NULL;
+
+	for (sourceRowIndex = destRowIndex = 0; sourceRowIndex < this->height; sourceRowIndex++)
+	{
+		if (sourceRowIndex == rowIndex)
+			continue;
+
+		for (sourceColumnIndex = destColumnIndex = 0; sourceColumnIndex < this->width; sourceColumnIndex++)
+		{
+			if (sourceColumnIndex == columnIndex)
+				continue;
+
+			minor->cells[destRowIndex][destColumnIndex] = this->cells[sourceRowIndex][sourceColumnIndex];
+			destColumnIndex++;
+		}
+
+		destRowIndex++;
+	}
+
+	return minor;
+}
+
+
+static MATRIX * cofactors(MATRIX const * const this)
+{
+	size_t rowIndex, columnIndex;
+	MATRIX * cofactors;
+	MATRIX view;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->cofactors(stored(this, & view)));
+
+	if (this->height != this->width)
+		return NULL;
+	if (this->height < 2)
+		return NULL;
+
+	cofactors = MATRIX_SELF->create(this->height, this->width);
+	if (cofactors == NULL)
+		return NULL;
+
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+			cofactors->cells[rowIndex][columnIndex] = cofactor(this, rowIndex, columnIndex);
+	}
+
+	return cofactors;
+}
+
+
+static MATRIX * transpose(MATRIX const * const this)
+{
+	/* the cells of A, shared, are those of ^t A in the other layout */
+	return relabel(MATRIX_SELF->copy(this));
+}
+
+
+static MATRIX * adjugate(MATRIX const * const this)
+{
+	MATRIX * cofactorsMatrix;
+	MATRIX * adjugate;
+
+	if (this == NULL)
+		return NULL;
+
+	cofactorsMatrix = MATRIX_SELF->cofactors(this);
+	if (cofactorsMatrix == NULL)
+		return NULL;
+
+	/* laid out as [this], rather than the other way, as a shared transpose would be */
+	adjugate = MATRIX_SELF->toLayout(relabel(cofactorsMatrix), this->layout);
+
+	MATRIX_SELF->delete(& cofactorsMatrix);
+
+	return adjugate;
+}
+
+
+static MATRIX * sum(MATRIX const * const left, MATRIX const * const right)
+{
+	size_t rowIndex, columnIndex, rowTile, columnTile, rowEnd, columnEnd;
+	MATRIX * sum;
+
+	if ((left == NULL) || (right == NULL))
+		return NULL;
+	if (left->width != right->width)
+		return NULL;
+	if (left->height != right->height)
+		return NULL;
+
+	/* operands of the same layout are summed in memory order, into a sum laid out as they are */
+	if (left->layout == right->layout)
+	{
+		sum = MATRIX_SELF->create(MATRIX_LINES(left), MATRIX_LENGTH(left));
+		if (sum == NULL)
+			return NULL;
+
+		for (rowIndex = 0; rowIndex < MATRIX_LINES(left); rowIndex++)
+		{
+			for (columnIndex = 0; columnIndex < MATRIX_LENGTH(left); columnIndex++)
+				sum->cells[rowIndex][columnIndex] = left->cells[rowIndex][columnIndex] + right->cells[rowIndex][columnIndex];
+		}
+
+		return isColumnMajor(left) ? relabel(sum) : sum;
+	}
+
+	sum = MATRIX_SELF->create(left->height, left->width);
+	if (sum == NULL)
+		return NULL;
+
+	/* otherwise the column-major operand is read across its columns, a tile at a time */
+	for (rowTile = 0; rowTile < left->height; rowTile += LAYOUT_TILE)
+	{
+		rowEnd = (rowTile + LAYOUT_TILE < left->height) ? rowTile + LAYOUT_TILE : left->height;
+		for (columnTile = 0; columnTile < left->width; columnTile += LAYOUT_TILE)
+		{
+			columnEnd = (columnTile + LAYOUT_TILE < left->width) ? columnTile + LAYOUT_TILE : left->width;
+			for (rowIndex = rowTile; rowIndex < rowEnd; rowIndex++)
+			{
+				for (columnIndex = columnTile; columnIndex < columnEnd; columnIndex++)
+				{
+					sum->cells[rowIndex][columnIndex] = MATRIX_CELL(left, rowIndex, columnIndex)
+						+ MATRIX_CELL(right, rowIndex, columnIndex);
+				}
+			}
+		}
+	}
+
+	return sum;
+}
+
+
+static MATRIX * product(MATRIX const * const left, MATRIX const * const right)
+{
+	TiledProduct job;
+	MATRIX * product;
+	MATRIX leftView, rightView;
+	size_t threshold;
+	/*
+	 * A ∈ M(a,b), B ∈ M(b,c) => AB ∈ M(a,c)
+	 * Pi,j = ∑_i=1->n Ai,k * Bk,j
+	 */
+
+	if ((left == NULL) || (right == NULL))
+		return NULL;
+
+	if (left->width != right->height)
+		return NULL;
+
+	/* ^t (AB) = ^t B ^t A, from the cells of both */
+	if (isColumnMajor(left) && isColumnMajor(right))
+		return relabel(MATRIX_SELF->product(stored(right, & rightView), stored(left, & leftView)));
+
+	threshold = TUNED(strassenThreshold);
+	if ((threshold != 0)
+		&& (left->height >= threshold)
+		&& (left->width >= threshold)
+		&& (right->width >= threshold))
+	{
+		return MATRIX_SELF->strassenProduct(left, right);
+	}
+
+	product = MATRIX_SELF->create(left->height, right->width);
+	if (product == NULL)
+		return NULL;
+
+	/* a column-major operand is read in place, by swapping the steps between rows and columns */
+	job.height = left->height;
+	job.depth = left->width;
+	job.width = right->width;
+	job.alpha = 1;
+	job.left = left->cells[0];
+	job.leftRowStep = isColumnMajor(left) ? 1 : left->stride;
+	job.leftColumnStep = isColumnMajor(left) ? left->stride : 1;
+	job.right = right->cells[0];
+	job.rightRowStep = isColumnMajor(right) ? 1 : right->stride;
+	job.rightColumnStep = isColumnMajor(right) ? right->stride : 1;
+	job.beta = 1;
+	job.result = product->cells[0];
+	job.resultStride = product->stride;
+	multiplyInParallel(& job);
+
+	return product;
+}
+
+
+static int gemm(
+	MATRIX_SCALAR alpha,
+	MATRIX const * const left, int transposeLeft,
+	MATRIX const * const right, int transposeRight,
+	MATRIX_SCALAR beta,
+	MATRIX * const result)
+{
+	TiledProduct job;
+	MATRIX const * first;
+	MATRIX const * second;
+	size_t height, depth, width;
+	int firstTransposed, secondTransposed, swap;
+
+	if ((left == NULL) || (right == NULL) || (result == NULL))
+		return 0;
+	if ((result == left) || (result == right))
+		return 0;
+
+	height = transposeLeft ? left->width : left->height;
+	depth = transposeLeft ? left->height : left->width;
+	width = transposeRight ? right->height : right->width;
+
+	if (depth != (transposeRight ? right->width : right->height))
+		return 0;
+	if ((result->height != height) || (result->width != width))
+		return 0;
+	if (! MATRIX_SELF->detach(result))
+		return 0;
+
+	/* a column-major X is ^t X to its cells, a column-major C is written as ^t C = ^t op(B) ^t op(A) */
+	first = left;
+	second = right;
+	firstTransposed = (! transposeLeft) != ! isColumnMajor(left);
+	secondTransposed = (! transposeRight) != ! isColumnMajor(right);
+	if (isColumnMajor(result))
+	{
+		first = right;
+		second = left;
+		swap = firstTransposed;
+		firstTransposed = ! secondTransposed;
+		secondTransposed = ! swap;
+		height = width;
+		width = result->height;
+	}
+
+	/* ^t X is read in place, by swapping the steps between rows and columns */
+	job.height = height;
+	job.depth = depth;
+	job.width = width;
+	job.alpha = alpha;
+	job.left = first->cells[0];
+	job.leftRowStep = firstTransposed ? 1 : first->stride;
+	job.leftColumnStep = firstTransposed ? first->stride : 1;
+	job.right = second->cells[0];
+	job.rightRowStep = secondTransposed ? 1 : second->stride;
+	job.rightColumnStep = secondTransposed ? second->stride : 1;
+	job.beta = beta;
+	job.result = result->cells[0];
+	job.resultStride = result->stride;
+	multiplyInParallel(& job);
+
+	return 1;
+}
+
+
+static MATRIX * strassenProduct(MATRIX const * const left, MATRIX const * const right)
+{
+	MATRIX * product;
+	size_t height, depth, width;
+	size_t unit, smallest, crossover;
+	size_t rowIndex;
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR * paddedLeft;
+	MATRIX_SCALAR * paddedRight;
+	MATRIX_SCALAR * paddedProduct;
+	MATRIX leftView, rightView;
+
+	if ((left == NULL) || (right == NULL))
+		return NULL;
+
+	if (left->width != right->height)
+		return NULL;
+
+	/* ^t (AB) = ^t B ^t A, from the cells of both */
+	if (isColumnMajor(left) && isColumnMajor(right))
+		return relabel(MATRIX_SELF->strassenProduct(stored(right, & rightView), stored(left, & leftView)));
+
+	product = MATRIX_SELF->create(left->height, right->width);
+	if (product == NULL)
+		return NULL;
+
+	/* dimensions are zero-padded to be halved as many times as the smallest one needs */
+	smallest = left->height;
+	if (left->width < smallest)
+		smallest = left->width;
+	if (right->width < smallest)
+		smallest = right->width;
+	crossover = TUNED(strassenCrossover);
+	for (unit = 1; smallest / unit > crossover; unit *= 2)
+		continue;
+
+	height = roundUp(left->height, unit);
+	depth = roundUp(left->width, unit);
+	width = roundUp(right->width, unit);
+
+	if ((height == left->height) && (depth == left->width) && (width == right->width)
+		&& ! isColumnMajor(left) && ! isColumnMajor(right))
+	{
+		buffer = allocateWorkspace(strassenWorkspace(height, depth, width, crossover) + 1);
+		if (buffer == NULL)
+		{
+			MATRIX_SELF->delete(& product);
+			return NULL;
+		}
+
+		strassenWinograd(
+			height, depth, width,
+			left->cells[0], left->stride,
+			right->cells[0], right->stride,
+			product->cells[0], product->stride,
+			buffer,
+			crossover);
+
+		freeWorkspace(buffer);
+		return product;
+	}
+
+	buffer = allocateWorkspace(height * depth + depth * width + height * width + strassenWorkspace(height, depth, width, crossover));
+	if (buffer == NULL)
+	{
+		MATRIX_SELF->delete(& product);
+		return NULL;
+	}
+	memset(buffer, 0, (height * depth + depth * width) * sizeof(* buffer));
+
+	paddedLeft = buffer;
+	paddedRight = paddedLeft + height * depth;
+	paddedProduct = paddedRight + depth * width;
+
+	/* padding needs a copy anyway, a column-major operand is laid out row-major on the way */
+	if (isColumnMajor(left))
+		transposeCells(left->width, left->height, left->cells, paddedLeft, depth);
+	for (rowIndex = 0; ! isColumnMajor(left) && (rowIndex < left->height); rowIndex++)
+		memcpy(paddedLeft + rowIndex * depth, left->cells[rowIndex], left->width * sizeof(* buffer));
+	if (isColumnMajor(right))
+		transposeCells(right->width, right->height, right->cells, paddedRight, width);
+	for (rowIndex = 0; ! isColumnMajor(right) && (rowIndex < right->height); rowIndex++)
+		memcpy(paddedRight + rowIndex * width, right->cells[rowIndex], right->width * sizeof(* buffer));
+
+	strassenWinograd(
+		height, depth, width,
+		paddedLeft, depth,
+		paddedRight, width,
+		paddedProduct, width,
+		paddedProduct + height * width,
+		crossover);
+
+	for (rowIndex = 0; rowIndex < product->height; rowIndex++)
+		memcpy(product->cells[rowIndex], paddedProduct + rowIndex * width, product->width * sizeof(* buffer));
+
+	freeWorkspace(buffer);
+
+	return product;
+}
+
+
+static void tuneStrassen(size_t crossover, size_t threshold)
+{
+	TUNE(strassenCrossover, (crossover == 0) ? 1 : crossover);
+	TUNE(strassenThreshold, threshold);
+}
+
+
+static void tuneLU(size_t threshold)
+{
+	TUNE(luThreshold, threshold);
+}
+
+
+static void setThreads(size_t count)
+{
+	TUNE(threads, (count == 0) ? 1 : count);
+}
+
+
+static MATRIX * scalarProduct(MATRIX const * const this, MATRIX_SCALAR scalar)
+{
+	size_t rowIndex, columnIndex;
+	MATRIX * product;
+	MATRIX view;
+
+	if (this == NULL)
+		return NULL;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->scalarProduct(stored(this, & view), scalar));
+
+	product = MATRIX_SELF->create(this->height, this->width);
+	if (product == NULL)
+		return NULL;
+
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+			product->cells[rowIndex][columnIndex] = scalar * this->cells[rowIndex][columnIndex];
+	}
+
+	return product;
+}
+
+
+static MATRIX * hadamard(MATRIX const * const left, MATRIX const * const right)
+{
+	size_t rowIndex, columnIndex;
+	MATRIX_SCALAR const * leftRow;
+	MATRIX_SCALAR const * rightRow;
+	MATRIX_SCALAR * resultRow;
+	MATRIX * hadamard;
+	MATRIX * converted;
+	MATRIX leftView, rightView;
+
+	if ((left == NULL) || (right == NULL))
+		return NULL;
+	if ((left->width != right->width) || (left->height != right->height))
+		return NULL;
+
+	if (isColumnMajor(left) && isColumnMajor(right))
+		return relabel(MATRIX_SELF->hadamard(stored(left, & leftView), stored(right, & rightView)));
+
+	/* mixed layouts, a row-major copy of the column-major operand is read */
+	if (isColumnMajor(left) || isColumnMajor(right))
+	{
+		converted = MATRIX_SELF->toLayout(isColumnMajor(left) ? left : right, MATRIX_ROW_MAJOR);
+		if (converted == NULL)
+			return NULL;
+		hadamard = MATRIX_SELF->hadamard(isColumnMajor(left) ? converted : left, isColumnMajor(right) ? converted : right);
+		MATRIX_SELF->delete(& converted);
+		return hadamard;
+	}
+
+	hadamard = MATRIX_SELF->create(left->height, left->width);
+	if (hadamard == NULL)
+		return NULL;
+
+	for (rowIndex = 0; rowIndex < left->height; rowIndex++)
+	{
+		leftRow = left->cells[rowIndex];
+		rightRow = right->cells[rowIndex];
+		resultRow = hadamard->cells[rowIndex];
+		for (columnIndex = 0; columnIndex < left->width; columnIndex++)
+			resultRow[columnIndex] = leftRow[columnIndex] * rightRow[columnIndex];
+	}
+
+	return hadamard;
+}
+
+
+static MATRIX * clamp(MATRIX const * const this, MATRIX_SCALAR lower, MATRIX_SCALAR upper)
+{
+	size_t rowIndex, columnIndex;
+	MATRIX_SCALAR const * row;
+	MATRIX_SCALAR * resultRow;
+	MATRIX * clamped;
+	MATRIX view;
+
+	if (this == NULL)
+		return NULL;
+	if (lower > upper)
+		return NULL;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->clamp(stored(this, & view), lower, upper));
+
+	clamped = MATRIX_SELF->create(this->height, this->width);
+	if (clamped == NULL)
+		return NULL;
+
+	/* two selects per cell, without branches the loop gets vectorized */
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		row = this->cells[rowIndex];
+		resultRow = clamped->cells[rowIndex];
+		for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+		{
+			resultRow[columnIndex] = (row[columnIndex] < lower) ? lower : row[columnIndex];
+			resultRow[columnIndex] = (resultRow[columnIndex] > upper) ? upper : resultRow[columnIndex];
+		}
+	}
+
+	return clamped;
+}
+
+
+static MATRIX * map(
+	MATRIX const * const this,
+	void (* const function)(MATRIX_SCALAR const * cells, MATRIX_SCALAR * results, size_t count, void * context),
+	void * const context)
+{
+	size_t chunk, offset;
+	MATRIX * mapped;
+	MATRIX view;
+
+	if ((this == NULL) || (function == NULL))
+		return NULL;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->map(stored(this, & view), function, context));
+
+	mapped = MATRIX_SELF->create(this->height, this->width);
+	if (mapped == NULL)
+		return NULL;
+
+	chunk = (isContiguous(this) && isContiguous(mapped)) ? this->height * this->width : this->width;
+	for (offset = 0; offset < this->height * this->width; offset += chunk)
+		function(this->cells[offset / this->width], mapped->cells[offset / this->width], chunk, context);
+
+	return mapped;
+}
+
+
+static MATRIX * zip(
+	MATRIX const * const left,
+	MATRIX const * const right,
+	void (* const function)(MATRIX_SCALAR const * left, MATRIX_SCALAR const * right, MATRIX_SCALAR * results, size_t count, void * context),
+	void * const context)
+{
+	size_t chunk, offset, row;
+	MATRIX * zipped;
+	MATRIX * converted;
+	MATRIX leftView, rightView;
+
+	if ((left == NULL) || (right == NULL) || (function == NULL))
+		return NULL;
+	if ((left->width != right->width) || (left->height != right->height))
+		return NULL;
+
+	if (isColumnMajor(left) && isColumnMajor(right))
+		return relabel(MATRIX_SELF->zip(stored(left, & leftView), stored(right, & rightView), function, context));
+
+	/* mixed layouts, a row-major copy of the column-major operand is read */
+	if (isColumnMajor(left) || isColumnMajor(right))
+	{
+		converted = MATRIX_SELF->toLayout(isColumnMajor(left) ? left : right, MATRIX_ROW_MAJOR);
+		if (converted == NULL)
+			return NULL;
+		zipped = MATRIX_SELF->zip(isColumnMajor(left) ? converted : left, isColumnMajor(right) ? converted : right, function, context);
+		MATRIX_SELF->delete(& converted);
+		return zipped;
+	}
+
+	zipped = MATRIX_SELF->create(left->height, left->width);
+	if (zipped == NULL)
+		return NULL;
+
+	chunk = (isContiguous(left) && isContiguous(right) && isContiguous(zipped)) ? left->height * left->width : left->width;
+	for (offset = 0; offset < left->height * left->width; offset += chunk)
+	{
+		row = offset / left->width;
+		function(left->cells[row], right->cells[row], zipped->cells[row], chunk, context);
+	}
+
+	return zipped;
+}
+
+
+static MATRIX_SCALAR reduce(
+	MATRIX const * const this,
+	MATRIX_SCALAR (* const function)(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * cells, size_t count, void * context),
+	MATRIX_SCALAR initial,
+	void * const context)
+{
+	if ((this == NULL) || (function == NULL))
+		return NO_VALUE;
+
+	return fold(this, function, initial, context);
+}
+
+
+static MATRIX_SCALAR minimum(MATRIX const * const this)
+{
+	if (this == NULL)
+		return NO_VALUE;
+
+	return fold(this, foldMinimum, this->cells[0][0], NULL);
+}
+
+
+static MATRIX_SCALAR maximum(MATRIX const * const this)
+{
+	if (this == NULL)
+		return NO_VALUE;
+
+	return fold(this, foldMaximum, this->cells[0][0], NULL);
+}
+
+
+static MATRIX_SCALAR total(MATRIX const * const this)
+{
+	if (this == NULL)
+		return NO_VALUE;
+
+	return fold(this, foldTotal, 0, NULL);
+}
+
+
+static MATRIX_SCALAR frobeniusNorm(MATRIX const * const this)
+{
+	MATRIX_SCALAR scale;
+
+	if (this == NULL)
+		return NO_VALUE;
+
+	scale = fold(this, foldMagnitude, 0, NULL);
+	if (scale == 0)
+		return 0;
+
+	return scale * sqrt(fold(this, foldScaledSquares, 0, & scale));
+}
+
+
+static MATRIX * kronecker(MATRIX const * const left, MATRIX const * const right)
+{
+	size_t leftRow, leftColumn, rightRow, columnIndex;
+	MATRIX_SCALAR factor;
+	MATRIX_SCALAR const * source;
+	MATRIX_SCALAR * destination;
+	MATRIX * kronecker;
+	MATRIX * converted;
+	MATRIX leftView, rightView;
+
+	if ((left == NULL) || (right == NULL))
+		return NULL;
+	if ((left->height > ((size_t) -1) / right->height) || (left->width > ((size_t) -1) / right->width))
+		return NULL;
+
+	/* ^t (A ⊗ B) = ^t A ⊗ ^t B */
+	if (isColumnMajor(left) && isColumnMajor(right))
+		return relabel(MATRIX_SELF->kronecker(stored(left, & leftView), stored(right, & rightView)));
+
+	/* mixed layouts, a row-major copy of the column-major operand is read */
+	if (isColumnMajor(left) || isColumnMajor(right))
+	{
+		converted = MATRIX_SELF->toLayout(isColumnMajor(left) ? left : right, MATRIX_ROW_MAJOR);
+		if (converted == NULL)
+			return NULL;
+		kronecker = MATRIX_SELF->kronecker(isColumnMajor(left) ? converted : left, isColumnMajor(right) ? converted : right);
+		MATRIX_SELF->delete(& converted);
+		return kronecker;
+	}
+
+	kronecker = MATRIX_SELF->create(left->height * right->height, left->width * right->width);
+	if (kronecker == NULL)
+		return NULL;
+
+	/* every row of the result is a row of B, scaled by each cell of a row of A in turn */
+	for (leftRow = 0; leftRow < left->height; leftRow++)
+	{
+		for (rightRow = 0; rightRow < right->height; rightRow++)
+		{
+			source = right->cells[rightRow];
+			destination = kronecker->cells[leftRow * right->height + rightRow];
+			for (leftColumn = 0; leftColumn < left->width; leftColumn++)
+			{
+				factor = left->cells[leftRow][leftColumn];
+				for (columnIndex = 0; columnIndex < right->width; columnIndex++)
+					destination[columnIndex] = factor * source[columnIndex];
+				destination += right->width;
+			}
+		}
+	}
+
+	return kronecker;
+}
+
+
+static MATRIX * hconcat(MATRIX const * const left, MATRIX const * const right)
+{
+	MATRIX const * blocks[2];
+
+	blocks[0] = left;
+	blocks[1] = right;
+
+	if ((left == NULL) || (right == NULL))
+		return NULL;
+
+	return assemble(1, 2, blocks);
+}
+
+
+static MATRIX * vconcat(MATRIX const * const top, MATRIX const * const bottom)
+{
+	MATRIX const * blocks[2];
+
+	blocks[0] = top;
+	blocks[1] = bottom;
+
+	if ((top == NULL) || (bottom == NULL))
+		return NULL;
+
+	return assemble(2, 1, blocks);
+}
+
+
+static MATRIX * blockAssemble(size_t rows, size_t columns, MATRIX const * const * const blocks)
+{
+	if ((rows == 0) || (columns == 0) || (blocks == NULL))
+		return NULL;
+
+	return assemble(rows, columns, blocks);
+}
+
+
+static MATRIX_SCALAR norm(MATRIX const * const this, MatrixNorm type)
+{
+	MATRIX_SCALAR * sums;
+	MATRIX_SCALAR norm, sum;
+	size_t rowIndex, columnIndex;
+	MATRIX_SCALAR const * row;
+	MATRIX view;
+
+	if (this == NULL)
+		return NO_VALUE;
+
+	/* ||A||1 = ||^t A||inf, the other norms don't change */
+	if (isColumnMajor(this))
+	{
+		if (type == MATRIX_NORM_ONE)
+			type = MATRIX_NORM_INFINITY;
+		else if (type == MATRIX_NORM_INFINITY)
+			type = MATRIX_NORM_ONE;
+		return MATRIX_SELF->norm(stored(this, & view), type);
+	}
+
+	switch (type)
+	{
+		case MATRIX_NORM_ONE:
+			/* column sums are accumulated a row at a time, reading cells in memory order */
+			sums = allocateWorkspace(this->width);
+			if (sums == NULL)
+				return NO_VALUE;
+
+			for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+				sums[columnIndex] = 0;
+			for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+			{
+				row = this->cells[rowIndex];
+				for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+					sums[columnIndex] += fabs(row[columnIndex]);
+			}
+
+			norm = 0;
+			for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+				norm = (sums[columnIndex] > norm) ? sums[columnIndex] : norm;
+
+			freeWorkspace(sums);
+			return norm;
+
+		case MATRIX_NORM_INFINITY:
+			norm = 0;
+			for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+			{
+				row = this->cells[rowIndex];
+				sum = 0;
+				for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+					sum += fabs(row[columnIndex]);
+				norm = (sum > norm) ? sum : norm;
+			}
+			return norm;
+
+		case MATRIX_NORM_FROBENIUS:
+			return MATRIX_SELF->frobeniusNorm(this);
+
+		case MATRIX_NORM_MAX:
+			return fold(this, foldMagnitude, 0, NULL);
+	}
+
+	return NO_VALUE;
+}
+
+
+static MATRIX_SCALAR rcond(MATRIX const * const this)
+{
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR * factors;
+	MATRIX_SCALAR normA, estimate;
+	size_t size, pivotCells;
+	size_t * pivots;
+	MATRIX view;
+
+	if (this == NULL)
+		return NO_VALUE;
+	if (this->height != this->width)
+		return MATRIX_IS_NOT_SQUARE;
+
+	normA = MATRIX_SELF->norm(this, MATRIX_NORM_ONE);
+	if (normA == (MATRIX_SCALAR) NO_VALUE)
+		return NO_VALUE;
+	if (normA == 0)
+		return 0;
+
+	size = this->height;
+	pivotCells = (size * sizeof(size_t) + sizeof(MATRIX_SCALAR) - 1) / sizeof(MATRIX_SCALAR);
+	buffer = allocateWorkspace(pivotCells + size * size);
+	if (buffer == NULL)
+		return NO_VALUE;
+
+	pivots = (size_t *) buffer;
+	factors = buffer + pivotCells;
+
+	/* a column-major A is factored as the row-major ^t A its cells are, solves with A then being transposed ones */
+	packCells(stored(this, & view), factors);
+
+	if (factorLU(size, factors, pivots) == 0)
+		estimate = 0;
+	else
+		estimate = MATRIX_RCOND_FACTORED(size, factors, pivots, isColumnMajor(this), normA);
+
+	freeWorkspace(buffer);
+
+	return estimate;
+}
+
+
+static int isInvertible(MATRIX const * const this)
+{
+	if (this == NULL)
+		return 0;
+	if (this->height != this->width)
+		return 0;
+
+	return MATRIX_SELF->determinant(this) != 0;
+}
+
+
+static int isWellConditioned(MATRIX const * const this, MATRIX_SCALAR tolerance)
+{
+	MATRIX_SCALAR estimate;
+
+	if (this == NULL)
+		return 0;
+	if (this->height != this->width)
+		return 0;
+
+	estimate = MATRIX_SELF->rcond(this);
+
+	return (estimate != (MATRIX_SCALAR) NO_VALUE) && (estimate > tolerance);
+}
+
+
+static MATRIX * inverse(MATRIX const * const this)
+{
+	MATRIX_SCALAR determinant;
+	MATRIX * adjugate;
+	MATRIX * inverse;
+	MATRIX view;
+	size_t threshold;
+
+	if (this == NULL)
+		return NULL;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->inverse(stored(this, & view)));
+
+	if (this->height != this->width)
+		return NULL;
+
+	threshold = TUNED(luThreshold);
+	if ((threshold != 0) && (this->height >= threshold))
+		return inverseLU(this);
+
+	determinant = MATRIX_SELF->determinant(this);
+	if ((determinant == 0) || (determinant == (MATRIX_SCALAR) NO_VALUE))
+		return NULL;
+
+	adjugate = MATRIX_SELF->adjugate(this);
+	if (adjugate == NULL)
+		return NULL;
+
+	inverse = MATRIX_SELF->scalarProduct(adjugate, 1.0 / determinant);
+
+	MATRIX_SELF->delete(& adjugate);
+
+	return inverse;
+}
+
+
+static MATRIX * power(MATRIX const * const this, unsigned long exponent)
+{
+	MATRIX * power;
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR * current, * square, * scratch, * strassen, * swap;
+	size_t size, strassenCells, crossover;
+	int isFirstFactor;
+	MATRIX view;
+
+	if (this == NULL)
+		return NULL;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->power(stored(this, & view), exponent));
+
+	if (this->height != this->width)
+		return NULL;
+
+	if (exponent == 0)
+		return MATRIX_SELF->identity(this->height);
+
+	size = this->height;
+	power = MATRIX_SELF->create(size, size);
+	if (power == NULL)
+		return NULL;
+
+	crossover = TUNED(strassenCrossover);
+	strassenCells = productWorkspace(size, crossover);
+	buffer = allocateWorkspace(3 * size * size + strassenCells);
+	if (buffer == NULL)
+	{
+		MATRIX_SELF->delete(& power);
+		return NULL;
+	}
+
+	/*
+	 * A^k = ∏ A^(2^i) for every bit i set in k, the 3 buffers rotate between
+	 * the running product, the running square, and the product being computed,
+	 * the Strassen-Winograd workspace follows them so that one allocation serves every k
+	 */
+	current = buffer;
+	square = buffer + size * size;
+	scratch = square + size * size;
+	strassen = (strassenCells != 0) ? scratch + size * size : NULL;
+	packCells(this, square);
+
+	isFirstFactor = 1;
+	while (exponent != 0)
+	{
+		if (exponent & 1)
+		{
+			if (isFirstFactor)
+				memcpy(current, square, size * size * sizeof(* buffer));
+			else
+			{
+				multiplyInto(size, current, square, scratch, strassen, crossover);
+				swap = current;
+				current = scratch;
+				scratch = swap;
+			}
+			isFirstFactor = 0;
+		}
+
+		exponent >>= 1;
+		if (exponent != 0)
+		{
+			multiplyInto(size, square, square, scratch, strassen, crossover);
+			swap = square;
+			square = scratch;
+			scratch = swap;
+		}
+	}
+
+	unpackCells(current, power);
+
+	freeWorkspace(buffer);
+
+	return power;
+}
+
+
+static MATRIX * exponential(MATRIX const * const this)
+{
+	MATRIX * exponential;
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR * scaled, * power, * numerator, * denominator, * scratch, * strassen, * swap;
+	size_t * pivots;
+	size_t size, index, rowIndex, columnIndex, pivotCells, strassenCells, crossover;
+	int degree, squarings;
+	double norm, rowNorm, coefficient;
+	MATRIX view;
+
+	if (this == NULL)
+		return NULL;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->exponential(stored(this, & view)));
+
+	if (this->height != this->width)
+		return NULL;
+
+	size = this->height;
+	exponential = MATRIX_SELF->create(size, size);
+	if (exponential == NULL)
+		return NULL;
+
+	/* pivots and the Strassen-Winograd workspace share the block, whatever the number of squarings */
+	pivotCells = (size * sizeof(size_t) + sizeof(MATRIX_SCALAR) - 1) / sizeof(MATRIX_SCALAR);
+	crossover = TUNED(strassenCrossover);
+	strassenCells = productWorkspace(size, crossover);
+	buffer = allocateWorkspace(pivotCells + 5 * size * size + strassenCells);
+	if (buffer == NULL)
+	{
+		MATRIX_SELF->delete(& exponential);
+		return NULL;
+	}
+
+	pivots = (size_t *) buffer;
+	scaled = buffer + pivotCells;
+	power = scaled + size * size;
+	denominator = power + size * size;
+	scratch = denominator + size * size;
+	numerator = scratch + size * size;
+	strassen = (strassenCells != 0) ? numerator + size * size : NULL;
+
+	/* exp(A) = exp(A / 2^s)^(2^s), with s such that the infinity norm of A / 2^s is at most 1/2 */
+	norm = 0;
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+	{
+		rowNorm = 0;
+		for (columnIndex = 0; columnIndex < size; columnIndex++)
+			rowNorm += fabs(this->cells[rowIndex][columnIndex]);
+		if (rowNorm > norm)
+			norm = rowNorm;
+	}
+	frexp(norm, & squarings);
+	squarings = (squarings + 1 > 0) ? squarings + 1 : 0;
+
+	packCells(this, scaled);
+	for (index = 0; index < size * size; index++)
+	{
+		scaled[index] = ldexp(scaled[index], -squarings);
+		power[index] = scaled[index];
+		numerator[index] = scaled[index] / 2;
+		denominator[index] = -scaled[index] / 2;
+	}
+	for (index = 0; index < size; index++)
+	{
+		numerator[index * size + index] += 1;
+		denominator[index * size + index] += 1;
+	}
+
+	/* N = ∑ c_k A^k, D = ∑ (-1)^k c_k A^k, with c_k = c_(k-1) * (q-k+1) / (k * (2q-k+1)) */
+	coefficient = 0.5;
+	for (degree = 2; degree <= PADE_DEGREE; degree++)
+	{
+		coefficient = coefficient * (PADE_DEGREE - degree + 1) / (degree * (2 * PADE_DEGREE - degree + 1));
+
+		multiplyInto(size, scaled, power, scratch, strassen, crossover);
+		swap = power;
+		power = scratch;
+		scratch = swap;
+
+		for (index = 0; index < size * size; index++)
+		{
+			numerator[index] += coefficient * power[index];
+			if (degree & 1)
+				denominator[index] -= coefficient * power[index];
+			else
+				denominator[index] += coefficient * power[index];
+		}
+	}
+
+	if (! solveInPlace(size, denominator, numerator, pivots))
+	{
+		freeWorkspace(buffer);
+		MATRIX_SELF->delete(& exponential);
+		return NULL;
+	}
+
+	for (; squarings > 0; squarings--)
+	{
+		multiplyInto(size, numerator, numerator, scratch, strassen, crossover);
+		swap = numerator;
+		numerator = scratch;
+		scratch = swap;
+	}
+
+	unpackCells(numerator, exponential);
+
+	freeWorkspace(buffer);
+
+	return exponential;
+}
+
+
+static MATRIX * svd(MATRIX const * const this, int full, MATRIX ** const left, MATRIX ** const right)
+{
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR * columns;
+	MATRIX_SCALAR * vectors;
+	MATRIX_SCALAR * basis;
+	MATRIX_SCALAR * norms;
+	MATRIX * values;
+	MATRIX * columnSide;
+	MATRIX * rotationSide;
+	size_t length, count, basisCount, rowIndex, columnIndex, index, other, best;
+	size_t * order;
+	size_t orderCells;
+	int transposed;
+	MATRIX_SCALAR norm;
+	MATRIX_SCALAR cutoff;
+	MATRIX view;
+
+	if (left != NULL)
+		* left = NULL;
+	if (right != NULL)
+		* right = NULL;
+	if (this == NULL)
+		return NULL;
+
+	/* ^t A = V Σ ^t U */
+	if (isColumnMajor(this))
+		return MATRIX_SELF->svd(stored(this, & view), full, right, left);
+
+	/* A^T = W Σ J^T is decomposed rather than a wide A, so that columns are the longer side */
+	transposed = (this->height < this->width);
+	length = transposed ? this->width : this->height;
+	count = transposed ? this->height : this->width;
+	basisCount = full ? length : count;
+
+	orderCells = (count * sizeof(size_t) + sizeof(MATRIX_SCALAR) - 1) / sizeof(MATRIX_SCALAR);
+	buffer = allocateWorkspace(orderCells + length * count + count * count + length * basisCount + count);
+	if (buffer == NULL)
+		return NULL;
+
+	order = (size_t *) buffer;
+	columns = buffer + orderCells;
+	vectors = columns + length * count;
+	basis = vectors + count * count;
+	norms = basis + length * basisCount;
+
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	{
+		for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+		{
+			if (transposed)
+				columns[rowIndex * length + columnIndex] = this->cells[rowIndex][columnIndex];
+			else
+				columns[columnIndex * length + rowIndex] = this->cells[rowIndex][columnIndex];
+		}
+	}
+
+	if (! orthogonalizeColumns(length, count, columns, vectors))
+	{
+		freeWorkspace(buffer);
+		return NULL;
+	}
+
+	/* σ = ||W_j||, by decreasing value */
+	values = MATRIX_SELF->create(count, 1);
+	if (values == NULL)
+	{
+		freeWorkspace(buffer);
+		return NULL;
+	}
+	for (index = 0; index < count; index++)
+	{
+		norms[index] = sqrt(dotColumns(length, columns + index * length, columns + index * length));
+		for (other = index; (other > 0) && (norms[index] > norms[order[other - 1]]); other--)
+			order[other] = order[other - 1];
+		order[other] = index;
+	}
+	for (index = 0; index < count; index++)
+		values->cells[index][0] = norms[order[index]];
+
+	/* U_j = W_j / σ_j, columns of singular values lost in rounding being completed, as the full basis is */
+	cutoff = (count > 0) ? length * MATRIX_EPSILON * values->cells[0][0] : 0;
+	for (index = 0; index < basisCount; index++)
+	{
+		if ((index < count) && (values->cells[index][0] > cutoff))
+		{
+			norm = values->cells[index][0];
+			for (rowIndex = 0; rowIndex < length; rowIndex++)
+				basis[index * length + rowIndex] = columns[order[index] * length + rowIndex] / norm;
+			continue;
+		}
+
+		/* e_i least covered by the basis so far, orthogonalized, W being no longer read from here and reused as scratch */
+		best = 0;
+		for (rowIndex = 0; rowIndex < length; rowIndex++)
+		{
+			norm = 0;
+			for (other = 0; other < index; other++)
+				norm += basis[other * length + rowIndex] * basis[other * length + rowIndex];
+			columns[rowIndex] = norm;
+			if (norm < columns[best])
+				best = rowIndex;
+		}
+		for (rowIndex = 0; rowIndex < length; rowIndex++)
+			basis[index * length + rowIndex] = (rowIndex == best) ? 1 : 0;
+		for (other = 0; other < 2 * index; other++)
+		{
+			norm = dotColumns(length, basis + (other % index) * length, basis + index * length);
+			for (rowIndex = 0; rowIndex < length; rowIndex++)
+				basis[index * length + rowIndex] -= norm * basis[(other % index) * length + rowIndex];
+		}
+		norm = sqrt(dotColumns(length, basis + index * length, basis + index * length));
+		for (rowIndex = 0; rowIndex < length; rowIndex++)
+			basis[index * length + rowIndex] /= norm;
+	}
+
+	columnSide = NULL;
+	rotationSide = NULL;
+	if ((transposed && (right != NULL)) || (! transposed && (left != NULL)))
+	{
+		columnSide = MATRIX_SELF->create(length, basisCount);
+		for (index = 0; (columnSide != NULL) && (index < basisCount); index++)
+		{
+			for (rowIndex = 0; rowIndex < length; rowIndex++)
+				columnSide->cells[rowIndex][index] = basis[index * length + rowIndex];
+		}
+	}
+	if ((transposed && (left != NULL)) || (! transposed && (right != NULL)))
+	{
+		rotationSide = MATRIX_SELF->create(count, count);
+		for (index = 0; (rotationSide != NULL) && (index < count); index++)
+		{
+			for (rowIndex = 0; rowIndex < count; rowIndex++)
+				rotationSide->cells[rowIndex][index] = vectors[order[index] * count + rowIndex];
+		}
+	}
+
+	freeWorkspace(buffer);
+
+	if (((columnSide == NULL) && ((transposed && (right != NULL)) || (! transposed && (left != NULL))))
+		|| ((rotationSide == NULL) && ((transposed && (left != NULL)) || (! transposed && (right != NULL)))))
+	{
+		MATRIX_SELF->delete(& columnSide);
+		MATRIX_SELF->delete(& rotationSide);
+		MATRIX_SELF->delete(& values);
+		return NULL;
+	}
+
+	if (left != NULL)
+		* left = transposed ? rotationSide : columnSide;
+	if (right != NULL)
+		* right = transposed ? columnSide : rotationSide;
+
+	return values;
+}
+
+
+static MATRIX * pinv(MATRIX const * const this, MATRIX_SCALAR tolerance)
+{
+	MATRIX * values;
+	MATRIX * left;
+	MATRIX * right;
+	MATRIX * inverse;
+	MATRIX_SCALAR cutoff;
+	size_t rowIndex, columnIndex;
+	MATRIX view;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->pinv(stored(this, & view), tolerance));
+
+	values = MATRIX_SELF->svd(this, 0, & left, & right);
+	if (values == NULL)
+		return NULL;
+
+	/* A+ = V Σ+ ^t U, Σ+ inverting the singular values above the cutoff only */
+	if (tolerance <= 0)
+		tolerance = ((this->height > this->width) ? this->height : this->width) * MATRIX_EPSILON;
+	cutoff = tolerance * values->cells[0][0];
+	for (columnIndex = 0; columnIndex < right->width; columnIndex++)
+	{
+		for (rowIndex = 0; rowIndex < right->height; rowIndex++)
+		{
+			if (values->cells[columnIndex][0] > cutoff)
+				right->cells[rowIndex][columnIndex] /= values->cells[columnIndex][0];
+			else
+				right->cells[rowIndex][columnIndex] = 0;
+		}
+	}
+
+	inverse = MATRIX_SELF->create(this->width, this->height);
+	if ((inverse != NULL) && ! MATRIX_SELF->gemm(1, right, 0, left, 1, 0, inverse))
+		MATRIX_SELF->delete(& inverse);
+
+	MATRIX_SELF->delete(& values);
+	MATRIX_SELF->delete(& left);
+	MATRIX_SELF->delete(& right);
+
+	return inverse;
+}
+
+
+static MATRIX * lowRank(MATRIX const * const this, size_t rank)
+{
+	MATRIX * values;
+	MATRIX * left;
+	MATRIX * right;
+	MATRIX * scaled;
+	MATRIX * kept;
+	MATRIX * approximation;
+	size_t rowIndex, columnIndex;
+	MATRIX view;
+
+	if (isColumnMajor(this))
+		return relabel(MATRIX_SELF->lowRank(stored(this, & view), rank));
+
+	values = MATRIX_SELF->svd(this, 0, & left, & right);
+	if (values == NULL)
+		return NULL;
+
+	/* Eckart-Young: U_r Σ_r ^t V_r is the closest matrix of rank r, in 2-norm and Frobenius norm */
+	if (rank > values->height)
+		rank = values->height;
+
+	approximation = MATRIX_SELF->create(this->height, this->width);
+	if ((approximation != NULL) && (rank > 0))
+	{
+		scaled = MATRIX_SELF->create(this->height, rank);
+		kept = MATRIX_SELF->create(this->width, rank);
+		if ((scaled != NULL) && (kept != NULL))
+		{
+			for (columnIndex = 0; columnIndex < rank; columnIndex++)
+			{
+				for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+					scaled->cells[rowIndex][columnIndex] = left->cells[rowIndex][columnIndex] * values->cells[columnIndex][0];
+				for (rowIndex = 0; rowIndex < this->width; rowIndex++)
+					kept->cells[rowIndex][columnIndex] = right->cells[rowIndex][columnIndex];
+			}
+		}
+
+		if ((scaled == NULL) || (kept == NULL) || ! MATRIX_SELF->gemm(1, scaled, 0, kept, 1, 0, approximation))
+			MATRIX_SELF->delete(& approximation);
+
+		MATRIX_SELF->delete(& scaled);
+		MATRIX_SELF->delete(& kept);
+	}
+
+	MATRIX_SELF->delete(& values);
+	MATRIX_SELF->delete(& left);
+	MATRIX_SELF->delete(& right);
+
+	return approximation;
+}
+
+
+static int inverseRankUpdate(MATRIX * const inverse, MATRIX const * const left, MATRIX const * const right)
+{
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR * factors;
+	MATRIX_SCALAR magnitude;
+	MATRIX * product;
+	MATRIX * projected;
+	MATRIX * weights;
+	MATRIX * solved;
+	size_t rank, pivotCells, rowIndex, columnIndex;
+	size_t * pivots;
+	int safe;
+
+	if (! isRankUpdate(inverse, left, right))
+		return 0;
+	if (! MATRIX_SELF->detach(inverse))
+		return 0;
+
+	rank = left->width;
+	pivotCells = (rank * sizeof(size_t) + sizeof(MATRIX_SCALAR) - 1) / sizeof(MATRIX_SCALAR);
+	buffer = allocateWorkspace(pivotCells + rank * rank + rank);
+	product = MATRIX_SELF->create(inverse->height, rank);
+	projected = MATRIX_SELF->create(rank, inverse->width);
+	weights = MATRIX_SELF->create(rank, inverse->width);
+	solved = MATRIX_SELF->create(rank, rank);
+
+	safe = (buffer != NULL) && (product != NULL) && (projected != NULL) && (weights != NULL) && (solved != NULL);
+	if (safe)
+	{
+		pivots = (size_t *) buffer;
+		factors = buffer + pivotCells;
+		safe = (factorCapacitance(inverse, left, right, product, factors, pivots, & magnitude) != 0);
+	}
+
+	/* C^(-1), column after column, k being small next to n */
+	for (columnIndex = 0; safe && (columnIndex < rank); columnIndex++)
+	{
+		for (rowIndex = 0; rowIndex < rank; rowIndex++)
+			factors[rank * rank + rowIndex] = (rowIndex == columnIndex) ? 1 : 0;
+		solveFactored(rank, factors, pivots, factors + rank * rank, 0);
+		for (rowIndex = 0; rowIndex < rank; rowIndex++)
+			solved->cells[rowIndex][columnIndex] = factors[rank * rank + rowIndex];
+	}
+
+	/*
+	 * C sums Id(k) and ^t V A^(-1) U, any cancellation between them is amplified by ||C^(-1)||:
+	 * past half the digits, the update is refused and A + U ^t V should be inverted again
+	 */
+	if (safe)
+		safe = (MATRIX_SELF->norm(solved, MATRIX_NORM_ONE) * magnitude * sqrt(MATRIX_EPSILON) <= 1);
+
+	/* Woodbury: (A + U ^t V)^(-1) = A^(-1) - A^(-1) U C^(-1) ^t V A^(-1), in O(n^2 k) */
+	if (safe)
+	{
+		MATRIX_SELF->gemm(1, right, 1, inverse, 0, 0, projected);
+		MATRIX_SELF->gemm(1, solved, 0, projected, 0, 0, weights);
+		MATRIX_SELF->gemm(-1, product, 0, weights, 0, 1, inverse);
+	}
+
+	freeWorkspace(buffer);
+	MATRIX_SELF->delete(& product);
+	MATRIX_SELF->delete(& projected);
+	MATRIX_SELF->delete(& weights);
+	MATRIX_SELF->delete(& solved);
+
+	return safe;
+}
+
+
+static MATRIX_SCALAR determinantRankUpdate(
+	MATRIX const * const inverse,
+	MATRIX_SCALAR determinant,
+	MATRIX const * const left,
+	MATRIX const * const right)
+{
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR * factors;
+	MATRIX_SCALAR magnitude;
+	MATRIX * product;
+	size_t rank, pivotCells, index;
+	size_t * pivots;
+	int sign;
+
+	if (! isRankUpdate(inverse, left, right))
+		return NO_VALUE;
+	if (determinant == (MATRIX_SCALAR) NO_VALUE)
+		return NO_VALUE;
+
+	rank = left->width;
+	pivotCells = (rank * sizeof(size_t) + sizeof(MATRIX_SCALAR) - 1) / sizeof(MATRIX_SCALAR);
+	buffer = allocateWorkspace(pivotCells + rank * rank);
+	product = MATRIX_SELF->create(inverse->height, rank);
+	if ((buffer == NULL) || (product == NULL))
+	{
+		freeWorkspace(buffer);
+		MATRIX_SELF->delete(& product);
+		return NO_VALUE;
+	}
+
+	pivots = (size_t *) buffer;
+	factors = buffer + pivotCells;
+
+	/* matrix determinant lemma: det(A + U ^t V) = det(C) det(A), in O(n^2 k) */
+	sign = factorCapacitance(inverse, left, right, product, factors, pivots, & magnitude);
+	determinant *= sign;
+	for (index = 0; (sign != 0) && (index < rank); index++)
+		determinant *= factors[index * rank + index];
+
+	freeWorkspace(buffer);
+	MATRIX_SELF->delete(& product);
+
+	return determinant;
+}
+
+
+
+
+static MATRIX_SCALAR cofactor(MATRIX const * const this, size_t rowIndex, size_t columnIndex)
+{
+	MATRIX * minor;
+	MATRIX_SCALAR cofactor;
+
+	minor = MATRIX_SELF->minor(this, rowIndex, columnIndex);
+
+	if ((rowIndex + columnIndex) & 1)
+		cofactor = -1 * MATRIX_SELF->determinant(minor);
+	else
+		cofactor = MATRIX_SELF->determinant(minor);
+
+	MATRIX_SELF->delete(& minor);
+
+	return cofactor;
+}
+
+
+
+
+static void multiplyAccumulate(
+	size_t height, size_t depth, size_t width,
+	MATRIX_SCALAR const * const left, size_t leftStride,
+	MATRIX_SCALAR const * const right, size_t rightStride,
+	MATRIX_SCALAR * const result, size_t resultStride)
+{
+	scaledMultiplyAccumulate(
+		height, depth, width,
+		1,
+		left, leftStride, 1,
+		right, rightStride, 1,
+		1,
+		result, resultStride);
+}
+
+
+static void scaledMultiplyAccumulate(
+	size_t height, size_t depth, size_t width,
+	MATRIX_SCALAR alpha,
+	MATRIX_SCALAR const * const left, size_t leftRowStep, size_t leftColumnStep,
+	MATRIX_SCALAR const * const right, size_t rightRowStep, size_t rightColumnStep,
+	MATRIX_SCALAR beta,
+	MATRIX_SCALAR * const result, size_t resultStride)
+{
+	size_t i, j, k;
+	size_t tileDepth, tileWidth;
+	size_t depthEnd, widthEnd;
+	MATRIX_SCALAR factor;
+	MATRIX_SCALAR const * rightRow;
+	MATRIX_SCALAR * resultRow;
+	MATRIX_SCALAR packed[PRODUCT_TILE * PRODUCT_TILE];
+
+	for (tileDepth = 0; tileDepth < depth; tileDepth += PRODUCT_TILE)
+	{
+		depthEnd = (tileDepth + PRODUCT_TILE < depth) ? tileDepth + PRODUCT_TILE : depth;
+
+		for (tileWidth = 0; tileWidth < width; tileWidth += PRODUCT_TILE)
+		{
+			widthEnd = (tileWidth + PRODUCT_TILE < width) ? tileWidth + PRODUCT_TILE : width;
+
+			/* columns of ^t B are strided, the tile is gathered once for every row of A */
+			if (rightColumnStep != 1)
+			{
+				for (k = tileDepth; k < depthEnd; k++)
+				{
+					for (j = tileWidth; j < widthEnd; j++)
+						packed[(k - tileDepth) * PRODUCT_TILE + j - tileWidth] = right[k * rightRowStep + j * rightColumnStep];
+				}
+			}
+
+			for (i = 0; i < height; i++)
+			{
+				resultRow = result + i * resultStride;
+
+				if ((tileDepth == 0) && (beta != 1))
+				{
+					for (j = tileWidth; j < widthEnd; j++)
+						resultRow[j] = (beta == 0) ? 0 : beta * resultRow[j];
+				}
+
+				for (k = tileDepth; k < depthEnd; k++)
+				{
+					factor = alpha * left[i * leftRowStep + k * leftColumnStep];
+					if (rightColumnStep != 1)
+						rightRow = packed + (k - tileDepth) * PRODUCT_TILE;
+					else
+						rightRow = right + k * rightRowStep + tileWidth;
+					for (j = 0; j < widthEnd - tileWidth; j++)
+						resultRow[tileWidth + j] += factor * rightRow[j];
+				}
+			}
+		}
+	}
+}
+
+
+static void combine(
+	size_t height, size_t width,
+	MATRIX_SCALAR const * const left, size_t leftStride,
+	MATRIX_SCALAR sign,
+	MATRIX_SCALAR const * const right, size_t rightStride,
+	MATRIX_SCALAR * const result, size_t resultStride)
+{
+	size_t rowIndex, columnIndex;
+
+	for (rowIndex = 0; rowIndex < height; rowIndex++)
+	{
+		for (columnIndex = 0; columnIndex < width; columnIndex++)
+		{
+			result[rowIndex * resultStride + columnIndex] =
+				left[rowIndex * leftStride + columnIndex] + sign * right[rowIndex * rightStride + columnIndex];
+		}
+	}
+}
+
+
+static void strassenWinograd(
+	size_t height, size_t depth, size_t width,
+	MATRIX_SCALAR const * const left, size_t leftStride,
+	MATRIX_SCALAR const * const right, size_t rightStride,
+	MATRIX_SCALAR * const result, size_t resultStride,
+	MATRIX_SCALAR * const workspace,
+	size_t crossover)
+{
+	size_t rowIndex;
+	size_t h, d, w;
+	MATRIX_SCALAR const * a11, * a12, * a21, * a22;
+	MATRIX_SCALAR const * b11, * b12, * b21, * b22;
+	MATRIX_SCALAR * c11, * c12, * c21, * c22;
+	MATRIX_SCALAR * s, * t, * p, * next;
+
+	if ((height <= crossover) || (depth <= crossover) || (width <= crossover)
+		|| ((height | depth | width) & 1))
+	{
+		for (rowIndex = 0; rowIndex < height; rowIndex++)
+			memset(result + rowIndex * resultStride, 0, width * sizeof(* result));
+		multiplyAccumulate(height, depth, width, left, leftStride, right, rightStride, result, resultStride);
+		return;
+	}
+
+	h = height / 2;
+	d = depth / 2;
+	w = width / 2;
+
+	a11 = left;
+	a12 = left + d;
+	a21 = left + h * leftStride;
+	a22 = a21 + d;
+	b11 = right;
+	b12 = right + w;
+	b21 = right + d * rightStride;
+	b22 = b21 + w;
+	c11 = result;
+	c12 = result + w;
+	c21 = result + h * resultStride;
+	c22 = c21 + w;
+
+	/* S is h*d, T is d*w, P is h*w, the rest is for deeper levels */
+	s = workspace;
+	t = s + h * d;
+	p = t + d * w;
+	next = p + h * w;
+
+	/*
+	 * P1 = A11 B11, P2 = A12 B21, P3 = S4 B22, P4 = A22 T4, P5 = S1 T1, P6 = S2 T2, P7 = S3 T3
+	 * C11 = P1 + P2, C12 = P1 + P6 + P5 + P3, C21 = P1 + P6 + P7 - P4, C22 = P1 + P6 + P7 + P5
+	 * Quadrants of C hold intermediate products until they're combined
+	 */
+
+	combine(h, d, a21, leftStride, 1, a22, leftStride, s, d); /* S1 = A21 + A22 */
+	combine(d, w, b12, rightStride, -1, b11, rightStride, t, w); /* T1 = B12 - B11 */
+	strassenWinograd(h, d, w, s, d, t, w, p, w, next, crossover); /* P = P5 */
+
+	combine(h, d, s, d, -1, a11, leftStride, s, d); /* S2 = S1 - A11 */
+	combine(d, w, b22, rightStride, -1, t, w, t, w); /* T2 = B22 - T1 */
+	strassenWinograd(h, d, w, s, d, t, w, c11, resultStride, next, crossover); /* C11 = P6 */
+
+	combine(h, d, a12, leftStride, -1, s, d, s, d); /* S4 = A12 - S2 */
+	strassenWinograd(h, d, w, s, d, b22, rightStride, c12, resultStride, next, crossover); /* C12 = P3 */
+
+	combine(d, w, t, w, -1, b21, rightStride, t, w); /* T4 = T2 - B21 */
+	strassenWinograd(h, d, w, a22, leftStride, t, w, c21, resultStride, next, crossover); /* C21 = P4 */
+
+	combine(h, d, a11, leftStride, -1, a21, leftStride, s, d); /* S3 = A11 - A21 */
+	combine(d, w, b22, rightStride, -1, b12, rightStride, t, w); /* T3 = B22 - B12 */
+	strassenWinograd(h, d, w, s, d, t, w, c22, resultStride, next, crossover); /* C22 = P7 */
+
+	combine(h, w, c22, resultStride, 1, c11, resultStride, c22, resultStride); /* C22 = P6 + P7 */
+	combine(h, w, c22, resultStride, -1, c21, resultStride, c21, resultStride); /* C21 = P6 + P7 - P4 */
+	combine(h, w, c22, resultStride, 1, p, w, c22, resultStride); /* C22 = P5 + P6 + P7 */
+	combine(h, w, c12, resultStride, 1, c11, resultStride, c12, resultStride); /* C12 = P3 + P6 */
+	combine(h, w, c12, resultStride, 1, p, w, c12, resultStride); /* C12 = P3 + P5 + P6 */
+
+	strassenWinograd(h, d, w, a11, leftStride, b11, rightStride, p, w, next, crossover); /* P = P1 */
+	combine(h, w, c12, resultStride, 1, p, w, c12, resultStride);
+	combine(h, w, c21, resultStride, 1, p, w, c21, resultStride);
+	combine(h, w, c22, resultStride, 1, p, w, c22, resultStride);
+
+	strassenWinograd(h, d, w, a12, leftStride, b21, rightStride, c11, resultStride, next, crossover); /* C11 = P2 */
+	combine(h, w, c11, resultStride, 1, p, w, c11, resultStride); /* C11 = P1 + P2 */
+}
+
+
+static size_t strassenWorkspace(size_t height, size_t depth, size_t width, size_t crossover)
+{
+	size_t cells = 0;
+
+	while ((height > crossover) && (depth > crossover) && (width > crossover)
+		&& ! ((height | depth | width) & 1))
+	{
+		height /= 2;
+		depth /= 2;
+		width /= 2;
+		cells += height * depth + depth * width + height * width;
+	}
+
+	return cells;
+}
+
+
+static size_t roundUp(size_t value, size_t unit)
+{
+	return (value + unit - 1) / unit * unit;
+}
+
+
+static void multiplyInto(
+	size_t size,
+	MATRIX_SCALAR const * const left,
+	MATRIX_SCALAR const * const right,
+	MATRIX_SCALAR * const result,
+	MATRIX_SCALAR * const workspace,
+	size_t crossover)
+{
+	TiledProduct job;
+
+	if (workspace != NULL)
+	{
+		strassenWinograd(size, size, size, left, size, right, size, result, size, workspace, crossover);
+		return;
+	}
+
+	job.height = size;
+	job.depth = size;
+	job.width = size;
+	job.alpha = 1;
+	job.left = left;
+	job.leftRowStep = size;
+	job.leftColumnStep = 1;
+	job.right = right;
+	job.rightRowStep = size;
+	job.rightColumnStep = 1;
+	job.beta = 0;
+	job.result = result;
+	job.resultStride = size;
+	multiplyInParallel(& job);
+}
+
+
+static size_t productWorkspace(size_t size, size_t crossover)
+{
+	size_t threshold;
+
+	threshold = TUNED(strassenThreshold);
+	if ((threshold == 0) || (size < threshold))
+		return 0;
+
+	return strassenWorkspace(size, size, size, crossover);
+}
+
+
+static int solveInPlace(
+	size_t size,
+	MATRIX_SCALAR * const system,
+	MATRIX_SCALAR * const rightHand,
+	size_t * const pivots)
+{
+	Factorization job;
+	size_t index, columnIndex;
+	MATRIX_SCALAR swap;
+
+	if (factorLU(size, system, pivots) == 0)
+		return 0;
+
+	/* B = P B, rows exchanged as rows of A were */
+	for (index = 0; index < size; index++)
+	{
+		for (columnIndex = 0; (pivots[index] != index) && (columnIndex < size); columnIndex++)
+		{
+			swap = rightHand[index * size + columnIndex];
+			rightHand[index * size + columnIndex] = rightHand[pivots[index] * size + columnIndex];
+			rightHand[pivots[index] * size + columnIndex] = swap;
+		}
+	}
+
+	job.size = size;
+	job.factors = system;
+	job.pivots = pivots;
+	job.blocks = (size + LU_PANEL - 1) / LU_PANEL;
+	job.singular = 0;
+	job.solution = rightHand;
+	job.stride = size;
+	inParallel(job.blocks, substitute, & job);
+
+	return 1;
+}
+
+
+static MATRIX * allocate(size_t height, size_t width, MatrixAllocator const * const allocator)
+{
+	MATRIX * this;
+	size_t stride, header, bytes, unit, rowIndex;
+	char * block;
+
+	if ((width == 0) || (height == 0))
+		return NULL;
+
+	/* rows are padded to whole multiples of the alignment */
+	unit = allocator->alignment / sizeof(MATRIX_SCALAR);
+	stride = (unit > 1) ? roundUp(width, unit) : width;
+	if (stride < width)
+		return NULL;
+	if (stride > ((size_t) -1) / sizeof(MATRIX_SCALAR) / height)
+		return NULL;
+	if (height > (((size_t) -1) / 2 - sizeof(MATRIX)) / sizeof(* this->cells))
+		return NULL;
+
+	unit = (allocator->alignment > sizeof(MATRIX_SCALAR)) ? allocator->alignment : sizeof(MATRIX_SCALAR);
+	header = roundUp(sizeof(MATRIX) + height * sizeof(* this->cells), unit);
+	bytes = height * stride * sizeof(MATRIX_SCALAR);
+	if (bytes > ((size_t) -1) - header)
+		return NULL;
+
+	block = allocator->alloc(header + bytes, allocator->alignment, allocator->context);
+	if (block == NULL)
+		return NULL;
+
+	this = (MATRIX *) block;
+	this->cells = (MATRIX_SCALAR **) (block + sizeof(MATRIX));
+	this->cells[0] = (MATRIX_SCALAR *) (block + header);
+	memset(this->cells[0], 0, bytes);
+
+	for (rowIndex = 1; rowIndex < height; rowIndex++)
+		this->cells[rowIndex] = this->cells[rowIndex - 1] + stride;
+
+	this->width = width;
+	this->height = height;
+	this->stride = stride;
+	this->layout = MATRIX_ROW_MAJOR;
+	this->allocator = * allocator;
+	this->owner = this;
+	this->references = 1;
+	this->retains = 1;
+	this->buffer = NULL;
+	this->deleter = NULL;
+	this->deleterContext = NULL;
+
+	return this;
+}
+
+
+static MATRIX * wrapCells(size_t height, size_t width, MATRIX_SCALAR * const cells, size_t stride, MatrixLayout layout)
+{
+	MATRIX * this;
+	size_t lines, length, lineIndex;
+
+	if ((cells == NULL) || (width == 0) || (height == 0))
+		return NULL;
+	if ((layout != MATRIX_ROW_MAJOR) && (layout != MATRIX_COLUMN_MAJOR))
+		return NULL;
+
+	lines = (layout == MATRIX_ROW_MAJOR) ? height : width;
+	length = (layout == MATRIX_ROW_MAJOR) ? width : height;
+	if ((stride < length) || (stride > ((size_t) -1) / sizeof(MATRIX_SCALAR) / lines))
+		return NULL;
+	if (lines > (((size_t) -1) - sizeof(MATRIX)) / sizeof(* this->cells))
+		return NULL;
+
+	/* no cells after the row pointers, which point into the buffer, [stride] cells apart */
+	this = currentAllocator.alloc(
+		sizeof(MATRIX) + lines * sizeof(* this->cells),
+		currentAllocator.alignment,
+		currentAllocator.context);
+	if (this == NULL)
+		return NULL;
+
+	this->cells = (MATRIX_SCALAR **) ((char *) this + sizeof(MATRIX));
+	for (lineIndex = 0; lineIndex < lines; lineIndex++)
+		this->cells[lineIndex] = cells + lineIndex * stride;
+
+	this->width = width;
+	this->height = height;
+	this->stride = stride;
+	this->layout = layout;
+	this->allocator = currentAllocator;
+	this->owner = this;
+	this->references = 1;
+	this->retains = 1;
+	this->buffer = cells;
+	this->deleter = NULL;
+	this->deleterContext = NULL;
+
+	return this;
+}
+
+
+static int isValidAllocator(MatrixAllocator const * const allocator)
+{
+	if ((allocator->alloc == NULL) || (allocator->free == NULL))
+		return 0;
+
+	return (allocator->alignment != 0) && ((allocator->alignment & (allocator->alignment - 1)) == 0);
+}
+
+
+static MATRIX_SPAN span(MATRIX const * const this, size_t index, int stored)
+{
+	MATRIX_SPAN result;
+
+	result.cells = NULL;
+	result.length = 0;
+	result.stride = 0;
+
+	if (this == NULL)
+		return result;
+
+	/* lines are [stride] cells apart in every block, whether allocated, wrapped or detached */
+	if (stored)
+	{
+		result.cells = this->cells[index];
+		result.length = MATRIX_LENGTH(this);
+		result.stride = 1;
+	}
+	else
+	{
+		result.cells = this->cells[0] + index;
+		result.length = MATRIX_LINES(this);
+		result.stride = this->stride;
+	}
+
+	return result;
+}
+
+
+static void writeLine(MATRIX * const this, size_t index, MATRIX_SCALAR const * const values, int stored)
+{
+	size_t lineIndex;
+
+	if (stored)
+	{
+		memcpy(this->cells[index], values, MATRIX_LENGTH(this) * sizeof(** this->cells));
+		return;
+	}
+
+	for (lineIndex = 0; lineIndex < MATRIX_LINES(this); lineIndex++)
+		this->cells[lineIndex][index] = values[lineIndex];
+}
+
+
+static void dropReference(MATRIX * const block)
+{
+	if (DECREMENT(block->references) > 0)
+		return;
+
+	freeBlock(block);
+}
+
+
+static void freeBlock(MATRIX * const block)
+{
+	MatrixAllocator owner;
+
+	if (block->deleter != NULL)
+		block->deleter(block->buffer, block->deleterContext);
+
+	/* the allocator lives in the block it frees */
+	owner = block->allocator;
+	owner.free(block, owner.context);
+}
+
+
+static void freeCells(void * const cells, void * const context)
+{
+	(void) context;
+
+	free(cells);
+}
+
+
+static void * alignedAlloc(size_t bytes, size_t alignment, void * const context)
+{
+	char * block;
+	char * aligned;
+
+	(void) context;
+
+	if (alignment < sizeof(void *))
+		alignment = sizeof(void *);
+	if (bytes > ((size_t) -1) - alignment - sizeof(void *))
+		return NULL;
+
+	block = malloc(bytes + alignment + sizeof(void *));
+	if (block == NULL)
+		return NULL;
+
+	aligned = block + sizeof(void *);
+	aligned += (alignment - (size_t) aligned % alignment) % alignment;
+	((void **) aligned)[-1] = block;
+
+	return aligned;
+}
+
+
+static void alignedFree(void * const block, void * const context)
+{
+	(void) context;
+
+	free(((void **) block)[-1]);
+}
+
+
+static MATRIX_SCALAR * allocateWorkspace(size_t count)
+{
+	if (count > ((size_t) -1) / sizeof(MATRIX_SCALAR))
+		return NULL;
+
+	return currentAllocator.alloc(count * sizeof(MATRIX_SCALAR), currentAllocator.alignment, currentAllocator.context);
+}
+
+
+static void freeWorkspace(MATRIX_SCALAR * const workspace)
+{
+	if (workspace != NULL)
+		currentAllocator.free(workspace, currentAllocator.context);
+}
+
+
+static void packCells(MATRIX const * const this, MATRIX_SCALAR * const block)
+{
+	size_t rowIndex;
+
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+		memcpy(block + rowIndex * this->width, this->cells[rowIndex], this->width * sizeof(* block));
+}
+
+
+static void unpackCells(MATRIX_SCALAR const * const block, MATRIX * const this)
+{
+	size_t rowIndex;
+
+	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+		memcpy(this->cells[rowIndex], block + rowIndex * this->width, this->width * sizeof(* block));
+}
+
+
+static int factorLU(size_t size, MATRIX_SCALAR * const factors, size_t * const pivots)
+{
+	Factorization job;
+	TaskGraph * graph;
+	size_t panel, block, task, first, previous, index, columnIndex, panelStart, workers;
+	MATRIX_SCALAR swap;
+	int sign;
+
+	job.size = size;
+	job.factors = factors;
+	job.pivots = pivots;
+	job.blocks = (size + LU_PANEL - 1) / LU_PANEL;
+	job.singular = 0;
+
+	/* tasks are added panel by panel, (panel, block) waits for (panel - 1, block) and (panel, panel) */
+	workers = TUNED(threads);
+	graph = (workers < 2) ? NULL : _TaskGraph->create(& job);
+	first = 0;
+	previous = 0;
+	for (panel = 0; (graph != NULL) && (panel < job.blocks); panel++)
+	{
+		for (block = panel; (graph != NULL) && (block < job.blocks); block++)
+		{
+			task = _TaskGraph->add(graph, factorTile, panel * job.blocks + block);
+			if (block == panel)
+				first = task;
+
+			if ((task == NO_TASK)
+				|| ((panel > 0) && ! _TaskGraph->depend(graph, task, previous + block - panel + 1))
+				|| ((block > panel) && ! _TaskGraph->depend(graph, task, first)))
+			{
+				_TaskGraph->delete(& graph);
+			}
+		}
+		previous = first;
+	}
+
+	if (graph != NULL)
+	{
+		_TaskGraph->run(graph, workers);
+		_TaskGraph->delete(& graph);
+	}
+	else
+	{
+		for (panel = 0; panel < job.blocks; panel++)
+		{
+			for (block = panel; block < job.blocks; block++)
+				factorTile(& job, panel * job.blocks + block);
+		}
+	}
+
+	/* L left of each panel gets its row exchanges last, they never read it */
+	sign = 1;
+	for (index = 0; index < size; index++)
+	{
+		if (pivots[index] == index)
+			continue;
+
+		panelStart = index - index % LU_PANEL;
+		for (columnIndex = 0; columnIndex < panelStart; columnIndex++)
+		{
+			swap = factors[pivots[index] * size + columnIndex];
+			factors[pivots[index] * size + columnIndex] = factors[index * size + columnIndex];
+			factors[index * size + columnIndex] = swap;
+		}
+		sign = -sign;
+	}
+
+	return job.singular ? 0 : sign;
+}
+
+
+static void factorTile(void * const job, size_t index)
+{
+	Factorization * const this = job;
+	size_t start, end, first, last, width;
+	size_t pivotIndex, rowIndex, columnIndex, best;
+	MATRIX_SCALAR factor, swap;
+	MATRIX_SCALAR * row;
+	MATRIX_SCALAR * pivotRow;
+
+	start = index / this->blocks * LU_PANEL;
+	end = (start + LU_PANEL < this->size) ? start + LU_PANEL : this->size;
+	first = index % this->blocks * LU_PANEL;
+	last = (first + LU_PANEL < this->size) ? first + LU_PANEL : this->size;
+	width = last - first;
+
+	if (first == start)
+	{
+		/* the panel is factored a column at a time, rows are exchanged within it */
+		for (pivotIndex = start; pivotIndex < end; pivotIndex++)
+		{
+			best = pivotIndex;
+			for (rowIndex = pivotIndex + 1; rowIndex < this->size; rowIndex++)
+			{
+				if (fabs(this->factors[rowIndex * this->size + pivotIndex]) > fabs(this->factors[best * this->size + pivotIndex]))
+					best = rowIndex;
+			}
+
+			this->pivots[pivotIndex] = best;
+
+			/* the whole column is zero below the diagonal, there is nothing to eliminate */
+			if (this->factors[best * this->size + pivotIndex] == 0)
+			{
+				this->singular = 1;
+				continue;
+			}
+
+			for (columnIndex = start; (best != pivotIndex) && (columnIndex < end); columnIndex++)
+			{
+				swap = this->factors[best * this->size + columnIndex];
+				this->factors[best * this->size + columnIndex] = this->factors[pivotIndex * this->size + columnIndex];
+				this->factors[pivotIndex * this->size + columnIndex] = swap;
+			}
+
+			pivotRow = this->factors + pivotIndex * this->size;
+			for (rowIndex = pivotIndex + 1; rowIndex < this->size; rowIndex++)
+			{
+				row = this->factors + rowIndex * this->size;
+				row[pivotIndex] /= pivotRow[pivotIndex];
+				factor = row[pivotIndex];
+				for (columnIndex = pivotIndex + 1; columnIndex < end; columnIndex++)
+					row[columnIndex] -= factor * pivotRow[columnIndex];
+			}
+		}
+
+		return;
+	}
+
+	/* rows exchanged by the panel */
+	for (pivotIndex = start; pivotIndex < end; pivotIndex++)
+	{
+		for (columnIndex = first; (this->pivots[pivotIndex] != pivotIndex) && (columnIndex < last); columnIndex++)
+		{
+			swap = this->factors[this->pivots[pivotIndex] * this->size + columnIndex];
+			this->factors[this->pivots[pivotIndex] * this->size + columnIndex] = this->factors[pivotIndex * this->size + columnIndex];
+			this->factors[pivotIndex * this->size + columnIndex] = swap;
+		}
+	}
+
+	/* rows of the panel, forward substituted with the unit lower L11 */
+	for (pivotIndex = start; pivotIndex < end; pivotIndex++)
+	{
+		pivotRow = this->factors + pivotIndex * this->size + first;
+		for (rowIndex = pivotIndex + 1; rowIndex < end; rowIndex++)
+		{
+			factor = this->factors[rowIndex * this->size + pivotIndex];
+			row = this->factors + rowIndex * this->size + first;
+			for (columnIndex = 0; columnIndex < width; columnIndex++)
+				row[columnIndex] -= factor * pivotRow[columnIndex];
+		}
+	}
+
+	scaledMultiplyAccumulate(
+		this->size - end, end - start, width,
+		-1,
+		this->factors + end * this->size + start, this->size, 1,
+		this->factors + start * this->size + first, this->size, 1,
+		1,
+		this->factors + end * this->size + first, this->size);
+}
+
+
+static void substitute(void * const job, size_t index)
+{
+	Factorization const * const this = job;
+	size_t rowIndex, other, columnIndex, first, width;
+	MATRIX_SCALAR factor;
+	MATRIX_SCALAR * row;
+	MATRIX_SCALAR const * otherRow;
+
+	first = index * LU_PANEL;
+	width = (first + LU_PANEL < this->size) ? LU_PANEL : this->size - first;
+
+	/* L Y = B, a whole range of a row at a time */
+	for (rowIndex = 1; rowIndex < this->size; rowIndex++)
+	{
+		row = this->solution + rowIndex * this->stride + first;
+		for (other = 0; other < rowIndex; other++)
+		{
+			factor = this->factors[rowIndex * this->size + other];
+			if (factor == 0)
+				continue;
+
+			otherRow = this->solution + other * this->stride + first;
+			for (columnIndex = 0; columnIndex < width; columnIndex++)
+				row[columnIndex] -= factor * otherRow[columnIndex];
+		}
+	}
+
+	/* U X = Y */
+	for (rowIndex = this->size; rowIndex-- > 0;)
+	{
+		row = this->solution + rowIndex * this->stride + first;
+		for (other = rowIndex + 1; other < this->size; other++)
+		{
+			factor = this->factors[rowIndex * this->size + other];
+			otherRow = this->solution + other * this->stride + first;
+			for (columnIndex = 0; columnIndex < width; columnIndex++)
+				row[columnIndex] -= factor * otherRow[columnIndex];
+		}
+
+		factor = this->factors[rowIndex * this->size + rowIndex];
+		for (columnIndex = 0; columnIndex < width; columnIndex++)
+			row[columnIndex] /= factor;
+	}
+}
+
+
+static void multiplyTile(void * const job, size_t index)
+{
+	TiledProduct const * const this = job;
+	size_t columnTiles, rowStart, columnStart;
+
+	columnTiles = (this->width + TASK_TILE - 1) / TASK_TILE;
+	rowStart = index / columnTiles * TASK_TILE;
+	columnStart = index % columnTiles * TASK_TILE;
+
+	scaledMultiplyAccumulate(
+		(rowStart + TASK_TILE < this->height) ? TASK_TILE : this->height - rowStart,
+		this->depth,
+		(columnStart + TASK_TILE < this->width) ? TASK_TILE : this->width - columnStart,
+		this->alpha,
+		this->left + rowStart * this->leftRowStep, this->leftRowStep, this->leftColumnStep,
+		this->right + columnStart * this->rightColumnStep, this->rightRowStep, this->rightColumnStep,
+		this->beta,
+		this->result + rowStart * this->resultStride + columnStart, this->resultStride);
+}
+
+
+static void multiplyInParallel(TiledProduct * const job)
+{
+	size_t tiles;
+
+	tiles = ((job->height + TASK_TILE - 1) / TASK_TILE) * ((job->width + TASK_TILE - 1) / TASK_TILE);
+	if ((TUNED(threads) < 2) || (tiles < 2))
+	{
+		scaledMultiplyAccumulate(
+			job->height, job->depth, job->width,
+			job->alpha,
+			job->left, job->leftRowStep, job->leftColumnStep,
+			job->right, job->rightRowStep, job->rightColumnStep,
+			job->beta,
+			job->result, job->resultStride);
+		return;
+	}
+
+	inParallel(tiles, multiplyTile, job);
+}
+
+
+static void inParallel(size_t count, void (* const task)(void * job, size_t index), void * const job)
+{
+	TaskGraph * graph;
+	size_t index, workers;
+
+	workers = TUNED(threads);
+	graph = (workers < 2) ? NULL : _TaskGraph->create(job);
+	for (index = 0; (graph != NULL) && (index < count); index++)
+	{
+		if (_TaskGraph->add(graph, task, index) == NO_TASK)
+			_TaskGraph->delete(& graph);
+	}
+
+	if (graph == NULL)
+	{
+		for (index = 0; index < count; index++)
+			task(job, index);
+		return;
+	}
+
+	_TaskGraph->run(graph, workers);
+	_TaskGraph->delete(& graph);
+}
+
+
+static int isContiguous(MATRIX const * const this)
+{
+	return (this->stride == MATRIX_LENGTH(this)) || (MATRIX_LINES(this) == 1);
+}
+
+
+static int isColumnMajor(MATRIX const * const this)
+{
+	return (this != NULL) && (this->layout == MATRIX_COLUMN_MAJOR);
+}
+
+
+static MATRIX const * stored(MATRIX const * const this, MATRIX * const view)
+{
+	if (! isColumnMajor(this))
+		return this;
+
+	* view = * this;
+	view->height = this->width;
+	view->width = this->height;
+	view->layout = MATRIX_ROW_MAJOR;
+
+	return view;
+}
+
+
+static MATRIX * relabel(MATRIX * const this)
 {
+	size_t height;
+
 	if (this == NULL)
-		return NO_VALUE;
-	return this->height;
+		return NULL;
+
+	height = this->height;
+	this->height = this->width;
+	this->width = height;
+	this->layout = isColumnMajor(this) ? MATRIX_ROW_MAJOR : MATRIX_COLUMN_MAJOR;
+
+	return this;
 }
 
 
-static void print(Matrix const * const this)
+static void transposeCells(
+	size_t lines,
+	size_t length,
+	MATRIX_SCALAR * const * const source,
+	MATRIX_SCALAR * const destination,
+	size_t stride)
 {
-	size_t rowIndex, columnIndex;
-	int isFirstCell;
+	size_t lineTile, cellTile, lineEnd, cellEnd, lineIndex, cellIndex;
 
-	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	for (lineTile = 0; lineTile < lines; lineTile += LAYOUT_TILE)
 	{
-		isFirstCell = 1;
-		for (columnIndex = 0; columnIndex < this->width; columnIndex++)
+		lineEnd = (lineTile + LAYOUT_TILE < lines) ? lineTile + LAYOUT_TILE : lines;
+		for (cellTile = 0; cellTile < length; cellTile += LAYOUT_TILE)
 		{
-			if (! isFirstCell)
-				printf("\t");
-			printf("%.2f", this->cells[rowIndex][columnIndex]);
-			isFirstCell = 0;
+			cellEnd = (cellTile + LAYOUT_TILE < length) ? cellTile + LAYOUT_TILE : length;
+			for (lineIndex = lineTile; lineIndex < lineEnd; lineIndex++)
+			{
+				for (cellIndex = cellTile; cellIndex < cellEnd; cellIndex++)
+					destination[cellIndex * stride + lineIndex] = source[lineIndex][cellIndex];
+			}
 		}
-		printf("\n");
 	}
 }
 
 
-static double getCell(Matrix const * const this, size_t ordinate, size_t abscissa)
+static MATRIX_SCALAR fold(
+	MATRIX const * const this,
+	MATRIX_SCALAR (* const function)(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * cells, size_t count, void * context),
+	MATRIX_SCALAR accumulator,
+	void * const context)
 {
-	if (this == NULL)
-		return NO_VALUE;
+	size_t chunk, offset;
 
-	if ((abscissa >= this->width) || (ordinate >= this->height))
-		return NO_VALUE;
+	chunk = isContiguous(this) ? this->height * this->width : MATRIX_LENGTH(this);
+	for (offset = 0; offset < this->height * this->width; offset += chunk)
+		accumulator = function(accumulator, this->cells[offset / MATRIX_LENGTH(this)], chunk, context);
 
-	return this->cells[ordinate][abscissa];
+	return accumulator;
 }
 
 
-static double trace(Matrix const * const this)
+static MATRIX_SCALAR foldMinimum(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * const cells, size_t count, void * const context)
 {
-	size_t coord;
-	double trace;
+	size_t index;
 
-	if (this == NULL)
-		return NO_VALUE;
+	(void) context;
 
-	if (this->height != this->width)
-		return MATRIX_IS_NOT_SQUARE;
+	for (index = 0; index < count; index++)
+		accumulator = (cells[index] < accumulator) ? cells[index] : accumulator;
 
-	trace = 0;
-	for (coord = 0; coord < this->height; coord++)
-		trace += this->cells[coord][coord];
+	return accumulator;
+}
 
-	return trace;
+
+static MATRIX_SCALAR foldMaximum(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * const cells, size_t count, void * const context)
+{
+	size_t index;
+
+	(void) context;
+
+	for (index = 0; index < count; index++)
+		accumulator = (cells[index] > accumulator) ? cells[index] : accumulator;
+
+	return accumulator;
 }
 
 
-static double determinant(Matrix const * const this)
+static MATRIX_SCALAR foldMagnitude(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * const cells, size_t count, void * const context)
 {
-	size_t rowIndex, columnIndex;
-	Matrix * cofactorsMatrix;
-	double determinant = 0;
+	size_t index;
 
-	if (this->width != this->height)
-		return MATRIX_IS_NOT_SQUARE;
+	(void) context;
 
-	if (this->height == 1)
-		return this->cells[0][0];
-	if (this->height == 2)
-		return this->cells[0][0] * this->cells[1][1] - this->cells[0][1] * this->cells[1][0];
+	for (index = 0; index < count; index++)
+		accumulator = (fabs(cells[index]) > accumulator) ? fabs(cells[index]) : accumulator;
 
-	/* TODO: we don't need the FULL cofactors matrix, only 1 row or column */
-	/* TODO: rows permutation for faster processing, instead of Laplace expansion */
+	return accumulator;
+}
 
-	cofactorsMatrix = _Matrix->cofactors(this);
-	if (cofactorsMatrix == NULL)
-		return NO_VALUE;
 
-	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+static MATRIX_SCALAR foldTotal(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * const cells, size_t count, void * const context)
+{
+	MATRIX_SCALAR partial[FOLD_LANES];
+	size_t index, lane;
+
+	(void) context;
+
+	for (lane = 0; lane < FOLD_LANES; lane++)
+		partial[lane] = 0;
+
+	for (index = 0; index + FOLD_LANES <= count; index += FOLD_LANES)
 	{
-		for (columnIndex = 0; columnIndex < cofactorsMatrix->width; columnIndex++)
-			determinant += this->cells[rowIndex][columnIndex] * cofactorsMatrix->cells[0][columnIndex];
+		for (lane = 0; lane < FOLD_LANES; lane++)
+			partial[lane] += cells[index + lane];
 	}
+	for (; index < count; index++)
+		partial[0] += cells[index];
 
-	_Matrix->delete(& cofactorsMatrix);
+	for (lane = 0; lane < FOLD_LANES; lane++)
+		accumulator += partial[lane];
 
-	return determinant;
+	return accumulator;
 }
 
 
-static Matrix * minor(Matrix const * const this, size_t rowIndex, size_t columnIndex)
+static MATRIX_SCALAR foldScaledSquares(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * const cells, size_t count, void * const context)
 {
-	Matrix * minor;
-	size_t sourceRowIndex, sourceColumnIndex;
-	size_t destRowIndex, destColumnIndex;
+	MATRIX_SCALAR partial[FOLD_LANES];
+	MATRIX_SCALAR inverseScale, scaled;
+	size_t index, lane;
 
-	if (this->height < 2)
-		return NULL;
+	inverseScale = 1 / * (MATRIX_SCALAR const *) context;
 
-	minor = _Matrix->create(this->height - 1, this->width - 1);
-	if (minor == NULL)
-		return NULL;
+	for (lane = 0; lane < FOLD_LANES; lane++)
+		partial[lane] = 0;
 
-	for (sourceRowIndex = destRowIndex = 0; sourceRowIndex < this->height; sourceRowIndex++)
+	for (index = 0; index + FOLD_LANES <= count; index += FOLD_LANES)
 	{
-		if (sourceRowIndex == rowIndex)
-			continue;
-
-		for (sourceColumnIndex = destColumnIndex = 0; sourceColumnIndex < this->width; sourceColumnIndex++)
+		for (lane = 0; lane < FOLD_LANES; lane++)
 		{
-			if (sourceColumnIndex == columnIndex)
-				continue;
-
-			minor->cells[destRowIndex][destColumnIndex] = this->cells[sourceRowIndex][sourceColumnIndex];
-			destColumnIndex++;
+			scaled = cells[index + lane] * inverseScale;
+			partial[lane] += scaled * scaled;
 		}
-
-		destRowIndex++;
+	}
+	for (; index < count; index++)
+	{
+		scaled = cells[index] * inverseScale;
+		partial[0] += scaled * scaled;
 	}
 
-	return minor;
+	for (lane = 0; lane < FOLD_LANES; lane++)
+		accumulator += partial[lane];
+
+	return accumulator;
 }
 
 
-static Matrix * cofactors(Matrix const * const this)
+static MATRIX * assemble(size_t rows, size_t columns, MATRIX const * const * const blocks)
 {
-	size_t rowIndex, columnIndex;
-	Matrix * cofactors;
+	size_t * heights;
+	size_t * widths;
+	size_t height, width, row, column, rowIndex, top, left;
+	MATRIX const * block;
+	MATRIX * assembled;
 
-	if (this->height != this->width)
-		return NULL;
-	if (this->height < 2)
+	if (rows > ((size_t) -1) / sizeof(size_t) - columns)
 		return NULL;
 
-	cofactors = _Matrix->create(this->height, this->width);
-	if (cofactors == NULL)
+	heights = malloc((rows + columns) * sizeof(size_t));
+	if (heights == NULL)
 		return NULL;
+	widths = heights + rows;
 
-	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
-	{
-		for (columnIndex = 0; columnIndex < this->width; columnIndex++)
-			cofactors->cells[rowIndex][columnIndex] = cofactor(this, rowIndex, columnIndex);
-	}
+	/* sizes of grid rows and columns, 0 until a block gives them */
+	for (row = 0; row < rows; row++)
+		heights[row] = 0;
+	for (column = 0; column < columns; column++)
+		widths[column] = 0;
 
-	return cofactors;
-}
+	for (row = 0; row < rows; row++)
+	{
+		for (column = 0; column < columns; column++)
+		{
+			block = blocks[row * columns + column];
+			if (block == NULL)
+				continue;
 
+			if (((heights[row] != 0) && (heights[row] != block->height))
+				|| ((widths[column] != 0) && (widths[column] != block->width)))
+			{
+				free(heights);
+				return NULL;
+			}
+			heights[row] = block->height;
+			widths[column] = block->width;
+		}
+	}
 
-static Matrix * transpose(Matrix const * const this)
-{
-	Matrix * transpose;
-	size_t rowIndex, columnIndex;
+	height = 0;
+	width = 0;
+	for (row = 0; (row < rows) && (heights[row] != 0) && (height <= ((size_t) -1) - heights[row]); row++)
+		height += heights[row];
+	for (column = 0; (column < columns) && (widths[column] != 0) && (width <= ((size_t) -1) - widths[column]); column++)
+		width += widths[column];
 
-	transpose = _Matrix->create(this->width, this->height);
-	if (transpose == NULL)
+	/* a grid row or column without any block, or sizes overflowing */
+	assembled = ((row < rows) || (column < columns)) ? NULL : MATRIX_SELF->create(height, width);
+	if (assembled == NULL)
+	{
+		free(heights);
 		return NULL;
+	}
 
-	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	/* zero blocks are left as create() made them */
+	top = 0;
+	for (row = 0; row < rows; row++)
 	{
-		for (columnIndex = 0; columnIndex < this->width; columnIndex++)
-			transpose->cells[columnIndex][rowIndex] = this->cells[rowIndex][columnIndex];
+		left = 0;
+		for (column = 0; column < columns; column++)
+		{
+			block = blocks[row * columns + column];
+			if (isColumnMajor(block))
+				transposeCells(block->width, block->height, block->cells, assembled->cells[top] + left, assembled->stride);
+			for (rowIndex = 0; (block != NULL) && ! isColumnMajor(block) && (rowIndex < block->height); rowIndex++)
+				memcpy(assembled->cells[top + rowIndex] + left, block->cells[rowIndex], block->width * sizeof(MATRIX_SCALAR));
+			left += widths[column];
+		}
+		top += heights[row];
 	}
 
-	return transpose;
+	free(heights);
+
+	return assembled;
 }
 
 
-static Matrix * adjugate(Matrix const * const this)
+static MATRIX_SCALAR determinantLU(MATRIX const * const this)
 {
-	Matrix * cofactorsMatrix;
-	Matrix * adjugate;
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR * factors;
+	MATRIX_SCALAR determinant;
+	size_t size, pivotCells, index;
+	int sign;
+
+	/* pivots come first in the workspace, which is suitably aligned for them */
+	size = this->height;
+	pivotCells = (size * sizeof(size_t) + sizeof(MATRIX_SCALAR) - 1) / sizeof(MATRIX_SCALAR);
+	buffer = allocateWorkspace(pivotCells + size * size);
+	if (buffer == NULL)
+		return NO_VALUE;
 
-	if (this == NULL)
-		return NULL;
+	factors = buffer + pivotCells;
+	packCells(this, factors);
 
-	cofactorsMatrix = _Matrix->cofactors(this);
-	if (cofactorsMatrix == NULL)
-		return NULL;
+	sign = factorLU(size, factors, (size_t *) buffer);
 
-	adjugate = _Matrix->transpose(cofactorsMatrix);
+	determinant = sign;
+	for (index = 0; (sign != 0) && (index < size); index++)
+		determinant *= factors[index * size + index];
 
-	_Matrix->delete(& cofactorsMatrix);
+	freeWorkspace(buffer);
 
-	return adjugate;
+	return determinant;
 }
 
 
-static Matrix * sum(Matrix const * const left, Matrix const * const right)
+static MATRIX * inverseLU(MATRIX const * const this)
 {
-	size_t rowIndex, columnIndex;
-	Matrix * sum;
-
-	if ((left == NULL) || (right == NULL))
-		return NULL;
-	if (left->width != right->width)
+	Factorization job;
+	MATRIX * inverse;
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR swap;
+	size_t size, pivotCells, index, columnIndex;
+	size_t * pivots;
+
+	size = this->height;
+	inverse = MATRIX_SELF->create(size, size);
+	if (inverse == NULL)
 		return NULL;
-	if (left->height != right->height)
+
+	pivotCells = (size * sizeof(size_t) + sizeof(MATRIX_SCALAR) - 1) / sizeof(MATRIX_SCALAR);
+	buffer = allocateWorkspace(pivotCells + size * size);
+	if (buffer == NULL)
+	{
+		MATRIX_SELF->delete(& inverse);
 		return NULL;
+	}
 
-	sum = _Matrix->copy(left);
-	if (sum == NULL)
+	pivots = (size_t *) buffer;
+	job.size = size;
+	job.factors = buffer + pivotCells;
+	job.blocks = (size + LU_PANEL - 1) / LU_PANEL;
+	packCells(this, job.factors);
+
+	if (factorLU(size, job.factors, pivots) == 0)
+	{
+		freeWorkspace(buffer);
+		MATRIX_SELF->delete(& inverse);
 		return NULL;
+	}
 
-	for (rowIndex = 0; rowIndex < left->height; rowIndex++)
+	/* B = P Id, rows of the identity exchanged as rows of A were */
+	for (index = 0; index < size; index++)
+		inverse->cells[index][index] = 1;
+	for (index = 0; index < size; index++)
 	{
-		for (columnIndex = 0; columnIndex < left->width; columnIndex++)
-			sum->cells[rowIndex][columnIndex] += right->cells[rowIndex][columnIndex];
+		for (columnIndex = 0; (pivots[index] != index) && (columnIndex < size); columnIndex++)
+		{
+			swap = inverse->cells[index][columnIndex];
+			inverse->cells[index][columnIndex] = inverse->cells[pivots[index]][columnIndex];
+			inverse->cells[pivots[index]][columnIndex] = swap;
+		}
 	}
 
-	return sum;
-}
+	job.solution = inverse->cells[0];
+	job.stride = inverse->stride;
+	inParallel(job.blocks, substitute, & job);
 
+	freeWorkspace(buffer);
 
-static Matrix * product(Matrix const * const left, Matrix const * const right)
-{
-	Matrix * product;
-	/*
-	 * A ∈ M(a,b), B ∈ M(b,c) => AB ∈ M(a,c)
-	 * Pi,j = ∑_i=1->n Ai,k * Bk,j
-	 */
-	size_t i, j, k;
+	return inverse;
+}
 
-	if ((left == NULL) || (right == NULL))
-		return NULL;
 
-	if (left->width != right->height)
-		return NULL;
 
-	product = _Matrix->create(left->height, right->width);
-	if (product == NULL)
-		return NULL;
+static void solveFactored(
+	size_t size,
+	MATRIX_SCALAR const * const factors,
+	size_t const * const pivots,
+	MATRIX_SCALAR * const vector,
+	int transposed)
+{
+	size_t rowIndex, index;
+	MATRIX_SCALAR swap, value;
+	MATRIX_SCALAR const * row;
 
-	for (i = 0; i < left->height; i++)
+	if (! transposed)
 	{
-		for (j = 0; j < right->width; j++)
+		/* L U x = P b */
+		for (index = 0; index < size; index++)
+		{
+			swap = vector[index];
+			vector[index] = vector[pivots[index]];
+			vector[pivots[index]] = swap;
+		}
+
+		for (rowIndex = 1; rowIndex < size; rowIndex++)
 		{
-			for (k = 0; k < left->width; k++)
-				product->cells[i][j] += left->cells[i][k] * right->cells[k][j];
+			row = factors + rowIndex * size;
+			value = vector[rowIndex];
+			for (index = 0; index < rowIndex; index++)
+				value -= row[index] * vector[index];
+			vector[rowIndex] = value;
 		}
+
+		for (rowIndex = size; rowIndex-- > 0;)
+		{
+			row = factors + rowIndex * size;
+			value = vector[rowIndex];
+			for (index = rowIndex + 1; index < size; index++)
+				value -= row[index] * vector[index];
+			vector[rowIndex] = value / row[rowIndex];
+		}
+
+		return;
 	}
 
-	return product;
+	/* ^t U ^t L P x = b, rows of U and L are read as columns of their transposes */
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+	{
+		row = factors + rowIndex * size;
+		vector[rowIndex] /= row[rowIndex];
+		for (index = rowIndex + 1; index < size; index++)
+			vector[index] -= row[index] * vector[rowIndex];
+	}
+
+	for (rowIndex = size; rowIndex-- > 1;)
+	{
+		row = factors + rowIndex * size;
+		for (index = 0; index < rowIndex; index++)
+			vector[index] -= row[index] * vector[rowIndex];
+	}
+
+	for (index = size; index-- > 0;)
+	{
+		swap = vector[index];
+		vector[index] = vector[pivots[index]];
+		vector[pivots[index]] = swap;
+	}
 }
 
 
-static Matrix * scalarProduct(Matrix const * const this, double scalar)
+static int orthogonalizeColumns(size_t length, size_t count, MATRIX_SCALAR * const columns, MATRIX_SCALAR * const vectors)
 {
-	size_t rowIndex, columnIndex;
-	Matrix * product;
+	JacobiRound round;
+	MATRIX_SCALAR * buffer;
+	size_t players, pairCount, pairCells, sweep, turn, index;
+	int rotated;
+
+	players = count + count % 2;
+	pairCount = players / 2;
+	pairCells = (2 * pairCount * sizeof(size_t) + pairCount + sizeof(MATRIX_SCALAR) - 1) / sizeof(MATRIX_SCALAR);
+	buffer = allocateWorkspace(pairCells);
+	if (buffer == NULL)
+		return 0;
 
-	if (this == NULL)
-		return NULL;
+	round.length = length;
+	round.count = count;
+	round.columns = columns;
+	round.vectors = vectors;
+	round.pairs = (size_t *) buffer;
+	round.rotated = (unsigned char *) (round.pairs + 2 * pairCount);
 
-	product = _Matrix->create(this->height, this->width);
-	if (product == NULL)
-		return NULL;
+	for (index = 0; index < count * count; index++)
+		vectors[index] = (index % (count + 1) == 0) ? 1 : 0;
 
-	for (rowIndex = 0; rowIndex < this->height; rowIndex++)
+	for (sweep = 0; sweep < JACOBI_SWEEPS; sweep++)
 	{
-		for (columnIndex = 0; columnIndex < this->width; columnIndex++)
-			product->cells[rowIndex][columnIndex] = scalar * this->cells[rowIndex][columnIndex];
+		rotated = 0;
+
+		/* the circle method: one column stays, the others turn, every pair meets once in [players] - 1 rounds */
+		for (turn = 0; turn + 1 < players; turn++)
+		{
+			round.pairs[0] = turn;
+			round.pairs[1] = players - 1;
+			for (index = 1; index < pairCount; index++)
+			{
+				round.pairs[2 * index] = (turn + index) % (players - 1);
+				round.pairs[2 * index + 1] = (turn + players - 1 - index) % (players - 1);
+			}
+
+			/* pairs of a round are disjoint, the result doesn't depend on how many threads rotate them */
+			if (length * pairCount < TASK_TILE * TASK_TILE)
+			{
+				for (index = 0; index < pairCount; index++)
+					rotatePair(& round, index);
+			}
+			else
+				inParallel(pairCount, rotatePair, & round);
+
+			for (index = 0; index < pairCount; index++)
+				rotated |= round.rotated[index];
+		}
+
+		if (! rotated)
+			break;
 	}
 
-	return product;
+	freeWorkspace(buffer);
+
+	return 1;
 }
 
 
-static int isInvertible(Matrix const * const this)
+static void rotatePair(void * const job, size_t index)
 {
-	if (this == NULL)
-		return 0;
-	if (this->height != this->width)
-		return 0;
+	JacobiRound * const round = job;
+	MATRIX_SCALAR * first;
+	MATRIX_SCALAR * second;
+	MATRIX_SCALAR alpha, beta, gamma, zeta, t, c, s, x, y;
+	size_t row;
+
+	round->rotated[index] = 0;
+	if ((round->pairs[2 * index] >= round->count) || (round->pairs[2 * index + 1] >= round->count))
+		return;
 
-	return _Matrix->determinant(this) != 0;
-}
+	first = round->columns + round->pairs[2 * index] * round->length;
+	second = round->columns + round->pairs[2 * index + 1] * round->length;
+	alpha = dotColumns(round->length, first, first);
+	beta = dotColumns(round->length, second, second);
+	gamma = dotColumns(round->length, first, second);
 
+	/* orthogonal up to the rounding of the dot products */
+	if (fabs(gamma) <= sqrt((MATRIX_SCALAR) round->length) * MATRIX_EPSILON * sqrt(alpha) * sqrt(beta))
+		return;
 
-static Matrix * inverse(Matrix const * const this)
-{
-	double determinant;
-	Matrix * adjugate;
-	Matrix * inverse;
+	/* the rotation diagonalizing the Gram matrix { { α, γ }, { γ, β } } of the pair */
+	zeta = (beta - alpha) / (2 * gamma);
+	t = 1 / (fabs(zeta) + sqrt(1 + zeta * zeta));
+	if (zeta < 0)
+		t = -t;
+	c = 1 / sqrt(1 + t * t);
+	s = c * t;
 
-	if (this == NULL)
-		return NULL;
+	for (row = 0; row < round->length; row++)
+	{
+		x = first[row];
+		y = second[row];
+		first[row] = c * x - s * y;
+		second[row] = s * x + c * y;
+	}
 
-	if (this->height != this->width)
-		return NULL;
+	first = round->vectors + round->pairs[2 * index] * round->count;
+	second = round->vectors + round->pairs[2 * index + 1] * round->count;
+	for (row = 0; row < round->count; row++)
+	{
+		x = first[row];
+		y = second[row];
+		first[row] = c * x - s * y;
+		second[row] = s * x + c * y;
+	}
 
-	determinant = _Matrix->determinant(this);
-	if ((determinant == 0) || (determinant == NO_VALUE))
-		return NULL;
+	round->rotated[index] = 1;
+}
 
-	adjugate = _Matrix->adjugate(this);
-	if (adjugate == NULL)
-		return NULL;
 
-	inverse = _Matrix->scalarProduct(adjugate, 1.0 / determinant);
+static MATRIX_SCALAR dotColumns(size_t length, MATRIX_SCALAR const * const x, MATRIX_SCALAR const * const y)
+{
+	MATRIX_SCALAR sums[4] = { 0, 0, 0, 0 };
+	size_t index;
 
-	_Matrix->delete(& adjugate);
+	for (index = 0; index + 4 <= length; index += 4)
+	{
+		sums[0] += x[index] * y[index];
+		sums[1] += x[index + 1] * y[index + 1];
+		sums[2] += x[index + 2] * y[index + 2];
+		sums[3] += x[index + 3] * y[index + 3];
+	}
+	for (; index < length; index++)
+		sums[0] += x[index] * y[index];
 
-	return inverse;
+	return (sums[0] + sums[1]) + (sums[2] + sums[3]);
 }
 
 
+static int isRankUpdate(MATRIX const * const inverse, MATRIX const * const left, MATRIX const * const right)
+{
+	if ((inverse == NULL) || (left == NULL) || (right == NULL))
+		return 0;
+	if (inverse->height != inverse->width)
+		return 0;
+
+	return (left->height == inverse->height) && (right->height == inverse->height) && (left->width == right->width);
+}
 
 
-static double cofactor(Matrix const * const this, size_t rowIndex, size_t columnIndex)
+static int factorCapacitance(
+	MATRIX const * const inverse,
+	MATRIX const * const left,
+	MATRIX const * const right,
+	MATRIX * const product,
+	MATRIX_SCALAR * const factors,
+	size_t * const pivots,
+	MATRIX_SCALAR * const magnitude)
 {
-	Matrix * minor;
-	double cofactor;
-
-	minor = _Matrix->minor(this, rowIndex, columnIndex);
+	size_t rank, rowIndex, columnIndex, index;
+	MATRIX_SCALAR value, column;
 
-	if ((rowIndex + columnIndex) & 1)
-		cofactor = -1 * _Matrix->determinant(minor);
-	else
-		cofactor = _Matrix->determinant(minor);
+	rank = left->width;
+	MATRIX_SELF->gemm(1, inverse, 0, left, 0, 0, product);
 
-	_Matrix->delete(& minor);
+	/* ^t V (A^(-1) U) is only k*k, summed along the n rows of both */
+	* magnitude = 0;
+	for (columnIndex = 0; columnIndex < rank; columnIndex++)
+	{
+		column = 0;
+		for (rowIndex = 0; rowIndex < rank; rowIndex++)
+		{
+			value = 0;
+			for (index = 0; index < product->height; index++)
+				value += MATRIX_CELL(right, index, rowIndex) * product->cells[index][columnIndex];
+			column += fabs(value);
+			factors[rowIndex * rank + columnIndex] = value + ((rowIndex == columnIndex) ? 1 : 0);
+		}
+		if (column > * magnitude)
+			* magnitude = column;
+	}
+	* magnitude += 1;
 
-	return cofactor;
+	return factorLU(rank, factors, pivots);
 }
 
 
 
-
-static MatrixMethods methods =
+static MATRIX_METHODS const methods =
 {
 	create,
+	createWith,
 	delete,
+	setAllocator,
 	identity,
 	isIdentity,
 	copy,
+	retain,
+	release,
+	isShared,
+	detach,
+	convert,
 	fromRows,
 	fromColumns,
+	fromBuffer,
+	wrap,
+	adopt,
 	width,
 	height,
+	layout,
+	toLayout,
 	print,
 	getCell,
+	setCell,
+	row,
+	column,
+	setRow,
+	setColumn,
+	fill,
+	copyRegion,
 	trace,
 	determinant,
 	minor,
@@ -571,8 +4055,148 @@ static MatrixMethods methods =
 	adjugate,
 	sum,
 	product,
+	gemm,
+	strassenProduct,
+	tuneStrassen,
+	tuneLU,
+	setThreads,
 	scalarProduct,
+	hadamard,
+	clamp,
+	map,
+	zip,
+	reduce,
+	minimum,
+	maximum,
+	total,
+	frobeniusNorm,
+	kronecker,
+	hconcat,
+	vconcat,
+	blockAssemble,
+	norm,
+	rcond,
 	isInvertible,
-	inverse
+	isWellConditioned,
+	inverse,
+	power,
+	exponential,
+	svd,
+	pinv,
+	lowRank,
+	inverseRankUpdate,
+	determinantRankUpdate
 };
-MatrixMethods const * const _Matrix = & methods;
+MATRIX_METHODS const * MATRIX_SELF = & methods;
+
+
+
+
+MATRIX * MATRIX_FROM_LINES(
+	size_t height, size_t width, MatrixLayout layout,
+	MATRIX_SCALAR const * const first, va_list rest)
+{
+	size_t const lines = (layout == MATRIX_ROW_MAJOR) ? height : width;
+	size_t const length = (layout == MATRIX_ROW_MAJOR) ? width : height;
+	size_t lineIndex;
+	MATRIX_SCALAR const * line;
+
+	/* a column-major A is the row-major ^t A, whose rows are the columns of A */
+	MATRIX * this = MATRIX_SELF->create(lines, length);
+	if (this == NULL)
+		return NULL;
+
+	line = first;
+	for (lineIndex = 0; lineIndex < lines; lineIndex++)
+	{
+		memcpy(this->cells[lineIndex], line, length * sizeof(this->cells[lineIndex][0]));
+		if (lineIndex + 1 < lines)
+			line = va_arg(rest, MATRIX_SCALAR *);
+	}
+
+	return (layout == MATRIX_COLUMN_MAJOR) ? relabel(this) : this;
+}
+
+
+MATRIX_SCALAR MATRIX_RCOND_FACTORED(
+	size_t size, MATRIX_SCALAR const * const factors, size_t const * const pivots,
+	int transposed, MATRIX_SCALAR normA)
+{
+	MATRIX_SCALAR * buffer;
+	MATRIX_SCALAR * x;
+	MATRIX_SCALAR * z;
+	MATRIX_SCALAR estimate, candidate, alternative;
+	size_t index, iteration, best, previous;
+
+	if (normA == 0)
+		return 0;
+	for (index = 0; index < size; index++)
+	{
+		if (factors[index * size + index] == 0)
+			return 0;
+	}
+
+	buffer = allocateWorkspace(2 * size);
+	if (buffer == NULL)
+		return NO_VALUE;
+	x = buffer;
+	z = x + size;
+
+	/*
+	 * Hager: ||A^(-1)||1 is the maximum of the convex ||A^(-1) x||1 over the unit ball, reached on a vertex e_j;
+	 * the subgradient A^(-T) sign(A^(-1) x) points to a better vertex until none is
+	 */
+	for (index = 0; index < size; index++)
+		x[index] = 1.0 / size;
+	estimate = 0;
+	previous = size;
+	for (iteration = 0; iteration < RCOND_ITERATIONS; iteration++)
+	{
+		solveFactored(size, factors, pivots, x, transposed);
+		candidate = 0;
+		for (index = 0; index < size; index++)
+			candidate += fabs(x[index]);
+		if ((iteration > 0) && (candidate <= estimate))
+			break;
+		estimate = candidate;
+
+		for (index = 0; index < size; index++)
+			z[index] = (x[index] < 0) ? -1 : 1;
+		solveFactored(size, factors, pivots, z, ! transposed);
+
+		best = 0;
+		for (index = 1; index < size; index++)
+		{
+			if (fabs(z[index]) > fabs(z[best]))
+				best = index;
+		}
+		if (best == previous)
+			break;
+		previous = best;
+
+		for (index = 0; index < size; index++)
+			x[index] = 0;
+		x[best] = 1;
+	}
+
+	/* Higham: an alternating vector, for the matrices the ascent stops too early on */
+	for (index = 0; index < size; index++)
+		x[index] = ((index % 2 == 0) ? 1 : -1) * (1 + (MATRIX_SCALAR) index / ((size > 1) ? size - 1 : 1));
+	solveFactored(size, factors, pivots, x, transposed);
+	alternative = 0;
+	for (index = 0; index < size; index++)
+		alternative += fabs(x[index]);
+	alternative = 2 * alternative / (3 * size);
+	if (alternative > estimate)
+		estimate = alternative;
+
+	freeWorkspace(buffer);
+
+	return 1 / (normA * estimate);
+}
+
+
+size_t MATRIX_THREADS(void)
+{
+	return TUNED(threads);
+}
@@ -0,0 +1,557 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "MatrixAsync.h"
+#include "Factorization.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+
+
+
+typedef enum
+{
+	PRODUCT,
+	INVERSE,
+	SOLVE
+} Operation;
+
+
+struct MatrixHandle
+{
+	Operation operation;
+
+	/* operands, [right] for products only, [rightHand] for resolutions only */
+	Matrix const * left;
+	Matrix const * right;
+	Vector const * rightHand;
+
+	/* results, until taken */
+	Matrix * matrix;
+	Vector * vector;
+
+	MatrixAsyncStatus status;
+
+	/* set once the callback has returned, wait and delete block until then */
+	int over;
+	pthread_cond_t ended;
+
+	void (* callback)(MatrixHandle * handle, void * context);
+	void * context;
+
+	/* next queued handle */
+	MatrixHandle * next;
+};
+
+
+
+
+/**
+ * Allocates a pending handle
+ *
+ * @return - the handle, or NULL if allocation failed
+ */
+static MatrixHandle * createHandle(Operation operation, Matrix const * left, Matrix const * right, Vector const * rightHand);
+
+/**
+ * Ends [this] with [status] right away, for operands rejected before being queued
+ *
+ * @return - [this]
+ */
+static MatrixHandle * reject(MatrixHandle * this, MatrixAsyncStatus status);
+
+/**
+ * Queues [this], starting a pool thread if none is idle and the limit allows it
+ * If no pool thread could ever be started, the operation runs on the calling thread
+ *
+ * @return - [this]
+ */
+static MatrixHandle * submit(MatrixHandle * this);
+
+/**
+ * Computes the result of [this], sets its status, then calls its callback
+ */
+static void execute(MatrixHandle * this);
+
+/**
+ * Factors [this] as P A = L U, for inverses and resolutions to substitute with
+ *
+ * @param status - receives MATRIX_ASYNC_SINGULAR or MATRIX_ASYNC_OUT_OF_MEMORY if factoring failed
+ *
+ * @return - the factorization, or NULL if A is singular or allocation failed
+ */
+static Factorization * factor(Matrix const * this, MatrixAsyncStatus * status);
+
+/**
+ * A^(-1), a column at a time, solving L U x = P e_j
+ *
+ * @return - the inverse, or NULL if allocation failed
+ */
+static Matrix * invert(Factorization const * factorization);
+
+/**
+ * Runs queued operations, forever
+ *
+ * @param unused - for pthread_create
+ *
+ * @return - NULL, never reached: pool threads serve until the process exits
+ */
+static void * serve(void * unused);
+
+
+
+
+/* guards the queue, the pool counters, and the status, results and callback of every handle */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* signaled when an operation is queued */
+static pthread_cond_t queued = PTHREAD_COND_INITIALIZER;
+
+static MatrixHandle * first = NULL;
+static MatrixHandle * last = NULL;
+static size_t waiting = 0;
+
+static size_t workers = MATRIX_ASYNC_DEFAULT_WORKERS;
+static size_t started = 0;
+static size_t idle = 0;
+
+
+
+
+static MatrixHandle * productAsync(Matrix const * const left, Matrix const * const right)
+{
+	MatrixHandle * this;
+
+	this = createHandle(PRODUCT, left, right, NULL);
+	if (this == NULL)
+		return NULL;
+
+	if ((left == NULL) || (right == NULL))
+		return reject(this, MATRIX_ASYNC_INVALID_ARGUMENT);
+	if (_Matrix->width(left) != _Matrix->height(right))
+		return reject(this, MATRIX_ASYNC_SIZE_MISMATCH);
+
+	return submit(this);
+}
+
+
+static MatrixHandle * inverseAsync(Matrix const * const this)
+{
+	MatrixHandle * handle;
+
+	handle = createHandle(INVERSE, this, NULL, NULL);
+	if (handle == NULL)
+		return NULL;
+
+	if (this == NULL)
+		return reject(handle, MATRIX_ASYNC_INVALID_ARGUMENT);
+	if (_Matrix->width(this) != _Matrix->height(this))
+		return reject(handle, MATRIX_ASYNC_SIZE_MISMATCH);
+
+	return submit(handle);
+}
+
+
+static MatrixHandle * solveAsync(Matrix const * const this, Vector const * const rightHand)
+{
+	MatrixHandle * handle;
+
+	handle = createHandle(SOLVE, this, NULL, rightHand);
+	if (handle == NULL)
+		return NULL;
+
+	if ((this == NULL) || (rightHand == NULL))
+		return reject(handle, MATRIX_ASYNC_INVALID_ARGUMENT);
+	if ((_Matrix->width(this) != _Matrix->height(this)) || (_Vector->size(rightHand) != _Matrix->height(this)))
+		return reject(handle, MATRIX_ASYNC_SIZE_MISMATCH);
+
+	return submit(handle);
+}
+
+
+static int poll(MatrixHandle const * const this)
+{
+	int over;
+
+	if (this == NULL)
+		return 0;
+
+	pthread_mutex_lock(& lock);
+	over = this->over;
+	pthread_mutex_unlock(& lock);
+
+	return over;
+}
+
+
+static MatrixAsyncStatus wait(MatrixHandle * const this)
+{
+	MatrixAsyncStatus status;
+
+	if (this == NULL)
+		return MATRIX_ASYNC_INVALID_ARGUMENT;
+
+	pthread_mutex_lock(& lock);
+	while (! this->over)
+		pthread_cond_wait(& this->ended, & lock);
+	status = this->status;
+	pthread_mutex_unlock(& lock);
+
+	return status;
+}
+
+
+static int onCompletion(MatrixHandle * const this, void (* const callback)(MatrixHandle * handle, void * context), void * const context)
+{
+	int pending;
+
+	if ((this == NULL) || (callback == NULL))
+		return 0;
+
+	pthread_mutex_lock(& lock);
+	pending = (this->status == MATRIX_ASYNC_PENDING);
+	if (pending)
+	{
+		this->callback = callback;
+		this->context = context;
+	}
+	pthread_mutex_unlock(& lock);
+
+	if (! pending)
+		callback(this, context);
+
+	return 1;
+}
+
+
+static MatrixAsyncStatus status(MatrixHandle const * const this)
+{
+	MatrixAsyncStatus status;
+
+	if (this == NULL)
+		return MATRIX_ASYNC_INVALID_ARGUMENT;
+
+	pthread_mutex_lock(& lock);
+	status = this->status;
+	pthread_mutex_unlock(& lock);
+
+	return status;
+}
+
+
+static Matrix * takeMatrix(MatrixHandle * const this)
+{
+	Matrix * result;
+
+	if (this == NULL)
+		return NULL;
+
+	pthread_mutex_lock(& lock);
+	result = this->matrix;
+	this->matrix = NULL;
+	pthread_mutex_unlock(& lock);
+
+	return result;
+}
+
+
+static Vector * takeVector(MatrixHandle * const this)
+{
+	Vector * result;
+
+	if (this == NULL)
+		return NULL;
+
+	pthread_mutex_lock(& lock);
+	result = this->vector;
+	this->vector = NULL;
+	pthread_mutex_unlock(& lock);
+
+	return result;
+}
+
+
+static void delete(MatrixHandle ** const this)
+{
+	if (this == NULL)
+		return;
+	if (* this == NULL)
+		return;
+
+	wait(* this);
+
+	_Matrix->delete(& (* this)->matrix);
+	_Vector->delete(& (* this)->vector);
+	pthread_cond_destroy(& (* this)->ended);
+
+	free(* this);
+	* this = NULL;
+}
+
+
+static void setWorkers(size_t count)
+{
+	pthread_mutex_lock(& lock);
+	workers = (count == 0) ? 1 : count;
+	pthread_mutex_unlock(& lock);
+}
+
+
+
+
+static MatrixHandle * createHandle(Operation operation, Matrix const * const left, Matrix const * const right, Vector const * const rightHand)
+{
+	MatrixHandle * this;
+
+	this = malloc(sizeof(* this));
+	if (this == NULL)
+		return NULL;
+
+	if (pthread_cond_init(& this->ended, NULL) != 0)
+	{
+		free(this);
+		return NULL;
+	}
+
+	this->operation = operation;
+	this->left = left;
+	this->right = right;
+	this->rightHand = rightHand;
+	this->matrix = NULL;
+	this->vector = NULL;
+	this->status = MATRIX_ASYNC_PENDING;
+	this->over = 0;
+	this->callback = NULL;
+	this->context = NULL;
+	this->next = NULL;
+
+	return this;
+}
+
+
+static MatrixHandle * reject(MatrixHandle * const this, MatrixAsyncStatus status)
+{
+	/* nobody else knows the handle yet */
+	this->status = status;
+	this->over = 1;
+
+	return this;
+}
+
+
+static MatrixHandle * submit(MatrixHandle * const this)
+{
+	pthread_attr_t attributes;
+	pthread_t identifier;
+	int here;
+
+	pthread_mutex_lock(& lock);
+
+	if (last == NULL)
+		first = this;
+	else
+		last->next = this;
+	last = this;
+	waiting++;
+
+	if ((waiting > idle) && (started < workers) && (pthread_attr_init(& attributes) == 0))
+	{
+		pthread_attr_setdetachstate(& attributes, PTHREAD_CREATE_DETACHED);
+		if (pthread_create(& identifier, & attributes, serve, NULL) == 0)
+			started++;
+		pthread_attr_destroy(& attributes);
+	}
+
+	/* without any pool thread, the operation is taken back from the queue */
+	here = (started == 0);
+	if (here)
+	{
+		first = NULL;
+		last = NULL;
+		waiting = 0;
+	}
+	else
+		pthread_cond_signal(& queued);
+
+	pthread_mutex_unlock(& lock);
+
+	if (here)
+		execute(this);
+
+	return this;
+}
+
+
+static void execute(MatrixHandle * const this)
+{
+	Matrix * matrix;
+	Vector * vector;
+	Factorization * factorization;
+	MatrixAsyncStatus status;
+	void (* callback)(MatrixHandle * handle, void * context);
+	void * context;
+
+	matrix = NULL;
+	vector = NULL;
+	status = MATRIX_ASYNC_DONE;
+
+	switch (this->operation)
+	{
+		case PRODUCT:
+			matrix = _Matrix->product(this->left, this->right);
+			if (matrix == NULL)
+				status = MATRIX_ASYNC_OUT_OF_MEMORY;
+			break;
+
+		case INVERSE:
+			factorization = factor(this->left, & status);
+			if (factorization == NULL)
+				break;
+
+			matrix = invert(factorization);
+			if (matrix == NULL)
+				status = MATRIX_ASYNC_OUT_OF_MEMORY;
+			_Factorization->delete(& factorization);
+			break;
+
+		case SOLVE:
+			factorization = factor(this->left, & status);
+			if (factorization == NULL)
+				break;
+
+			/* U has no zero pivot, solve only fails allocating */
+			vector = _Factorization->solve(factorization, this->rightHand);
+			if (vector == NULL)
+				status = MATRIX_ASYNC_OUT_OF_MEMORY;
+			_Factorization->delete(& factorization);
+			break;
+	}
+
+	pthread_mutex_lock(& lock);
+	this->matrix = matrix;
+	this->vector = vector;
+	this->status = status;
+	callback = this->callback;
+	context = this->context;
+	pthread_mutex_unlock(& lock);
+
+	/* outside of the lock, the callback may take the result or queue more work */
+	if (callback != NULL)
+		callback(this, context);
+
+	pthread_mutex_lock(& lock);
+	this->over = 1;
+	pthread_cond_broadcast(& this->ended);
+	pthread_mutex_unlock(& lock);
+}
+
+
+static Factorization * factor(Matrix const * const this, MatrixAsyncStatus * const status)
+{
+	Factorization * factorization;
+	double estimate;
+
+	factorization = _Factorization->lu(this);
+	if (factorization == NULL)
+	{
+		* status = MATRIX_ASYNC_OUT_OF_MEMORY;
+		return NULL;
+	}
+
+	/* 0 for a zero pivot left on the diagonal of U, in O(n^2), where the product of the pivots could underflow */
+	estimate = _Factorization->rcond(factorization);
+	if ((estimate == 0) || (estimate == NO_VALUE))
+	{
+		_Factorization->delete(& factorization);
+		* status = (estimate == 0) ? MATRIX_ASYNC_SINGULAR : MATRIX_ASYNC_OUT_OF_MEMORY;
+		return NULL;
+	}
+
+	return factorization;
+}
+
+
+static Matrix * invert(Factorization const * const factorization)
+{
+	Matrix * inverse;
+	Vector * unit;
+	Vector * column;
+	size_t size, index;
+
+	size = _Factorization->width(factorization);
+	inverse = _Matrix->create(size, size);
+	unit = _Vector->create(size);
+	if ((inverse == NULL) || (unit == NULL))
+	{
+		_Matrix->delete(& inverse);
+		_Vector->delete(& unit);
+		return NULL;
+	}
+
+	for (index = 0; index < size; index++)
+	{
+		_Vector->setCell(unit, index, 1);
+		column = _Factorization->solve(factorization, unit);
+		_Vector->setCell(unit, index, 0);
+		if (column == NULL)
+		{
+			_Matrix->delete(& inverse);
+			break;
+		}
+
+		_Matrix->setColumn(inverse, index, _Vector->cells(column));
+		_Vector->delete(& column);
+	}
+
+	_Vector->delete(& unit);
+
+	return inverse;
+}
+
+
+static void * serve(void * const unused)
+{
+	MatrixHandle * handle;
+
+	(void) unused;
+
+	pthread_mutex_lock(& lock);
+	for (;;)
+	{
+		idle++;
+		while (first == NULL)
+			pthread_cond_wait(& queued, & lock);
+		idle--;
+
+		handle = first;
+		first = handle->next;
+		if (first == NULL)
+			last = NULL;
+		waiting--;
+
+		pthread_mutex_unlock(& lock);
+		execute(handle);
+		pthread_mutex_lock(& lock);
+	}
+
+	return NULL;
+}
+
+
+
+
+static MatrixAsyncMethods methods =
+{
+	productAsync,
+	inverseAsync,
+	solveAsync,
+	poll,
+	wait,
+	onCompletion,
+	status,
+	takeMatrix,
+	takeVector,
+	delete,
+	setWorkers
+};
+MatrixAsyncMethods const * const _MatrixAsync = & methods;
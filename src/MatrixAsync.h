@@ -0,0 +1,158 @@
+#ifndef MATRIX_ASYNC_HEADER
+#define MATRIX_ASYNC_HEADER
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <stddef.h>
+
+
+
+
+/* pool threads started at most, until setWorkers changes it */
+#define MATRIX_ASYNC_DEFAULT_WORKERS 2
+
+
+
+
+/*
+ * Operations queued on a pool of library threads, the caller keeping a handle on each
+ *
+ * Operands are only referenced: they must outlive the operation, and stay unmodified until it's done
+ * Operations go through _Matrix, _Vector and _Factorization, instrumented pool threads being counted too
+ * Pool threads are started when work is queued and none is idle, and are never stopped
+ */
+typedef struct MatrixHandle MatrixHandle;
+
+
+typedef enum
+{
+	/* queued or running */
+	MATRIX_ASYNC_PENDING,
+
+	/* the result is ready */
+	MATRIX_ASYNC_DONE,
+
+	/* an operand is NULL */
+	MATRIX_ASYNC_INVALID_ARGUMENT,
+
+	/* operands sizes don't match, or a matrix to invert isn't square */
+	MATRIX_ASYNC_SIZE_MISMATCH,
+
+	/* the matrix to invert has a zero determinant */
+	MATRIX_ASYNC_SINGULAR,
+
+	/* allocation failed */
+	MATRIX_ASYNC_OUT_OF_MEMORY
+} MatrixAsyncStatus;
+
+
+typedef struct
+{
+	/**
+	 * Queues _Matrix->product(left, right)
+	 * Invalid operands are reported by the handle, which is done at once
+	 *
+	 * @return - the handle, with a Matrix result, or NULL if allocating the handle failed
+	 */
+	MatrixHandle * (* productAsync)(Matrix const * left, Matrix const * right);
+
+	/**
+	 * Queues the inversion of A, factored as P A = L U, then substituted a column at a time
+	 * Invalid operands are reported by the handle, which is done at once
+	 *
+	 * @return - the handle, with a Matrix result, or NULL if allocating the handle failed
+	 */
+	MatrixHandle * (* inverseAsync)(Matrix const * this);
+
+	/**
+	 * Queues the resolution of A x = b, by substitution from P A = L U, without inverting A
+	 * Invalid operands are reported by the handle, which is done at once
+	 *
+	 * @param this - A, square
+	 * @param rightHand - b, as many cells as A has rows
+	 *
+	 * @return - the handle, with a Vector result, or NULL if allocating the handle failed
+	 */
+	MatrixHandle * (* solveAsync)(Matrix const * this, Vector const * rightHand);
+
+	/**
+	 * @return - 1 if the operation is over and its callback has returned, 0 if it's pending,
+	 * 		or if [this] is NULL
+	 */
+	int (* poll)(MatrixHandle const * this);
+
+	/**
+	 * Blocks until the operation is over and its callback has returned
+	 *
+	 * @return - the final status, or MATRIX_ASYNC_INVALID_ARGUMENT if [this] is NULL
+	 */
+	MatrixAsyncStatus (* wait)(MatrixHandle * this);
+
+	/**
+	 * Sets the function called once the operation is over, replacing any previous one
+	 * It's called by the pool thread which ran the operation, or right away by the calling thread
+	 * if the operation is already over; it may take the result or read the status, but must not
+	 * call wait or delete on the handle: both block until the callback has returned, and would never return
+	 *
+	 * @param callback - called with the handle and [context]
+	 * @param context - handed to [callback] as is
+	 *
+	 * @return - 1 on success, 0 if [this] or [callback] is NULL
+	 */
+	int (* onCompletion)(MatrixHandle * this, void (* callback)(MatrixHandle * handle, void * context), void * context);
+
+	/**
+	 * @return - the current status, without waiting, or MATRIX_ASYNC_INVALID_ARGUMENT if [this] is NULL
+	 */
+	MatrixAsyncStatus (* status)(MatrixHandle const * this);
+
+	/**
+	 * Transfers the result of a product or an inverse to the caller, who has to delete it
+	 *
+	 * @return - the result, or NULL if:
+	 * 		[this] is NULL,
+	 * 		the status isn't MATRIX_ASYNC_DONE,
+	 * 		the result isn't a Matrix,
+	 * 		it was already taken
+	 */
+	Matrix * (* takeMatrix)(MatrixHandle * this);
+
+	/**
+	 * Transfers the result of a resolution to the caller, who has to delete it
+	 *
+	 * @return - the result, or NULL if:
+	 * 		[this] is NULL,
+	 * 		the status isn't MATRIX_ASYNC_DONE,
+	 * 		the result isn't a Vector,
+	 * 		it was already taken
+	 */
+	Vector * (* takeVector)(MatrixHandle * this);
+
+	/**
+	 * Waits for the operation to be over, deletes its result if it wasn't taken,
+	 * then the handle, and sets it to NULL
+	 *
+	 * @param this - pointer to pointer to handle to delete
+	 */
+	void (* delete)(MatrixHandle ** this);
+
+	/**
+	 * Sets how many pool threads may be started, for every thread
+	 * Threads already started keep running when it's lowered
+	 *
+	 * @param count - MATRIX_ASYNC_DEFAULT_WORKERS initially, 0 is treated as 1
+	 */
+	void (* setWorkers)(size_t count);
+
+} MatrixAsyncMethods;
+
+
+
+
+extern MatrixAsyncMethods const * const _MatrixAsync;
+
+
+
+
+#endif /* MATRIX_ASYNC_HEADER */
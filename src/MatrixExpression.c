@@ -0,0 +1,568 @@
+#include "MatrixExpression.h"
+#include "MatrixPrivate.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+
+
+typedef enum
+{
+	LEAF,
+	SUM,
+	PRODUCT,
+	SCALAR_PRODUCT,
+	TRANSPOSE
+} NodeType;
+
+
+struct MatrixExpression
+{
+	NodeType type;
+
+	size_t height;
+	size_t width;
+
+	/* leaves only */
+	Matrix const * matrix;
+
+	/* scalar products only */
+	double scalar;
+
+	/* single operand of unary nodes is [left] */
+	MatrixExpression * left;
+	MatrixExpression * right;
+};
+
+
+/**
+ * A matrix read as-is or transposed, without copying it
+ */
+typedef struct
+{
+	Matrix const * matrix;
+	int transposed;
+} Operand;
+
+
+/**
+ * coefficient * left, or coefficient * left * right if [right] is set
+ */
+typedef struct
+{
+	double coefficient;
+	Operand left;
+	Operand right;
+} Term;
+
+
+/**
+ * An expression flattened into a sum of terms, with the matrices materialized to get there
+ */
+typedef struct
+{
+	Term * terms;
+	size_t termsCount;
+
+	Matrix ** temporaries;
+	size_t temporariesCount;
+} Plan;
+
+
+
+
+/**
+ * Allocates a node, or deletes its children if allocation failed
+ *
+ * @param type - the type of the node
+ * @param height - the height of the evaluated node
+ * @param width - the width of the evaluated node
+ * @param left - the first child, or NULL
+ * @param right - the second child, or NULL
+ *
+ * @return - the node, or NULL if allocation failed
+ */
+static MatrixExpression * node(NodeType type, size_t height, size_t width, MatrixExpression * left, MatrixExpression * right);
+
+/**
+ * @param this - the expression to count terms for
+ *
+ * @return - how many terms the flattened expression has at most
+ */
+static size_t countTerms(MatrixExpression const * this);
+
+/**
+ * @param this - the expression to count products for
+ *
+ * @return - how many product nodes the expression has
+ */
+static size_t countProducts(MatrixExpression const * this);
+
+/**
+ * Appends the terms of [coefficient] * [this] to [plan], transposed if [transposed] is set
+ *
+ * @return - 1 on success, 0 if an operand allocation failed
+ */
+static int flatten(MatrixExpression const * this, double coefficient, int transposed, Plan * plan);
+
+/**
+ * Turns [this] into something a product can read directly: leaves are used as-is,
+ * anything else is materialized into a temporary of [plan]
+ *
+ * @param this - the product operand
+ * @param transposed - whether the operand is read transposed
+ * @param plan - the plan owning temporaries
+ * @param operand - where to write the matrix to read
+ * @param factor - where to write the factor folded out of [this]
+ *
+ * @return - 1 on success, 0 if allocation failed
+ */
+static int resolve(MatrixExpression const * this, int transposed, Plan * plan, Operand * operand, double * factor);
+
+/**
+ * Releases terms and temporaries of [plan]
+ */
+static void release(Plan * plan);
+
+/**
+ * @return - 1 if [destination] is read in a way that writing it in place would corrupt
+ */
+static int isOverwrittenWhileRead(Plan const * plan, Matrix const * destination);
+
+/**
+ * Computes the planned terms into [destination], which must not be read by products or transposed terms
+ *
+ * @return - 1 on success, 0 if allocation failed
+ */
+static int execute(Plan const * plan, Matrix * destination);
+
+
+
+
+static MatrixExpression * leaf(Matrix const * const matrix)
+{
+	MatrixExpression * this;
+
+	if (matrix == NULL)
+		return NULL;
+
+	this = node(LEAF, matrix->height, matrix->width, NULL, NULL);
+	if (this == NULL)
+		return NULL;
+
+	this->matrix = matrix;
+
+	return this;
+}
+
+
+static void delete(MatrixExpression ** this)
+{
+	if (this == NULL)
+		return;
+	if (* this == NULL)
+		return;
+
+	delete(& (* this)->left);
+	delete(& (* this)->right);
+
+	free(* this);
+	* this = NULL;
+}
+
+
+static MatrixExpression * sum(MatrixExpression * left, MatrixExpression * right)
+{
+	if ((left == NULL) || (right == NULL)
+		|| (left->width != right->width) || (left->height != right->height))
+	{
+		delete(& left);
+		delete(& right);
+		return NULL;
+	}
+
+	return node(SUM, left->height, left->width, left, right);
+}
+
+
+static MatrixExpression * product(MatrixExpression * left, MatrixExpression * right)
+{
+	if ((left == NULL) || (right == NULL) || (left->width != right->height))
+	{
+		delete(& left);
+		delete(& right);
+		return NULL;
+	}
+
+	return node(PRODUCT, left->height, right->width, left, right);
+}
+
+
+static MatrixExpression * scalarProduct(MatrixExpression * const this, double scalar)
+{
+	MatrixExpression * scaled;
+
+	if (this == NULL)
+		return NULL;
+
+	scaled = node(SCALAR_PRODUCT, this->height, this->width, this, NULL);
+	if (scaled == NULL)
+		return NULL;
+
+	scaled->scalar = scalar;
+
+	return scaled;
+}
+
+
+static MatrixExpression * transpose(MatrixExpression * const this)
+{
+	if (this == NULL)
+		return NULL;
+
+	return node(TRANSPOSE, this->width, this->height, this, NULL);
+}
+
+
+static size_t width(MatrixExpression const * const this)
+{
+	if (this == NULL)
+		return 0;
+	return this->width;
+}
+
+
+static size_t height(MatrixExpression const * const this)
+{
+	if (this == NULL)
+		return 0;
+	return this->height;
+}
+
+
+static Matrix * evaluate(MatrixExpression const * const this)
+{
+	Matrix * result;
+
+	if (this == NULL)
+		return NULL;
+
+	result = _Matrix->create(this->height, this->width);
+	if (result == NULL)
+		return NULL;
+
+	if (! _MatrixExpression->evaluateInto(this, result))
+		_Matrix->delete(& result);
+
+	return result;
+}
+
+
+static int evaluateInto(MatrixExpression const * const this, Matrix * const destination)
+{
+	Plan plan;
+	Matrix * buffer;
+	size_t rowIndex, columnIndex;
+	int succeeded;
+
+	if ((this == NULL) || (destination == NULL))
+		return 0;
+	if ((this->height != destination->height) || (this->width != destination->width))
+		return 0;
+	if (! _Matrix->detach(destination))
+		return 0;
+
+	plan.termsCount = 0;
+	plan.temporariesCount = 0;
+	plan.terms = malloc(countTerms(this) * sizeof(* plan.terms));
+	plan.temporaries = malloc((2 * countProducts(this) + 1) * sizeof(* plan.temporaries));
+	if ((plan.terms == NULL) || (plan.temporaries == NULL))
+	{
+		release(& plan);
+		return 0;
+	}
+
+	if (! flatten(this, 1, 0, & plan))
+	{
+		release(& plan);
+		return 0;
+	}
+
+	if (! isOverwrittenWhileRead(& plan, destination))
+	{
+		succeeded = execute(& plan, destination);
+		release(& plan);
+		return succeeded;
+	}
+
+	buffer = _Matrix->create(destination->height, destination->width);
+	succeeded = (buffer != NULL) && execute(& plan, buffer);
+	if (succeeded)
+	{
+		for (rowIndex = 0; rowIndex < destination->height; rowIndex++)
+		{
+			if (destination->layout == MATRIX_ROW_MAJOR)
+				memcpy(destination->cells[rowIndex], buffer->cells[rowIndex], destination->width * sizeof(** destination->cells));
+			else for (columnIndex = 0; columnIndex < destination->width; columnIndex++)
+				destination->cells[columnIndex][rowIndex] = buffer->cells[rowIndex][columnIndex];
+		}
+	}
+
+	_Matrix->delete(& buffer);
+	release(& plan);
+
+	return succeeded;
+}
+
+
+
+
+static MatrixExpression * node(NodeType type, size_t height, size_t width, MatrixExpression * left, MatrixExpression * right)
+{
+	MatrixExpression * this;
+
+	this = malloc(sizeof(* this));
+	if (this == NULL)
+	{
+		delete(& left);
+		delete(& right);
+		return NULL;
+	}
+
+	this->type = type;
+	this->height = height;
+	this->width = width;
+	this->matrix = NULL;
+	this->scalar = 1;
+	this->left = left;
+	this->right = right;
+
+	return this;
+}
+
+
+static size_t countTerms(MatrixExpression const * const this)
+{
+	switch (this->type)
+	{
+		case SUM:
+			return countTerms(this->left) + countTerms(this->right);
+		case SCALAR_PRODUCT:
+		case TRANSPOSE:
+			return countTerms(this->left);
+		default:
+			return 1;
+	}
+}
+
+
+static size_t countProducts(MatrixExpression const * const this)
+{
+	size_t count = (this->type == PRODUCT) ? 1 : 0;
+
+	if (this->left != NULL)
+		count += countProducts(this->left);
+	if (this->right != NULL)
+		count += countProducts(this->right);
+
+	return count;
+}
+
+
+static int flatten(MatrixExpression const * const this, double coefficient, int transposed, Plan * const plan)
+{
+	Term * term;
+	double leftFactor, rightFactor;
+
+	switch (this->type)
+	{
+		case LEAF:
+			term = & plan->terms[plan->termsCount++];
+			term->coefficient = coefficient;
+			term->left.matrix = this->matrix;
+			term->left.transposed = transposed;
+			term->right.matrix = NULL;
+			term->right.transposed = 0;
+			return 1;
+
+		case SUM:
+			return flatten(this->left, coefficient, transposed, plan)
+				&& flatten(this->right, coefficient, transposed, plan);
+
+		case SCALAR_PRODUCT:
+			return flatten(this->left, coefficient * this->scalar, transposed, plan);
+
+		case TRANSPOSE:
+			return flatten(this->left, coefficient, ! transposed, plan);
+
+		case PRODUCT:
+			term = & plan->terms[plan->termsCount];
+			/* ^t (AB) = ^t B ^t A */
+			if (! resolve(transposed ? this->right : this->left, transposed, plan, & term->left, & leftFactor))
+				return 0;
+			if (! resolve(transposed ? this->left : this->right, transposed, plan, & term->right, & rightFactor))
+				return 0;
+			term->coefficient = coefficient * leftFactor * rightFactor;
+			plan->termsCount++;
+			return 1;
+	}
+
+	return 0;
+}
+
+
+static int resolve(MatrixExpression const * this, int transposed, Plan * const plan, Operand * const operand, double * const factor)
+{
+	Matrix * temporary;
+
+	* factor = 1;
+	while ((this->type == SCALAR_PRODUCT) || (this->type == TRANSPOSE))
+	{
+		if (this->type == SCALAR_PRODUCT)
+			* factor *= this->scalar;
+		else
+			transposed = ! transposed;
+		this = this->left;
+	}
+
+	if (this->type == LEAF)
+	{
+		operand->matrix = this->matrix;
+		operand->transposed = transposed;
+		return 1;
+	}
+
+	temporary = _MatrixExpression->evaluate(this);
+	if (temporary == NULL)
+		return 0;
+
+	plan->temporaries[plan->temporariesCount++] = temporary;
+	operand->matrix = temporary;
+	operand->transposed = transposed;
+
+	return 1;
+}
+
+
+static void release(Plan * const plan)
+{
+	size_t index;
+
+	if (plan->temporaries != NULL)
+	{
+		for (index = 0; index < plan->temporariesCount; index++)
+			_Matrix->delete(& plan->temporaries[index]);
+	}
+
+	free(plan->temporaries);
+	plan->temporaries = NULL;
+	free(plan->terms);
+	plan->terms = NULL;
+}
+
+
+static int isOverwrittenWhileRead(Plan const * const plan, Matrix const * const destination)
+{
+	size_t index;
+	Term const * term;
+
+	for (index = 0; index < plan->termsCount; index++)
+	{
+		term = & plan->terms[index];
+		if (term->right.matrix != NULL)
+		{
+			if ((term->left.matrix == destination) || (term->right.matrix == destination))
+				return 1;
+		}
+		else if ((term->left.matrix == destination) && term->left.transposed)
+			return 1;
+	}
+
+	return 0;
+}
+
+
+static int execute(Plan const * const plan, Matrix * const destination)
+{
+	size_t const lines = MATRIX_LINES(destination), length = MATRIX_LENGTH(destination);
+	size_t rowIndex, columnIndex, index;
+	Term const * term;
+	double * row;
+	double const * source;
+	int crossed;
+
+	/*
+	 * Element-wise terms are summed a row at a time in a scratch row, so each row of
+	 * the destination is written once, and may be read by untransposed terms until then
+	 * Rows are those stored, columns for a column-major destination: an operand is read across
+	 * its stored rows when it is transposed, or laid out differently, but not both
+	 */
+	row = malloc(length * sizeof(* row));
+	if (row == NULL)
+		return 0;
+
+	for (rowIndex = 0; rowIndex < lines; rowIndex++)
+	{
+		memset(row, 0, length * sizeof(* row));
+
+		for (index = 0; index < plan->termsCount; index++)
+		{
+			term = & plan->terms[index];
+			if (term->right.matrix != NULL)
+				continue;
+
+			crossed = term->left.transposed ^ (term->left.matrix->layout != destination->layout);
+			if (crossed)
+			{
+				for (columnIndex = 0; columnIndex < length; columnIndex++)
+					row[columnIndex] += term->coefficient * term->left.matrix->cells[columnIndex][rowIndex];
+			}
+			else
+			{
+				source = term->left.matrix->cells[rowIndex];
+				for (columnIndex = 0; columnIndex < length; columnIndex++)
+					row[columnIndex] += term->coefficient * source[columnIndex];
+			}
+		}
+
+		memcpy(destination->cells[rowIndex], row, length * sizeof(* row));
+	}
+
+	free(row);
+
+	/* destination += coefficient * op(left) * op(right) */
+	for (index = 0; index < plan->termsCount; index++)
+	{
+		term = & plan->terms[index];
+		if (term->right.matrix != NULL)
+		{
+			_Matrix->gemm(
+				term->coefficient,
+				term->left.matrix, term->left.transposed,
+				term->right.matrix, term->right.transposed,
+				1,
+				destination);
+		}
+	}
+
+	return 1;
+}
+
+
+
+
+static MatrixExpressionMethods methods =
+{
+	leaf,
+	delete,
+	sum,
+	product,
+	scalarProduct,
+	transpose,
+	width,
+	height,
+	evaluate,
+	evaluateInto
+};
+MatrixExpressionMethods const * const _MatrixExpression = & methods;
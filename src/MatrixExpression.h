@@ -0,0 +1,136 @@
+#ifndef MATRIX_EXPRESSION_HEADER
+#define MATRIX_EXPRESSION_HEADER
+
+#include "Matrix.h"
+
+
+
+
+/*
+ * Deferred computation over matrices, nothing is computed until evaluation
+ *
+ * Sums, scalar products and transposes are linear, so any tree of them is evaluated
+ * as one weighted sum of its leaves, in a single pass over the destination;
+ * products are accumulated straight into the destination, with transposition folded
+ * into how their operands are read, so only product operands which are themselves
+ * sums get an intermediate matrix
+ *
+ * Nodes own their children: building a node from expressions transfers them to it,
+ * even on failure, so the whole tree is deleted from its root
+ * Leaves only reference their matrix, which must outlive the expression
+ */
+typedef struct MatrixExpression MatrixExpression;
+
+
+typedef struct
+{
+	/**
+	 * Creates an expression reading an existing matrix
+	 *
+	 * @param matrix - the matrix to read, not copied nor owned
+	 *
+	 * @return - the leaf expression, or NULL if [matrix] is NULL or allocation failed
+	 */
+	MatrixExpression * (* leaf)(Matrix const * matrix);
+
+	/**
+	 * Deletes the expression and all its children, and sets it to NULL
+	 * Matrices referenced by leaves are left untouched
+	 *
+	 * @param this - pointer to pointer to expression to delete
+	 */
+	void (* delete)(MatrixExpression ** this);
+
+	/**
+	 * Deferred _Matrix->sum
+	 *
+	 * @param left - the left operand, owned by the result
+	 * @param right - the right operand, owned by the result
+	 *
+	 * @return - the sum expression, or NULL if:
+	 * 		any operand is NULL,
+	 * 		operands don't have the same size,
+	 * 		allocation failed
+	 */
+	MatrixExpression * (* sum)(MatrixExpression * left, MatrixExpression * right);
+
+	/**
+	 * Deferred _Matrix->product
+	 *
+	 * @param left - the left operand, owned by the result
+	 * @param right - the right operand, owned by the result
+	 *
+	 * @return - the product expression, or NULL if:
+	 * 		any operand is NULL,
+	 * 		[left] width != [right] height,
+	 * 		allocation failed
+	 */
+	MatrixExpression * (* product)(MatrixExpression * left, MatrixExpression * right);
+
+	/**
+	 * Deferred _Matrix->scalarProduct
+	 *
+	 * @param this - the expression to multiply, owned by the result
+	 * @param scalar - the factor
+	 *
+	 * @return - the scaled expression, or NULL if [this] is NULL or allocation failed
+	 */
+	MatrixExpression * (* scalarProduct)(MatrixExpression * this, double scalar);
+
+	/**
+	 * Deferred _Matrix->transpose
+	 *
+	 * @param this - the expression to transpose, owned by the result
+	 *
+	 * @return - the transposed expression, or NULL if [this] is NULL or allocation failed
+	 */
+	MatrixExpression * (* transpose)(MatrixExpression * this);
+
+	/**
+	 * @param this - the expression to get the result width for
+	 *
+	 * @return - the width of the evaluated matrix, or 0 if [this] is NULL
+	 */
+	size_t (* width)(MatrixExpression const * this);
+
+	/**
+	 * @param this - the expression to get the result height for
+	 *
+	 * @return - the height of the evaluated matrix, or 0 if [this] is NULL
+	 */
+	size_t (* height)(MatrixExpression const * this);
+
+	/**
+	 * Computes the expression into a new matrix
+	 *
+	 * @param this - the expression to compute
+	 *
+	 * @return - the result, or NULL if [this] is NULL or allocation failed
+	 */
+	Matrix * (* evaluate)(MatrixExpression const * this);
+
+	/**
+	 * Computes the expression into an existing matrix, overwriting all of its cells
+	 * [destination] may be read by the expression itself
+	 *
+	 * @param this - the expression to compute
+	 * @param destination - where to write the result
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		any parameter is NULL,
+	 * 		[destination] doesn't have the size of the result,
+	 * 		allocation failed
+	 */
+	int (* evaluateInto)(MatrixExpression const * this, Matrix * destination);
+
+} MatrixExpressionMethods;
+
+
+
+
+extern MatrixExpressionMethods const * const _MatrixExpression;
+
+
+
+
+#endif /* MATRIX_EXPRESSION_HEADER */
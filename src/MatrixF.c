@@ -0,0 +1,7 @@
+/*
+ * Single precision instantiation of Matrix.c
+ */
+
+#define MATRIX_SINGLE_PRECISION
+
+#include "Matrix.c"
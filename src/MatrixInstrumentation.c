@@ -0,0 +1,1516 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "MatrixInstrumentation.h"
+#include "MatrixPrivate.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+
+
+
+static char const * const names[MATRIX_OPERATIONS_COUNT] =
+{
+	"create",
+	"createWith",
+	"delete",
+	"setAllocator",
+	"identity",
+	"isIdentity",
+	"copy",
+	"retain",
+	"release",
+	"isShared",
+	"detach",
+	"toFloat",
+	"fromRows",
+	"fromColumns",
+	"fromBuffer",
+	"wrap",
+	"adopt",
+	"width",
+	"height",
+	"layout",
+	"toLayout",
+	"print",
+	"getCell",
+	"setCell",
+	"row",
+	"column",
+	"setRow",
+	"setColumn",
+	"fill",
+	"copyRegion",
+	"trace",
+	"determinant",
+	"minor",
+	"cofactors",
+	"transpose",
+	"adjugate",
+	"sum",
+	"product",
+	"gemm",
+	"strassenProduct",
+	"tuneStrassen",
+	"tuneLU",
+	"setThreads",
+	"scalarProduct",
+	"hadamard",
+	"clamp",
+	"map",
+	"zip",
+	"reduce",
+	"minimum",
+	"maximum",
+	"total",
+	"frobeniusNorm",
+	"kronecker",
+	"hconcat",
+	"vconcat",
+	"blockAssemble",
+	"norm",
+	"rcond",
+	"isInvertible",
+	"isWellConditioned",
+	"inverse",
+	"power",
+	"exponential",
+	"svd",
+	"pinv",
+	"lowRank",
+	"inverseRankUpdate",
+	"determinantRankUpdate"
+};
+
+
+static MatrixStatistics collected;
+
+
+
+
+#ifndef MATRIX_NO_INSTRUMENTATION
+
+
+
+
+/* the library's own table, _Matrix points to it while disabled, wrappers forward to it */
+static MatrixMethods const * original = NULL;
+
+static int enabled = 0;
+
+/*
+ * Per thread: how many calls of each operation are currently running on it, to detect nesting and recursion,
+ * when the outermost one started, and how many it entered so far, for wrappers to tell delegations apart
+ */
+static __thread unsigned int running[MATRIX_OPERATIONS_COUNT];
+static __thread double startedAt[MATRIX_OPERATIONS_COUNT];
+static __thread unsigned long entered[MATRIX_OPERATIONS_COUNT];
+
+
+
+
+/**
+ * @return - a monotonic time, in seconds
+ */
+static double now(void);
+
+/**
+ * Counts a call to [operation], and starts its timer if it's not already running
+ *
+ * @param operation - the called operation
+ */
+static void enter(MatrixOperation operation);
+
+/**
+ * Stops the timer of [operation] if this is its outermost call
+ *
+ * @param operation - the returning operation
+ * @param flops - estimated floating point operations done by [operation] itself
+ */
+static void leave(MatrixOperation operation, double flops);
+
+/**
+ * Adds [amount] to [total], atomically, by compare and swap, there being no atomic addition of doubles
+ */
+static void accumulate(double * total, double amount);
+
+/**
+ * Raises [peak] to [value], atomically, unless another thread raised it higher already
+ */
+static void reachPeak(size_t * peak, size_t value);
+
+/**
+ * @param this - the matrix to measure
+ *
+ * @return - the heap size of the block holding the structure of [this], 0 if [this] is NULL
+ */
+static size_t footprint(Matrix const * this);
+
+/**
+ * @param this - the matrix about to be released for the last time
+ *
+ * @return - the heap size freed along with [this]: its block unless copies still read it,
+ *           and the block it reads, be it one it was detached into, if it holds the last reference to it
+ */
+static size_t releasedFootprint(Matrix const * this);
+
+/**
+ * Accounts [bytes] allocated to every running operation
+ */
+static void charge(size_t bytes);
+
+/**
+ * Accounts a matrix allocation to every running operation, and updates live matrices count
+ *
+ * @param this - the created matrix, nothing is done if NULL
+ */
+static void allocated(Matrix const * this);
+
+/**
+ * Accounts a matrix deletion to every running operation, and updates live matrices count
+ *
+ * @param this - the matrix about to be deleted, nothing is done if NULL
+ */
+static void freed(Matrix const * this);
+
+/**
+ * Same as freed, when the reference given back by delete or release is the last one
+ *
+ * @param this - the matrix about to be released, nothing is done if NULL
+ */
+static void released(Matrix const * this);
+
+
+
+
+static Matrix * instrumentedCreate(size_t height, size_t width)
+{
+	Matrix * result;
+
+	enter(MATRIX_CREATE);
+	result = original->create(height, width);
+	allocated(result);
+	leave(MATRIX_CREATE, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedCreateWith(size_t height, size_t width, MatrixAllocator const * const allocator)
+{
+	Matrix * result;
+
+	enter(MATRIX_CREATE_WITH);
+	result = original->createWith(height, width, allocator);
+	allocated(result);
+	leave(MATRIX_CREATE_WITH, 0);
+
+	return result;
+}
+
+
+static void instrumentedDelete(Matrix ** this)
+{
+	/* the matrix is accounted as freed by release, which delete goes through */
+	enter(MATRIX_DELETE);
+	original->delete(this);
+	leave(MATRIX_DELETE, 0);
+}
+
+
+static int instrumentedSetAllocator(MatrixAllocator const * const allocator)
+{
+	int result;
+
+	enter(MATRIX_SET_ALLOCATOR);
+	result = original->setAllocator(allocator);
+	leave(MATRIX_SET_ALLOCATOR, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedIdentity(size_t size)
+{
+	Matrix * result;
+
+	enter(MATRIX_IDENTITY);
+	result = original->identity(size);
+	leave(MATRIX_IDENTITY, 0);
+
+	return result;
+}
+
+
+static int instrumentedIsIdentity(Matrix const * const this)
+{
+	int result;
+
+	enter(MATRIX_IS_IDENTITY);
+	result = original->isIdentity(this);
+	leave(MATRIX_IS_IDENTITY, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedCopy(Matrix const * const this)
+{
+	Matrix * result;
+
+	enter(MATRIX_COPY);
+	result = original->copy(this);
+	allocated(result);
+	leave(MATRIX_COPY, 0);
+
+	return result;
+}
+
+
+static Matrix const * instrumentedRetain(Matrix const * const this)
+{
+	Matrix const * result;
+
+	enter(MATRIX_RETAIN);
+	result = original->retain(this);
+	leave(MATRIX_RETAIN, 0);
+
+	return result;
+}
+
+
+static void instrumentedRelease(Matrix const * const this)
+{
+	enter(MATRIX_RELEASE);
+	released(this);
+	original->release(this);
+	leave(MATRIX_RELEASE, 0);
+}
+
+
+static int instrumentedIsShared(Matrix const * const this)
+{
+	int result;
+
+	enter(MATRIX_IS_SHARED);
+	result = original->isShared(this);
+	leave(MATRIX_IS_SHARED, 0);
+
+	return result;
+}
+
+
+static int instrumentedDetach(Matrix * const this)
+{
+	Matrix const * owner;
+	int result;
+
+	enter(MATRIX_DETACH);
+	owner = (this == NULL) ? NULL : this->owner;
+	result = original->detach(this);
+	/* a new owner is the block the cells were copied into */
+	if ((this != NULL) && (this->owner != owner))
+		charge(footprint(this->owner));
+	leave(MATRIX_DETACH, 0);
+
+	return result;
+}
+
+
+static MatrixF * instrumentedToFloat(Matrix const * const this)
+{
+	MatrixF * result;
+
+	enter(MATRIX_TO_FLOAT);
+	result = original->toFloat(this);
+	leave(MATRIX_TO_FLOAT, 0);
+
+	return result;
+}
+
+
+/*
+ * Variadic arguments can't be forwarded to the original constructors,
+ * both go through the helper they are built on, with the instrumented create
+ */
+
+
+static Matrix * instrumentedFromRows(size_t height, size_t width, double const * const rows, ...)
+{
+	va_list variadic;
+	Matrix * result;
+
+	enter(MATRIX_FROM_ROWS);
+	va_start(variadic, rows);
+	result = matrixFromLines(height, width, MATRIX_ROW_MAJOR, rows, variadic);
+	va_end(variadic);
+	leave(MATRIX_FROM_ROWS, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedFromColumns(size_t height, size_t width, double const * const columns, ...)
+{
+	va_list variadic;
+	Matrix * result;
+
+	enter(MATRIX_FROM_COLUMNS);
+	va_start(variadic, columns);
+	result = matrixFromLines(height, width, MATRIX_COLUMN_MAJOR, columns, variadic);
+	va_end(variadic);
+	leave(MATRIX_FROM_COLUMNS, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedFromBuffer(size_t height, size_t width, double const * const cells, size_t stride)
+{
+	Matrix * result;
+
+	enter(MATRIX_FROM_BUFFER);
+	result = original->fromBuffer(height, width, cells, stride);
+	leave(MATRIX_FROM_BUFFER, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedWrap(size_t height, size_t width, double * const cells, size_t stride, MatrixLayout layout)
+{
+	Matrix * result;
+
+	enter(MATRIX_WRAP);
+	result = original->wrap(height, width, cells, stride, layout);
+	allocated(result);
+	leave(MATRIX_WRAP, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedAdopt(
+	size_t height, size_t width, double * const cells, size_t stride, MatrixLayout layout,
+	MatrixDeleter deleter, void * const context)
+{
+	Matrix * result;
+
+	enter(MATRIX_ADOPT);
+	result = original->adopt(height, width, cells, stride, layout, deleter, context);
+	allocated(result);
+	leave(MATRIX_ADOPT, 0);
+
+	return result;
+}
+
+
+static size_t instrumentedWidth(Matrix const * const this)
+{
+	size_t result;
+
+	enter(MATRIX_WIDTH);
+	result = original->width(this);
+	leave(MATRIX_WIDTH, 0);
+
+	return result;
+}
+
+
+static size_t instrumentedHeight(Matrix const * const this)
+{
+	size_t result;
+
+	enter(MATRIX_HEIGHT);
+	result = original->height(this);
+	leave(MATRIX_HEIGHT, 0);
+
+	return result;
+}
+
+
+static MatrixLayout instrumentedLayout(Matrix const * const this)
+{
+	MatrixLayout result;
+
+	enter(MATRIX_LAYOUT);
+	result = original->layout(this);
+	leave(MATRIX_LAYOUT, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedToLayout(Matrix const * const this, MatrixLayout layout)
+{
+	Matrix * result;
+
+	enter(MATRIX_TO_LAYOUT);
+	result = original->toLayout(this, layout);
+	leave(MATRIX_TO_LAYOUT, 0);
+
+	return result;
+}
+
+
+static void instrumentedPrint(Matrix const * const this)
+{
+	enter(MATRIX_PRINT);
+	original->print(this);
+	leave(MATRIX_PRINT, 0);
+}
+
+
+static double instrumentedGetCell(Matrix const * const this, size_t ordinate, size_t abscissa)
+{
+	double result;
+
+	enter(MATRIX_GET_CELL);
+	result = original->getCell(this, ordinate, abscissa);
+	leave(MATRIX_GET_CELL, 0);
+
+	return result;
+}
+
+
+static int instrumentedSetCell(Matrix * const this, size_t ordinate, size_t abscissa, double value)
+{
+	int result;
+
+	enter(MATRIX_SET_CELL);
+	result = original->setCell(this, ordinate, abscissa, value);
+	leave(MATRIX_SET_CELL, 0);
+
+	return result;
+}
+
+
+static MatrixSpan instrumentedRow(Matrix const * const this, size_t index)
+{
+	MatrixSpan result;
+
+	enter(MATRIX_ROW);
+	result = original->row(this, index);
+	leave(MATRIX_ROW, 0);
+
+	return result;
+}
+
+
+static MatrixSpan instrumentedColumn(Matrix const * const this, size_t index)
+{
+	MatrixSpan result;
+
+	enter(MATRIX_COLUMN);
+	result = original->column(this, index);
+	leave(MATRIX_COLUMN, 0);
+
+	return result;
+}
+
+
+static int instrumentedSetRow(Matrix * const this, size_t index, double const * const values)
+{
+	int result;
+
+	enter(MATRIX_SET_ROW);
+	result = original->setRow(this, index, values);
+	leave(MATRIX_SET_ROW, 0);
+
+	return result;
+}
+
+
+static int instrumentedSetColumn(Matrix * const this, size_t index, double const * const values)
+{
+	int result;
+
+	enter(MATRIX_SET_COLUMN);
+	result = original->setColumn(this, index, values);
+	leave(MATRIX_SET_COLUMN, 0);
+
+	return result;
+}
+
+
+static int instrumentedFill(Matrix * const this, double value)
+{
+	int result;
+
+	enter(MATRIX_FILL);
+	result = original->fill(this, value);
+	leave(MATRIX_FILL, 0);
+
+	return result;
+}
+
+
+static int instrumentedCopyRegion(
+	Matrix * const destination, size_t destinationRow, size_t destinationColumn,
+	Matrix const * const source, size_t sourceRow, size_t sourceColumn,
+	size_t height, size_t width)
+{
+	int result;
+
+	enter(MATRIX_COPY_REGION);
+	result = original->copyRegion(
+		destination, destinationRow, destinationColumn,
+		source, sourceRow, sourceColumn,
+		height, width);
+	leave(MATRIX_COPY_REGION, 0);
+
+	return result;
+}
+
+
+static double instrumentedTrace(Matrix const * const this)
+{
+	double result;
+
+	enter(MATRIX_TRACE);
+	result = original->trace(this);
+	leave(MATRIX_TRACE, (this == NULL) ? 0 : (double) this->height);
+
+	return result;
+}
+
+
+static double instrumentedDeterminant(Matrix const * const this)
+{
+	double result;
+	double flops;
+	unsigned long cofactorsCalls;
+
+	cofactorsCalls = entered[MATRIX_COFACTORS];
+
+	/*
+	 * ad - bc for 2*2 matrices; 2/3 n^3 for the elimination of P A = L U, the product of the n pivots aside;
+	 * otherwise a multiplication and an addition per cell against the first row of cofactors,
+	 * cofactors and the determinants of minors being counted by their own operations
+	 */
+	enter(MATRIX_DETERMINANT);
+	result = original->determinant(this);
+	if (this->height == 2)
+		flops = 3;
+	else if ((this->height > 2) && (entered[MATRIX_COFACTORS] == cofactorsCalls))
+		flops = 2.0 / 3.0 * this->height * this->height * this->height;
+	else if (this->height > 2)
+		flops = 2.0 * this->height * this->width;
+	else
+		flops = 0;
+	leave(MATRIX_DETERMINANT, flops);
+
+	return result;
+}
+
+
+static Matrix * instrumentedMinor(Matrix const * const this, size_t rowIndex, size_t columnIndex)
+{
+	Matrix * result;
+
+	enter(MATRIX_MINOR);
+	result = original->minor(this, rowIndex, columnIndex);
+	leave(MATRIX_MINOR, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedCofactors(Matrix const * const this)
+{
+	Matrix * result;
+
+	enter(MATRIX_COFACTORS);
+	result = original->cofactors(this);
+	leave(MATRIX_COFACTORS, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedTranspose(Matrix const * const this)
+{
+	Matrix * result;
+
+	enter(MATRIX_TRANSPOSE);
+	result = original->transpose(this);
+	leave(MATRIX_TRANSPOSE, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedAdjugate(Matrix const * const this)
+{
+	Matrix * result;
+
+	enter(MATRIX_ADJUGATE);
+	result = original->adjugate(this);
+	leave(MATRIX_ADJUGATE, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedSum(Matrix const * const left, Matrix const * const right)
+{
+	Matrix * result;
+
+	enter(MATRIX_SUM);
+	result = original->sum(left, right);
+	leave(MATRIX_SUM, (result == NULL) ? 0 : (double) result->height * result->width);
+
+	return result;
+}
+
+
+static Matrix * instrumentedProduct(Matrix const * const left, Matrix const * const right)
+{
+	Matrix * result;
+	unsigned long strassenCalls;
+
+	strassenCalls = entered[MATRIX_STRASSEN_PRODUCT];
+
+	enter(MATRIX_PRODUCT);
+	result = original->product(left, right);
+	/* large products are delegated to strassenProduct, which accounts for them */
+	if ((result == NULL) || (entered[MATRIX_STRASSEN_PRODUCT] != strassenCalls))
+		leave(MATRIX_PRODUCT, 0);
+	else
+		leave(MATRIX_PRODUCT, 2.0 * result->height * result->width * left->width);
+
+	return result;
+}
+
+
+static int instrumentedGemm(
+	double alpha,
+	Matrix const * const left, int transposeLeft,
+	Matrix const * const right, int transposeRight,
+	double beta,
+	Matrix * const result)
+{
+	int succeeded;
+
+	/* k multiplications and additions per cell of C, and its scaling */
+	enter(MATRIX_GEMM);
+	succeeded = original->gemm(alpha, left, transposeLeft, right, transposeRight, beta, result);
+	if (! succeeded)
+		leave(MATRIX_GEMM, 0);
+	else
+	{
+		leave(MATRIX_GEMM,
+			(2.0 * (transposeLeft ? left->height : left->width) + 1) * result->height * result->width);
+	}
+
+	return succeeded;
+}
+
+
+static Matrix * instrumentedStrassenProduct(Matrix const * const left, Matrix const * const right)
+{
+	Matrix * result;
+
+	/* flops are estimated as the classical algorithm's, an upper bound */
+	enter(MATRIX_STRASSEN_PRODUCT);
+	result = original->strassenProduct(left, right);
+	leave(MATRIX_STRASSEN_PRODUCT, (result == NULL) ? 0 : 2.0 * result->height * result->width * left->width);
+
+	return result;
+}
+
+
+static void instrumentedTuneStrassen(size_t crossover, size_t threshold)
+{
+	enter(MATRIX_TUNE_STRASSEN);
+	original->tuneStrassen(crossover, threshold);
+	leave(MATRIX_TUNE_STRASSEN, 0);
+}
+
+
+static void instrumentedTuneLU(size_t threshold)
+{
+	enter(MATRIX_TUNE_LU);
+	original->tuneLU(threshold);
+	leave(MATRIX_TUNE_LU, 0);
+}
+
+
+static void instrumentedSetThreads(size_t count)
+{
+	enter(MATRIX_SET_THREADS);
+	original->setThreads(count);
+	leave(MATRIX_SET_THREADS, 0);
+}
+
+
+static Matrix * instrumentedScalarProduct(Matrix const * const this, double scalar)
+{
+	Matrix * result;
+
+	enter(MATRIX_SCALAR_PRODUCT);
+	result = original->scalarProduct(this, scalar);
+	leave(MATRIX_SCALAR_PRODUCT, (result == NULL) ? 0 : (double) result->height * result->width);
+
+	return result;
+}
+
+
+static Matrix * instrumentedHadamard(Matrix const * const left, Matrix const * const right)
+{
+	Matrix * result;
+
+	enter(MATRIX_HADAMARD);
+	result = original->hadamard(left, right);
+	leave(MATRIX_HADAMARD, (result == NULL) ? 0 : (double) result->height * result->width);
+
+	return result;
+}
+
+
+static Matrix * instrumentedClamp(Matrix const * const this, double lower, double upper)
+{
+	Matrix * result;
+
+	/* comparisons only */
+	enter(MATRIX_CLAMP);
+	result = original->clamp(this, lower, upper);
+	leave(MATRIX_CLAMP, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedMap(
+	Matrix const * const this,
+	void (* const function)(double const * cells, double * results, size_t count, void * context),
+	void * const context)
+{
+	Matrix * result;
+
+	/* what callbacks compute is unknown */
+	enter(MATRIX_MAP);
+	result = original->map(this, function, context);
+	leave(MATRIX_MAP, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedZip(
+	Matrix const * const left,
+	Matrix const * const right,
+	void (* const function)(double const * left, double const * right, double * results, size_t count, void * context),
+	void * const context)
+{
+	Matrix * result;
+
+	enter(MATRIX_ZIP);
+	result = original->zip(left, right, function, context);
+	leave(MATRIX_ZIP, 0);
+
+	return result;
+}
+
+
+static double instrumentedReduce(
+	Matrix const * const this,
+	double (* const function)(double accumulator, double const * cells, size_t count, void * context),
+	double initial,
+	void * const context)
+{
+	double result;
+
+	enter(MATRIX_REDUCE);
+	result = original->reduce(this, function, initial, context);
+	leave(MATRIX_REDUCE, 0);
+
+	return result;
+}
+
+
+static double instrumentedMinimum(Matrix const * const this)
+{
+	double result;
+
+	enter(MATRIX_MINIMUM);
+	result = original->minimum(this);
+	leave(MATRIX_MINIMUM, 0);
+
+	return result;
+}
+
+
+static double instrumentedMaximum(Matrix const * const this)
+{
+	double result;
+
+	enter(MATRIX_MAXIMUM);
+	result = original->maximum(this);
+	leave(MATRIX_MAXIMUM, 0);
+
+	return result;
+}
+
+
+static double instrumentedTotal(Matrix const * const this)
+{
+	double result;
+
+	enter(MATRIX_TOTAL);
+	result = original->total(this);
+	leave(MATRIX_TOTAL, (this == NULL) ? 0 : (double) this->height * this->width);
+
+	return result;
+}
+
+
+static double instrumentedFrobeniusNorm(Matrix const * const this)
+{
+	double result;
+
+	/* a scaling, a square and an addition per cell */
+	enter(MATRIX_FROBENIUS_NORM);
+	result = original->frobeniusNorm(this);
+	leave(MATRIX_FROBENIUS_NORM, (this == NULL) ? 0 : 3.0 * this->height * this->width);
+
+	return result;
+}
+
+
+static Matrix * instrumentedKronecker(Matrix const * const left, Matrix const * const right)
+{
+	Matrix * result;
+
+	enter(MATRIX_KRONECKER);
+	result = original->kronecker(left, right);
+	leave(MATRIX_KRONECKER, (result == NULL) ? 0 : (double) result->height * result->width);
+
+	return result;
+}
+
+
+static Matrix * instrumentedHconcat(Matrix const * const left, Matrix const * const right)
+{
+	Matrix * result;
+
+	/* copies only */
+	enter(MATRIX_HCONCAT);
+	result = original->hconcat(left, right);
+	leave(MATRIX_HCONCAT, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedVconcat(Matrix const * const top, Matrix const * const bottom)
+{
+	Matrix * result;
+
+	enter(MATRIX_VCONCAT);
+	result = original->vconcat(top, bottom);
+	leave(MATRIX_VCONCAT, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedBlockAssemble(size_t rows, size_t columns, Matrix const * const * const blocks)
+{
+	Matrix * result;
+
+	enter(MATRIX_BLOCK_ASSEMBLE);
+	result = original->blockAssemble(rows, columns, blocks);
+	leave(MATRIX_BLOCK_ASSEMBLE, 0);
+
+	return result;
+}
+
+
+static double instrumentedNorm(Matrix const * const this, MatrixNorm type)
+{
+	double result;
+
+	/* an addition per cell for sums of magnitudes, MAX only compares, FROBENIUS is counted by frobeniusNorm */
+	enter(MATRIX_NORM);
+	result = original->norm(this, type);
+	leave(MATRIX_NORM, ((this == NULL) || ((type != MATRIX_NORM_ONE) && (type != MATRIX_NORM_INFINITY))) ? 0
+		: (double) this->height * this->width);
+
+	return result;
+}
+
+
+static double instrumentedRcond(Matrix const * const this)
+{
+	double result;
+	double squared;
+
+	/*
+	 * An upper bound: 2/3 n^3 factoring P A = L U, then 2 n^2 per solve, 2 for each of the 5 iterations
+	 * of the estimator, which may stop earlier, and 1 for the alternative vector; ||A||1 is counted by norm
+	 */
+	enter(MATRIX_RCOND);
+	result = original->rcond(this);
+	squared = (this == NULL) ? 0 : (double) this->height * this->height;
+	leave(MATRIX_RCOND, (this == NULL) ? 0 : 2.0 / 3.0 * squared * this->height + (2 * 5 + 1) * 2.0 * squared);
+
+	return result;
+}
+
+
+static int instrumentedIsInvertible(Matrix const * const this)
+{
+	int result;
+
+	enter(MATRIX_IS_INVERTIBLE);
+	result = original->isInvertible(this);
+	leave(MATRIX_IS_INVERTIBLE, 0);
+
+	return result;
+}
+
+
+static int instrumentedIsWellConditioned(Matrix const * const this, double tolerance)
+{
+	int result;
+
+	enter(MATRIX_IS_WELL_CONDITIONED);
+	result = original->isWellConditioned(this, tolerance);
+	leave(MATRIX_IS_WELL_CONDITIONED, 0);
+
+	return result;
+}
+
+
+static Matrix * instrumentedInverse(Matrix const * const this)
+{
+	Matrix * result;
+	unsigned long adjugateCalls;
+
+	adjugateCalls = entered[MATRIX_ADJUGATE];
+
+	/*
+	 * 2/3 n^3 factoring P A = L U, then 2 n^2 substituting each of the n columns, when no adjugate was needed;
+	 * else the division by the determinant, the adjugate and its scaling being counted by their own operations
+	 */
+	enter(MATRIX_INVERSE);
+	result = original->inverse(this);
+	if (result == NULL)
+		leave(MATRIX_INVERSE, 0);
+	else if (entered[MATRIX_ADJUGATE] == adjugateCalls)
+		leave(MATRIX_INVERSE, 8.0 / 3.0 * result->height * result->height * result->height);
+	else
+		leave(MATRIX_INVERSE, 1);
+
+	return result;
+}
+
+
+static Matrix * instrumentedPower(Matrix const * const this, unsigned long exponent)
+{
+	Matrix * result;
+	unsigned long bits;
+	double products;
+
+	/* one squaring per bit below the highest one, and one product per bit set among them */
+	products = 0;
+	for (bits = exponent; bits > 1; bits >>= 1)
+		products += (bits & 1) ? 2 : 1;
+
+	enter(MATRIX_POWER);
+	result = original->power(this, exponent);
+	leave(MATRIX_POWER, (result == NULL) ? 0 : products * 2.0 * result->height * result->height * result->height);
+
+	return result;
+}
+
+
+static Matrix * instrumentedExponential(Matrix const * const this)
+{
+	Matrix * result;
+	double cubed, squared;
+	int squarings;
+
+	/*
+	 * The [6/6] Padé approximant: 5 products for powers 2 to 6, each added to N and D in 4 n^2,
+	 * 8/3 n^3 solving D X = N, and the squarings, as many as A is scaled down by, read from its norm as the kernel does:
+	 * the infinity norm of the cells it runs on, those of ^t A for a column-major A
+	 */
+	enter(MATRIX_EXPONENTIAL);
+	result = original->exponential(this);
+	squarings = 0;
+	if (result != NULL)
+	{
+		frexp(original->norm(this, (this->layout == MATRIX_COLUMN_MAJOR) ? MATRIX_NORM_ONE : MATRIX_NORM_INFINITY), & squarings);
+		squarings = (squarings + 1 > 0) ? squarings + 1 : 0;
+	}
+	squared = (result == NULL) ? 0 : (double) result->height * result->height;
+	cubed = squared * ((result == NULL) ? 0 : (double) result->height);
+	leave(MATRIX_EXPONENTIAL, 5 * (2.0 * cubed + 4.0 * squared) + 8.0 / 3.0 * cubed + squarings * 2.0 * cubed);
+
+	return result;
+}
+
+
+static Matrix * instrumentedSvd(Matrix const * const this, int full, Matrix ** const left, Matrix ** const right)
+{
+	Matrix * result;
+	double length, count;
+
+	/*
+	 * An estimate: sweeps until convergence aren't known from outside, the 6 typical of double precision are counted,
+	 * each one handling c (c - 1) / 2 pairs of columns, at 6 l for their 3 dot products, 6 l rotating W and 6 c rotating J
+	 */
+	enter(MATRIX_SVD);
+	result = original->svd(this, full, left, right);
+	length = (this == NULL) ? 0 : (double) ((this->height > this->width) ? this->height : this->width);
+	count = (this == NULL) ? 0 : (double) ((this->height > this->width) ? this->width : this->height);
+	leave(MATRIX_SVD, (result == NULL) ? 0 : 6 * count * (count - 1) / 2 * (12 * length + 6 * count));
+
+	return result;
+}
+
+
+static Matrix * instrumentedPinv(Matrix const * const this, double tolerance)
+{
+	Matrix * result;
+
+	/*
+	 * A division per cell of V, an upper bound as columns of zeroed singular values are skipped,
+	 * the decomposition and the product being counted by their own operations
+	 */
+	enter(MATRIX_PINV);
+	result = original->pinv(this, tolerance);
+	leave(MATRIX_PINV, (result == NULL) ? 0
+		: (double) result->height * ((result->height < result->width) ? result->height : result->width));
+
+	return result;
+}
+
+
+static Matrix * instrumentedLowRank(Matrix const * const this, size_t rank)
+{
+	Matrix * result;
+
+	/* a multiplication per cell of U_r, the decomposition and the product being counted by their own operations */
+	enter(MATRIX_LOW_RANK);
+	result = original->lowRank(this, rank);
+	leave(MATRIX_LOW_RANK, (result == NULL) ? 0 : (double) result->height * rank);
+
+	return result;
+}
+
+
+static int instrumentedInverseRankUpdate(Matrix * const inverse, Matrix const * const left, Matrix const * const right)
+{
+	int result;
+
+	/*
+	 * The k*k work only: 2 n k^2 for ^t V (A^(-1) U), 2/3 k^3 factoring C, and 2 k^2 for each of the k columns of C^(-1)
+	 * The O(n^2 k) of the update, A^(-1) U and the three Woodbury products, is counted by gemm, ||C^(-1)||1 by norm
+	 */
+	enter(MATRIX_INVERSE_RANK_UPDATE);
+	result = original->inverseRankUpdate(inverse, left, right);
+	leave(MATRIX_INVERSE_RANK_UPDATE, result ? (2.0 * inverse->height + 8.0 / 3.0 * left->width) * left->width * left->width : 0);
+
+	return result;
+}
+
+
+static double instrumentedDeterminantRankUpdate(
+	Matrix const * const inverse,
+	double determinant,
+	Matrix const * const left,
+	Matrix const * const right)
+{
+	double result;
+
+	/* 2 n k^2 for ^t V (A^(-1) U), 2/3 k^3 factoring C, and k multiplications by its pivots, A^(-1) U being counted by gemm */
+	enter(MATRIX_DETERMINANT_RANK_UPDATE);
+	result = original->determinantRankUpdate(inverse, determinant, left, right);
+	leave(MATRIX_DETERMINANT_RANK_UPDATE, (result == NO_VALUE) ? 0
+		: (2.0 * inverse->height + 2.0 / 3.0 * left->width) * left->width * left->width + left->width);
+
+	return result;
+}
+
+
+
+
+static MatrixMethods const instrumented =
+{
+	instrumentedCreate,
+	instrumentedCreateWith,
+	instrumentedDelete,
+	instrumentedSetAllocator,
+	instrumentedIdentity,
+	instrumentedIsIdentity,
+	instrumentedCopy,
+	instrumentedRetain,
+	instrumentedRelease,
+	instrumentedIsShared,
+	instrumentedDetach,
+	instrumentedToFloat,
+	instrumentedFromRows,
+	instrumentedFromColumns,
+	instrumentedFromBuffer,
+	instrumentedWrap,
+	instrumentedAdopt,
+	instrumentedWidth,
+	instrumentedHeight,
+	instrumentedLayout,
+	instrumentedToLayout,
+	instrumentedPrint,
+	instrumentedGetCell,
+	instrumentedSetCell,
+	instrumentedRow,
+	instrumentedColumn,
+	instrumentedSetRow,
+	instrumentedSetColumn,
+	instrumentedFill,
+	instrumentedCopyRegion,
+	instrumentedTrace,
+	instrumentedDeterminant,
+	instrumentedMinor,
+	instrumentedCofactors,
+	instrumentedTranspose,
+	instrumentedAdjugate,
+	instrumentedSum,
+	instrumentedProduct,
+	instrumentedGemm,
+	instrumentedStrassenProduct,
+	instrumentedTuneStrassen,
+	instrumentedTuneLU,
+	instrumentedSetThreads,
+	instrumentedScalarProduct,
+	instrumentedHadamard,
+	instrumentedClamp,
+	instrumentedMap,
+	instrumentedZip,
+	instrumentedReduce,
+	instrumentedMinimum,
+	instrumentedMaximum,
+	instrumentedTotal,
+	instrumentedFrobeniusNorm,
+	instrumentedKronecker,
+	instrumentedHconcat,
+	instrumentedVconcat,
+	instrumentedBlockAssemble,
+	instrumentedNorm,
+	instrumentedRcond,
+	instrumentedIsInvertible,
+	instrumentedIsWellConditioned,
+	instrumentedInverse,
+	instrumentedPower,
+	instrumentedExponential,
+	instrumentedSvd,
+	instrumentedPinv,
+	instrumentedLowRank,
+	instrumentedInverseRankUpdate,
+	instrumentedDeterminantRankUpdate
+};
+
+
+
+
+static int enable(void)
+{
+	/*
+	 * _Matrix is swapped for the instrumented table: the library itself only calls through _Matrix,
+	 * so nested calls get counted, and calls pay nothing once it points to the original table again
+	 * The swap is a plain store, no matrix call may be running meanwhile
+	 */
+	if (enabled)
+		return 1;
+
+	if (original == NULL)
+		original = _Matrix;
+	_Matrix = & instrumented;
+	enabled = 1;
+
+	return 1;
+}
+
+
+static void disable(void)
+{
+	if (! enabled)
+		return;
+
+	_Matrix = original;
+	enabled = 0;
+}
+
+
+static int isEnabled(void)
+{
+	return enabled;
+}
+
+
+
+
+static double now(void)
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, & time);
+
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+static void enter(MatrixOperation operation)
+{
+	__atomic_add_fetch(& collected.operations[operation].calls, 1, __ATOMIC_RELAXED);
+	entered[operation]++;
+
+	if (running[operation]++ == 0)
+		startedAt[operation] = now();
+}
+
+
+static void leave(MatrixOperation operation, double flops)
+{
+	if (flops != 0)
+		accumulate(& collected.operations[operation].flops, flops);
+
+	if (--running[operation] == 0)
+		accumulate(& collected.operations[operation].seconds, now() - startedAt[operation]);
+}
+
+
+static void accumulate(double * const total, double amount)
+{
+	double current, updated;
+
+	__atomic_load(total, & current, __ATOMIC_RELAXED);
+	do
+		updated = current + amount;
+	while (! __atomic_compare_exchange(total, & current, & updated, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+
+static void reachPeak(size_t * const peak, size_t value)
+{
+	size_t current;
+
+	current = __atomic_load_n(peak, __ATOMIC_RELAXED);
+	while ((value > current)
+		&& ! __atomic_compare_exchange_n(peak, & current, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+
+static size_t footprint(Matrix const * const this)
+{
+	if (this == NULL)
+		return 0;
+
+	/* copies are a structure alone, whose block never counts references */
+	if (this->references == 0)
+		return sizeof(* this);
+
+	/* wrapped cells belong to the caller, the block holds the structure and row pointers */
+	if (this->buffer != NULL)
+		return sizeof(* this) + MATRIX_LINES(this) * sizeof(* this->cells);
+
+	/* the structure, row pointers and padded cells are one block, cells last, as is the block it was detached into */
+	return (size_t) ((char const *) this->owner->cells[0] - (char const *) this->owner)
+		+ MATRIX_LINES(this) * this->stride * sizeof(** this->cells);
+}
+
+
+static size_t releasedFootprint(Matrix const * const this)
+{
+	size_t bytes;
+
+	/* a block copies still read is freed by the last of them */
+	bytes = (__atomic_load_n(& this->references, __ATOMIC_ACQUIRE) <= 1) ? footprint(this) : 0;
+	if ((this->owner != this) && (__atomic_load_n(& this->owner->references, __ATOMIC_ACQUIRE) == 1))
+		bytes += footprint(this->owner);
+
+	return bytes;
+}
+
+
+static void charge(size_t bytes)
+{
+	MatrixOperation operation;
+
+	for (operation = 0; operation < MATRIX_OPERATIONS_COUNT; operation++)
+	{
+		if (running[operation] > 0)
+			__atomic_add_fetch(& collected.operations[operation].bytesAllocated, bytes, __ATOMIC_RELAXED);
+	}
+}
+
+
+static void allocated(Matrix const * const this)
+{
+	if (this == NULL)
+		return;
+
+	charge(footprint(this));
+
+	reachPeak(& collected.peakLiveMatrices, __atomic_add_fetch(& collected.liveMatrices, 1, __ATOMIC_RELAXED));
+}
+
+
+static void freed(Matrix const * const this)
+{
+	MatrixOperation operation;
+	size_t bytes, live;
+
+	if (this == NULL)
+		return;
+
+	bytes = releasedFootprint(this);
+	for (operation = 0; operation < MATRIX_OPERATIONS_COUNT; operation++)
+	{
+		if (running[operation] > 0)
+			__atomic_add_fetch(& collected.operations[operation].bytesFreed, bytes, __ATOMIC_RELAXED);
+	}
+
+	/* matrices created before the last reset are not known */
+	live = __atomic_load_n(& collected.liveMatrices, __ATOMIC_RELAXED);
+	while ((live > 0)
+		&& ! __atomic_compare_exchange_n(& collected.liveMatrices, & live, live - 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+
+static void released(Matrix const * const this)
+{
+	if (this == NULL)
+		return;
+
+	if (__atomic_load_n(& this->retains, __ATOMIC_ACQUIRE) == 1)
+		freed(this);
+}
+
+
+
+
+#else /* MATRIX_NO_INSTRUMENTATION */
+
+
+
+
+static int enable(void)
+{
+	return 0;
+}
+
+
+static void disable(void)
+{
+}
+
+
+static int isEnabled(void)
+{
+	return 0;
+}
+
+
+
+
+#endif /* MATRIX_NO_INSTRUMENTATION */
+
+
+
+
+static void snapshot(MatrixStatistics * const statistics)
+{
+	MatrixOperation operation;
+	MatrixOperationStatistics const * source;
+	MatrixOperationStatistics * entry;
+
+	if (statistics == NULL)
+		return;
+
+	/* each counter is read atomically, counters of operations running meanwhile may be a call apart */
+	for (operation = 0; operation < MATRIX_OPERATIONS_COUNT; operation++)
+	{
+		source = & collected.operations[operation];
+		entry = & statistics->operations[operation];
+		entry->name = names[operation];
+		entry->calls = __atomic_load_n(& source->calls, __ATOMIC_RELAXED);
+		__atomic_load(& source->seconds, & entry->seconds, __ATOMIC_RELAXED);
+		__atomic_load(& source->flops, & entry->flops, __ATOMIC_RELAXED);
+		entry->bytesAllocated = __atomic_load_n(& source->bytesAllocated, __ATOMIC_RELAXED);
+		entry->bytesFreed = __atomic_load_n(& source->bytesFreed, __ATOMIC_RELAXED);
+	}
+	statistics->liveMatrices = __atomic_load_n(& collected.liveMatrices, __ATOMIC_RELAXED);
+	statistics->peakLiveMatrices = __atomic_load_n(& collected.peakLiveMatrices, __ATOMIC_RELAXED);
+}
+
+
+static void reset(void)
+{
+	MatrixOperation operation;
+	MatrixOperationStatistics * entry;
+	double const zero = 0;
+
+	for (operation = 0; operation < MATRIX_OPERATIONS_COUNT; operation++)
+	{
+		entry = & collected.operations[operation];
+		__atomic_store_n(& entry->calls, 0, __ATOMIC_RELAXED);
+		__atomic_store(& entry->seconds, & zero, __ATOMIC_RELAXED);
+		__atomic_store(& entry->flops, & zero, __ATOMIC_RELAXED);
+		__atomic_store_n(& entry->bytesAllocated, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(& entry->bytesFreed, 0, __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(& collected.liveMatrices, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(& collected.peakLiveMatrices, 0, __ATOMIC_RELAXED);
+}
+
+
+static void print(MatrixStatistics const * const statistics)
+{
+	MatrixOperation operation;
+	MatrixOperationStatistics const * entry;
+
+	if (statistics == NULL)
+		return;
+
+	printf("operation\tcalls\tseconds\tflops\tallocated\tfreed\n");
+	for (operation = 0; operation < MATRIX_OPERATIONS_COUNT; operation++)
+	{
+		entry = & statistics->operations[operation];
+		if (entry->calls == 0)
+			continue;
+
+		printf(
+			"%s\t%lu\t%.6f\t%.0f\t%lu\t%lu\n",
+			names[operation],
+			entry->calls,
+			entry->seconds,
+			entry->flops,
+			(unsigned long) entry->bytesAllocated,
+			(unsigned long) entry->bytesFreed);
+	}
+	printf(
+		"live matrices: %lu (peak %lu)\n",
+		(unsigned long) statistics->liveMatrices,
+		(unsigned long) statistics->peakLiveMatrices);
+}
+
+
+
+
+static MatrixInstrumentationMethods methods =
+{
+	enable,
+	disable,
+	isEnabled,
+	snapshot,
+	reset,
+	print
+};
+MatrixInstrumentationMethods const * const _MatrixInstrumentation = & methods;
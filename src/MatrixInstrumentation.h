@@ -0,0 +1,180 @@
+#ifndef MATRIX_INSTRUMENTATION_HEADER
+#define MATRIX_INSTRUMENTATION_HEADER
+
+#include <stddef.h>
+
+
+
+
+/**
+ * One entry per member of MatrixMethods, in declaration order
+ * Only double precision matrices are instrumented, _MatrixF is left untouched
+ */
+typedef enum
+{
+	MATRIX_CREATE,
+	MATRIX_CREATE_WITH,
+	MATRIX_DELETE,
+	MATRIX_SET_ALLOCATOR,
+	MATRIX_IDENTITY,
+	MATRIX_IS_IDENTITY,
+	MATRIX_COPY,
+	MATRIX_RETAIN,
+	MATRIX_RELEASE,
+	MATRIX_IS_SHARED,
+	MATRIX_DETACH,
+	MATRIX_TO_FLOAT,
+	MATRIX_FROM_ROWS,
+	MATRIX_FROM_COLUMNS,
+	MATRIX_FROM_BUFFER,
+	MATRIX_WRAP,
+	MATRIX_ADOPT,
+	MATRIX_WIDTH,
+	MATRIX_HEIGHT,
+	MATRIX_LAYOUT,
+	MATRIX_TO_LAYOUT,
+	MATRIX_PRINT,
+	MATRIX_GET_CELL,
+	MATRIX_SET_CELL,
+	MATRIX_ROW,
+	MATRIX_COLUMN,
+	MATRIX_SET_ROW,
+	MATRIX_SET_COLUMN,
+	MATRIX_FILL,
+	MATRIX_COPY_REGION,
+	MATRIX_TRACE,
+	MATRIX_DETERMINANT,
+	MATRIX_MINOR,
+	MATRIX_COFACTORS,
+	MATRIX_TRANSPOSE,
+	MATRIX_ADJUGATE,
+	MATRIX_SUM,
+	MATRIX_PRODUCT,
+	MATRIX_GEMM,
+	MATRIX_STRASSEN_PRODUCT,
+	MATRIX_TUNE_STRASSEN,
+	MATRIX_TUNE_LU,
+	MATRIX_SET_THREADS,
+	MATRIX_SCALAR_PRODUCT,
+	MATRIX_HADAMARD,
+	MATRIX_CLAMP,
+	MATRIX_MAP,
+	MATRIX_ZIP,
+	MATRIX_REDUCE,
+	MATRIX_MINIMUM,
+	MATRIX_MAXIMUM,
+	MATRIX_TOTAL,
+	MATRIX_FROBENIUS_NORM,
+	MATRIX_KRONECKER,
+	MATRIX_HCONCAT,
+	MATRIX_VCONCAT,
+	MATRIX_BLOCK_ASSEMBLE,
+	MATRIX_NORM,
+	MATRIX_RCOND,
+	MATRIX_IS_INVERTIBLE,
+	MATRIX_IS_WELL_CONDITIONED,
+	MATRIX_INVERSE,
+	MATRIX_POWER,
+	MATRIX_EXPONENTIAL,
+	MATRIX_SVD,
+	MATRIX_PINV,
+	MATRIX_LOW_RANK,
+	MATRIX_INVERSE_RANK_UPDATE,
+	MATRIX_DETERMINANT_RANK_UPDATE,
+
+	MATRIX_OPERATIONS_COUNT
+} MatrixOperation;
+
+
+typedef struct
+{
+	/* name of the MatrixMethods member */
+	char const * name;
+
+	/* number of calls, nested and recursive ones included */
+	unsigned long calls;
+
+	/* wall time spent inside the operation, nested calls included, recursion counted once, summed over threads */
+	double seconds;
+
+	/* estimated floating point operations done by the operation itself, nested calls excluded */
+	double flops;
+
+	/* matrix memory allocated and freed by the thread running the operation meanwhile, nested calls included */
+	size_t bytesAllocated;
+	size_t bytesFreed;
+} MatrixOperationStatistics;
+
+
+typedef struct
+{
+	MatrixOperationStatistics operations[MATRIX_OPERATIONS_COUNT];
+
+	/* matrices created and not deleted yet */
+	size_t liveMatrices;
+
+	/* highest value reached by [liveMatrices] since last reset */
+	size_t peakLiveMatrices;
+} MatrixStatistics;
+
+
+
+
+typedef struct
+{
+	/**
+	 * Routes every _Matrix method through its counting wrapper, swapping the table _Matrix points to
+	 * Calls made from inside the library are counted too, as they go through _Matrix as well
+	 * The swap isn't synchronized: no other matrix call, on any thread, may overlap enable or disable
+	 *
+	 * @return - 1 if instrumentation is now active, 0 if it was compiled out
+	 * 		(MATRIX_NO_INSTRUMENTATION defined)
+	 */
+	int (* enable)(void);
+
+	/**
+	 * Restores the original _Matrix methods, collected statistics are kept
+	 * Same as enable, no other matrix call may overlap it
+	 */
+	void (* disable)(void);
+
+	/**
+	 * @return - 1 if _Matrix methods are currently instrumented, 0 otherwise
+	 */
+	int (* isEnabled)(void);
+
+	/**
+	 * Copies the statistics collected since last reset
+	 *
+	 * @param statistics - where to write the statistics, nothing is done if NULL
+	 */
+	void (* snapshot)(MatrixStatistics * statistics);
+
+	/**
+	 * Zeroes every counter, live matrices included
+	 */
+	void (* reset)(void);
+
+	/**
+	 * Prints called operations, one per line
+	 *
+	 * @param statistics - the statistics to print
+	 */
+	void (* print)(MatrixStatistics const * statistics);
+
+} MatrixInstrumentationMethods;
+
+
+
+
+/*
+ * Counters are updated atomically, instrumented methods may be called from several threads at once,
+ * but enable and disable must be called while no matrix call is running
+ * Nesting, timers, and the memory accounted to running operations are tracked per thread
+ */
+extern MatrixInstrumentationMethods const * const _MatrixInstrumentation;
+
+
+
+
+#endif /* MATRIX_INSTRUMENTATION_HEADER */
@@ -0,0 +1,901 @@
+/*
+ * Methods table template, included by Matrix.h once per precision
+ * Expects the following macros to be defined, they are left defined:
+ * 	MATRIX - the matrix type
+ * 	MATRIX_SCALAR - the type of the cells
+ * 	MATRIX_METHODS - the type of the methods table
+ * 	MATRIX_SELF - the methods table
+ * 	MATRIX_SPAN - the type of rows and columns
+ * 	MATRIX_CONVERTED - the matrix type of the other precision
+ * 	MATRIX_CONVERSION - the name of the method converting to the other precision
+ *
+ * For float matrices, NO_VALUE and MATRIX_IS_NOT_SQUARE are returned rounded to float,
+ * compare results against (float) NO_VALUE and (float) MATRIX_IS_NOT_SQUARE
+ */
+
+
+
+
+typedef struct
+{
+	/**
+	 * Creates a m*n matrix
+	 * @param height - n, the number of rows
+	 * @param width - m, the number of columns
+	 *
+	 * @return - the created matrix, or NULL if:
+	 * 		any dimension is 0,
+	 * 		any allocation failed
+	 */
+	MATRIX * (* create)(size_t height, size_t width);
+
+	/**
+	 * Same as create, with memory from [allocator] rather than the one set with setAllocator
+	 * The matrix keeps a copy of [allocator], and gives its memory back to it when deleted
+	 *
+	 * @param allocator - the allocator to use, the current one if NULL
+	 *
+	 * @return - the created matrix, or NULL if:
+	 * 		any dimension is 0,
+	 * 		[allocator] has no alloc or free function, or its alignment isn't a power of 2,
+	 * 		allocation failed
+	 */
+	MATRIX * (* createWith)(size_t height, size_t width, MatrixAllocator const * allocator);
+
+	/**
+	 * Releases the matrix, and sets it to NULL: it is only freed once every reference
+	 * taken with retain is released too
+	 * @see release
+	 *
+	 * @param this - pointer to pointer to matrix to delete
+	 */
+	void (* delete)(MATRIX ** this);
+
+	/**
+	 * Sets the allocator used by every following creation, for this precision,
+	 * workspaces of products, powers and exponentials included
+	 * Matrices created before keep the allocator they were created with
+	 * By default, blocks come from malloc and are aligned on MATRIX_DEFAULT_ALIGNMENT bytes
+	 *
+	 * @param allocator - the allocator to copy, NULL restores the default one
+	 *
+	 * @return - 1 on success, 0 if [allocator] has no alloc or free function,
+	 * 		or its alignment isn't a power of 2
+	 */
+	int (* setAllocator)(MatrixAllocator const * allocator);
+
+	/**
+	 * Creates an identity matrix
+	 *
+	 * @param size - the dimensions of the matrix to create
+	 *
+	 * @return - the created identity matrix, or NULL if:
+	 * 		size is 0,
+	 * 		allocation failed
+	 */
+	MATRIX * (* identity)(size_t size);
+
+	/**
+	 * Identity matrix is a n*n square matrix, with 1s on its main diagonal,
+	 * and 0s everywhere else
+	 *
+	 * @param this - the matrix to check
+	 *
+	 * @return - 1 only if [this] is not NULL, is square, and has
+	 * 		its main diagonal filled with 1s, returns 0 otherwise
+	 */
+	int (* isIdentity)(MATRIX const * this);
+
+	/**
+	 * Copies the input matrix, in O(1): the copy shares the cells of [this] until either is written to
+	 * Every method writing to a matrix in place (setCell, setRow, setColumn, fill, copyRegion, gemm,
+	 * inverseRankUpdate, evaluateInto) first gives it cells of its own
+	 * @see detach
+	 *
+	 * @param this - the matrix to copy
+	 *
+	 * @return - a copy of the matrix, or NULL if:
+	 * 		[this] is NULL,
+	 * 		allocation failed
+	 */
+	MATRIX * (* copy)(MATRIX const * this);
+
+	/**
+	 * Takes one more reference to [this], for a holder which outlives its creator's,
+	 * the count being atomic, so that references are taken and released from any thread
+	 *
+	 * @param this - the matrix to keep
+	 *
+	 * @return - [this]
+	 */
+	MATRIX const * (* retain)(MATRIX const * this);
+
+	/**
+	 * Gives a reference back, the last one freeing the matrix, as delete does
+	 *
+	 * @param this - the matrix to release, nothing is done if NULL
+	 */
+	void (* release)(MATRIX const * this);
+
+	/**
+	 * @param this - the matrix to check
+	 *
+	 * @return - 1 if another matrix, from copy, may still read the cells of [this], 0 otherwise
+	 */
+	int (* isShared)(MATRIX const * this);
+
+	/**
+	 * Gives [this] cells of its own, copying them if they are shared, before they are written to
+	 * Matrices sharing them keep the former cells, and values, so that no writer is ever seen by another
+	 * Nothing is copied when [this] already has its own cells
+	 *
+	 * @param this - the matrix to write to
+	 *
+	 * @return - 1 on success, 0 if [this] is NULL, or allocation failed
+	 */
+	int (* detach)(MATRIX * this);
+
+	/**
+	 * Copies the input matrix into the other precision, double to float or float to double
+	 * Cells are rounded to the nearest float when narrowing
+	 *
+	 * @param this - the matrix to convert
+	 *
+	 * @return - the converted copy, or NULL if:
+	 * 		[this] is NULL,
+	 * 		allocation failed
+	 */
+	MATRIX_CONVERTED * (* MATRIX_CONVERSION)(MATRIX const * this);
+
+	/**
+	 * Creates a matrix from rows, from top to bottom
+	 * If not exactly [height] rows are given, or if any row doesn't contain
+	 * exactly [width] values, the behavior is undefined
+	 *
+	 * @param height - the number of rows
+	 * @param width - the number of values in each row
+	 * @param rows - [width]-sized array of doubles
+	 * @param ... - other [width]-sized arrays of doubles, there must be [height]-1 of them after [rows]
+	 *
+	 * @return - the newly created matrix, or NULL if allocation failed
+	 */
+	MATRIX * (* fromRows)(size_t height, size_t width, MATRIX_SCALAR const * rows, ...);
+
+	/**
+	 * Creates a column-major matrix from columns, from left to right, each one copied as a whole
+	 * If not exactly [width] columns are given, or if any column doesn't contain
+	 * exactly [height] values, the behavior is undefined
+	 *
+	 * @param height - the number of values in each column
+	 * @param width - the number of columns
+	 * @param columns - [height]-sized array of doubles
+	 * @param ... - other [height]-sized arrays of doubles, there must be [width]-1 of them after [columns]
+	 *
+	 * @return - the newly created matrix, or NULL if allocation failed
+	 */
+	MATRIX * (* fromColumns)(size_t height, size_t width, MATRIX_SCALAR const * columns, ...);
+
+	/**
+	 * Creates a matrix from the cells of a row-major buffer, copied a row at a time
+	 *
+	 * @param height - the number of rows
+	 * @param width - the number of values in each row
+	 * @param cells - the buffer, holding at least ([height] - 1) * [stride] + [width] values
+	 * @param stride - how many values apart rows start, at least [width]
+	 *
+	 * @return - the newly created matrix, or NULL if:
+	 * 		[cells] is NULL,
+	 * 		any dimension is 0, or [stride] is less than [width],
+	 * 		allocation failed
+	 */
+	MATRIX * (* fromBuffer)(size_t height, size_t width, MATRIX_SCALAR const * cells, size_t stride);
+
+	/**
+	 * Creates a matrix reading and writing the cells of a buffer in place, without copying them:
+	 * methods writing to the matrix write to the buffer, as long as no copy shares it
+	 * @see detach
+	 * The caller keeps the buffer, which must outlive the matrix and its copies
+	 * A column-major buffer, as from Fortran or LAPACK, is read as is
+	 *
+	 * @param height - the number of rows
+	 * @param width - the number of columns
+	 * @param cells - the buffer, holding at least (lines - 1) * [stride] + length values,
+	 * 		lines being rows and length [width] for row-major buffers, columns and [height] otherwise
+	 * @param stride - how many values apart lines start, at least their length
+	 * @param layout - the layout of the buffer
+	 *
+	 * @return - the matrix, or NULL if:
+	 * 		[cells] is NULL,
+	 * 		any dimension is 0, or [stride] is less than the length of lines,
+	 * 		allocation of the structure failed
+	 */
+	MATRIX * (* wrap)(size_t height, size_t width, MATRIX_SCALAR * cells, size_t stride, MatrixLayout layout);
+
+	/**
+	 * Same as wrap, the matrix taking the buffer over: it is handed to [deleter] once neither the matrix
+	 * nor any of its copies reads it anymore, so that a buffer from malloc or mmap is given back in time
+	 * @see wrap
+	 *
+	 * @param deleter - gives the buffer back, free() if NULL
+	 * @param context - handed to [deleter] as is
+	 *
+	 * @return - the matrix, or NULL as wrap does, the buffer being left to the caller then
+	 */
+	MATRIX * (* adopt)(
+		size_t height, size_t width, MATRIX_SCALAR * cells, size_t stride, MatrixLayout layout,
+		MatrixDeleter deleter, void * context);
+
+	/**
+	 * For a m*n matrix, returns n
+	 *
+	 * @param this - the matrix to get width for
+	 *
+	 * @return - the width of the matrix, or NO_VALUE if [this] is NULL
+	 */
+	size_t (* width)(MATRIX const * this);
+
+	/**
+	 * For a m*n matrix, returns m
+	 *
+	 * @param this - the matrix to get height for
+	 *
+	 * @return - the height of the matrix, or NO_VALUE if [this] is NULL
+	 */
+	size_t (* height)(MATRIX const * this);
+
+	/**
+	 * Matrices are row-major, but for fromColumns and transpose, which return column-major ones,
+	 * and for column-major buffers given to wrap or adopt
+	 * Every method takes either layout, and any mix of them:
+	 * 	product, gemm, strassenProduct, transpose, sum, copy, and what works on a whole matrix, inverse or svd
+	 * 	for instance, read a column-major A in place as the row-major ^t A its cells are,
+	 * 	other methods, rcond or hadamard of mixed layouts for instance, read a row-major copy
+	 * Results keep the layout their operands share, they are row-major for products and mixed layouts
+	 *
+	 * @param this - the matrix to get layout for
+	 *
+	 * @return - the layout of the matrix, MATRIX_ROW_MAJOR if [this] is NULL
+	 */
+	MatrixLayout (* layout)(MATRIX const * this);
+
+	/**
+	 * Copies the input matrix into [layout], in O(1) sharing its cells if it's already laid out so
+	 * @see copy
+	 *
+	 * @param this - the matrix to copy
+	 * @param layout - the layout of the copy
+	 *
+	 * @return - the copy, or NULL if:
+	 * 		[this] is NULL,
+	 * 		allocation failed
+	 */
+	MATRIX * (* toLayout)(MATRIX const * this, MatrixLayout layout);
+
+	void (* print)(MATRIX const * this);
+
+	/**
+	 * Returns Ai,j
+	 *
+	 * @param ordinate - the row, in range [0, height[
+	 * @param abscissa - the column, in range [0, width[
+	 *
+	 * @return - the requested cell, or NO_VALUE if:
+	 * 		[this] is NULL,
+	 * 		out of bounds occurred
+	 */
+	MATRIX_SCALAR (* getCell)(MATRIX const * this, size_t ordinate, size_t abscissa);
+
+	/**
+	 * Sets Ai,j, giving [this] cells of its own first if a copy shares them
+	 * @see detach
+	 *
+	 * @param ordinate - the row, in range [0, height[
+	 * @param abscissa - the column, in range [0, width[
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		[this] is NULL,
+	 * 		out of bounds occurred,
+	 * 		allocation failed
+	 */
+	int (* setCell)(MATRIX * this, size_t ordinate, size_t abscissa, MATRIX_SCALAR value);
+
+	/**
+	 * Row [index], read in place, in O(1): its cells are contiguous in row-major matrices,
+	 * and [stride] apart in column-major ones
+	 * Cells are then read with MATRIX_SPAN_CELL, without a call or a check per cell
+	 *
+	 * @param index - the row, in range [0, height[
+	 *
+	 * @return - the span of the row, or one of NULL cells and length 0 if [this] is NULL or [index] is out of bounds
+	 */
+	MATRIX_SPAN (* row)(MATRIX const * this, size_t index);
+
+	/**
+	 * Column [index], read in place, in O(1)
+	 * @see row
+	 *
+	 * @param index - the column, in range [0, width[
+	 */
+	MATRIX_SPAN (* column)(MATRIX const * this, size_t index);
+
+	/**
+	 * Sets row [index], giving [this] cells of its own first if a copy shares them
+	 *
+	 * @param index - the row, in range [0, height[
+	 * @param values - n values, from left to right
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		[this] or [values] is NULL,
+	 * 		[index] is out of bounds,
+	 * 		allocation failed
+	 */
+	int (* setRow)(MATRIX * this, size_t index, MATRIX_SCALAR const * values);
+
+	/**
+	 * Sets column [index]
+	 * @see setRow
+	 *
+	 * @param index - the column, in range [0, width[
+	 * @param values - m values, from top to bottom
+	 */
+	int (* setColumn)(MATRIX * this, size_t index, MATRIX_SCALAR const * values);
+
+	/**
+	 * Sets every cell to [value], giving [this] cells of its own first if a copy shares them
+	 *
+	 * @return - 1 on success, 0 if [this] is NULL, or allocation failed
+	 */
+	int (* fill)(MATRIX * this, MATRIX_SCALAR value);
+
+	/**
+	 * Copies the [height]*[width] block of [source] at ([sourceRow], [sourceColumn])
+	 * into [destination] at ([destinationRow], [destinationColumn]), a line of cells at a time
+	 * [source] may be [destination], the blocks overlapping or not, cells being read before they are overwritten
+	 * [destination] is given cells of its own first if a copy shares them
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		[destination] or [source] is NULL,
+	 * 		either block is out of bounds, or is empty,
+	 * 		allocation failed
+	 */
+	int (* copyRegion)(
+		MATRIX * destination, size_t destinationRow, size_t destinationColumn,
+		MATRIX const * source, size_t sourceRow, size_t sourceColumn,
+		size_t height, size_t width);
+
+	/**
+	 * Let A, a n*n square matrix, Tr(A) = ∑_i=1->n Ai,j
+	 *
+	 * @param this - the matrix to get trace for
+	 *
+	 * @return - the sum of the main diagonal, or NO_VALUE if [this] is NULL,
+	 * 		or MATRIX_IS_NOT_SQUARE if [this] is not square
+	 */
+	MATRIX_SCALAR (* trace)(MATRIX const * this);
+
+	/**
+	 * For a n*n square matrix A, Det(A) = ∑_i=1->n (-1)^(i+1) * Ai1 * Det(Ci))
+	 *
+	 * Negative determinant means the application flips the space orientation
+	 * Absolute value is how output measures (length, surface, volume, etc.) are multiplied
+	 * Zero value means the application squishes at least 1 dimension from the input space
+	 *
+	 * Matrices reaching the LU threshold get the product of the pivots of P A = L U instead,
+	 * in O(n^3), with rounding errors
+	 * @see tuneLU
+	 *
+	 * @param this - the matrix to compute determinant for
+	 *
+	 * @return - the determinant, or MATRIX_IS_NOT_SQUARE is [this] isn't square,
+	 * 		or NO_VALUE if minors allocation failed
+	 */
+	MATRIX_SCALAR (* determinant)(MATRIX const * this);
+
+	/**
+	 * Let A, a m*n matrix, Cij is its (i,j) minor, obtained by removing the i-th row and j-th column
+	 *
+	 * @param this - the matrix to minor
+	 * @param rowIndex - the row to remove
+	 * @param columnIndex - the column to remove
+	 *
+	 * @return - the matrix without the given row and column, or NULL if matrix size is lesser than 2,
+	 * 		or if allocation failed
+	 */
+	MATRIX * (* minor)(MATRIX const * this, size_t rowIndex, size_t columnIndex);
+
+	/**
+	 * Let A, a m*m square matrix, Cof(A) is the cofactors matrix, where Cof(A)ij = (-1)^(i+j) * Det(Cij(A))
+	 *
+	 * @param this - the matrix to compute cofactors for
+	 *
+	 * @return - the matrix of cofactors, or NULL if matrix isn't square, or if its size is lesser than 2,
+	 * 		or if allocation failed
+	 */
+	MATRIX * (* cofactors)(MATRIX const * this);
+
+	/**
+	 * Let A, a m*n matrix, ^t A is its transpose matrix, such as Aij = ^t Aji
+	 *
+	 * In O(1): ^t A shares the cells of A, read in the other layout, until either is written to
+	 * @see copy
+	 *
+	 * @param - the matrix to get transpose from
+	 *
+	 * @return - the matrix where rows are written in columns, or NULL if allocation failed
+	 */
+	MATRIX * (* transpose)(MATRIX const * this);
+
+	/**
+	 * For a square matrix, the adjugate matrix is the transpose of its cofactors matrix
+	 * Adj(A) = ^t Cof(A)
+	 *
+	 * @param this - the matrix to get the adjugate for
+	 *
+	 * @return - the adjugate matrix, or NULL if:
+	 * 		[this] is NULL,
+	 * 		[this] isn't square,
+	 * 		cofactors matrix is not defined,
+	 * 		or if allocation failed
+	 */
+	MATRIX * (* adjugate)(MATRIX const * this);
+
+	/**
+	 * Let A and B, two m*n matrix, S is the m*n matrix such that Si,j = Ai,j + Bi,j
+	 *
+	 * @param left - the left operand
+	 * @param right - the right operand
+	 *
+	 * @return - the sum of the operands, or NULL if:
+	 * 		any operand is NULL,
+	 * 		operands don't have the same size,
+	 * 		allocation failed
+	 */
+	MATRIX * (* sum)(MATRIX const * left, MATRIX const * right);
+
+	/**
+	 * Let A and B, m*n matrix and n*p respectively, P is the m*p matrix, such that
+	 * Pi,j = ∑_k=1->n Ai,k * Bk,j
+	 * Product do not commute
+	 *
+	 * @param left - the left operand
+	 * @param right - the right operand
+	 *
+	 * @return - the product as a new matrix, or NULL if:
+	 * 		[left] or [right] is NULL,
+	 * 		[left] width != [right] height
+	 * 		allocation failed
+	 */
+	MATRIX * (* product)(MATRIX const * left, MATRIX const * right);
+
+	/**
+	 * C = alpha * op(A) * op(B) + beta * C, in place, op(X) being X or ^t X
+	 * op(A) is m*k, op(B) k*p and C m*p, operands are never transposed in memory,
+	 * C is scaled and accumulated into tile by tile with the product kernel, [C] isn't read if [beta] is 0
+	 *
+	 * @param alpha - the factor of op(A) * op(B)
+	 * @param left - A
+	 * @param transposeLeft - non-zero for op(A) = ^t A
+	 * @param right - B
+	 * @param transposeRight - non-zero for op(B) = ^t B
+	 * @param beta - the factor of C
+	 * @param result - C, receiving the result, must not be [left] nor [right]
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		any matrix is NULL,
+	 * 		sizes don't match,
+	 * 		[result] is an operand
+	 */
+	int (* gemm)(
+		MATRIX_SCALAR alpha,
+		MATRIX const * left, int transposeLeft,
+		MATRIX const * right, int transposeRight,
+		MATRIX_SCALAR beta,
+		MATRIX * result);
+
+	/**
+	 * Same as product, with the Strassen-Winograd algorithm: each level replaces 8 half-size
+	 * products by 7 of them and 15 additions, down to the crossover size where the
+	 * classical kernel takes over
+	 * Operands are zero-padded when their dimensions can't be halved often enough
+	 * Rounding errors are slightly bigger than with the classical algorithm
+	 * @see tuneStrassen
+	 *
+	 * @param left - the left operand
+	 * @param right - the right operand
+	 *
+	 * @return - the product as a new matrix, or NULL if:
+	 * 		[left] or [right] is NULL,
+	 * 		[left] width != [right] height
+	 * 		allocation failed
+	 */
+	MATRIX * (* strassenProduct)(MATRIX const * left, MATRIX const * right);
+
+	/**
+	 * Tunes when the Strassen-Winograd algorithm is used, for every thread
+	 * Safe to call while other threads multiply: each call reads every setting once, atomically,
+	 * though it may see one of the two from before this call and the other from after
+	 *
+	 * @param crossover - sub-products with any dimension lesser than or equal to this
+	 * 		are computed by the classical kernel, STRASSEN_DEFAULT_CROSSOVER initially,
+	 * 		0 is treated as 1
+	 * @param threshold - product switches to strassenProduct when every dimension of its
+	 * 		operands reaches this, STRASSEN_DEFAULT_THRESHOLD initially, 0 never switches
+	 */
+	void (* tuneStrassen)(size_t crossover, size_t threshold);
+
+	/**
+	 * Tunes when determinant, inverse and isInvertible use a tiled LU factorization
+	 * rather than cofactors, for every thread
+	 *
+	 * @param threshold - square matrices of this size and above are factored,
+	 * 		LU_DEFAULT_THRESHOLD initially, 0 never factors
+	 */
+	void (* tuneLU)(size_t threshold);
+
+	/**
+	 * Sets how many threads run the tasks of product, gemm, and of the LU factorization
+	 * and substitutions, for every thread, those of _Vector->gemv included for double precision
+	 * Work is split in tiles, run as a dependency graph by workers stealing ready tiles from each other
+	 * Results don't depend on [count]: every cell is computed by the same operations, in the same order
+	 *
+	 * @param count - the calling thread included, 1 initially, 0 is treated as 1
+	 */
+	void (* setThreads)(size_t count);
+
+	/**
+	 * Multiplies every cell in [this] by [scalar]
+	 *
+	 * @param this - the matrix to multiply
+	 * @param scalar - the factor with which cells in [this] must be multiplied
+	 *
+	 * @return - a new matrix, where every cell in [this] has been multiplied by [scalar],
+	 * 		or NULL if [this] is NULL, or if allocation failed
+	 */
+	MATRIX * (* scalarProduct)(MATRIX const * this, MATRIX_SCALAR scalar);
+
+	/**
+	 * Let A and B, two m*n matrix, H is the m*n matrix such that Hi,j = Ai,j * Bi,j
+	 *
+	 * @param left - the left operand
+	 * @param right - the right operand
+	 *
+	 * @return - the Hadamard product, or NULL if:
+	 * 		any operand is NULL,
+	 * 		operands don't have the same size,
+	 * 		allocation failed
+	 */
+	MATRIX * (* hadamard)(MATRIX const * left, MATRIX const * right);
+
+	/**
+	 * Copies [this] with every cell brought within [[lower], [upper]]
+	 *
+	 * @param this - the matrix to clamp
+	 * @param lower - the least value of the result
+	 * @param upper - the greatest value of the result
+	 *
+	 * @return - the clamped matrix, or NULL if:
+	 * 		[this] is NULL,
+	 * 		[lower] > [upper],
+	 * 		allocation failed
+	 */
+	MATRIX * (* clamp)(MATRIX const * this, MATRIX_SCALAR lower, MATRIX_SCALAR upper);
+
+	/**
+	 * Applies [function] to every cell of [this], a contiguous chunk of cells at a time,
+	 * a row or the whole matrix, rather than cell by cell
+	 *
+	 * @param this - the matrix to read
+	 * @param function - writes [count] results from [count] cells, chunks are processed in row order
+	 * @param context - handed to [function] as is
+	 *
+	 * @return - the new matrix of results, or NULL if:
+	 * 		[this] or [function] is NULL,
+	 * 		allocation failed
+	 */
+	MATRIX * (* map)(
+		MATRIX const * this,
+		void (* function)(MATRIX_SCALAR const * cells, MATRIX_SCALAR * results, size_t count, void * context),
+		void * context);
+
+	/**
+	 * Same as map, with the matching chunks of two matrices of the same size
+	 *
+	 * @return - the new matrix of results, or NULL if:
+	 * 		any operand or [function] is NULL,
+	 * 		operands don't have the same size,
+	 * 		allocation failed
+	 */
+	MATRIX * (* zip)(
+		MATRIX const * left,
+		MATRIX const * right,
+		void (* function)(MATRIX_SCALAR const * left, MATRIX_SCALAR const * right, MATRIX_SCALAR * results, size_t count, void * context),
+		void * context);
+
+	/**
+	 * Folds every cell of [this] into an accumulator, a contiguous chunk of cells at a time
+	 *
+	 * @param this - the matrix to read
+	 * @param function - returns the accumulator updated with [count] cells, chunks are processed in memory order,
+	 * 		row after row, or column after column for column-major matrices
+	 * @param initial - the accumulator before the first chunk
+	 * @param context - handed to [function] as is
+	 *
+	 * @return - the accumulator after the last chunk, or NO_VALUE if [this] or [function] is NULL
+	 */
+	MATRIX_SCALAR (* reduce)(
+		MATRIX const * this,
+		MATRIX_SCALAR (* function)(MATRIX_SCALAR accumulator, MATRIX_SCALAR const * cells, size_t count, void * context),
+		MATRIX_SCALAR initial,
+		void * context);
+
+	/**
+	 * @param this - the matrix to search
+	 *
+	 * @return - the least cell, or NO_VALUE if [this] is NULL
+	 */
+	MATRIX_SCALAR (* minimum)(MATRIX const * this);
+
+	/**
+	 * @param this - the matrix to search
+	 *
+	 * @return - the greatest cell, or NO_VALUE if [this] is NULL
+	 */
+	MATRIX_SCALAR (* maximum)(MATRIX const * this);
+
+	/**
+	 * @param this - the matrix to add cells of
+	 *
+	 * @return - ∑_i,j Ai,j, or NO_VALUE if [this] is NULL
+	 */
+	MATRIX_SCALAR (* total)(MATRIX const * this);
+
+	/**
+	 * ||A||F = sqrt(∑_i,j Ai,j^2), computed on cells scaled by the greatest magnitude,
+	 * so that squares neither overflow nor underflow
+	 *
+	 * @param this - the matrix to measure
+	 *
+	 * @return - the Frobenius norm, or NO_VALUE if [this] is NULL
+	 */
+	MATRIX_SCALAR (* frobeniusNorm)(MATRIX const * this);
+
+	/**
+	 * Let A, a m*n matrix, and B, a p*q matrix, A ⊗ B is the mp*nq block matrix whose (i,j) block is Ai,j * B
+	 *
+	 * @param left - A
+	 * @param right - B
+	 *
+	 * @return - the Kronecker product, or NULL if:
+	 * 		any operand is NULL,
+	 * 		allocation failed
+	 */
+	MATRIX * (* kronecker)(MATRIX const * left, MATRIX const * right);
+
+	/**
+	 * [left right], side by side
+	 *
+	 * @return - the concatenation, or NULL if:
+	 * 		any operand is NULL,
+	 * 		operands don't have the same height,
+	 * 		allocation failed
+	 */
+	MATRIX * (* hconcat)(MATRIX const * left, MATRIX const * right);
+
+	/**
+	 * [top], above [bottom]
+	 *
+	 * @return - the concatenation, or NULL if:
+	 * 		any operand is NULL,
+	 * 		operands don't have the same width,
+	 * 		allocation failed
+	 */
+	MATRIX * (* vconcat)(MATRIX const * top, MATRIX const * bottom);
+
+	/**
+	 * Assembles a block matrix from a grid of matrices, copied a row at a time into the result
+	 * Blocks of a grid row share their height, blocks of a grid column their width
+	 *
+	 * @param rows - the number of grid rows
+	 * @param columns - the number of grid columns
+	 * @param blocks - [rows]*[columns] matrices, grid row after grid row,
+	 * 		NULL for a zero block, sized by the other blocks of its grid row and column
+	 *
+	 * @return - the block matrix, or NULL if:
+	 * 		[rows] or [columns] is 0, or [blocks] is NULL,
+	 * 		a grid row or column only has NULL blocks,
+	 * 		sizes of blocks don't match,
+	 * 		allocation failed
+	 */
+	MATRIX * (* blockAssemble)(size_t rows, size_t columns, MATRIX const * const * blocks);
+
+	/**
+	 * ONE, INFINITY and MAX read the cells once, FROBENIUS twice, finding the scale first
+	 * @see frobeniusNorm
+	 *
+	 * @param this - the matrix to measure
+	 * @param type - which norm
+	 *
+	 * @return - the norm, or NO_VALUE if [this] is NULL, or allocation failed
+	 */
+	MATRIX_SCALAR (* norm)(MATRIX const * this, MatrixNorm type);
+
+	/**
+	 * Estimates the reciprocal condition number 1 / (||A||1 * ||A^(-1)||1), without inverting A:
+	 * P A = L U is factored once, then Hager's estimator, with Higham's refinements, solves
+	 * a few systems with it, in O(n^2) each
+	 * The estimate of ||A^(-1)||1 is a lower bound, almost always within a factor of 3
+	 * _Factorization->rcond estimates it from an existing LU factorization instead, without factoring A again
+	 *
+	 * @param this - the matrix to estimate the condition of
+	 *
+	 * @return - the estimate, between 0 for singular matrices and 1, or NO_VALUE if [this] is NULL
+	 * 		or allocation failed, or MATRIX_IS_NOT_SQUARE if [this] isn't square
+	 */
+	MATRIX_SCALAR (* rcond)(MATRIX const * this);
+
+	/**
+	 * Checks whether or not [this] can be inverted
+	 * @see inverse
+	 *
+	 * @param this - the matrix to check
+	 *
+	 * @return - 1 if [this] is not NULL, is square, and its determinant isn't zero, 0 otherwise
+	 */
+	int (* isInvertible)(MATRIX const * this);
+
+	/**
+	 * Checks whether or not [this] can be inverted without losing too many digits,
+	 * inverses of matrices whose rcond is near [tolerance] losing about -log10(tolerance) of them
+	 * @see rcond
+	 *
+	 * @param this - the matrix to check
+	 * @param tolerance - the least acceptable rcond
+	 *
+	 * @return - 1 if [this] is not NULL, is square, and its rcond is greater than [tolerance], 0 otherwise
+	 */
+	int (* isWellConditioned)(MATRIX const * this, MATRIX_SCALAR tolerance);
+
+	/**
+	 * Given A, a n*n square matrix, A^(-1) is its inverse matrix, such as A*A^(-1) = A^(-1)*A = Id(n)
+	 * Inverse is only defined for square matrix, with non-zero determinant
+	 * Matrices reaching the LU threshold are inverted by substitution, from P A = L U
+	 * @see tuneLU
+	 *
+	 * @param this - the matrix to invert
+	 *
+	 * @return - the inverse matrix, or NULL if :
+	 * 		[this] is NULL,
+	 * 		[this] isn't square,
+	 * 		[this] as a determinant equal to 0,
+	 * 		some allocation failed
+	 */
+	MATRIX * (* inverse)(MATRIX const * this);
+
+	/**
+	 * Given A, a n*n square matrix, A^k = A*A*...*A, k times, and A^0 = Id(n)
+	 * Computed by repeated squaring, in O(log(k)) products and 3 buffers whatever k is,
+	 * each product on the kernel product would pick: tiled on the worker threads, or Strassen-Winograd
+	 * past the threshold, its workspace allocated along with the buffers
+	 *
+	 * @param this - the matrix to raise
+	 * @param exponent - k
+	 *
+	 * @return - the power as a new matrix, or NULL if:
+	 * 		[this] is NULL,
+	 * 		[this] isn't square,
+	 * 		allocation failed
+	 */
+	MATRIX * (* power)(MATRIX const * this, unsigned long exponent);
+
+	/**
+	 * Given A, a n*n square matrix, exp(A) = ∑_k=0->∞ A^k / k!
+	 * Computed with a degree 6 Padé approximant of A / 2^s, squared s times,
+	 * with s chosen so that the approximant is accurate, in 5 buffers whatever s is
+	 * Products run on the same kernels as power, the approximant is solved for with the blocked LU factorization
+	 *
+	 * @param this - the matrix to get the exponential of
+	 *
+	 * @return - the exponential as a new matrix, or NULL if:
+	 * 		[this] is NULL,
+	 * 		[this] isn't square,
+	 * 		allocation failed
+	 */
+	MATRIX * (* exponential)(MATRIX const * this);
+
+	/**
+	 * Given A, a m*n matrix, A = U Σ ^t V, with U and V orthonormal and Σ diagonal, k = min(m, n)
+	 * Computed by one-sided Jacobi on the k columns of A, or of ^t A when wider than tall:
+	 * sweeps rotate pairs of columns until all are orthogonal, the disjoint pairs of each round
+	 * running as parallel tasks, on a contiguous copy of the columns
+	 * Columns of U or V for singular values lost in rounding are completed to an orthonormal basis
+	 * @see setThreads
+	 *
+	 * @param this - A
+	 * @param full - 0 for the thin decomposition, U m*k and V n*k, other for the full one, U m*m and V n*n
+	 * @param left - receives U, the caller deleting it, may be NULL when it isn't needed
+	 * @param right - receives V, the caller deleting it, may be NULL when it isn't needed
+	 *
+	 * @return - the k singular values as a k*1 matrix, decreasing, or NULL if:
+	 * 		[this] is NULL,
+	 * 		allocation failed
+	 */
+	MATRIX * (* svd)(MATRIX const * this, int full, MATRIX ** left, MATRIX ** right);
+
+	/**
+	 * Given A, a m*n matrix, its Moore-Penrose pseudo-inverse A+ = V Σ+ ^t U, a n*m matrix
+	 * Σ+ inverts the singular values greater than [tolerance] times the greatest one, and zeroes the others
+	 * @see svd
+	 *
+	 * @param this - A
+	 * @param tolerance - relative to the greatest singular value, 0 or less for max(m, n) times the machine epsilon
+	 *
+	 * @return - the pseudo-inverse, or NULL if:
+	 * 		[this] is NULL,
+	 * 		allocation failed
+	 */
+	MATRIX * (* pinv)(MATRIX const * this, MATRIX_SCALAR tolerance);
+
+	/**
+	 * Given A, a m*n matrix, U_r Σ_r ^t V_r keeping the r greatest singular values, the closest matrix
+	 * of rank r to A, in 2-norm and Frobenius norm
+	 * @see svd
+	 *
+	 * @param this - A
+	 * @param rank - r, A itself being rebuilt from min(m, n) or more, and 0 giving zeros
+	 *
+	 * @return - the m*n approximation, or NULL if:
+	 * 		[this] is NULL,
+	 * 		allocation failed
+	 */
+	MATRIX * (* lowRank)(MATRIX const * this, size_t rank);
+
+	/**
+	 * Given A^(-1), the inverse of a n*n matrix, and U and V, two n*k matrices,
+	 * replaces it in place with (A + U ^t V)^(-1), by the Sherman-Morrison-Woodbury formula:
+	 * A^(-1) - A^(-1) U C^(-1) ^t V A^(-1), with C = Id(k) + ^t V A^(-1) U, in O(n^2 k) rather than O(n^3)
+	 * The update is refused when C is singular, or so ill-conditioned next to its terms
+	 * that about half the digits would be lost: A + U ^t V should then be inverted again
+	 *
+	 * @param inverse - A^(-1), left unchanged unless the update succeeds
+	 * @param left - U, k columns
+	 * @param right - V, k columns, u ^t v being a rank 1 update
+	 *
+	 * @return - 1 if [inverse] was updated, 0 if:
+	 * 		any operand is NULL,
+	 * 		[inverse] isn't square, or sizes of [left] and [right] don't match it,
+	 * 		the update is singular or unsafe,
+	 * 		allocation failed
+	 */
+	int (* inverseRankUpdate)(MATRIX * inverse, MATRIX const * left, MATRIX const * right);
+
+	/**
+	 * det(A + U ^t V) = det(C) * det(A), by the matrix determinant lemma, in O(n^2 k)
+	 * To go along with inverseRankUpdate, call it first, with A^(-1) before the update
+	 * @see inverseRankUpdate
+	 *
+	 * @param inverse - A^(-1)
+	 * @param determinant - det(A)
+	 * @param left - U
+	 * @param right - V
+	 *
+	 * @return - the updated determinant, or NO_VALUE if:
+	 * 		any operand is NULL, or [determinant] is NO_VALUE,
+	 * 		[inverse] isn't square, or sizes of [left] and [right] don't match it,
+	 * 		allocation failed
+	 */
+	MATRIX_SCALAR (* determinantRankUpdate)(
+		MATRIX const * inverse,
+		MATRIX_SCALAR determinant,
+		MATRIX const * left,
+		MATRIX const * right);
+
+} MATRIX_METHODS;
+
+
+
+
+/*
+ * Points to a constant table, which MatrixInstrumentation swaps for its own and back
+ * The swap is a plain store, made while no matrix call is running: callers must only read it
+ */
+extern MATRIX_METHODS const * MATRIX_SELF;
@@ -0,0 +1,109 @@
+#ifndef MATRIX_PRIVATE_HEADER
+#define MATRIX_PRIVATE_HEADER
+
+/*
+ * Matrix layout, shared by the library translation units only
+ * Users must go through _Matrix
+ */
+
+#include "Matrix.h"
+
+#include <stdarg.h>
+
+
+
+
+/*
+ * Same layout for every precision, only the type of the cells changes
+ * The structure, its row pointers and its cells are one block from [allocator], in that order
+ * Cells are reached through row pointers into a single height * stride block,
+ * rows are [stride] cells apart, the padding after [width] cells is zeroed and never read
+ *
+ * Column-major matrices point to columns rather than rows, [cells][j][i] being Ai,j:
+ * their cells are those of the row-major ^t A, which they are read as, in O(1)
+ *
+ * Copies are a block holding the structure alone, whose [cells] are the row pointers of [owner]
+ * A block holding cells counts in [references] the matrices reading them, and itself while its structure
+ * is in use, even once it was given cells of its own: blocks of a structure alone always count 0
+ * Both counts are only changed atomically
+ *
+ * Wrapped matrices are a block holding the structure and row pointers, into the caller's [buffer],
+ * handed to [deleter] when the block is freed if the matrix adopted it
+ */
+#define MATRIX_FIELDS(Self, Scalar) \
+	size_t width; \
+	size_t height; \
+	size_t stride; \
+	MatrixLayout layout; \
+	MatrixAllocator allocator; \
+	Scalar ** cells; \
+	struct Self * owner; \
+	long references; \
+	long retains; \
+	Scalar * buffer; \
+	MatrixDeleter deleter; \
+	void * deleterContext;
+
+
+/* how many rows or columns [cells] points to, and how many cells each one has */
+#define MATRIX_LINES(this) (((this)->layout == MATRIX_ROW_MAJOR) ? (this)->height : (this)->width)
+#define MATRIX_LENGTH(this) (((this)->layout == MATRIX_ROW_MAJOR) ? (this)->width : (this)->height)
+
+/* Ai,j whatever the layout, as an lvalue: hot loops should rather walk [cells] line by line */
+#define MATRIX_CELL(this, row, column) \
+	(* (((this)->layout == MATRIX_ROW_MAJOR) ? & (this)->cells[row][column] : & (this)->cells[column][row]))
+
+
+struct Matrix
+{
+	MATRIX_FIELDS(Matrix, double)
+};
+
+
+struct MatrixF
+{
+	MATRIX_FIELDS(MatrixF, float)
+};
+
+
+
+
+/**
+ * Builds a matrix of [layout] from its lines, rows or columns, as fromRows and fromColumns do
+ * Shared with the instrumented constructors, which can't forward variadic arguments
+ * [rest] is read [lines] - 1 times, never past the last line
+ *
+ * @param first - the first line
+ * @param rest - the other lines, started by the caller, which ends it
+ *
+ * @return - the matrix, or NULL if allocation failed
+ */
+Matrix * matrixFromLines(size_t height, size_t width, MatrixLayout layout, double const * first, va_list rest);
+MatrixF * matrixFFromLines(size_t height, size_t width, MatrixLayout layout, float const * first, va_list rest);
+
+/**
+ * Estimates rcond from the factors of P A = L U, as rcond does once it factored A
+ * Shared with Factorization, whose LU factorizations are estimated without being factored again
+ *
+ * @param factors - [size]*[size], row by row, L below the diagonal, its unit diagonal left implicit, and U from it
+ * @param pivots - row [index] was swapped with row [pivots[index]], in increasing order of [index]
+ * @param transposed - whether [factors] are those of ^t A rather than A
+ * @param normA - ||A||1
+ *
+ * @return - the estimate, 0 if A or U is singular, or NO_VALUE if allocation failed
+ */
+double matrixRcondFactored(size_t size, double const * factors, size_t const * pivots, int transposed, double normA);
+float matrixFRcondFactored(size_t size, float const * factors, size_t const * pivots, int transposed, float normA);
+
+
+/**
+ * Shared with Vector, whose products run on the same workers as those of matrices
+ *
+ * @return - the number of threads set by setThreads, the calling thread included
+ */
+size_t matrixThreads(void);
+size_t matrixFThreads(void);
+
+
+
+#endif /* MATRIX_PRIVATE_HEADER */
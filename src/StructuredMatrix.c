@@ -0,0 +1,759 @@
+#include "StructuredMatrix.h"
+#include "MatrixPrivate.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+
+/* (i,j) in the working band of eliminateBanded, rows are [width] cells wide, starting at column i - lower */
+#define BAND(work, width, lower, i, j) ((work)[(i) * (width) + (j) + (lower) - (i)])
+
+
+
+
+struct StructuredMatrix
+{
+	MatrixStructure structure;
+
+	size_t size;
+
+	/* every structure is a band: triangles and symmetric matrices span n - 1 diagonals, diagonal ones none */
+	size_t lowerBandwidth;
+	size_t upperBandwidth;
+
+	double * cells;
+};
+
+
+
+
+/**
+ * Allocates a matrix of zeros, with bandwidths already checked against size
+ *
+ * @return - the matrix, or NULL if allocation failed
+ */
+static StructuredMatrix * allocate(MatrixStructure structure, size_t size, size_t lowerBandwidth, size_t upperBandwidth);
+
+/**
+ * @return - the address of the stored cell holding Ai,j, or NULL if it is a structural zero,
+ * 		both indices must be in bounds
+ */
+static double * locate(StructuredMatrix const * this, size_t ordinate, size_t abscissa);
+
+/**
+ * Columns of row i that may hold a non-zero, symmetric cells included
+ */
+static void rowRange(StructuredMatrix const * this, size_t ordinate, size_t * first, size_t * last);
+
+/**
+ * Columns of row i that are actually stored, only the lower triangle of symmetric matrices
+ */
+static void storedRange(StructuredMatrix const * this, size_t ordinate, size_t * first, size_t * last);
+
+/**
+ * Adds every stored cell of [source] to the same cell of [destination], which must contain its structure
+ */
+static void accumulate(StructuredMatrix * destination, StructuredMatrix const * source);
+
+/**
+ * Factors a packed symmetric matrix as L ^t L, in place, L packed lower
+ *
+ * @return - 1, or 0 if the matrix isn't positive definite
+ */
+static int cholesky(size_t size, double * packed);
+
+/**
+ * Gaussian elimination with partial pivoting on a band matrix, in place
+ * Row exchanges spread upper bands by [lower] more diagonals, [work] has room for them
+ *
+ * @param work - rows of 2 * lower + upper + 1 cells, see BAND
+ * @param rightHand - transformed along with the matrix, may be NULL
+ * @param sign - receives the parity of row exchanges, 1 or -1
+ *
+ * @return - 1, or 0 if the matrix is singular
+ */
+static int eliminateBanded(size_t size, size_t lower, size_t upper, double * work, double * rightHand, int * sign);
+
+/**
+ * Copies A into a working band for eliminateBanded, symmetric matrices are fully expanded
+ *
+ * @return - the working band, or NULL if allocation failed
+ */
+static double * bandOf(StructuredMatrix const * this, size_t * lower, size_t * upper);
+
+
+
+
+static StructuredMatrix * create(MatrixStructure structure, size_t size)
+{
+	if (size == 0)
+		return NULL;
+
+	switch (structure)
+	{
+		case STRUCTURE_UPPER_TRIANGULAR:
+			return allocate(structure, size, 0, size - 1);
+		case STRUCTURE_LOWER_TRIANGULAR:
+			return allocate(structure, size, size - 1, 0);
+		case STRUCTURE_SYMMETRIC:
+			return allocate(structure, size, size - 1, size - 1);
+		case STRUCTURE_DIAGONAL:
+			return allocate(structure, size, 0, 0);
+		default:
+			return NULL;
+	}
+}
+
+
+static StructuredMatrix * banded(size_t size, size_t lowerBandwidth, size_t upperBandwidth)
+{
+	if (size == 0)
+		return NULL;
+	if ((lowerBandwidth >= size) || (upperBandwidth >= size))
+		return NULL;
+
+	return allocate(STRUCTURE_BANDED, size, lowerBandwidth, upperBandwidth);
+}
+
+
+static void delete(StructuredMatrix ** this)
+{
+	if (this == NULL)
+		return;
+	if (* this == NULL)
+		return;
+
+	free((* this)->cells);
+	(* this)->cells = NULL;
+
+	free(* this);
+	* this = NULL;
+}
+
+
+static StructuredMatrix * fromDense(Matrix const * const dense, MatrixStructure structure, size_t lowerBandwidth, size_t upperBandwidth)
+{
+	StructuredMatrix * this;
+	size_t rowIndex, columnIndex, first, last;
+
+	if (dense == NULL)
+		return NULL;
+	if (dense->width != dense->height)
+		return NULL;
+
+	if (structure == STRUCTURE_BANDED)
+		this = _StructuredMatrix->banded(dense->height, lowerBandwidth, upperBandwidth);
+	else
+		this = _StructuredMatrix->create(structure, dense->height);
+	if (this == NULL)
+		return NULL;
+
+	for (rowIndex = 0; rowIndex < this->size; rowIndex++)
+	{
+		storedRange(this, rowIndex, & first, & last);
+		for (columnIndex = first; columnIndex <= last; columnIndex++)
+			* locate(this, rowIndex, columnIndex) = MATRIX_CELL(dense, rowIndex, columnIndex);
+	}
+
+	return this;
+}
+
+
+static Matrix * toDense(StructuredMatrix const * const this)
+{
+	Matrix * dense;
+	size_t rowIndex, columnIndex, first, last;
+
+	if (this == NULL)
+		return NULL;
+
+	dense = _Matrix->create(this->size, this->size);
+	if (dense == NULL)
+		return NULL;
+
+	for (rowIndex = 0; rowIndex < this->size; rowIndex++)
+	{
+		rowRange(this, rowIndex, & first, & last);
+		for (columnIndex = first; columnIndex <= last; columnIndex++)
+			dense->cells[rowIndex][columnIndex] = * locate(this, rowIndex, columnIndex);
+	}
+
+	return dense;
+}
+
+
+static MatrixStructure structure(StructuredMatrix const * const this)
+{
+	return this->structure;
+}
+
+
+static size_t size(StructuredMatrix const * const this)
+{
+	if (this == NULL)
+		return 0;
+	return this->size;
+}
+
+
+static double getCell(StructuredMatrix const * const this, size_t ordinate, size_t abscissa)
+{
+	double const * cell;
+
+	if (this == NULL)
+		return NO_VALUE;
+	if ((ordinate >= this->size) || (abscissa >= this->size))
+		return NO_VALUE;
+
+	cell = locate(this, ordinate, abscissa);
+
+	return (cell == NULL) ? 0 : * cell;
+}
+
+
+static int setCell(StructuredMatrix * const this, size_t ordinate, size_t abscissa, double value)
+{
+	double * cell;
+
+	if (this == NULL)
+		return 0;
+	if ((ordinate >= this->size) || (abscissa >= this->size))
+		return 0;
+
+	cell = locate(this, ordinate, abscissa);
+	if (cell == NULL)
+		return value == 0;
+
+	* cell = value;
+
+	return 1;
+}
+
+
+static StructuredMatrix * sum(StructuredMatrix const * const left, StructuredMatrix const * const right)
+{
+	StructuredMatrix * result;
+	StructuredMatrix const * shape;
+
+	if ((left == NULL) || (right == NULL))
+		return NULL;
+	if (left->size != right->size)
+		return NULL;
+
+	if (left->structure == right->structure)
+		shape = left;
+	else if (left->structure == STRUCTURE_DIAGONAL)
+		shape = right;
+	else if (right->structure == STRUCTURE_DIAGONAL)
+		shape = left;
+	else
+		return NULL;
+
+	/* a diagonal operand fits in any band, band operands give the widest one */
+	result = allocate(
+		shape->structure,
+		shape->size,
+		(left->lowerBandwidth > right->lowerBandwidth) ? left->lowerBandwidth : right->lowerBandwidth,
+		(left->upperBandwidth > right->upperBandwidth) ? left->upperBandwidth : right->upperBandwidth);
+	if (result == NULL)
+		return NULL;
+
+	accumulate(result, left);
+	accumulate(result, right);
+
+	return result;
+}
+
+
+static Matrix * product(StructuredMatrix const * const left, Matrix const * const right)
+{
+	Matrix * result;
+	size_t rowIndex, innerIndex, columnIndex, first, last;
+	double factor;
+	double const * rightRow;
+	double * resultRow;
+
+	if ((left == NULL) || (right == NULL))
+		return NULL;
+	if (right->height != left->size)
+		return NULL;
+
+	result = _Matrix->create(left->size, right->width);
+	if (result == NULL)
+		return NULL;
+
+	/* row i of the result accumulates rows of the right operand, for non-zero Ai,k only */
+	for (rowIndex = 0; rowIndex < left->size; rowIndex++)
+	{
+		resultRow = result->cells[rowIndex];
+
+		rowRange(left, rowIndex, & first, & last);
+		for (innerIndex = first; innerIndex <= last; innerIndex++)
+		{
+			factor = * locate(left, rowIndex, innerIndex);
+			if (factor == 0)
+				continue;
+
+			/* a column-major operand is read across its columns, the rows aren't stored */
+			if (right->layout == MATRIX_COLUMN_MAJOR)
+			{
+				for (columnIndex = 0; columnIndex < right->width; columnIndex++)
+					resultRow[columnIndex] += factor * right->cells[columnIndex][innerIndex];
+				continue;
+			}
+
+			rightRow = right->cells[innerIndex];
+			for (columnIndex = 0; columnIndex < right->width; columnIndex++)
+				resultRow[columnIndex] += factor * rightRow[columnIndex];
+		}
+	}
+
+	return result;
+}
+
+
+static StructuredMatrix * transpose(StructuredMatrix const * const this)
+{
+	StructuredMatrix * result;
+	MatrixStructure transposed;
+	size_t rowIndex, columnIndex, first, last;
+
+	if (this == NULL)
+		return NULL;
+
+	if (this->structure == STRUCTURE_UPPER_TRIANGULAR)
+		transposed = STRUCTURE_LOWER_TRIANGULAR;
+	else if (this->structure == STRUCTURE_LOWER_TRIANGULAR)
+		transposed = STRUCTURE_UPPER_TRIANGULAR;
+	else
+		transposed = this->structure;
+
+	result = allocate(transposed, this->size, this->upperBandwidth, this->lowerBandwidth);
+	if (result == NULL)
+		return NULL;
+
+	if ((transposed == STRUCTURE_SYMMETRIC) || (transposed == STRUCTURE_DIAGONAL))
+	{
+		memcpy(result->cells, this->cells, (this->structure == STRUCTURE_DIAGONAL)
+			? this->size * sizeof(* this->cells)
+			: this->size * (this->size + 1) / 2 * sizeof(* this->cells));
+		return result;
+	}
+
+	for (rowIndex = 0; rowIndex < this->size; rowIndex++)
+	{
+		storedRange(this, rowIndex, & first, & last);
+		for (columnIndex = first; columnIndex <= last; columnIndex++)
+			* locate(result, columnIndex, rowIndex) = * locate(this, rowIndex, columnIndex);
+	}
+
+	return result;
+}
+
+
+static double determinant(StructuredMatrix const * const this)
+{
+	double * work;
+	double determinant;
+	size_t index, lower, upper, width;
+	int sign;
+
+	if (this == NULL)
+		return NO_VALUE;
+
+	if (this->structure == STRUCTURE_SYMMETRIC)
+	{
+		work = malloc(this->size * (this->size + 1) / 2 * sizeof(* work));
+		if (work == NULL)
+			return NO_VALUE;
+		memcpy(work, this->cells, this->size * (this->size + 1) / 2 * sizeof(* work));
+
+		/* det A = det L ^2 */
+		if (cholesky(this->size, work))
+		{
+			determinant = 1;
+			for (index = 0; index < this->size; index++)
+				determinant *= work[index * (index + 3) / 2];
+			free(work);
+			return determinant * determinant;
+		}
+		free(work);
+	}
+
+	if ((this->structure == STRUCTURE_SYMMETRIC) || (this->structure == STRUCTURE_BANDED))
+	{
+		work = bandOf(this, & lower, & upper);
+		if (work == NULL)
+			return NO_VALUE;
+
+		determinant = 0;
+		if (eliminateBanded(this->size, lower, upper, work, NULL, & sign))
+		{
+			width = 2 * lower + upper + 1;
+			determinant = sign;
+			for (index = 0; index < this->size; index++)
+				determinant *= BAND(work, width, lower, index, index);
+		}
+		free(work);
+		return determinant;
+	}
+
+	/* triangular and diagonal matrices */
+	determinant = 1;
+	for (index = 0; index < this->size; index++)
+		determinant *= * locate(this, index, index);
+
+	return determinant;
+}
+
+
+static Vector * solve(StructuredMatrix const * const this, Vector const * const rightHand)
+{
+	Vector * solution;
+	double * x, * work, * row;
+	double pivot;
+	size_t rowIndex, columnIndex, index, lower, upper, width, first, last;
+	int sign, solved;
+
+	if ((this == NULL) || (rightHand == NULL))
+		return NULL;
+	if (_Vector->size(rightHand) != this->size)
+		return NULL;
+
+	solution = _Vector->copy(rightHand);
+	if (solution == NULL)
+		return NULL;
+	x = _Vector->cells(solution);
+
+	if (this->structure == STRUCTURE_SYMMETRIC)
+	{
+		work = malloc(this->size * (this->size + 1) / 2 * sizeof(* work));
+		if (work == NULL)
+		{
+			_Vector->delete(& solution);
+			return NULL;
+		}
+		memcpy(work, this->cells, this->size * (this->size + 1) / 2 * sizeof(* work));
+
+		/* L y = b, then ^t L x = y, rows of L are contiguous in packed storage */
+		if (cholesky(this->size, work))
+		{
+			for (rowIndex = 0; rowIndex < this->size; rowIndex++)
+			{
+				row = work + rowIndex * (rowIndex + 1) / 2;
+				for (columnIndex = 0; columnIndex < rowIndex; columnIndex++)
+					x[rowIndex] -= row[columnIndex] * x[columnIndex];
+				x[rowIndex] /= row[rowIndex];
+			}
+			for (rowIndex = this->size; rowIndex-- > 0;)
+			{
+				row = work + rowIndex * (rowIndex + 1) / 2;
+				x[rowIndex] /= row[rowIndex];
+				for (columnIndex = 0; columnIndex < rowIndex; columnIndex++)
+					x[columnIndex] -= row[columnIndex] * x[rowIndex];
+			}
+			free(work);
+			return solution;
+		}
+		free(work);
+	}
+
+	if ((this->structure == STRUCTURE_SYMMETRIC) || (this->structure == STRUCTURE_BANDED))
+	{
+		work = bandOf(this, & lower, & upper);
+		if (work == NULL)
+		{
+			_Vector->delete(& solution);
+			return NULL;
+		}
+
+		solved = eliminateBanded(this->size, lower, upper, work, x, & sign);
+		if (solved)
+		{
+			/* the eliminated band is upper triangular, [lower + upper] diagonals wide */
+			width = 2 * lower + upper + 1;
+			for (rowIndex = this->size; rowIndex-- > 0;)
+			{
+				last = rowIndex + lower + upper;
+				if (last >= this->size)
+					last = this->size - 1;
+				for (columnIndex = rowIndex + 1; columnIndex <= last; columnIndex++)
+					x[rowIndex] -= BAND(work, width, lower, rowIndex, columnIndex) * x[columnIndex];
+				x[rowIndex] /= BAND(work, width, lower, rowIndex, rowIndex);
+			}
+		}
+		free(work);
+
+		if (! solved)
+			_Vector->delete(& solution);
+		return solution;
+	}
+
+	/* triangular and diagonal matrices, by substitution in dependency order */
+	for (index = 0; index < this->size; index++)
+	{
+		rowIndex = (this->structure == STRUCTURE_UPPER_TRIANGULAR) ? this->size - 1 - index : index;
+
+		pivot = * locate(this, rowIndex, rowIndex);
+		if (pivot == 0)
+		{
+			_Vector->delete(& solution);
+			return NULL;
+		}
+
+		rowRange(this, rowIndex, & first, & last);
+		for (columnIndex = first; columnIndex <= last; columnIndex++)
+		{
+			if (columnIndex != rowIndex)
+				x[rowIndex] -= * locate(this, rowIndex, columnIndex) * x[columnIndex];
+		}
+		x[rowIndex] /= pivot;
+	}
+
+	return solution;
+}
+
+
+
+
+static StructuredMatrix * allocate(MatrixStructure structure, size_t size, size_t lowerBandwidth, size_t upperBandwidth)
+{
+	StructuredMatrix * this;
+	size_t count;
+
+	switch (structure)
+	{
+		case STRUCTURE_BANDED:
+			count = size * (lowerBandwidth + upperBandwidth + 1);
+			break;
+		case STRUCTURE_DIAGONAL:
+			count = size;
+			break;
+		default:
+			count = size * (size + 1) / 2;
+			break;
+	}
+
+	this = malloc(sizeof(* this));
+	if (this == NULL)
+		return NULL;
+
+	this->cells = calloc(count, sizeof(* this->cells));
+	if (this->cells == NULL)
+	{
+		free(this);
+		return NULL;
+	}
+
+	this->structure = structure;
+	this->size = size;
+	this->lowerBandwidth = lowerBandwidth;
+	this->upperBandwidth = upperBandwidth;
+
+	return this;
+}
+
+
+static double * locate(StructuredMatrix const * const this, size_t ordinate, size_t abscissa)
+{
+	size_t swap;
+
+	switch (this->structure)
+	{
+		case STRUCTURE_UPPER_TRIANGULAR:
+			if (abscissa < ordinate)
+				return NULL;
+			/* rows above hold n, n - 1, ... cells */
+			return this->cells + ordinate * this->size - ordinate * (ordinate - 1) / 2 + abscissa - ordinate;
+
+		case STRUCTURE_SYMMETRIC:
+			if (abscissa > ordinate)
+			{
+				swap = abscissa;
+				abscissa = ordinate;
+				ordinate = swap;
+			}
+			return this->cells + ordinate * (ordinate + 1) / 2 + abscissa;
+
+		case STRUCTURE_LOWER_TRIANGULAR:
+			if (abscissa > ordinate)
+				return NULL;
+			return this->cells + ordinate * (ordinate + 1) / 2 + abscissa;
+
+		case STRUCTURE_BANDED:
+			if ((abscissa + this->lowerBandwidth < ordinate) || (abscissa > ordinate + this->upperBandwidth))
+				return NULL;
+			return this->cells + ordinate * (this->lowerBandwidth + this->upperBandwidth + 1)
+				+ abscissa + this->lowerBandwidth - ordinate;
+
+		default:
+			return (abscissa == ordinate) ? this->cells + ordinate : NULL;
+	}
+}
+
+
+static void rowRange(StructuredMatrix const * const this, size_t ordinate, size_t * const first, size_t * const last)
+{
+	* first = (ordinate > this->lowerBandwidth) ? ordinate - this->lowerBandwidth : 0;
+	* last = ordinate + this->upperBandwidth;
+	if (* last >= this->size)
+		* last = this->size - 1;
+}
+
+
+static void storedRange(StructuredMatrix const * const this, size_t ordinate, size_t * const first, size_t * const last)
+{
+	rowRange(this, ordinate, first, last);
+	if (this->structure == STRUCTURE_SYMMETRIC)
+		* last = ordinate;
+}
+
+
+static void accumulate(StructuredMatrix * const destination, StructuredMatrix const * const source)
+{
+	size_t rowIndex, columnIndex, first, last;
+
+	for (rowIndex = 0; rowIndex < source->size; rowIndex++)
+	{
+		storedRange(source, rowIndex, & first, & last);
+		for (columnIndex = first; columnIndex <= last; columnIndex++)
+			* locate(destination, rowIndex, columnIndex) += * locate(source, rowIndex, columnIndex);
+	}
+}
+
+
+static int cholesky(size_t size, double * const packed)
+{
+	size_t rowIndex, columnIndex, index;
+	double * row, * column;
+	double value;
+
+	for (rowIndex = 0; rowIndex < size; rowIndex++)
+	{
+		row = packed + rowIndex * (rowIndex + 1) / 2;
+
+		for (columnIndex = 0; columnIndex <= rowIndex; columnIndex++)
+		{
+			column = packed + columnIndex * (columnIndex + 1) / 2;
+
+			/* Li,j = (Ai,j - ∑_k<j Li,k * Lj,k) / Lj,j */
+			value = row[columnIndex];
+			for (index = 0; index < columnIndex; index++)
+				value -= row[index] * column[index];
+
+			if (columnIndex < rowIndex)
+				row[columnIndex] = value / column[columnIndex];
+			else if (value > 0)
+				row[columnIndex] = sqrt(value);
+			else
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+
+static int eliminateBanded(size_t size, size_t lower, size_t upper, double * const work, double * const rightHand, int * const sign)
+{
+	size_t width, pivotIndex, rowIndex, columnIndex, lastRow, lastColumn;
+	double factor, swap;
+
+	width = 2 * lower + upper + 1;
+	* sign = 1;
+
+	for (pivotIndex = 0; pivotIndex < size; pivotIndex++)
+	{
+		lastRow = (pivotIndex + lower < size) ? pivotIndex + lower : size - 1;
+		lastColumn = (pivotIndex + lower + upper < size) ? pivotIndex + lower + upper : size - 1;
+
+		/* only the [lower] rows below the pivot have a non-zero in its column */
+		rowIndex = pivotIndex;
+		for (columnIndex = pivotIndex + 1; columnIndex <= lastRow; columnIndex++)
+		{
+			if (fabs(BAND(work, width, lower, columnIndex, pivotIndex)) > fabs(BAND(work, width, lower, rowIndex, pivotIndex)))
+				rowIndex = columnIndex;
+		}
+		if (BAND(work, width, lower, rowIndex, pivotIndex) == 0)
+			return 0;
+
+		if (rowIndex != pivotIndex)
+		{
+			for (columnIndex = pivotIndex; columnIndex <= lastColumn; columnIndex++)
+			{
+				swap = BAND(work, width, lower, pivotIndex, columnIndex);
+				BAND(work, width, lower, pivotIndex, columnIndex) = BAND(work, width, lower, rowIndex, columnIndex);
+				BAND(work, width, lower, rowIndex, columnIndex) = swap;
+			}
+			if (rightHand != NULL)
+			{
+				swap = rightHand[pivotIndex];
+				rightHand[pivotIndex] = rightHand[rowIndex];
+				rightHand[rowIndex] = swap;
+			}
+			* sign = -(* sign);
+		}
+
+		for (rowIndex = pivotIndex + 1; rowIndex <= lastRow; rowIndex++)
+		{
+			factor = BAND(work, width, lower, rowIndex, pivotIndex) / BAND(work, width, lower, pivotIndex, pivotIndex);
+			if (factor == 0)
+				continue;
+
+			for (columnIndex = pivotIndex; columnIndex <= lastColumn; columnIndex++)
+				BAND(work, width, lower, rowIndex, columnIndex) -= factor * BAND(work, width, lower, pivotIndex, columnIndex);
+			if (rightHand != NULL)
+				rightHand[rowIndex] -= factor * rightHand[pivotIndex];
+		}
+	}
+
+	return 1;
+}
+
+
+static double * bandOf(StructuredMatrix const * const this, size_t * const lower, size_t * const upper)
+{
+	double * work;
+	size_t width, rowIndex, columnIndex, first, last;
+
+	* lower = this->lowerBandwidth;
+	* upper = this->upperBandwidth;
+	width = 2 * (* lower) + (* upper) + 1;
+
+	work = calloc(this->size * width, sizeof(* work));
+	if (work == NULL)
+		return NULL;
+
+	for (rowIndex = 0; rowIndex < this->size; rowIndex++)
+	{
+		rowRange(this, rowIndex, & first, & last);
+		for (columnIndex = first; columnIndex <= last; columnIndex++)
+			BAND(work, width, * lower, rowIndex, columnIndex) = * locate(this, rowIndex, columnIndex);
+	}
+
+	return work;
+}
+
+
+
+static StructuredMatrixMethods methods =
+{
+	create,
+	banded,
+	delete,
+	fromDense,
+	toDense,
+	structure,
+	size,
+	getCell,
+	setCell,
+	sum,
+	product,
+	transpose,
+	determinant,
+	solve
+};
+StructuredMatrixMethods const * const _StructuredMatrix = & methods;
@@ -0,0 +1,193 @@
+#ifndef STRUCTURED_MATRIX_HEADER
+#define STRUCTURED_MATRIX_HEADER
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <stddef.h>
+
+
+
+
+/*
+ * Square matrices whose known zeros (or symmetry) are not stored, nor computed with
+ */
+typedef struct StructuredMatrix StructuredMatrix;
+
+
+typedef enum
+{
+	/* Ai,j = 0 for i > j, stored packed row by row, n(n+1)/2 cells */
+	STRUCTURE_UPPER_TRIANGULAR,
+
+	/* Ai,j = 0 for i < j, stored packed row by row, n(n+1)/2 cells */
+	STRUCTURE_LOWER_TRIANGULAR,
+
+	/* Ai,j = Aj,i, the lower triangle is stored packed row by row, n(n+1)/2 cells */
+	STRUCTURE_SYMMETRIC,
+
+	/* Ai,j = 0 for j < i - kl or j > i + ku, stored row by row, n(kl+ku+1) cells */
+	STRUCTURE_BANDED,
+
+	/* Ai,j = 0 for i != j, n cells */
+	STRUCTURE_DIAGONAL
+} MatrixStructure;
+
+
+typedef struct
+{
+	/**
+	 * Creates a n*n matrix of zeros with the given structure
+	 *
+	 * @param structure - any structure but STRUCTURE_BANDED
+	 * @param size - n
+	 *
+	 * @return - the created matrix, or NULL if:
+	 * 		size is 0,
+	 * 		structure is STRUCTURE_BANDED,
+	 * 		allocation failed
+	 */
+	StructuredMatrix * (* create)(MatrixStructure structure, size_t size);
+
+	/**
+	 * Creates a n*n band matrix of zeros
+	 *
+	 * @param size - n
+	 * @param lowerBandwidth - kl, the number of non-zero diagonals below the main one
+	 * @param upperBandwidth - ku, the number of non-zero diagonals above the main one
+	 *
+	 * @return - the created matrix, or NULL if:
+	 * 		size is 0,
+	 * 		any bandwidth is greater than or equal to size,
+	 * 		allocation failed
+	 */
+	StructuredMatrix * (* banded)(size_t size, size_t lowerBandwidth, size_t upperBandwidth);
+
+	/**
+	 * Deletes the matrix, and sets it to NULL
+	 *
+	 * @param this - pointer to pointer to matrix to delete
+	 */
+	void (* delete)(StructuredMatrix ** this);
+
+	/**
+	 * Packs a dense square matrix, cells outside of the structure are ignored,
+	 * the lower triangle is read for STRUCTURE_SYMMETRIC
+	 *
+	 * @param dense - the matrix to pack
+	 * @param structure - the structure to pack into
+	 * @param lowerBandwidth - kl, for STRUCTURE_BANDED only
+	 * @param upperBandwidth - ku, for STRUCTURE_BANDED only
+	 *
+	 * @return - the packed matrix, or NULL if:
+	 * 		[dense] is NULL or isn't square,
+	 * 		bandwidths are invalid,
+	 * 		allocation failed
+	 */
+	StructuredMatrix * (* fromDense)(Matrix const * dense, MatrixStructure structure, size_t lowerBandwidth, size_t upperBandwidth);
+
+	/**
+	 * Unpacks the matrix, zeros and symmetric cells included
+	 *
+	 * @param this - the matrix to unpack
+	 *
+	 * @return - the dense matrix, or NULL if [this] is NULL or allocation failed
+	 */
+	Matrix * (* toDense)(StructuredMatrix const * this);
+
+	/**
+	 * @return - the structure of [this], which must not be NULL
+	 */
+	MatrixStructure (* structure)(StructuredMatrix const * this);
+
+	/**
+	 * @return - n, for a n*n matrix, or 0 if [this] is NULL
+	 */
+	size_t (* size)(StructuredMatrix const * this);
+
+	/**
+	 * Returns Ai,j, structural zeros included
+	 *
+	 * @return - the requested cell, or NO_VALUE if:
+	 * 		[this] is NULL,
+	 * 		out of bounds occurred
+	 */
+	double (* getCell)(StructuredMatrix const * this, size_t ordinate, size_t abscissa);
+
+	/**
+	 * Sets Ai,j, and Aj,i for symmetric matrices
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		[this] is NULL,
+	 * 		out of bounds occurred,
+	 * 		the cell is a structural zero and [value] is not 0
+	 */
+	int (* setCell)(StructuredMatrix * this, size_t ordinate, size_t abscissa, double value);
+
+	/**
+	 * Let A and B, two n*n structured matrices, S is such that Si,j = Ai,j + Bi,j
+	 * Only stored cells are added
+	 *
+	 * @return - the sum, with the structure of the operands, or of the non-diagonal one,
+	 * 		band matrices giving the widest bands, or NULL if:
+	 * 		any operand is NULL,
+	 * 		operands don't have the same size,
+	 * 		structures differ and none is diagonal,
+	 * 		allocation failed
+	 */
+	StructuredMatrix * (* sum)(StructuredMatrix const * left, StructuredMatrix const * right);
+
+	/**
+	 * Let A, a n*n structured matrix, and B, a n*p dense matrix, P = AB is the dense n*p matrix
+	 * Only stored cells of A are multiplied, rows of B and P are streamed
+	 *
+	 * @return - the product as a new matrix, or NULL if:
+	 * 		any operand is NULL,
+	 * 		[right] height != n,
+	 * 		allocation failed
+	 */
+	Matrix * (* product)(StructuredMatrix const * left, Matrix const * right);
+
+	/**
+	 * Transposition swaps upper and lower triangles, and the bandwidths of band matrices,
+	 * symmetric and diagonal matrices are copied
+	 *
+	 * @return - the transpose, or NULL if [this] is NULL or allocation failed
+	 */
+	StructuredMatrix * (* transpose)(StructuredMatrix const * this);
+
+	/**
+	 * Triangular and diagonal determinants are the product of the diagonal,
+	 * band matrices are factored in O(n kl (kl + ku)), symmetric ones with Cholesky
+	 * when positive definite, and Gaussian elimination otherwise
+	 *
+	 * @return - the determinant, or NO_VALUE if [this] is NULL or allocation failed
+	 */
+	double (* determinant)(StructuredMatrix const * this);
+
+	/**
+	 * Solves A x = b, with substitution for triangular and diagonal matrices,
+	 * and the same factorizations as determinant otherwise
+	 *
+	 * @param this - A
+	 * @param rightHand - b, a n-sized vector
+	 *
+	 * @return - x as a new vector, or NULL if:
+	 * 		any parameter is NULL,
+	 * 		[rightHand] size != n,
+	 * 		A is singular,
+	 * 		allocation failed
+	 */
+	Vector * (* solve)(StructuredMatrix const * this, Vector const * rightHand);
+
+} StructuredMatrixMethods;
+
+
+
+
+extern StructuredMatrixMethods const * const _StructuredMatrix;
+
+
+
+
+#endif /* STRUCTURED_MATRIX_HEADER */
@@ -0,0 +1,638 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "TaskGraph.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+
+
+
+/* workers of a run, at most, the calling thread included, and one less pool threads */
+#define MAXIMUM_WORKERS 64
+
+
+
+
+typedef struct
+{
+	void (* run)(void * context, size_t index);
+	size_t index;
+
+	/* number of tasks to wait for */
+	size_t prerequisites;
+
+	/* first edge towards a task waiting for this one, NO_TASK if none */
+	size_t firstDependent;
+} Task;
+
+
+typedef struct
+{
+	size_t dependent;
+
+	/* next edge leaving the same task, NO_TASK if none */
+	size_t next;
+} Edge;
+
+
+struct TaskGraph
+{
+	void * context;
+
+	Task * tasks;
+	size_t tasksCount;
+	size_t tasksCapacity;
+
+	Edge * edges;
+	size_t edgesCount;
+	size_t edgesCapacity;
+};
+
+
+/**
+ * Chase-Lev deque of tasks ready to run, owned by one worker, without locks
+ * Its owner pushes and takes at the bottom, other workers steal from the top, a compare and swap of [top]
+ * settling which of them gets the last task
+ * [top] and [bottom] only grow, but for the owner taking back what it pushed, cells being used modulo the capacity
+ */
+typedef struct
+{
+	/* a power of 2 no lesser than the number of tasks, each task being pushed once, so pushing never overflows */
+	size_t * tasks;
+	size_t mask;
+
+	long top;
+	long bottom;
+} Deque;
+
+
+typedef struct Run Run;
+
+
+typedef struct
+{
+	Run * shared;
+	size_t number;
+	Deque deque;
+} Worker;
+
+
+/**
+ * State of one run, shared by its workers, changed atomically only
+ */
+struct Run
+{
+	TaskGraph const * graph;
+
+	/* prerequisites each task is still waiting for */
+	size_t * remaining;
+
+	size_t completed;
+
+	Worker * workers;
+	size_t workersCount;
+
+	/* pool threads working on the run, guarded by [poolLock]: the run ends once they all left it */
+	size_t active;
+};
+
+
+
+
+/**
+ * Runs every task on the calling thread, in the order they were added, which respects dependencies
+ */
+static void runInOrder(TaskGraph const * this);
+
+/**
+ * Starts pool threads until there are [count], never stopped
+ *
+ * @return - how many pool threads there are, less than [count] if starting one failed
+ */
+static size_t startPool(size_t count);
+
+/**
+ * Serves runs as pool thread [number], forever
+ *
+ * @param number - points to the number of the thread, from 1, the worker it is in every run
+ *
+ * @return - NULL, never reached
+ */
+static void * serve(void * number);
+
+/**
+ * Pushes [task] to the bottom of [this], by its owner only
+ */
+static void push(Deque * this, size_t task);
+
+/**
+ * Takes back the task last pushed to [this], by its owner only
+ *
+ * @return - the task, or NO_TASK if [this] is empty, or a thief stole the last one
+ */
+static size_t pop(Deque * this);
+
+/**
+ * Steals the oldest task of [this], from any other worker
+ *
+ * @return - the task, or NO_TASK if [this] is empty, or another worker took it first
+ */
+static size_t steal(Deque * this);
+
+/**
+ * Takes a ready task from the bottom of the worker's own deque, or steals one from the top of another
+ *
+ * @return - the task, or NO_TASK if every deque looked empty
+ */
+static size_t take(Worker * worker);
+
+/**
+ * Runs tasks until the whole graph is done, sleeping while there is nothing to take
+ */
+static void work(Worker * worker);
+
+/**
+ * Counts [task] as done, and pushes the tasks it was the last prerequisite of to the worker's deque
+ * Sleeping workers are woken if any was pushed, or if [task] was the last one
+ */
+static void complete(Worker * worker, size_t task);
+
+/**
+ * @return - 1 if a deque of [shared] has a task, or the run is done, 0 otherwise
+ */
+static int isWorthWaking(Run * shared);
+
+
+
+
+/*
+ * The pool: threads are started by the first runs needing them, then sleep on [poolWake] between runs
+ * [poolLock] is only taken to hand runs over and to put idle workers to sleep, never to take or complete tasks
+ * One run uses the pool at a time, [busy] being set meanwhile: others, tasks running nested runs among them,
+ * run their tasks on their calling thread
+ */
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poolWake = PTHREAD_COND_INITIALIZER;
+static size_t poolSize = 0;
+static int busy = 0;
+
+/* the run being served, NULL between runs, and how many runs were handed over, to join each once */
+static Run * current = NULL;
+static unsigned long generation = 0;
+
+/* workers sleeping on [poolWake] during a run, which those pushing tasks check before taking [poolLock] */
+static size_t sleepers = 0;
+
+/* the argument of each pool thread */
+static size_t numbers[MAXIMUM_WORKERS];
+
+
+
+
+static TaskGraph * create(void * const context)
+{
+	TaskGraph * this;
+
+	this = malloc(sizeof(* this));
+	if (this == NULL)
+		return NULL;
+
+	this->context = context;
+	this->tasks = NULL;
+	this->tasksCount = 0;
+	this->tasksCapacity = 0;
+	this->edges = NULL;
+	this->edgesCount = 0;
+	this->edgesCapacity = 0;
+
+	return this;
+}
+
+
+static void delete(TaskGraph ** this)
+{
+	if (this == NULL)
+		return;
+	if (* this == NULL)
+		return;
+
+	free((* this)->tasks);
+	free((* this)->edges);
+
+	free(* this);
+	* this = NULL;
+}
+
+
+static size_t add(TaskGraph * const this, void (* const run)(void * context, size_t index), size_t index)
+{
+	Task * tasks;
+	size_t capacity;
+
+	if ((this == NULL) || (run == NULL))
+		return NO_TASK;
+
+	if (this->tasksCount == this->tasksCapacity)
+	{
+		capacity = (this->tasksCapacity == 0) ? 64 : 2 * this->tasksCapacity;
+		tasks = realloc(this->tasks, capacity * sizeof(* tasks));
+		if (tasks == NULL)
+			return NO_TASK;
+
+		this->tasks = tasks;
+		this->tasksCapacity = capacity;
+	}
+
+	this->tasks[this->tasksCount].run = run;
+	this->tasks[this->tasksCount].index = index;
+	this->tasks[this->tasksCount].prerequisites = 0;
+	this->tasks[this->tasksCount].firstDependent = NO_TASK;
+
+	return this->tasksCount++;
+}
+
+
+static int depend(TaskGraph * const this, size_t task, size_t prerequisite)
+{
+	Edge * edges;
+	size_t capacity;
+
+	if (this == NULL)
+		return 0;
+	if ((task >= this->tasksCount) || (prerequisite >= task))
+		return 0;
+
+	if (this->edgesCount == this->edgesCapacity)
+	{
+		capacity = (this->edgesCapacity == 0) ? 64 : 2 * this->edgesCapacity;
+		edges = realloc(this->edges, capacity * sizeof(* edges));
+		if (edges == NULL)
+			return 0;
+
+		this->edges = edges;
+		this->edgesCapacity = capacity;
+	}
+
+	this->edges[this->edgesCount].dependent = task;
+	this->edges[this->edgesCount].next = this->tasks[prerequisite].firstDependent;
+	this->tasks[prerequisite].firstDependent = this->edgesCount++;
+	this->tasks[task].prerequisites++;
+
+	return 1;
+}
+
+
+static void run(TaskGraph * const this, size_t workers)
+{
+	Run shared;
+	size_t index, ready, capacity;
+	int expected;
+
+	if (this == NULL)
+		return;
+
+	if (workers > MAXIMUM_WORKERS)
+		workers = MAXIMUM_WORKERS;
+	if (workers > this->tasksCount)
+		workers = this->tasksCount;
+	if (workers < 2)
+	{
+		runInOrder(this);
+		return;
+	}
+
+	expected = 0;
+	if (! __atomic_compare_exchange_n(& busy, & expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+		runInOrder(this);
+		return;
+	}
+
+	/* the calling thread is worker 0 */
+	workers = startPool(workers - 1) + 1;
+	if (workers < 2)
+	{
+		__atomic_store_n(& busy, 0, __ATOMIC_RELEASE);
+		runInOrder(this);
+		return;
+	}
+
+	for (capacity = 1; capacity < this->tasksCount; capacity *= 2)
+		;
+
+	shared.graph = this;
+	shared.completed = 0;
+	shared.active = 0;
+	shared.workersCount = workers;
+	shared.remaining = malloc(this->tasksCount * sizeof(* shared.remaining));
+	shared.workers = malloc(workers * sizeof(* shared.workers));
+	if ((shared.remaining == NULL) || (shared.workers == NULL))
+	{
+		free(shared.remaining);
+		free(shared.workers);
+		__atomic_store_n(& busy, 0, __ATOMIC_RELEASE);
+		runInOrder(this);
+		return;
+	}
+
+	for (index = 0; index < workers; index++)
+	{
+		shared.workers[index].shared = & shared;
+		shared.workers[index].number = index;
+		shared.workers[index].deque.top = 0;
+		shared.workers[index].deque.bottom = 0;
+		shared.workers[index].deque.mask = capacity - 1;
+		shared.workers[index].deque.tasks = malloc(capacity * sizeof(size_t));
+		if (shared.workers[index].deque.tasks == NULL)
+			break;
+	}
+	if (index < workers)
+	{
+		while (index-- > 0)
+			free(shared.workers[index].deque.tasks);
+		free(shared.remaining);
+		free(shared.workers);
+		__atomic_store_n(& busy, 0, __ATOMIC_RELEASE);
+		runInOrder(this);
+		return;
+	}
+
+	/* tasks without prerequisites are dealt to workers in turn, before the pool sees the run */
+	ready = 0;
+	for (index = 0; index < this->tasksCount; index++)
+	{
+		shared.remaining[index] = this->tasks[index].prerequisites;
+		if (shared.remaining[index] == 0)
+		{
+			Deque * const deque = & shared.workers[ready % workers].deque;
+			deque->tasks[deque->bottom++] = index;
+			ready++;
+		}
+	}
+
+	pthread_mutex_lock(& poolLock);
+	current = & shared;
+	generation++;
+	pthread_cond_broadcast(& poolWake);
+	pthread_mutex_unlock(& poolLock);
+
+	work(& shared.workers[0]);
+
+	/* pool threads still reading the run are waited for, those which didn't join it yet won't */
+	pthread_mutex_lock(& poolLock);
+	current = NULL;
+	while (shared.active > 0)
+		pthread_cond_wait(& poolWake, & poolLock);
+	pthread_mutex_unlock(& poolLock);
+
+	for (index = 0; index < workers; index++)
+		free(shared.workers[index].deque.tasks);
+	free(shared.remaining);
+	free(shared.workers);
+
+	__atomic_store_n(& busy, 0, __ATOMIC_RELEASE);
+}
+
+
+
+
+static void runInOrder(TaskGraph const * const this)
+{
+	size_t index;
+
+	for (index = 0; index < this->tasksCount; index++)
+		this->tasks[index].run(this->context, this->tasks[index].index);
+}
+
+
+static size_t startPool(size_t count)
+{
+	pthread_t identifier;
+
+	/* only the run holding [busy] starts threads, [poolLock] guards [poolSize] from them */
+	pthread_mutex_lock(& poolLock);
+	while (poolSize < count)
+	{
+		numbers[poolSize + 1] = poolSize + 1;
+		if (pthread_create(& identifier, NULL, serve, & numbers[poolSize + 1]) != 0)
+			break;
+		pthread_detach(identifier);
+		poolSize++;
+	}
+	count = (poolSize < count) ? poolSize : count;
+	pthread_mutex_unlock(& poolLock);
+
+	return count;
+}
+
+
+static void * serve(void * const number)
+{
+	size_t const index = * (size_t const *) number;
+	unsigned long served;
+	Run * shared;
+
+	/* a run handed over while the thread was starting is joined too */
+	pthread_mutex_lock(& poolLock);
+	served = generation - 1;
+	for (;;)
+	{
+		while ((generation == served) || (current == NULL))
+		{
+			served = generation;
+			pthread_cond_wait(& poolWake, & poolLock);
+		}
+		served = generation;
+
+		shared = current;
+		if (index >= shared->workersCount)
+			continue;
+
+		shared->active++;
+		pthread_mutex_unlock(& poolLock);
+
+		work(& shared->workers[index]);
+
+		pthread_mutex_lock(& poolLock);
+		if (--shared->active == 0)
+			pthread_cond_broadcast(& poolWake);
+	}
+
+	return NULL;
+}
+
+
+static void push(Deque * const this, size_t task)
+{
+	long const bottom = __atomic_load_n(& this->bottom, __ATOMIC_RELAXED);
+
+	__atomic_store_n(& this->tasks[(size_t) bottom & this->mask], task, __ATOMIC_RELAXED);
+	__atomic_store_n(& this->bottom, bottom + 1, __ATOMIC_RELEASE);
+}
+
+
+static size_t pop(Deque * const this)
+{
+	long const bottom = __atomic_load_n(& this->bottom, __ATOMIC_RELAXED) - 1;
+	long top;
+	size_t task;
+
+	/* the bottom is claimed before the top is read, a thief reading them the other way round */
+	__atomic_store_n(& this->bottom, bottom, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	top = __atomic_load_n(& this->top, __ATOMIC_RELAXED);
+
+	if (top > bottom)
+	{
+		__atomic_store_n(& this->bottom, bottom + 1, __ATOMIC_RELAXED);
+		return NO_TASK;
+	}
+
+	task = __atomic_load_n(& this->tasks[(size_t) bottom & this->mask], __ATOMIC_RELAXED);
+	if (top < bottom)
+		return task;
+
+	/* the last task, which thieves may be after too */
+	if (! __atomic_compare_exchange_n(& this->top, & top, top + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		task = NO_TASK;
+	__atomic_store_n(& this->bottom, bottom + 1, __ATOMIC_RELAXED);
+
+	return task;
+}
+
+
+static size_t steal(Deque * const this)
+{
+	long top, bottom;
+	size_t task;
+
+	top = __atomic_load_n(& this->top, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	bottom = __atomic_load_n(& this->bottom, __ATOMIC_ACQUIRE);
+	if (top >= bottom)
+		return NO_TASK;
+
+	task = __atomic_load_n(& this->tasks[(size_t) top & this->mask], __ATOMIC_RELAXED);
+	if (! __atomic_compare_exchange_n(& this->top, & top, top + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		return NO_TASK;
+
+	return task;
+}
+
+
+static size_t take(Worker * const worker)
+{
+	Run * const shared = worker->shared;
+	size_t task, offset;
+
+	/* the most recently readied task of its own, its data is likely still in cache */
+	task = pop(& worker->deque);
+
+	/* otherwise the oldest task of the next workers, in turn */
+	for (offset = 1; (task == NO_TASK) && (offset < shared->workersCount); offset++)
+		task = steal(& shared->workers[(worker->number + offset) % shared->workersCount].deque);
+
+	return task;
+}
+
+
+static void work(Worker * const this)
+{
+	Run * const shared = this->shared;
+	TaskGraph const * const graph = shared->graph;
+	size_t task;
+
+	for (;;)
+	{
+		task = take(this);
+		if (task != NO_TASK)
+		{
+			graph->tasks[task].run(graph->context, graph->tasks[task].index);
+			complete(this, task);
+			continue;
+		}
+
+		if (__atomic_load_n(& shared->completed, __ATOMIC_ACQUIRE) == graph->tasksCount)
+			return;
+
+		/*
+		 * Nothing to take: sleep until tasks get pushed, or everything is done
+		 * [sleepers] is raised before deques are checked again, and those pushing check it after pushing:
+		 * either they see a sleeper and wake it, or it sees their tasks
+		 */
+		pthread_mutex_lock(& poolLock);
+		__atomic_add_fetch(& sleepers, 1, __ATOMIC_SEQ_CST);
+		if (! isWorthWaking(shared))
+			pthread_cond_wait(& poolWake, & poolLock);
+		__atomic_sub_fetch(& sleepers, 1, __ATOMIC_SEQ_CST);
+		pthread_mutex_unlock(& poolLock);
+	}
+}
+
+
+static void complete(Worker * const worker, size_t task)
+{
+	Run * const shared = worker->shared;
+	TaskGraph const * const graph = shared->graph;
+	size_t edge, dependent, completed;
+	int pushed;
+
+	pushed = 0;
+
+	/* the last prerequisite to be done pushes the dependent, after every other one's results */
+	for (edge = graph->tasks[task].firstDependent; edge != NO_TASK; edge = graph->edges[edge].next)
+	{
+		dependent = graph->edges[edge].dependent;
+		if (__atomic_sub_fetch(& shared->remaining[dependent], 1, __ATOMIC_ACQ_REL) != 0)
+			continue;
+
+		push(& worker->deque, dependent);
+		pushed = 1;
+	}
+
+	completed = __atomic_add_fetch(& shared->completed, 1, __ATOMIC_SEQ_CST);
+
+	if (! pushed && (completed != graph->tasksCount))
+		return;
+
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(& sleepers, __ATOMIC_SEQ_CST) == 0)
+		return;
+
+	pthread_mutex_lock(& poolLock);
+	pthread_cond_broadcast(& poolWake);
+	pthread_mutex_unlock(& poolLock);
+}
+
+
+static int isWorthWaking(Run * const shared)
+{
+	Deque const * deque;
+	size_t index;
+
+	if (__atomic_load_n(& shared->completed, __ATOMIC_SEQ_CST) == shared->graph->tasksCount)
+		return 1;
+
+	for (index = 0; index < shared->workersCount; index++)
+	{
+		deque = & shared->workers[index].deque;
+		if (__atomic_load_n(& deque->top, __ATOMIC_SEQ_CST) < __atomic_load_n(& deque->bottom, __ATOMIC_SEQ_CST))
+			return 1;
+	}
+
+	return 0;
+}
+
+
+
+
+static TaskGraphMethods methods =
+{
+	create,
+	delete,
+	add,
+	depend,
+	run
+};
+TaskGraphMethods const * const _TaskGraph = & methods;
@@ -0,0 +1,83 @@
+#ifndef TASK_GRAPH_HEADER
+#define TASK_GRAPH_HEADER
+
+/*
+ * Dependency graphs of tasks, run by a pool of work-stealing workers
+ * Library internal, tiled algorithms of Matrix.c describe their steps with it
+ */
+
+#include <stddef.h>
+
+
+
+
+/* returned by add when the task couldn't be added */
+#define NO_TASK ((size_t) -1)
+
+
+typedef struct TaskGraph TaskGraph;
+
+
+typedef struct
+{
+	/**
+	 * Creates an empty graph
+	 *
+	 * @param context - handed to every task when it runs
+	 *
+	 * @return - the created graph, or NULL if allocation failed
+	 */
+	TaskGraph * (* create)(void * context);
+
+	/**
+	 * Deletes the graph, and sets it to NULL
+	 *
+	 * @param this - pointer to pointer to graph to delete
+	 */
+	void (* delete)(TaskGraph ** this);
+
+	/**
+	 * Adds a task, tasks are numbered from 0 in the order they are added
+	 *
+	 * @param run - the work of the task, called with the context of the graph and [index]
+	 * @param index - which part of the work this task is
+	 *
+	 * @return - the number of the task, or NO_TASK if [this] or [run] is NULL, or allocation failed
+	 */
+	size_t (* add)(TaskGraph * this, void (* run)(void * context, size_t index), size_t index);
+
+	/**
+	 * Makes [task] wait for [prerequisite] to be done
+	 * Tasks are added after what they depend on, which keeps graphs free of cycles
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		[this] is NULL,
+	 * 		[prerequisite] isn't a task added before [task],
+	 * 		allocation failed
+	 */
+	int (* depend)(TaskGraph * this, size_t task, size_t prerequisite);
+
+	/**
+	 * Runs every task once, each after all of its prerequisites, and returns when all are done
+	 * Every worker has a lock-free deque: it takes tasks it made ready from the bottom of its own, and steals
+	 * the oldest ones from the top of others when it runs out, sleeping only when all are empty
+	 * Workers other than the calling thread come from a pool of threads, started by the first runs needing them
+	 * and kept for the next ones: one run uses the pool at a time
+	 * With a single worker, when the pool is used by another run, a task of this one among them,
+	 * or when workers can't be set up, tasks run in the order they were added, on the calling thread
+	 *
+	 * @param workers - how many threads run tasks, the calling thread included
+	 */
+	void (* run)(TaskGraph * this, size_t workers);
+
+} TaskGraphMethods;
+
+
+
+
+extern TaskGraphMethods const * const _TaskGraph;
+
+
+
+
+#endif /* TASK_GRAPH_HEADER */
@@ -0,0 +1,390 @@
+#include "Vector.h"
+#include "MatrixPrivate.h"
+#include "TaskGraph.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+
+/* matrices with fewer cells than this are not worth handing to the workers */
+#define THREADED_GEMV_CELLS 65536
+
+
+
+
+struct Vector
+{
+	size_t size;
+
+	double * cells;
+};
+
+
+/**
+ * A matrix-vector product, whose y is split in [slices] ranges computed as independent tasks
+ */
+typedef struct
+{
+	/* whether y is computed from the transpose of the cells of [matrix], rather than from them */
+	int transposed;
+	double alpha;
+	Matrix const * matrix;
+	double const * x;
+	double beta;
+	double * y;
+
+	size_t size;
+	size_t slices;
+} Product;
+
+
+
+
+/**
+ * @return - ∑ x[i] * y[i], over 4 independent sums so that they can be vectorized
+ */
+static double dotKernel(size_t size, double const * x, double const * y);
+
+/**
+ * y[i] += alpha * x[i]
+ */
+static void axpyKernel(size_t size, double alpha, double const * x, double * y);
+
+/**
+ * Computes the [index]-th range of y, for either product
+ *
+ * @param product - the product to compute a part of, as a task of _TaskGraph
+ */
+static void computeSlice(void * product, size_t index);
+
+/**
+ * Splits y among the threads set by _Matrix->setThreads when the matrix is big enough,
+ * computes it on the calling thread otherwise
+ */
+static void run(Product * product);
+
+
+
+
+static Vector * create(size_t size)
+{
+	Vector * this;
+
+	if (size == 0)
+		return NULL;
+
+	this = malloc(sizeof(* this));
+	if (this == NULL)
+		return NULL;
+
+	this->cells = calloc(size, sizeof(* this->cells));
+	if (this->cells == NULL)
+	{
+		free(this);
+		return NULL;
+	}
+
+	this->size = size;
+
+	return this;
+}
+
+
+static void delete(Vector ** this)
+{
+	if (this == NULL)
+		return;
+	if (* this == NULL)
+		return;
+
+	free((* this)->cells);
+	(* this)->cells = NULL;
+
+	free(* this);
+	* this = NULL;
+}
+
+
+static Vector * fromArray(size_t size, double const * const values)
+{
+	Vector * this;
+
+	if (values == NULL)
+		return NULL;
+
+	this = _Vector->create(size);
+	if (this == NULL)
+		return NULL;
+
+	memcpy(this->cells, values, size * sizeof(* this->cells));
+
+	return this;
+}
+
+
+static Vector * copy(Vector const * const this)
+{
+	if (this == NULL)
+		return NULL;
+
+	return _Vector->fromArray(this->size, this->cells);
+}
+
+
+static size_t size(Vector const * const this)
+{
+	if (this == NULL)
+		return 0;
+	return this->size;
+}
+
+
+static double getCell(Vector const * const this, size_t index)
+{
+	if (this == NULL)
+		return NO_VALUE;
+
+	if (index >= this->size)
+		return NO_VALUE;
+
+	return this->cells[index];
+}
+
+
+static void setCell(Vector * const this, size_t index, double value)
+{
+	if (this == NULL)
+		return;
+
+	if (index >= this->size)
+		return;
+
+	this->cells[index] = value;
+}
+
+
+static double * cells(Vector * const this)
+{
+	if (this == NULL)
+		return NULL;
+	return this->cells;
+}
+
+
+static double dot(Vector const * const left, Vector const * const right)
+{
+	if ((left == NULL) || (right == NULL))
+		return NO_VALUE;
+	if (left->size != right->size)
+		return NO_VALUE;
+
+	return dotKernel(left->size, left->cells, right->cells);
+}
+
+
+static double norm(Vector const * const this)
+{
+	if (this == NULL)
+		return NO_VALUE;
+
+	return sqrt(dotKernel(this->size, this->cells, this->cells));
+}
+
+
+static int axpy(double alpha, Vector const * const x, Vector * const y)
+{
+	if ((x == NULL) || (y == NULL))
+		return 0;
+	if (x->size != y->size)
+		return 0;
+
+	axpyKernel(x->size, alpha, x->cells, y->cells);
+
+	return 1;
+}
+
+
+static void scale(Vector * const this, double alpha)
+{
+	size_t index;
+
+	if (this == NULL)
+		return;
+
+	for (index = 0; index < this->size; index++)
+		this->cells[index] *= alpha;
+}
+
+
+static int gemv(double alpha, Matrix const * const matrix, Vector const * const x, double beta, Vector * const y)
+{
+	Product whole;
+
+	if ((matrix == NULL) || (x == NULL) || (y == NULL))
+		return 0;
+	if ((matrix->width != x->size) || (matrix->height != y->size))
+		return 0;
+	if (x == y)
+		return 0;
+
+	/* a column-major A is the row-major ^t A to its cells */
+	whole.transposed = (matrix->layout == MATRIX_COLUMN_MAJOR);
+	whole.alpha = alpha;
+	whole.matrix = matrix;
+	whole.x = x->cells;
+	whole.beta = beta;
+	whole.y = y->cells;
+	whole.size = y->size;
+	run(& whole);
+
+	return 1;
+}
+
+
+static int gemvTransposed(double alpha, Matrix const * const matrix, Vector const * const x, double beta, Vector * const y)
+{
+	Product whole;
+
+	if ((matrix == NULL) || (x == NULL) || (y == NULL))
+		return 0;
+	if ((matrix->height != x->size) || (matrix->width != y->size))
+		return 0;
+	if (x == y)
+		return 0;
+
+	whole.transposed = (matrix->layout == MATRIX_ROW_MAJOR);
+	whole.alpha = alpha;
+	whole.matrix = matrix;
+	whole.x = x->cells;
+	whole.beta = beta;
+	whole.y = y->cells;
+	whole.size = y->size;
+	run(& whole);
+
+	return 1;
+}
+
+
+
+
+static double dotKernel(size_t size, double const * const x, double const * const y)
+{
+	size_t index;
+	double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+	for (index = 0; index + 4 <= size; index += 4)
+	{
+		sum0 += x[index] * y[index];
+		sum1 += x[index + 1] * y[index + 1];
+		sum2 += x[index + 2] * y[index + 2];
+		sum3 += x[index + 3] * y[index + 3];
+	}
+	for (; index < size; index++)
+		sum0 += x[index] * y[index];
+
+	return (sum0 + sum1) + (sum2 + sum3);
+}
+
+
+static void axpyKernel(size_t size, double alpha, double const * const x, double * const y)
+{
+	size_t index;
+
+	for (index = 0; index < size; index++)
+		y[index] += alpha * x[index];
+}
+
+
+static void computeSlice(void * const product, size_t index)
+{
+	Product const * const this = product;
+	size_t rowIndex, cellIndex, first, last;
+	double * y;
+
+	first = this->size / this->slices * index;
+	last = (index + 1 == this->slices) ? this->size : this->size / this->slices * (index + 1);
+	y = this->y + first;
+
+	if (! this->transposed)
+	{
+		/* yi is the dot product of row i of the cells and x */
+		for (rowIndex = first; rowIndex < last; rowIndex++)
+		{
+			if (this->beta == 0)
+				this->y[rowIndex] = this->alpha * dotKernel(MATRIX_LENGTH(this->matrix), this->matrix->cells[rowIndex], this->x);
+			else
+			{
+				this->y[rowIndex] = this->alpha * dotKernel(MATRIX_LENGTH(this->matrix), this->matrix->cells[rowIndex], this->x)
+					+ this->beta * this->y[rowIndex];
+			}
+		}
+		return;
+	}
+
+	/* y accumulates rows of A weighted by x, each slice owns a range of columns */
+	for (cellIndex = 0; cellIndex < last - first; cellIndex++)
+		y[cellIndex] = (this->beta == 0) ? 0 : this->beta * y[cellIndex];
+
+	for (rowIndex = 0; rowIndex < MATRIX_LINES(this->matrix); rowIndex++)
+	{
+		axpyKernel(
+			last - first,
+			this->alpha * this->x[rowIndex],
+			this->matrix->cells[rowIndex] + first,
+			y);
+	}
+}
+
+
+static void run(Product * const product)
+{
+	TaskGraph * graph;
+	size_t threads, index;
+
+	/* one slice per thread, workers stealing them from each other keep the pool busy */
+	threads = matrixThreads();
+	product->slices = (threads < product->size) ? threads : product->size;
+	if (product->matrix->height * product->matrix->width < THREADED_GEMV_CELLS)
+		product->slices = 1;
+
+	graph = (product->slices < 2) ? NULL : _TaskGraph->create(product);
+	for (index = 0; (graph != NULL) && (index < product->slices); index++)
+	{
+		if (_TaskGraph->add(graph, computeSlice, index) == NO_TASK)
+			_TaskGraph->delete(& graph);
+	}
+
+	if (graph == NULL)
+	{
+		for (index = 0; index < product->slices; index++)
+			computeSlice(product, index);
+		return;
+	}
+
+	_TaskGraph->run(graph, product->slices);
+	_TaskGraph->delete(& graph);
+}
+
+
+
+static VectorMethods methods =
+{
+	create,
+	delete,
+	fromArray,
+	copy,
+	size,
+	getCell,
+	setCell,
+	cells,
+	dot,
+	norm,
+	axpy,
+	scale,
+	gemv,
+	gemvTransposed
+};
+VectorMethods const * const _Vector = & methods;
@@ -0,0 +1,180 @@
+#ifndef VECTOR_HEADER
+#define VECTOR_HEADER
+
+#include "Matrix.h"
+
+#include <stddef.h>
+
+
+
+
+/*
+ * Contiguous column of doubles, for matrix-vector work without n*1 matrices
+ */
+typedef struct Vector Vector;
+
+
+typedef struct
+{
+	/**
+	 * Creates a vector of [size] zeros
+	 *
+	 * @param size - the number of cells
+	 *
+	 * @return - the created vector, or NULL if:
+	 * 		size is 0,
+	 * 		allocation failed
+	 */
+	Vector * (* create)(size_t size);
+
+	/**
+	 * Deletes the vector, and sets it to NULL
+	 *
+	 * @param this - pointer to pointer to vector to delete
+	 */
+	void (* delete)(Vector ** this);
+
+	/**
+	 * Creates a vector from an array
+	 *
+	 * @param size - the number of values
+	 * @param values - [size] doubles, copied
+	 *
+	 * @return - the created vector, or NULL if:
+	 * 		size is 0,
+	 * 		[values] is NULL,
+	 * 		allocation failed
+	 */
+	Vector * (* fromArray)(size_t size, double const * values);
+
+	/**
+	 * Copies the input vector
+	 *
+	 * @param this - the vector to copy
+	 *
+	 * @return - a copy of the vector, or NULL if [this] is NULL or allocation failed
+	 */
+	Vector * (* copy)(Vector const * this);
+
+	/**
+	 * @param this - the vector to get size for
+	 *
+	 * @return - the number of cells, or 0 if [this] is NULL
+	 */
+	size_t (* size)(Vector const * this);
+
+	/**
+	 * Returns Vi
+	 *
+	 * @param index - the cell, in range [0, size[
+	 *
+	 * @return - the requested cell, or NO_VALUE if:
+	 * 		[this] is NULL,
+	 * 		out of bounds occurred
+	 */
+	double (* getCell)(Vector const * this, size_t index);
+
+	/**
+	 * Sets Vi, nothing is done if [this] is NULL or [index] is out of bounds
+	 *
+	 * @param index - the cell, in range [0, size[
+	 * @param value - the new value of the cell
+	 */
+	void (* setCell)(Vector * this, size_t index, double value);
+
+	/**
+	 * Direct access to the contiguous cells, for hot loops
+	 *
+	 * @param this - the vector to get cells of
+	 *
+	 * @return - the [size] cells, or NULL if [this] is NULL
+	 */
+	double * (* cells)(Vector * this);
+
+	/**
+	 * x.y = ∑_i=1->n xi * yi
+	 *
+	 * @param left - x
+	 * @param right - y
+	 *
+	 * @return - the dot product, or NO_VALUE if:
+	 * 		any operand is NULL,
+	 * 		operands don't have the same size
+	 */
+	double (* dot)(Vector const * left, Vector const * right);
+
+	/**
+	 * ||x|| = sqrt(x.x)
+	 *
+	 * @param this - the vector to get the euclidean norm of
+	 *
+	 * @return - the norm, or NO_VALUE if [this] is NULL
+	 */
+	double (* norm)(Vector const * this);
+
+	/**
+	 * y = y + alpha * x, in place
+	 *
+	 * @param alpha - the factor of [x]
+	 * @param x - the vector to add
+	 * @param y - the vector to add to
+	 *
+	 * @return - 1 on success, 0 if any vector is NULL or sizes differ
+	 */
+	int (* axpy)(double alpha, Vector const * x, Vector * y);
+
+	/**
+	 * x = alpha * x, in place
+	 *
+	 * @param this - the vector to scale, nothing is done if NULL
+	 * @param alpha - the factor
+	 */
+	void (* scale)(Vector * this, double alpha);
+
+	/**
+	 * y = alpha * A * x + beta * y, in place, with A a m*n matrix
+	 * Rows of A are streamed once, [y] isn't read if [beta] is 0
+	 * Large products split y across the threads set by _Matrix->setThreads, small ones run on the calling thread
+	 *
+	 * @param alpha - the factor of A * x
+	 * @param matrix - A
+	 * @param x - a n-sized vector
+	 * @param beta - the factor of y
+	 * @param y - a m-sized vector, receiving the result, must not be [x]
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		any operand is NULL,
+	 * 		sizes don't match,
+	 * 		[x] is [y]
+	 */
+	int (* gemv)(double alpha, Matrix const * matrix, Vector const * x, double beta, Vector * y);
+
+	/**
+	 * y = alpha * ^t A * x + beta * y, in place, with A a m*n matrix
+	 * Rows of A are streamed once, without transposing A, [y] isn't read if [beta] is 0
+	 * Split across threads as gemv is
+	 *
+	 * @param alpha - the factor of ^t A * x
+	 * @param matrix - A
+	 * @param x - a m-sized vector
+	 * @param beta - the factor of y
+	 * @param y - a n-sized vector, receiving the result, must not be [x]
+	 *
+	 * @return - 1 on success, 0 if:
+	 * 		any operand is NULL,
+	 * 		sizes don't match,
+	 * 		[x] is [y]
+	 */
+	int (* gemvTransposed)(double alpha, Matrix const * matrix, Vector const * x, double beta, Vector * y);
+
+} VectorMethods;
+
+
+
+
+extern VectorMethods const * const _Vector;
+
+
+
+
+#endif /* VECTOR_HEADER */
@@ -0,0 +1,428 @@
+#include "../../src/Factorization.h"
+#include "../../src/Matrix.h"
+#include "../../src/Vector.h"
+
+#include <criterion/criterion.h>
+#include <math.h>
+
+
+
+
+/**
+ * Builds a height*width matrix from its cells, row by row
+ */
+static Matrix * fromCells(size_t height, size_t width, double const * cells)
+{
+	Matrix * result = _Matrix->fromRows(1, width, cells);
+
+	for (size_t row = 1; row < height; row++)
+	{
+		Matrix * next = _Matrix->fromRows(1, width, cells + row * width);
+		Matrix * stacked = _Matrix->vconcat(result, next);
+
+		_Matrix->delete(& result);
+		_Matrix->delete(& next);
+		result = stacked;
+	}
+
+	return result;
+}
+
+
+/**
+ * Expects A x to be b, x being solved from the factorization of A
+ */
+static void expect_solved(Factorization const * this, Matrix const * matrix, double tolerance)
+{
+	size_t size = _Matrix->height(matrix);
+	Vector * rightHand = _Vector->create(size);
+	for (size_t index = 0; index < size; index++)
+		_Vector->setCell(rightHand, index, (double) index + 1);
+
+	Vector * solution = _Factorization->solve(this, rightHand);
+	Vector * product = _Vector->create(size);
+
+	cr_assert_not_null(solution);
+	_Vector->gemv(1, matrix, solution, 0, product);
+	for (size_t index = 0; index < size; index++)
+		cr_expect_float_eq(_Vector->getCell(rightHand, index), _Vector->getCell(product, index), tolerance);
+
+	_Vector->delete(& rightHand);
+	_Vector->delete(& solution);
+	_Vector->delete(& product);
+}
+
+
+/**
+ * Expects A x to be b
+ */
+static void expect_solved_by(Matrix const * matrix, Vector const * solution, Vector const * rightHand, double tolerance)
+{
+	size_t size = _Vector->size(rightHand);
+	Vector * product = _Vector->create(size);
+
+	_Vector->gemv(1, matrix, solution, 0, product);
+	for (size_t index = 0; index < size; index++)
+		cr_expect_float_eq(_Vector->getCell(rightHand, index), _Vector->getCell(product, index), tolerance);
+
+	_Vector->delete(& product);
+}
+
+
+/**
+ * Row [time] of a sliding window regression: a constant, a trend, and a periodic term
+ */
+static Vector * observation(size_t time)
+{
+	double cells[3] = { 1, (double) time / 10, sin((double) time) };
+
+	return _Vector->fromArray(3, cells);
+}
+
+
+
+
+Test(Factorization, qr_solves_least_squares)
+{
+	// given
+	Matrix * matrix = _Matrix->fromRows(4, 2,
+		(double[]) { 1, 0 },
+		(double[]) { 1, 1 },
+		(double[]) { 1, 2 },
+		(double[]) { 1, 3 });
+	Vector * rightHand = _Vector->fromArray(4, (double[]) { 1, 2, 2, 4 });
+	Factorization * this = _Factorization->qr(matrix);
+
+	// when
+	Vector * solution = _Factorization->solve(this, rightHand);
+
+	// then
+	cr_assert_not_null(solution);
+	cr_expect_float_eq(0.9, _Vector->getCell(solution, 0), 1e-14);
+	cr_expect_float_eq(0.9, _Vector->getCell(solution, 1), 1e-14);
+	cr_expect_eq(MATRIX_IS_NOT_SQUARE, _Factorization->determinant(this));
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& solution);
+	_Factorization->delete(& this);
+	cr_expect_null(this);
+}
+
+
+Test(Factorization, qr_sliding_window_matches_fresh_factorization)
+{
+	// given
+	double cells[8 * 3];
+	for (size_t time = 0; time < 8; time++)
+	{
+		Vector * row = observation(time);
+		for (size_t index = 0; index < 3; index++)
+			cells[time * 3 + index] = _Vector->getCell(row, index);
+		_Vector->delete(& row);
+	}
+	Matrix * window = fromCells(8, 3, cells);
+	Factorization * this = _Factorization->qr(window);
+	Vector * rightHand = _Vector->fromArray(8, (double[]) { 3, 1, 4, 1, 5, 9, 2, 6 });
+
+	// when
+	for (size_t time = 8; time < 40; time++)
+	{
+		Vector * row = observation(time);
+		cr_assert(_Factorization->insertRow(this, 8, row));
+		cr_assert(_Factorization->deleteRow(this, 0));
+		_Vector->delete(& row);
+	}
+
+	// then
+	for (size_t time = 32; time < 40; time++)
+	{
+		Vector * row = observation(time);
+		for (size_t index = 0; index < 3; index++)
+			cells[(time - 32) * 3 + index] = _Vector->getCell(row, index);
+		_Vector->delete(& row);
+	}
+	Matrix * expected = fromCells(8, 3, cells);
+	Factorization * fresh = _Factorization->qr(expected);
+	Vector * updated = _Factorization->solve(this, rightHand);
+	Vector * refactored = _Factorization->solve(fresh, rightHand);
+
+	cr_expect_eq(8, _Factorization->height(this));
+	cr_expect_eq(3, _Factorization->width(this));
+	cr_assert_not_null(updated);
+	for (size_t index = 0; index < 3; index++)
+		cr_expect_float_eq(_Vector->getCell(refactored, index), _Vector->getCell(updated, index), 1e-11);
+
+	// teardown
+	_Matrix->delete(& window);
+	_Matrix->delete(& expected);
+	_Factorization->delete(& this);
+	_Factorization->delete(& fresh);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& updated);
+	_Vector->delete(& refactored);
+}
+
+
+Test(Factorization, qr_follows_inserted_deleted_and_replaced_rows_and_columns)
+{
+	// given
+	Matrix * matrix = _Matrix->fromRows(3, 3,
+		(double[]) { 2, 1, 0 },
+		(double[]) { 1, 3, 1 },
+		(double[]) { 0, 1, 4 });
+	Matrix * grown = _Matrix->fromRows(4, 4,
+		(double[]) { 1, 1, 1, 1 },
+		(double[]) { 2, 5, 1, 0 },
+		(double[]) { 1, 6, 3, 1 },
+		(double[]) { 0, 7, 1, 4 });
+	Matrix * shrunk = _Matrix->fromRows(3, 3,
+		(double[]) { 1, 1, 1 },
+		(double[]) { 5, 1, 0 },
+		(double[]) { 6, 3, 1 });
+	Matrix * replaced = _Matrix->fromRows(3, 3,
+		(double[]) { 0, 1, 1 },
+		(double[]) { 1, 2, 9 },
+		(double[]) { 1, 3, 1 });
+	Vector * column = _Vector->fromArray(3, (double[]) { 5, 6, 7 });
+	Vector * row = _Vector->fromArray(4, (double[]) { 1, 1, 1, 1 });
+	Vector * newRow = _Vector->fromArray(3, (double[]) { 2, 2, 9 });
+	Vector * newColumn = _Vector->fromArray(3, (double[]) { 0, 1, 1 });
+	Factorization * this = _Factorization->qr(matrix);
+
+	// when
+	int inserted = _Factorization->insertColumn(this, 1, column) && _Factorization->insertRow(this, 0, row);
+	double grownDeterminant = _Factorization->determinant(this);
+
+	// then
+	cr_assert(inserted);
+	cr_expect_float_eq(_Matrix->determinant(grown), grownDeterminant, 1e-12);
+	expect_solved(this, grown, 1e-12);
+
+	// when
+	int deleted = _Factorization->deleteColumn(this, 0) && _Factorization->deleteRow(this, 3);
+	double shrunkDeterminant = _Factorization->determinant(this);
+
+	// then
+	cr_assert(deleted);
+	cr_expect_float_eq(5, shrunkDeterminant, 1e-12);
+	expect_solved(this, shrunk, 1e-12);
+
+	// when
+	int replacedCells = _Factorization->replaceRow(this, 1, newRow) && _Factorization->replaceColumn(this, 0, newColumn);
+	double replacedDeterminant = _Factorization->determinant(this);
+
+	// then
+	cr_assert(replacedCells);
+	cr_expect_float_eq(9, replacedDeterminant, 1e-12);
+	expect_solved(this, replaced, 1e-12);
+	cr_expect_not(_Factorization->insertRow(this, 4, newRow), "Rows go at most after the last one");
+	cr_expect_not(_Factorization->replaceColumn(this, 0, row), "Columns have 3 cells");
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Matrix->delete(& grown);
+	_Matrix->delete(& shrunk);
+	_Matrix->delete(& replaced);
+	_Vector->delete(& column);
+	_Vector->delete(& row);
+	_Vector->delete(& newRow);
+	_Vector->delete(& newColumn);
+	_Factorization->delete(& this);
+}
+
+
+Test(Factorization, lu_replacements_match_determinant_and_solve)
+{
+	// given
+	double cells[6 * 6];
+	for (size_t row = 0; row < 6; row++)
+		for (size_t column = 0; column < 6; column++)
+			cells[row * 6 + column] = 1.0 / (row + column + 1) + ((row == column) ? 2 : 0);
+	Matrix * matrix = fromCells(6, 6, cells);
+	Factorization * this = _Factorization->lu(matrix);
+
+	for (size_t time = 0; time < 12; time++)
+	{
+		// when
+		double values[6];
+		for (size_t index = 0; index < 6; index++)
+			values[index] = sin((double) (time * 6 + index)) + ((index == time % 6) ? 3 : 0);
+		Vector * replacement = _Vector->fromArray(6, values);
+		if (time % 2 == 0)
+		{
+			cr_assert(_Factorization->replaceRow(this, time % 6, replacement));
+			for (size_t index = 0; index < 6; index++)
+				cells[(time % 6) * 6 + index] = values[index];
+		}
+		else
+		{
+			cr_assert(_Factorization->replaceColumn(this, time % 6, replacement));
+			for (size_t index = 0; index < 6; index++)
+				cells[index * 6 + time % 6] = values[index];
+		}
+
+		// then
+		Matrix * expected = fromCells(6, 6, cells);
+		double determinant = _Matrix->determinant(expected);
+		cr_expect_float_eq(determinant, _Factorization->determinant(this), 1e-12 * fabs(determinant));
+		expect_solved(this, expected, 1e-12);
+
+		_Vector->delete(& replacement);
+		_Matrix->delete(& expected);
+	}
+	cr_expect_not(_Factorization->deleteRow(this, 0), "LU factorizations stay square");
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Factorization->delete(& this);
+}
+
+
+Test(Factorization, lu_factors_again_when_an_update_needs_a_pivot)
+{
+	// given
+	Matrix * matrix = _Matrix->fromRows(2, 2,
+		(double[]) { 1, 1 },
+		(double[]) { 1, 0 });
+	Vector * row = _Vector->fromArray(2, (double[]) { 0, 1 });
+	Vector * rightHand = _Vector->fromArray(2, (double[]) { 2, 3 });
+	Factorization * this = _Factorization->lu(matrix);
+
+	// when
+	int replaced = _Factorization->replaceRow(this, 0, row);
+	Vector * solution = _Factorization->solve(this, rightHand);
+
+	// then
+	cr_expect(replaced);
+	cr_expect_float_eq(-1, _Factorization->determinant(this), 1e-15, "The first pivot of [0 1; 1 0] is 0 without exchanging rows");
+	cr_assert_not_null(solution);
+	cr_expect_float_eq(3, _Vector->getCell(solution, 0), 1e-15);
+	cr_expect_float_eq(2, _Vector->getCell(solution, 1), 1e-15);
+	cr_expect_null(_Factorization->lu(NULL));
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Vector->delete(& row);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& solution);
+	_Factorization->delete(& this);
+}
+
+
+Test(Factorization, lu_rcond_matches_matrix_rcond)
+{
+	// given
+	Matrix * matrix = _Matrix->fromRows(4, 4,
+		(double[]) { 1, 2, 0, 1 },
+		(double[]) { 4, 1, 3, 0 },
+		(double[]) { 0, 5, 1, 2 },
+		(double[]) { 2, 0, 6, 1e-3 });
+	Matrix * replaced = _Matrix->fromRows(4, 4,
+		(double[]) { 1, 2, 0, 1 },
+		(double[]) { 4, 1, 3, 0 },
+		(double[]) { 1, 2, 0, 1 + 1e-9 },
+		(double[]) { 2, 0, 6, 1e-3 });
+	Vector * row = _Vector->fromArray(4, (double[]) { 1, 2, 0, 1 + 1e-9 });
+	Factorization * this = _Factorization->lu(matrix);
+	Factorization * orthogonal = _Factorization->qr(matrix);
+
+	// when
+	double estimate = _Factorization->rcond(this);
+	_Factorization->replaceRow(this, 2, row);
+	double updated = _Factorization->rcond(this);
+
+	// then
+	cr_expect_float_eq(estimate, _Matrix->rcond(matrix), 1e-12);
+	cr_expect_float_eq(updated, _Matrix->rcond(replaced), 1e-6 * updated);
+	cr_expect_lt(updated, 1e-8);
+	cr_expect_eq(_Factorization->rcond(orthogonal), NO_VALUE, "QR factorizations aren't estimated");
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Matrix->delete(& replaced);
+	_Vector->delete(& row);
+	_Factorization->delete(& this);
+	_Factorization->delete(& orthogonal);
+}
+
+
+Test(Factorization, solve_mixed_refines_to_double_accuracy)
+{
+	// given
+	double cells[8 * 8];
+	for (size_t row = 0; row < 8; row++)
+		for (size_t column = 0; column < 8; column++)
+			cells[row * 8 + column] = 1.0 / (row + column + 1) + ((row == column) ? 1 : 0);
+	Matrix * matrix = fromCells(8, 8, cells);
+	Vector * rightHand = _Vector->fromArray(8, (double[]) { 1, -2, 3, -4, 5, -6, 7, -8 });
+	Factorization * factorization = _Factorization->lu(matrix);
+	int iterations = 0;
+
+	// when
+	Vector * solution = _Factorization->solveMixed(matrix, rightHand, & iterations);
+
+	// then
+	Vector * expected = _Factorization->solve(factorization, rightHand);
+	cr_assert_not_null(solution);
+	cr_expect_gt(iterations, 0, "A single precision solution is only good to about 1e-7");
+	cr_expect_leq(iterations, 4);
+	for (size_t index = 0; index < 8; index++)
+		cr_expect_float_eq(_Vector->getCell(expected, index), _Vector->getCell(solution, index), 1e-13);
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& solution);
+	_Vector->delete(& expected);
+	_Factorization->delete(& factorization);
+}
+
+
+Test(Factorization, solve_mixed_falls_back_to_double)
+{
+	// given
+	double cells[10 * 10];
+	for (size_t row = 0; row < 10; row++)
+		for (size_t column = 0; column < 10; column++)
+			cells[row * 10 + column] = 1.0 / (row + column + 1);
+	Matrix * hilbert = fromCells(10, 10, cells);
+	Matrix * huge = _Matrix->fromRows(2, 2,
+		(double[]) { 1e300, 0 },
+		(double[]) { 0, 1 });
+	Matrix * rectangle = _Matrix->fromRows(1, 2, (double[]) { 1, 1 });
+	Vector * rightHand = _Vector->create(10);
+	for (size_t index = 0; index < 10; index++)
+		_Vector->setCell(rightHand, index, 1);
+	Vector * pair = _Vector->fromArray(2, (double[]) { 1e300, 2 });
+	int iterations = 0;
+
+	// when
+	Vector * solution = _Factorization->solveMixed(hilbert, rightHand, & iterations);
+
+	// then
+	cr_assert_not_null(solution);
+	cr_expect_eq(-1, iterations, "The Hilbert matrix of size 10 has κ(A) about 1e13");
+	expect_solved_by(hilbert, solution, rightHand, 1e-6);
+
+	// when
+	Vector * scaled = _Factorization->solveMixed(huge, pair, & iterations);
+
+	// then
+	cr_assert_not_null(scaled);
+	cr_expect_eq(-1, iterations, "1e300 overflows float");
+	cr_expect_float_eq(1, _Vector->getCell(scaled, 0), 1e-15);
+	cr_expect_float_eq(2, _Vector->getCell(scaled, 1), 1e-15);
+	cr_expect_null(_Factorization->solveMixed(rectangle, pair, NULL));
+	cr_expect_null(_Factorization->solveMixed(NULL, pair, & iterations));
+
+	// teardown
+	_Matrix->delete(& hilbert);
+	_Matrix->delete(& huge);
+	_Matrix->delete(& rectangle);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& pair);
+	_Vector->delete(& solution);
+	_Vector->delete(& scaled);
+}
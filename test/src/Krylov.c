@@ -0,0 +1,315 @@
+#include "../../src/Krylov.h"
+#include "../../src/Matrix.h"
+#include "../../src/Vector.h"
+
+#include <criterion/criterion.h>
+
+
+
+
+/* -x[i - 1] + 2 x[i] - x[i + 1], the 1D Laplacian, without storing it */
+static void laplacian(double const * x, double * y, size_t size, void * context)
+{
+	(void) context;
+
+	for (size_t index = 0; index < size; index++)
+		y[index] = 2 * x[index] - ((index > 0) ? x[index - 1] : 0) - ((index + 1 < size) ? x[index + 1] : 0);
+}
+
+
+/* 2 * 2 blocks { { a, -0.3 }, { 0.3, a } }, a = 1 + 0.05 j, whose eigenvalues are a ± 0.3 i */
+static void rotations(double const * x, double * y, size_t size, void * context)
+{
+	(void) context;
+
+	for (size_t index = 0; index + 1 < size; index += 2)
+	{
+		double scale = 1 + 0.05 * (index / 2);
+		y[index] = scale * x[index] - 0.3 * x[index + 1];
+		y[index + 1] = 0.3 * x[index] + scale * x[index + 1];
+	}
+}
+
+
+static Matrix * convectionDiffusion(void)
+{
+	return _Matrix->fromRows(6, 6,
+		(double[]) { 4, -2, 0, 0, 0, 1 },
+		(double[]) { -1, 4, -2, 0, 0, 0 },
+		(double[]) { 0, -1, 4, -2, 0, 0 },
+		(double[]) { 0, 0, -1, 4, -2, 0 },
+		(double[]) { 0, 0, 0, -1, 4, -2 },
+		(double[]) { 0, 0, 0, 0, -1, 4 });
+}
+
+
+
+
+Test(Krylov, cg_solves_matrix_free_laplacian)
+{
+	// given
+	size_t size = 50;
+	KrylovOperator operator = { size, laplacian, NULL };
+	Vector * rightHand = _Vector->create(size);
+	_Vector->setCell(rightHand, 0, 1);
+	_Vector->setCell(rightHand, size - 1, 1);
+	KrylovStatistics statistics;
+
+	// when
+	Vector * solution = _Krylov->cg(& operator, NULL, rightHand, NULL, NULL, & statistics);
+
+	// then
+	cr_assert_not_null(solution);
+	cr_expect_eq(KRYLOV_CONVERGED, statistics.status);
+	cr_expect_leq(statistics.iterations, size, "CG ends in at most n iterations in exact arithmetic");
+	cr_expect_leq(statistics.residual, KRYLOV_DEFAULT_TOLERANCE);
+	cr_expect_eq(0, statistics.preconditionings);
+	for (size_t index = 0; index < size; index++)
+		cr_expect_float_eq(1, _Vector->getCell(solution, index), 1e-8);
+
+	// teardown
+	_Vector->delete(& rightHand);
+	_Vector->delete(& solution);
+}
+
+
+Test(Krylov, cg_with_jacobi_solves_badly_scaled_system)
+{
+	// given
+	Matrix * matrix = _Matrix->fromRows(4, 4,
+		(double[]) { 2, -10, 0, 0 },
+		(double[]) { -10, 200, -1000, 0 },
+		(double[]) { 0, -1000, 20000, -100000 },
+		(double[]) { 0, 0, -100000, 2000000 });
+	Vector * expected = _Vector->fromArray(4, (double[]) { 1, -2, 3, -4 });
+	Vector * rightHand = _Vector->create(4);
+	_Vector->gemv(1, matrix, expected, 0, rightHand);
+	KrylovOperator * operator = _Krylov->dense(matrix);
+	KrylovOperator * preconditioner = _Krylov->jacobi(matrix);
+	KrylovSettings settings = { 1e-12, 4, 0 };
+	KrylovStatistics statistics;
+
+	// when
+	Vector * solution = _Krylov->cg(operator, preconditioner, rightHand, NULL, & settings, & statistics);
+
+	// then
+	cr_assert_not_null(solution);
+	cr_expect_eq(KRYLOV_CONVERGED, statistics.status);
+	cr_expect_leq(statistics.residual, 1e-12);
+	cr_expect_eq(statistics.iterations, statistics.preconditionings, "Jacobi undoes the scaling, the last iteration ends before preconditioning");
+	for (size_t index = 0; index < 4; index++)
+		cr_expect_float_eq(_Vector->getCell(expected, index), _Vector->getCell(solution, index), 1e-9);
+
+	// teardown
+	_Krylov->delete(& operator);
+	_Krylov->delete(& preconditioner);
+	cr_expect_null(operator);
+	_Matrix->delete(& matrix);
+	_Vector->delete(& expected);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& solution);
+}
+
+
+Test(Krylov, bicgstab_and_gmres_solve_nonsymmetric_system_with_ilu0)
+{
+	// given
+	Matrix * matrix = convectionDiffusion();
+	Vector * expected = _Vector->fromArray(6, (double[]) { 1, 2, 3, 4, 5, 6 });
+	Vector * rightHand = _Vector->create(6);
+	_Vector->gemv(1, matrix, expected, 0, rightHand);
+	KrylovOperator * operator = _Krylov->dense(matrix);
+	KrylovOperator * preconditioner = _Krylov->ilu0(matrix);
+	KrylovStatistics bicgstabStatistics;
+	KrylovStatistics gmresStatistics;
+	KrylovStatistics restartedStatistics;
+	KrylovSettings restarted = { 1e-10, 100, 2 };
+
+	// when
+	Vector * bicgstab = _Krylov->bicgstab(operator, preconditioner, rightHand, NULL, NULL, & bicgstabStatistics);
+	Vector * gmres = _Krylov->gmres(operator, preconditioner, rightHand, NULL, NULL, & gmresStatistics);
+	Vector * restartedGmres = _Krylov->gmres(operator, NULL, rightHand, NULL, & restarted, & restartedStatistics);
+
+	// then
+	cr_assert_not_null(preconditioner);
+	cr_assert_not_null(bicgstab);
+	cr_assert_not_null(gmres);
+	cr_assert_not_null(restartedGmres);
+	cr_expect_eq(KRYLOV_CONVERGED, bicgstabStatistics.status);
+	cr_expect_eq(KRYLOV_CONVERGED, gmresStatistics.status);
+	cr_expect_eq(KRYLOV_CONVERGED, restartedStatistics.status);
+	cr_expect_lt(gmresStatistics.iterations, 6, "ILU(0) is nearly exact for a nearly tridiagonal matrix");
+	cr_expect_eq(0, restartedStatistics.preconditionings);
+	for (size_t index = 0; index < 6; index++)
+	{
+		cr_expect_float_eq(index + 1, _Vector->getCell(bicgstab, index), 1e-8);
+		cr_expect_float_eq(index + 1, _Vector->getCell(gmres, index), 1e-8);
+		cr_expect_float_eq(index + 1, _Vector->getCell(restartedGmres, index), 1e-8);
+	}
+
+	// teardown
+	_Krylov->delete(& operator);
+	_Krylov->delete(& preconditioner);
+	_Matrix->delete(& matrix);
+	_Vector->delete(& expected);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& bicgstab);
+	_Vector->delete(& gmres);
+	_Vector->delete(& restartedGmres);
+}
+
+
+Test(Krylov, solvers_reject_invalid_operands_and_report_limits)
+{
+	// given
+	Matrix * rectangle = _Matrix->create(2, 3);
+	Matrix * zeroDiagonal = _Matrix->fromRows(2, 2,
+		(double[]) { 0, 1 },
+		(double[]) { 1, 0 });
+	KrylovOperator operator = { 50, laplacian, NULL };
+	Vector * shorter = _Vector->create(49);
+	Vector * rightHand = _Vector->create(50);
+	_Vector->setCell(rightHand, 0, 1);
+	KrylovSettings settings = { 1e-12, 3, 0 };
+	KrylovStatistics statistics;
+
+	// when
+	Vector * mismatched = _Krylov->gmres(& operator, NULL, shorter, NULL, NULL, & statistics);
+	Vector * limited = _Krylov->cg(& operator, NULL, rightHand, NULL, & settings, & statistics);
+
+	// then
+	cr_expect_null(_Krylov->dense(rectangle));
+	cr_expect_null(_Krylov->jacobi(zeroDiagonal));
+	cr_expect_null(_Krylov->ilu0(zeroDiagonal));
+	cr_expect_null(mismatched);
+	cr_assert_not_null(limited);
+	cr_expect_eq(KRYLOV_NOT_CONVERGED, statistics.status);
+	cr_expect_eq(3, statistics.iterations);
+	cr_expect_eq(5, statistics.products, "One product per iteration, and two for the initial and final residuals");
+	cr_expect_gt(statistics.residual, 1e-12);
+
+	// teardown
+	_Matrix->delete(& rectangle);
+	_Matrix->delete(& zeroDiagonal);
+	_Vector->delete(& shorter);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& limited);
+}
+
+
+Test(Krylov, powerIteration_finds_dominant_eigenpair)
+{
+	// given
+	Matrix * matrix = _Matrix->fromRows(3, 3,
+		(double[]) { 2, 1, 0 },
+		(double[]) { 1, 2, 0 },
+		(double[]) { 0, 0, -1 });
+	KrylovOperator * operator = _Krylov->dense(matrix);
+	Vector * shorter = _Vector->create(2);
+	KrylovSettings settings = { 1e-12, 0, 0 };
+	KrylovStatistics statistics;
+	double value = 0;
+
+	// when
+	Vector * vector = _Krylov->powerIteration(operator, NULL, & settings, & value, & statistics);
+
+	// then
+	cr_assert_not_null(vector);
+	cr_expect_eq(KRYLOV_CONVERGED, statistics.status);
+	cr_expect_eq(statistics.iterations, statistics.products);
+	cr_expect_leq(statistics.residual, 1e-12);
+	cr_expect_float_eq(3, value, 1e-12);
+	cr_expect_float_eq(1, fabs(_Vector->getCell(vector, 0) + _Vector->getCell(vector, 1)) / sqrt(2), 1e-10);
+	cr_expect_float_eq(0, _Vector->getCell(vector, 2), 1e-10);
+	cr_expect_null(_Krylov->powerIteration(operator, shorter, NULL, & value, NULL));
+
+	// teardown
+	_Krylov->delete(& operator);
+	_Matrix->delete(& matrix);
+	_Vector->delete(& shorter);
+	_Vector->delete(& vector);
+}
+
+
+Test(Krylov, lanczos_finds_largest_eigenpairs_of_matrix_free_laplacian)
+{
+	// given
+	size_t size = 100;
+	KrylovOperator operator = { size, laplacian, NULL };
+	KrylovSettings settings = { 1e-10, 0, 12 };
+	KrylovStatistics statistics;
+	double values[3];
+
+	// when
+	Matrix * vectors = _Krylov->lanczos(& operator, 3, & settings, values, & statistics);
+
+	// then
+	cr_assert_not_null(vectors);
+	cr_expect_eq(KRYLOV_CONVERGED, statistics.status);
+	cr_expect_gt(statistics.iterations, 1, "A basis of 12 vectors restarts");
+	cr_expect_leq(statistics.residual, 1e-8);
+	for (size_t index = 0; index < 3; index++)
+		cr_expect_float_eq(2 - 2 * cos((size - index) * M_PI / (size + 1)), values[index], 1e-10);
+
+	Matrix * transposed = _Matrix->transpose(vectors);
+	Matrix * gram = _Matrix->product(transposed, vectors);
+	for (size_t row = 0; row < 3; row++)
+		for (size_t column = 0; column < 3; column++)
+			cr_expect_float_eq((row == column) ? 1 : 0, _Matrix->getCell(gram, row, column), 1e-10);
+
+	// teardown
+	_Matrix->delete(& vectors);
+	_Matrix->delete(& transposed);
+	_Matrix->delete(& gram);
+}
+
+
+Test(Krylov, arnoldi_finds_complex_pairs_and_restarts)
+{
+	// given
+	Matrix * blocks = _Matrix->fromRows(5, 5,
+		(double[]) { 3, 1, 0, 0, 0.5 },
+		(double[]) { 0, 1, -2, 0, 0 },
+		(double[]) { 0, 2, 1, 0.3, 0 },
+		(double[]) { 0, 0, 0, 0.5, 1 },
+		(double[]) { 0, 0, 0, 0, -1 });
+	KrylovOperator * operator = _Krylov->dense(blocks);
+	KrylovOperator nonsymmetric = { 60, rotations, NULL };
+	KrylovSettings settings = { 1e-10, 0, 16 };
+	KrylovStatistics statistics;
+	KrylovStatistics restartedStatistics;
+	double real[3];
+	double imaginary[3];
+	double restartedReal[2];
+	double restartedImaginary[2];
+
+	// when
+	Matrix * vectors = _Krylov->arnoldi(operator, 3, NULL, real, imaginary, & statistics);
+	Matrix * restarted = _Krylov->arnoldi(& nonsymmetric, 2, & settings, restartedReal, restartedImaginary, & restartedStatistics);
+
+	// then
+	cr_assert_not_null(vectors);
+	cr_expect_eq(KRYLOV_CONVERGED, statistics.status);
+	cr_expect_leq(statistics.residual, 1e-10);
+	cr_expect_float_eq(3, real[0], 1e-10);
+	cr_expect_float_eq(0, imaginary[0], 1e-10);
+	cr_expect_float_eq(1, real[1], 1e-10);
+	cr_expect_float_eq(2, imaginary[1], 1e-10);
+	cr_expect_float_eq(1, real[2], 1e-10);
+	cr_expect_float_eq(-2, imaginary[2], 1e-10);
+	cr_expect_null(_Krylov->arnoldi(operator, 6, NULL, real, imaginary, NULL));
+
+	cr_assert_not_null(restarted);
+	cr_expect_eq(KRYLOV_CONVERGED, restartedStatistics.status);
+	cr_expect_gt(restartedStatistics.iterations, 1);
+	cr_expect_float_eq(2.45, restartedReal[0], 1e-8);
+	cr_expect_float_eq(0.3, restartedImaginary[0], 1e-8);
+	cr_expect_float_eq(2.45, restartedReal[1], 1e-8);
+	cr_expect_float_eq(-0.3, restartedImaginary[1], 1e-8);
+
+	// teardown
+	_Krylov->delete(& operator);
+	_Matrix->delete(& blocks);
+	_Matrix->delete(& vectors);
+	_Matrix->delete(& restarted);
+}
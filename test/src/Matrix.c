@@ -2,6 +2,9 @@
 #include "../../src/Matrix.h"
 
 #include <criterion/criterion.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 
 
@@ -135,6 +138,160 @@ Test(Matrix, fromColumns_stores_given_values)
 }
 
 
+Test(Matrix, fromBuffer_copies_strided_rows)
+{
+	// given
+	double cells[] = {
+		1, 2, 3, -1,
+		4, 5, 6, -1
+	};
+
+	// when
+	Matrix * this = _Matrix->fromBuffer(2, 3, cells, 4);
+	Matrix * tooShort = _Matrix->fromBuffer(2, 3, cells, 2);
+	cells[0] = 0;
+
+	// then
+	cr_assert_not_null(this);
+	cr_expect_null(tooShort, "Rows can't overlap");
+	for (size_t rowIndex = 0; rowIndex < 2; rowIndex++)
+	{
+		for (size_t columnIndex = 0; columnIndex < 3; columnIndex++)
+			cr_expect_eq(3 * rowIndex + columnIndex + 1, _Matrix->getCell(this, rowIndex, columnIndex));
+	}
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+/**
+ * Counts the buffers given back by adopted matrices
+ */
+static void countingDeleter(void * cells, void * context)
+{
+	(void) cells;
+
+	(* (int *) context)++;
+}
+
+
+Test(Matrix, wrap_and_adopt_read_buffers_in_place)
+{
+	// given
+	double columnMajor[] = {
+		1, 3, 0,
+		2, 4, 0
+	};
+	double * adopted = malloc(4 * sizeof(double));
+	for (size_t index = 0; index < 4; index++)
+		adopted[index] = (double) index;
+	double rows[] = { 1, 2, 3, 4, 5, 6 };
+	Matrix * identity = _Matrix->identity(2);
+	int deleted = 0;
+
+	// when
+	Matrix * wrapped = _Matrix->wrap(2, 2, columnMajor, 3, MATRIX_COLUMN_MAJOR);
+	Matrix * detached = _Matrix->wrap(2, 3, rows, 3, MATRIX_ROW_MAJOR);
+	Matrix * rowsCopy = _Matrix->copy(detached);
+	int detachedSucceeded = _Matrix->detach(detached);
+	Matrix * owner = _Matrix->adopt(2, 2, adopted, 2, MATRIX_ROW_MAJOR, countingDeleter, & deleted);
+	Matrix * copy = _Matrix->copy(owner);
+	int succeeded = _Matrix->gemm(1, identity, 0, identity, 0, 1, wrapped);
+	_Matrix->delete(& owner);
+	int deletedWhileCopied = deleted;
+	double copied = _Matrix->getCell(copy, 1, 0);
+	_Matrix->delete(& copy);
+
+	// then
+	cr_assert_not_null(wrapped);
+	cr_expect(succeeded);
+	cr_expect_eq(MATRIX_COLUMN_MAJOR, _Matrix->layout(wrapped));
+	cr_expect_eq(2, _Matrix->getCell(wrapped, 0, 0), "gemm writes to the wrapped buffer");
+	cr_expect_eq(2, columnMajor[0]);
+	cr_expect_eq(3, columnMajor[1]);
+	cr_expect_eq(5, columnMajor[4]);
+	cr_expect_eq(0, columnMajor[2], "Padding is never written");
+	cr_expect_eq(0, deletedWhileCopied, "The copy still reads the adopted buffer");
+	cr_expect_eq(2, copied);
+	cr_expect_eq(1, deleted);
+	cr_expect(detachedSucceeded);
+	cr_expect_eq(21, _Matrix->total(detached), "Detached cells are laid out as the allocator pads them");
+	cr_expect_eq(6, _Matrix->getCell(detached, 1, 2));
+
+	// teardown
+	free(adopted);
+	_Matrix->delete(& wrapped);
+	_Matrix->delete(& detached);
+	_Matrix->delete(& rowsCopy);
+	_Matrix->delete(& identity);
+}
+
+
+Test(Matrix, row_and_column_spans_read_cells_in_place)
+{
+	// given
+	Matrix * rowMajor = _Matrix->fromRows(2, 3, (double[]) { 1, 2, 3 }, (double[]) { 4, 5, 6 });
+	Matrix * columnMajor = _Matrix->toLayout(rowMajor, MATRIX_COLUMN_MAJOR);
+
+	for (int layout = 0; layout < 2; layout++)
+	{
+		Matrix * this = layout ? columnMajor : rowMajor;
+
+		// when
+		MatrixSpan row = _Matrix->row(this, 1);
+		MatrixSpan column = _Matrix->column(this, 2);
+		MatrixSpan outOfBounds = _Matrix->row(this, 2);
+
+		// then
+		cr_assert_eq(3, row.length);
+		cr_assert_eq(2, column.length);
+		for (size_t index = 0; index < 3; index++)
+			cr_expect_eq(4 + index, MATRIX_SPAN_CELL(row, index));
+		cr_expect_eq(3, MATRIX_SPAN_CELL(column, 0));
+		cr_expect_eq(6, MATRIX_SPAN_CELL(column, 1));
+		cr_expect_null(outOfBounds.cells);
+		cr_expect_eq(0, outOfBounds.length);
+	}
+
+	// teardown
+	_Matrix->delete(& rowMajor);
+	_Matrix->delete(& columnMajor);
+}
+
+
+Test(Matrix, setters_write_cells_of_their_own)
+{
+	// given
+	Matrix * this = _Matrix->fromColumns(2, 2, (double[]) { 1, 3 }, (double[]) { 2, 4 });
+	Matrix * copy = _Matrix->copy(this);
+	Matrix * filled = _Matrix->create(2, 3);
+
+	// when
+	int cellSet = _Matrix->setCell(copy, 0, 1, 7);
+	int rowSet = _Matrix->setRow(copy, 1, (double[]) { 8, 9 });
+	int columnSet = _Matrix->setColumn(copy, 0, (double[]) { 5, 6 });
+	int outOfBounds = _Matrix->setCell(copy, 2, 0, 1) || _Matrix->setColumn(copy, 2, (double[]) { 0, 0 });
+	int wasFilled = _Matrix->fill(filled, -1);
+
+	// then
+	cr_expect(cellSet && rowSet && columnSet);
+	cr_expect_not(outOfBounds);
+	cr_expect_eq(5, _Matrix->getCell(copy, 0, 0));
+	cr_expect_eq(7, _Matrix->getCell(copy, 0, 1));
+	cr_expect_eq(6, _Matrix->getCell(copy, 1, 0));
+	cr_expect_eq(9, _Matrix->getCell(copy, 1, 1));
+	cr_expect_eq(2, _Matrix->getCell(this, 0, 1), "Copies are written to cells of their own");
+	cr_expect(wasFilled);
+	cr_expect_eq(-6, _Matrix->total(filled));
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& copy);
+	_Matrix->delete(& filled);
+}
+
+
 Test(Matrix, sum_requires_equal_widths)
 {
 	// given
@@ -264,6 +421,106 @@ Test(Matrix, copy)
 }
 
 
+Test(Matrix, copy_shares_cells_until_written_to)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(2, 2,
+		(double[]) { 1, 2 },
+		(double[]) { 3, 4 });
+	Matrix * identity = _Matrix->identity(2);
+	Matrix * copy = _Matrix->copy(this);
+	Matrix * other = _Matrix->copy(copy);
+	int wasShared = _Matrix->isShared(this) && _Matrix->isShared(copy);
+
+	// when
+	int written = _Matrix->gemm(2, identity, 0, identity, 0, 0, copy);
+
+	// then
+	cr_expect(wasShared);
+	cr_assert(written);
+	cr_expect_eq(2, _Matrix->getCell(copy, 0, 0));
+	cr_expect_eq(0, _Matrix->getCell(copy, 0, 1));
+	cr_expect_eq(1, _Matrix->getCell(this, 0, 0), "Written cells are the copy's own");
+	cr_expect_eq(4, _Matrix->getCell(other, 1, 1));
+	cr_expect_not(_Matrix->isShared(copy));
+	cr_expect(_Matrix->isShared(this), "[other] still reads the cells of [this]");
+
+	// when
+	_Matrix->delete(& this);
+
+	// then
+	cr_expect_eq(3, _Matrix->getCell(other, 1, 0), "Cells outlive the matrix they were created with");
+	cr_expect_not(_Matrix->isShared(other));
+	cr_expect(_Matrix->detach(other));
+	cr_expect_not(_Matrix->detach(NULL));
+
+	// teardown
+	_Matrix->delete(& identity);
+	_Matrix->delete(& copy);
+	_Matrix->delete(& other);
+}
+
+
+Test(Matrix, retain_keeps_deleted_matrix_alive)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(1, 2, (double[]) { 5, 7 });
+	Matrix const * held = _Matrix->retain(this);
+
+	// when
+	_Matrix->delete(& this);
+
+	// then
+	cr_expect_null(this);
+	cr_expect_eq(held, _Matrix->retain(held));
+	_Matrix->release(held);
+	cr_expect_eq(7, _Matrix->getCell(held, 0, 1));
+
+	// teardown
+	_Matrix->release(held);
+	_Matrix->release(NULL);
+}
+
+
+/**
+ * Copies and deletes a shared matrix over and over, racing other threads doing the same
+ */
+static void * copyRepeatedly(void * matrix)
+{
+	for (size_t index = 0; index < 10000; index++)
+	{
+		Matrix * copy = _Matrix->copy(matrix);
+		Matrix const * held = _Matrix->retain(copy);
+
+		_Matrix->delete(& copy);
+		_Matrix->release(held);
+	}
+
+	return NULL;
+}
+
+
+Test(Matrix, references_are_counted_across_threads)
+{
+	// given
+	Matrix * this = _Matrix->identity(3);
+	pthread_t threads[4];
+
+	// when
+	for (size_t index = 0; index < 4; index++)
+		pthread_create(& threads[index], NULL, copyRepeatedly, this);
+	for (size_t index = 0; index < 4; index++)
+		pthread_join(threads[index], NULL);
+
+	// then
+	cr_expect_not(_Matrix->isShared(this), "Every copy was deleted");
+	cr_expect(_Matrix->isIdentity(this));
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
 Test(Matrix, width_error_on_null_matrix)
 {
 	// given
@@ -497,398 +754,1735 @@ Test(Matrix, product)
 }
 
 
-Test(Matrix, trace_requires_square_matrix)
+/**
+ * Builds a height*width matrix of small integers, as a sum of 3 outer products
+ */
+static Matrix * integers(size_t height, size_t width, int seed)
 {
-	// given
-	Matrix * this = _Matrix->create(2, 3);
+	Matrix * result = _Matrix->create(height, width);
 
-	// when
-	double trace = _Matrix->trace(this);
+	for (int term = 0; term < 3; term++)
+	{
+		double column[height];
+		double row[width];
+		for (size_t index = 0; index < height; index++)
+			column[index] = (double) ((int) ((index + 1) * (seed + term + 2)) % 7 - 3);
+		for (size_t index = 0; index < width; index++)
+			row[index] = (double) ((int) ((index + 3) * (seed + 2 * term + 1)) % 5 - 2);
+
+		Matrix * left = _Matrix->fromColumns(height, 1, column);
+		Matrix * right = _Matrix->fromRows(1, width, row);
+		Matrix * outer = _Matrix->product(left, right);
+		Matrix * sum = _Matrix->sum(result, outer);
+
+		_Matrix->delete(& left);
+		_Matrix->delete(& right);
+		_Matrix->delete(& outer);
+		_Matrix->delete(& result);
+		result = sum;
+	}
 
-	// then
-	cr_expect_eq(MATRIX_IS_NOT_SQUARE, trace, "Non-square matrix can't have trace");
+	return result;
+}
 
-	// teardown
-	_Matrix->delete(& this);
+
+static void expect_same_cells(Matrix const * actual, Matrix const * expected)
+{
+	cr_assert_not_null(actual);
+	cr_assert_eq(_Matrix->height(expected), _Matrix->height(actual), "Incorrect height");
+	cr_assert_eq(_Matrix->width(expected), _Matrix->width(actual), "Incorrect width");
+
+	for (size_t ordinate = 0; ordinate < _Matrix->height(expected); ordinate++)
+	{
+		for (size_t abscissa = 0; abscissa < _Matrix->width(expected); abscissa++)
+		{
+			double actualValue = _Matrix->getCell(actual, ordinate, abscissa);
+			double expectedValue = _Matrix->getCell(expected, ordinate, abscissa);
+			cr_expect_eq(
+				actualValue, expectedValue,
+				"Incorrect cell at (%zu,%zu), got %lf instead of %lf",
+				ordinate, abscissa, actualValue, expectedValue);
+		}
+	}
 }
 
 
-Test(Matrix, trace)
+/**
+ * Allocations and frees seen by countingAlloc and countingFree
+ */
+typedef struct
+{
+	size_t allocations;
+	size_t frees;
+	size_t misaligned;
+} Counters;
+
+
+static void * countingAlloc(size_t bytes, size_t alignment, void * context)
+{
+	Counters * counters = context;
+	void * block = aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+
+	counters->allocations++;
+	if ((uintptr_t) block % alignment != 0)
+		counters->misaligned++;
+
+	return block;
+}
+
+
+static void countingFree(void * block, void * context)
+{
+	Counters * counters = context;
+
+	counters->frees++;
+	free(block);
+}
+
+
+Test(Matrix, createWith_uses_given_allocator)
 {
 	// given
-	double rows[][3] = {
-		{    2, -100, -100 },
-		{ -100,    3, -100 },
-		{ -100, -100,    5 }
-	};
-	Matrix * this = _Matrix->fromRows(3, 3, rows[0], rows[1], rows[2]);
+	Counters counters = { 0, 0, 0 };
+	MatrixAllocator allocator = { countingAlloc, countingFree, 128, & counters };
 
 	// when
-	double trace = _Matrix->trace(this);
+	Matrix * this = _Matrix->createWith(3, 5, & allocator);
 
 	// then
-	cr_expect_eq(10, trace, "Got %lf instead of 10", trace);
+	cr_assert_not_null(this);
+	cr_expect_eq(1, counters.allocations, "A matrix is a single block");
+	cr_expect_eq(0, counters.misaligned);
+	for (size_t ordinate = 0; ordinate < 3; ordinate++)
+		for (size_t abscissa = 0; abscissa < 5; abscissa++)
+			cr_expect_eq(0, _Matrix->getCell(this, ordinate, abscissa));
 
 	// teardown
 	_Matrix->delete(& this);
+	cr_expect_eq(1, counters.frees, "Memory goes back to the allocator it came from");
 }
 
 
-Test(Matrix, determinant_of_non_square_matrix_is_not_defined)
+Test(Matrix, setAllocator_rejects_invalid_alignment)
 {
 	// given
-	Matrix * this = _Matrix->fromRows(1, 2, (double[]) { 0, 0 });
+	Counters counters = { 0, 0, 0 };
+	MatrixAllocator allocator = { countingAlloc, countingFree, 48, & counters };
 
 	// when
-	double determinant = _Matrix->determinant(this);
+	int accepted = _Matrix->setAllocator(& allocator);
+	Matrix * this = _Matrix->createWith(2, 2, & allocator);
 
 	// then
-	cr_expect_eq(MATRIX_IS_NOT_SQUARE, determinant, "Determinant only exists for square matrix");
-
-	// teardown
-	_Matrix->delete(& this);
+	cr_expect_not(accepted, "48 is not a power of 2");
+	cr_expect_null(this);
+	cr_expect_eq(0, counters.allocations);
 }
 
 
-Test(Matrix, determinant_for_matrix_size_1_is_its_only_value)
+Test(Matrix, setAllocator_serves_matrices_and_workspaces)
 {
 	// given
-	Matrix * this = _Matrix->fromRows(1, 1, (double[]) { 2 });
+	Counters counters = { 0, 0, 0 };
+	MatrixAllocator allocator = { countingAlloc, countingFree, 32, & counters };
+	Matrix * before = integers(33, 33, 1);
+	_Matrix->setAllocator(& allocator);
+	_Matrix->tuneStrassen(4, 0);
 
 	// when
-	double determinant = _Matrix->determinant(this);
+	Matrix * product = _Matrix->strassenProduct(before, before);
+	_Matrix->setAllocator(NULL);
+	Matrix * expected = _Matrix->product(before, before);
 
 	// then
-	cr_expect_eq(2, determinant, "Got %lf instead of 2", determinant);
+	cr_expect_eq(2, counters.allocations, "The product, and the padded workspace");
+	cr_expect_eq(1, counters.frees);
+	expect_same_cells(product, expected);
 
 	// teardown
-	_Matrix->delete(& this);
+	_Matrix->tuneStrassen(STRASSEN_DEFAULT_CROSSOVER, STRASSEN_DEFAULT_THRESHOLD);
+	_Matrix->delete(& before);
+	_Matrix->delete(& product);
+	_Matrix->delete(& expected);
+	cr_expect_eq(2, counters.frees);
 }
 
 
-Test(Matrix, determinant_for_matrix_size_2_is_diagonal_products_difference)
+Test(Matrix, strassenProduct_requires_left_width_equal_to_right_height)
 {
 	// given
-	double rows[][2] = {
-		{ 2, 3, },
-		{ 5, 7, },
-	};
-	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+	Matrix * left = _Matrix->create(2, 3);
+	Matrix * right = _Matrix->create(2, 2);
 
 	// when
-	double determinant = _Matrix->determinant(this);
+	Matrix * product = _Matrix->strassenProduct(left, right);
 
 	// then
-	cr_expect_eq(
-		2 * 7 - 3 * 5, determinant,
-		"Got %lf instead of %lf", determinant, 2.0 * 7 - 3 * 5);
+	cr_expect_null(product, "Matrix multiplication should fail on invalid operands size");
 
 	// teardown
-	_Matrix->delete(& this);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
 }
 
 
-Test(Matrix, determinant)
+Test(Matrix, strassenProduct_matches_product)
 {
 	// given
-	Matrix * this = _Matrix->fromRows(
-		3, 3,
-		(double[]) {  2,  3,  5 },
-		(double[]) {  7, 11, 13 },
-		(double[]) { 17, 19, 23 });
+	Matrix * left = integers(64, 64, 1);
+	Matrix * right = integers(64, 64, 2);
+	_Matrix->tuneStrassen(4, 0);
 
 	// when
-	double determinant = _Matrix->determinant(this);
+	Matrix * actual = _Matrix->strassenProduct(left, right);
 
 	// then
-	cr_expect_eq(determinant, -78, "Got %lf instead of -78", determinant);
+	Matrix * expected = _Matrix->product(left, right);
+	expect_same_cells(actual, expected);
 
 	// teardown
-	_Matrix->delete(& this);
+	_Matrix->tuneStrassen(STRASSEN_DEFAULT_CROSSOVER, STRASSEN_DEFAULT_THRESHOLD);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& actual);
+	_Matrix->delete(& expected);
 }
 
 
-Test(Matrix, transpose_creates_new_matrix)
+Test(Matrix, strassenProduct_pads_odd_dimensions)
 {
 	// given
-	Matrix * this = _Matrix->create(1, 2);
+	Matrix * left = integers(37, 53, 3);
+	Matrix * right = integers(53, 29, 4);
+	_Matrix->tuneStrassen(4, 0);
 
 	// when
-	Matrix * transpose = _Matrix->transpose(this);
+	Matrix * actual = _Matrix->strassenProduct(left, right);
 
 	// then
-	cr_expect_neq(transpose, this, "Transpose should create a new matrix");
+	Matrix * expected = _Matrix->product(left, right);
+	expect_same_cells(actual, expected);
 
 	// teardown
-	_Matrix->delete(& transpose);
-	_Matrix->delete(& this);
+	_Matrix->tuneStrassen(STRASSEN_DEFAULT_CROSSOVER, STRASSEN_DEFAULT_THRESHOLD);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& actual);
+	_Matrix->delete(& expected);
 }
 
 
-Test(Matrix, transpose_has_inverse_dimensions)
+Test(Matrix, product_above_strassen_threshold)
 {
 	// given
-	Matrix * this = _Matrix->create(1, 2);
+	Matrix * left = integers(40, 48, 5);
+	Matrix * right = integers(48, 36, 6);
+	Matrix * expected = _Matrix->product(left, right);
+	_Matrix->tuneStrassen(8, 32);
 
 	// when
-	Matrix * transpose = _Matrix->transpose(this);
+	Matrix * actual = _Matrix->product(left, right);
 
 	// then
-	cr_expect_eq(2, _Matrix->height(transpose));
-	cr_expect_eq(1, _Matrix->width(transpose));
+	expect_same_cells(actual, expected);
 
 	// teardown
-	_Matrix->delete(& this);
-	_Matrix->delete(& transpose);
+	_Matrix->tuneStrassen(STRASSEN_DEFAULT_CROSSOVER, STRASSEN_DEFAULT_THRESHOLD);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& actual);
+	_Matrix->delete(& expected);
 }
 
 
-Test(Matrix, transpose)
+Test(Matrix, gemm_requires_matching_sizes)
 {
 	// given
-	Matrix * this = _Matrix->fromRows(
-		2, 3,
-		(double[]) { 2, 3, 5 },
-		(double[]) { 5, 7, 11 } );
+	Matrix * left = _Matrix->create(2, 3);
+	Matrix * right = _Matrix->create(2, 2);
+	Matrix * result = _Matrix->create(3, 2);
 
 	// when
-	Matrix * transpose = _Matrix->transpose(this);
+	int mismatched = _Matrix->gemm(1, left, 0, right, 0, 0, result);
+	int transposed = _Matrix->gemm(1, left, 1, right, 0, 0, result);
+	int aliased = _Matrix->gemm(1, right, 0, right, 0, 0, right);
 
 	// then
-	for (size_t rowIndex = 0; rowIndex < 2; rowIndex++)
-	{
-		for (size_t columnIndex = 0; columnIndex < 3; columnIndex++)
-		{
-			double expected = _Matrix->getCell(this, rowIndex, columnIndex);
-			double actual = _Matrix->getCell(transpose, columnIndex, rowIndex);
-			cr_expect_eq(
-				expected, actual,
-				"At (%lu,%lu), got %lf instead of %lf",
-				columnIndex, rowIndex, actual, expected);
-		}
-	}
+	cr_expect_not(mismatched, "Left width must match right height");
+	cr_expect(transposed, "^t A is 3*2");
+	cr_expect_not(aliased, "The result must not be an operand");
 
 	// teardown
-	_Matrix->delete(& this);
-	_Matrix->delete(& transpose);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& result);
 }
 
 
-Test(Matrix, adjugate_matrix_is_only_defined_for_square_matrix)
+Test(Matrix, gemm_matches_product_of_transposes)
 {
 	// given
-	Matrix * this = _Matrix->create(1, 2);
+	Matrix * left = integers(70, 90, 7);
+	Matrix * right = integers(80, 70, 8);
+	Matrix * result = integers(90, 80, 9);
+	Matrix * leftTransposed = _Matrix->transpose(left);
+	Matrix * rightTransposed = _Matrix->transpose(right);
+	Matrix * product = _Matrix->product(leftTransposed, rightTransposed);
+	Matrix * scaledProduct = _Matrix->scalarProduct(product, 2);
+	Matrix * scaledResult = _Matrix->scalarProduct(result, -3);
+	Matrix * expected = _Matrix->sum(scaledProduct, scaledResult);
 
 	// when
-	Matrix * adjugate = _Matrix->adjugate(this);
+	int succeeded = _Matrix->gemm(2, left, 1, right, 1, -3, result);
 
 	// then
-	cr_expect_null(adjugate, "Adjugate matrix is only defined for square matrix");
+	cr_expect(succeeded);
+	expect_same_cells(result, expected);
 
 	// teardown
-	_Matrix->delete(& this);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& result);
+	_Matrix->delete(& leftTransposed);
+	_Matrix->delete(& rightTransposed);
+	_Matrix->delete(& product);
+	_Matrix->delete(& scaledProduct);
+	_Matrix->delete(& scaledResult);
+	_Matrix->delete(& expected);
 }
 
 
-Test(Matrix, adjugate)
+Test(Matrix, gemm_does_not_depend_on_threads)
 {
 	// given
-	Matrix * this = _Matrix->fromRows(
-		3, 3,
-		(double[]) {  2,  3,  5 },
-		(double[]) {  7, 11, 13 },
-		(double[]) { 17, 19, 23 });
+	Matrix * left = integers(150, 300, 4);
+	Matrix * right = integers(150, 260, 5);
+	Matrix * expected = integers(300, 260, 6);
+	Matrix * result = _Matrix->copy(expected);
+	_Matrix->gemm(0.5, left, 1, right, 0, 2, expected);
+	_Matrix->setThreads(4);
 
 	// when
-	Matrix * adjugate = _Matrix->adjugate(this);
+	int succeeded = _Matrix->gemm(0.5, left, 1, right, 0, 2, result);
 
 	// then
-	double expected[][3] = {
-		{   6,  26, -16 },
+	cr_expect(succeeded);
+	expect_same_cells(result, expected);
+
+	// teardown
+	_Matrix->setThreads(1);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& result);
+}
+
+
+Test(Matrix, copyRegion_moves_overlapping_blocks_across_layouts)
+{
+	// given
+	Matrix * this = integers(6, 5, 3);
+	Matrix * expected = _Matrix->create(6, 5);
+	for (size_t rowIndex = 0; rowIndex < 6; rowIndex++)
+	{
+		for (size_t columnIndex = 0; columnIndex < 5; columnIndex++)
+		{
+			int moved = (rowIndex >= 2) && (columnIndex >= 1);
+			_Matrix->setCell(
+				expected, rowIndex, columnIndex,
+				_Matrix->getCell(this, moved ? rowIndex - 2 : rowIndex, moved ? columnIndex - 1 : columnIndex));
+		}
+	}
+	Matrix * columnMajor = _Matrix->toLayout(this, MATRIX_COLUMN_MAJOR);
+	Matrix * mixed = _Matrix->toLayout(this, MATRIX_COLUMN_MAJOR);
+	Matrix * original = _Matrix->copy(this);
+
+	// when
+	int succeeded = _Matrix->copyRegion(this, 2, 1, this, 0, 0, 4, 4);
+	int columnMajorSucceeded = _Matrix->copyRegion(columnMajor, 2, 1, columnMajor, 0, 0, 4, 4);
+	int mixedSucceeded = _Matrix->copyRegion(mixed, 2, 1, original, 0, 0, 4, 4);
+	int outOfBounds = _Matrix->copyRegion(this, 3, 1, this, 0, 0, 4, 4);
+
+	// then
+	cr_expect(succeeded && columnMajorSucceeded && mixedSucceeded);
+	cr_expect_not(outOfBounds);
+	expect_same_cells(this, expected);
+	expect_same_cells(columnMajor, expected);
+	expect_same_cells(mixed, expected);
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& columnMajor);
+	_Matrix->delete(& mixed);
+	_Matrix->delete(& original);
+}
+
+
+Test(Matrix, toLayout_keeps_cells)
+{
+	// given
+	Matrix * this = _Matrix->fromColumns(
+		2, 3,
+		(double[]) { 1, 4 },
+		(double[]) { 2, 5 },
+		(double[]) { 3, 6 });
+	Matrix * expected = _Matrix->fromRows(
+		2, 3,
+		(double[]) { 1, 2, 3 },
+		(double[]) { 4, 5, 6 });
+
+	// when
+	Matrix * rowMajor = _Matrix->toLayout(this, MATRIX_ROW_MAJOR);
+	Matrix * columnMajor = _Matrix->toLayout(rowMajor, MATRIX_COLUMN_MAJOR);
+	Matrix * transposed = _Matrix->transpose(rowMajor);
+
+	// then
+	cr_expect_eq(MATRIX_COLUMN_MAJOR, _Matrix->layout(this));
+	cr_expect_eq(MATRIX_ROW_MAJOR, _Matrix->layout(rowMajor));
+	cr_expect_eq(MATRIX_COLUMN_MAJOR, _Matrix->layout(columnMajor));
+	cr_expect_eq(MATRIX_COLUMN_MAJOR, _Matrix->layout(transposed), "^t A shares the cells of A");
+	cr_expect_eq(3, _Matrix->height(transposed));
+	cr_expect_eq(6, _Matrix->getCell(transposed, 2, 1));
+	expect_same_cells(this, expected);
+	expect_same_cells(rowMajor, expected);
+	expect_same_cells(columnMajor, expected);
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& rowMajor);
+	_Matrix->delete(& columnMajor);
+	_Matrix->delete(& transposed);
+}
+
+
+Test(Matrix, products_do_not_depend_on_layouts)
+{
+	// given
+	Matrix * left = integers(40, 48, 3);
+	Matrix * right = integers(48, 36, 4);
+	Matrix * addend = integers(40, 36, 5);
+	Matrix * expectedProduct = _Matrix->product(left, right);
+	Matrix * expectedSum = _Matrix->sum(expectedProduct, addend);
+	Matrix * expectedGemm = _Matrix->copy(addend);
+	_Matrix->gemm(2, left, 0, right, 0, -1, expectedGemm);
+
+	for (int combination = 0; combination < 4; combination++)
+	{
+		Matrix * leftLaidOut = _Matrix->toLayout(left, (combination & 1) ? MATRIX_COLUMN_MAJOR : MATRIX_ROW_MAJOR);
+		Matrix * rightLaidOut = _Matrix->toLayout(right, (combination & 2) ? MATRIX_COLUMN_MAJOR : MATRIX_ROW_MAJOR);
+		Matrix * addendLaidOut = _Matrix->toLayout(addend, (combination & 1) ? MATRIX_ROW_MAJOR : MATRIX_COLUMN_MAJOR);
+		Matrix * rightTransposed = _Matrix->transpose(rightLaidOut);
+
+		// when
+		Matrix * product = _Matrix->product(leftLaidOut, rightLaidOut);
+		Matrix * sum = _Matrix->sum(product, addendLaidOut);
+		_Matrix->tuneStrassen(8, 32);
+		Matrix * strassen = _Matrix->strassenProduct(leftLaidOut, rightLaidOut);
+		_Matrix->tuneStrassen(STRASSEN_DEFAULT_CROSSOVER, STRASSEN_DEFAULT_THRESHOLD);
+		Matrix * gemm = _Matrix->copy(addendLaidOut);
+		int succeeded = _Matrix->gemm(2, leftLaidOut, 0, rightTransposed, 1, -1, gemm);
+
+		// then
+		cr_expect(succeeded);
+		expect_same_cells(product, expectedProduct);
+		expect_same_cells(sum, expectedSum);
+		expect_same_cells(strassen, expectedProduct);
+		expect_same_cells(gemm, expectedGemm);
+		cr_expect_eq(_Matrix->layout(addendLaidOut), _Matrix->layout(gemm), "gemm keeps the layout of the result");
+
+		// teardown
+		_Matrix->delete(& leftLaidOut);
+		_Matrix->delete(& rightLaidOut);
+		_Matrix->delete(& addendLaidOut);
+		_Matrix->delete(& rightTransposed);
+		_Matrix->delete(& product);
+		_Matrix->delete(& sum);
+		_Matrix->delete(& strassen);
+		_Matrix->delete(& gemm);
+	}
+
+	// teardown
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& addend);
+	_Matrix->delete(& expectedProduct);
+	_Matrix->delete(& expectedSum);
+	_Matrix->delete(& expectedGemm);
+}
+
+
+Test(Matrix, trace_requires_square_matrix)
+{
+	// given
+	Matrix * this = _Matrix->create(2, 3);
+
+	// when
+	double trace = _Matrix->trace(this);
+
+	// then
+	cr_expect_eq(MATRIX_IS_NOT_SQUARE, trace, "Non-square matrix can't have trace");
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, trace)
+{
+	// given
+	double rows[][3] = {
+		{    2, -100, -100 },
+		{ -100,    3, -100 },
+		{ -100, -100,    5 }
+	};
+	Matrix * this = _Matrix->fromRows(3, 3, rows[0], rows[1], rows[2]);
+
+	// when
+	double trace = _Matrix->trace(this);
+
+	// then
+	cr_expect_eq(10, trace, "Got %lf instead of 10", trace);
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, determinant_of_non_square_matrix_is_not_defined)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(1, 2, (double[]) { 0, 0 });
+
+	// when
+	double determinant = _Matrix->determinant(this);
+
+	// then
+	cr_expect_eq(MATRIX_IS_NOT_SQUARE, determinant, "Determinant only exists for square matrix");
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, determinant_for_matrix_size_1_is_its_only_value)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(1, 1, (double[]) { 2 });
+
+	// when
+	double determinant = _Matrix->determinant(this);
+
+	// then
+	cr_expect_eq(2, determinant, "Got %lf instead of 2", determinant);
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, determinant_for_matrix_size_2_is_diagonal_products_difference)
+{
+	// given
+	double rows[][2] = {
+		{ 2, 3, },
+		{ 5, 7, },
+	};
+	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+
+	// when
+	double determinant = _Matrix->determinant(this);
+
+	// then
+	cr_expect_eq(
+		2 * 7 - 3 * 5, determinant,
+		"Got %lf instead of %lf", determinant, 2.0 * 7 - 3 * 5);
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, determinant)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(
+		3, 3,
+		(double[]) {  2,  3,  5 },
+		(double[]) {  7, 11, 13 },
+		(double[]) { 17, 19, 23 });
+
+	// when
+	double determinant = _Matrix->determinant(this);
+
+	// then
+	cr_expect_eq(determinant, -78, "Got %lf instead of -78", determinant);
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, transpose_creates_new_matrix)
+{
+	// given
+	Matrix * this = _Matrix->create(1, 2);
+
+	// when
+	Matrix * transpose = _Matrix->transpose(this);
+
+	// then
+	cr_expect_neq(transpose, this, "Transpose should create a new matrix");
+
+	// teardown
+	_Matrix->delete(& transpose);
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, transpose_has_inverse_dimensions)
+{
+	// given
+	Matrix * this = _Matrix->create(1, 2);
+
+	// when
+	Matrix * transpose = _Matrix->transpose(this);
+
+	// then
+	cr_expect_eq(2, _Matrix->height(transpose));
+	cr_expect_eq(1, _Matrix->width(transpose));
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& transpose);
+}
+
+
+Test(Matrix, transpose)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(
+		2, 3,
+		(double[]) { 2, 3, 5 },
+		(double[]) { 5, 7, 11 } );
+
+	// when
+	Matrix * transpose = _Matrix->transpose(this);
+
+	// then
+	for (size_t rowIndex = 0; rowIndex < 2; rowIndex++)
+	{
+		for (size_t columnIndex = 0; columnIndex < 3; columnIndex++)
+		{
+			double expected = _Matrix->getCell(this, rowIndex, columnIndex);
+			double actual = _Matrix->getCell(transpose, columnIndex, rowIndex);
+			cr_expect_eq(
+				expected, actual,
+				"At (%lu,%lu), got %lf instead of %lf",
+				columnIndex, rowIndex, actual, expected);
+		}
+	}
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& transpose);
+}
+
+
+Test(Matrix, adjugate_matrix_is_only_defined_for_square_matrix)
+{
+	// given
+	Matrix * this = _Matrix->create(1, 2);
+
+	// when
+	Matrix * adjugate = _Matrix->adjugate(this);
+
+	// then
+	cr_expect_null(adjugate, "Adjugate matrix is only defined for square matrix");
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, adjugate)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(
+		3, 3,
+		(double[]) {  2,  3,  5 },
+		(double[]) {  7, 11, 13 },
+		(double[]) { 17, 19, 23 });
+
+	// when
+	Matrix * adjugate = _Matrix->adjugate(this);
+
+	// then
+	double expected[][3] = {
+		{   6,  26, -16 },
 		{  60, -39,   9 },
 		{ -54,  13,   1 },
 	};
 	for (size_t rowIndex = 0; rowIndex < 3; rowIndex++)
 	{
-		for (size_t columnIndex = 0; columnIndex < 3; columnIndex++)
+		for (size_t columnIndex = 0; columnIndex < 3; columnIndex++)
+		{
+			double actual = _Matrix->getCell(adjugate, rowIndex, columnIndex);
+			cr_expect_eq(
+				expected[rowIndex][columnIndex],
+				actual,
+				"At (%lu,%lu), got %lf instead of %lf",
+				rowIndex, columnIndex, actual, expected[rowIndex][columnIndex]);
+		}
+	}
+
+	// teardown
+	_Matrix->delete(& adjugate);
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, cofactors_matrix_is_only_defined_for_square_matrix)
+{
+	// given
+	Matrix * this = _Matrix->create(2, 3);
+
+	// when
+	Matrix * cofactors = _Matrix->cofactors(this);
+
+	// then
+	cr_expect_null(cofactors, "Cofactors matrix is only defined for square matrix");
+
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, cofactors_matrix_is_only_defined_for_matrix_size_greater_than_1)
+{
+	// given
+	Matrix * this = _Matrix->create(1, 1);
+
+	// when
+	Matrix * cofactors = _Matrix->cofactors(this);
+
+	// then
+	cr_expect_null(cofactors, "Cofactors matrix is only defined for square matrix size greater than 1");
+
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, scalarProduct)
+{
+	// given
+	double rows[][2] = {
+		{ 1, 2 },
+		{ 4, 5 },
+	};
+	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+
+	// when
+	double scalar = 3;
+	Matrix * product = _Matrix->scalarProduct(this, scalar);
+
+	// then
+	for (size_t rowIndex = 0; rowIndex < 2; rowIndex++)
+	{
+		for (size_t columnIndex = 0; columnIndex < 2; columnIndex++)
+		{
+			cr_expect_eq(
+				scalar * rows[rowIndex][columnIndex],
+				_Matrix->getCell(product, rowIndex, columnIndex),
+				"At (%lu,%lu), got %lf instead of %lf",
+				rowIndex, columnIndex,
+				_Matrix->getCell(product, rowIndex, columnIndex), scalar * rows[rowIndex][columnIndex]);
+		}
+	}
+}
+
+
+Test(Matrix, hadamard_requires_equal_sizes)
+{
+	// given
+	Matrix * left = _Matrix->create(2, 3);
+	Matrix * right = _Matrix->create(3, 2);
+
+	// when
+	Matrix * hadamard = _Matrix->hadamard(left, right);
+
+	// then
+	cr_expect_null(hadamard);
+
+	// teardown
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+}
+
+
+Test(Matrix, hadamard_and_clamp)
+{
+	// given
+	Matrix * left = _Matrix->fromRows(2, 3,
+		(double[]) { 1, -2, 3 },
+		(double[]) { 4, 5, -6 });
+	Matrix * right = _Matrix->fromRows(2, 3,
+		(double[]) { 2, 2, 2 },
+		(double[]) { -1, 0, 1 });
+	Matrix * expected = _Matrix->fromRows(2, 3,
+		(double[]) { 2, -3, 3 },
+		(double[]) { -3, 0, -3 });
+
+	// when
+	Matrix * hadamard = _Matrix->hadamard(left, right);
+	Matrix * clamped = _Matrix->clamp(hadamard, -3, 3);
+	Matrix * reversed = _Matrix->clamp(hadamard, 3, -3);
+
+	// then
+	expect_same_cells(clamped, expected);
+	cr_expect_eq(-4, _Matrix->getCell(hadamard, 0, 1));
+	cr_expect_null(reversed, "Bounds are reversed");
+
+	// teardown
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& hadamard);
+	_Matrix->delete(& clamped);
+}
+
+
+static void affine(double const * cells, double * results, size_t count, void * context)
+{
+	size_t * chunks = context;
+
+	chunks[0]++;
+	for (size_t index = 0; index < count; index++)
+		results[index] = 2 * cells[index] + 1;
+}
+
+
+static void difference(double const * left, double const * right, double * results, size_t count, void * context)
+{
+	(void) context;
+
+	for (size_t index = 0; index < count; index++)
+		results[index] = left[index] - right[index];
+}
+
+
+static double sumOfAbsolutes(double accumulator, double const * cells, size_t count, void * context)
+{
+	size_t * chunks = context;
+
+	chunks[0]++;
+	for (size_t index = 0; index < count; index++)
+		accumulator += fabs(cells[index]);
+
+	return accumulator;
+}
+
+
+Test(Matrix, map_zip_reduce_process_chunks)
+{
+	// given
+	Matrix * padded = integers(3, 5, 1);
+	Matrix * contiguous = integers(2, MATRIX_DEFAULT_ALIGNMENT / sizeof(double), 2);
+	size_t paddedChunks = 0;
+	size_t contiguousChunks = 0;
+	size_t reducedChunks = 0;
+
+	// when
+	Matrix * mapped = _Matrix->map(padded, affine, & paddedChunks);
+	Matrix * whole = _Matrix->map(contiguous, affine, & contiguousChunks);
+	Matrix * zipped = _Matrix->zip(mapped, padded, difference, NULL);
+	double reduced = _Matrix->reduce(padded, sumOfAbsolutes, 1, & reducedChunks);
+
+	// then
+	cr_expect_eq(3, paddedChunks, "Padded rows are handed one at a time");
+	cr_expect_eq(1, contiguousChunks, "Rows filling the alignment are handed at once");
+	cr_expect_eq(3, reducedChunks);
+	double expected = 1;
+	for (size_t ordinate = 0; ordinate < 3; ordinate++)
+	{
+		for (size_t abscissa = 0; abscissa < 5; abscissa++)
+		{
+			double cell = _Matrix->getCell(padded, ordinate, abscissa);
+			cr_expect_eq(2 * cell + 1, _Matrix->getCell(mapped, ordinate, abscissa));
+			cr_expect_eq(cell + 1, _Matrix->getCell(zipped, ordinate, abscissa));
+			expected += fabs(cell);
+		}
+	}
+	cr_expect_eq(expected, reduced);
+	cr_expect_eq(2 * _Matrix->getCell(contiguous, 1, 7) + 1, _Matrix->getCell(whole, 1, 7));
+
+	// teardown
+	_Matrix->delete(& padded);
+	_Matrix->delete(& contiguous);
+	_Matrix->delete(& mapped);
+	_Matrix->delete(& whole);
+	_Matrix->delete(& zipped);
+}
+
+
+Test(Matrix, reductions)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(2, 3,
+		(double[]) { 1, -2, 3 },
+		(double[]) { 4, 5, -6 });
+	Matrix * huge = _Matrix->scalarProduct(this, 1e200);
+
+	// when
+	double minimum = _Matrix->minimum(this);
+	double maximum = _Matrix->maximum(this);
+	double total = _Matrix->total(this);
+	double norm = _Matrix->frobeniusNorm(this);
+	double hugeNorm = _Matrix->frobeniusNorm(huge);
+
+	// then
+	cr_expect_eq(-6, minimum);
+	cr_expect_eq(5, maximum);
+	cr_expect_eq(5, total);
+	cr_expect_float_eq(sqrt(91), norm, 1e-15);
+	cr_expect_float_eq(sqrt(91) * 1e200, hugeNorm, 1e186, "Squares of the cells would overflow");
+	cr_expect_eq(NO_VALUE, _Matrix->total(NULL));
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& huge);
+}
+
+
+Test(Matrix, kronecker)
+{
+	// given
+	Matrix * left = _Matrix->fromRows(2, 2,
+		(double[]) { 1, 2 },
+		(double[]) { 3, 0 });
+	Matrix * right = _Matrix->fromRows(2, 3,
+		(double[]) { 0, 5, 1 },
+		(double[]) { 6, 7, 1 });
+	Matrix * expected = _Matrix->fromRows(4, 6,
+		(double[]) { 0, 5, 1, 0, 10, 2 },
+		(double[]) { 6, 7, 1, 12, 14, 2 },
+		(double[]) { 0, 15, 3, 0, 0, 0 },
+		(double[]) { 18, 21, 3, 0, 0, 0 });
+
+	// when
+	Matrix * kronecker = _Matrix->kronecker(left, right);
+
+	// then
+	expect_same_cells(kronecker, expected);
+
+	// teardown
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& kronecker);
+}
+
+
+Test(Matrix, concat_requires_matching_sizes)
+{
+	// given
+	Matrix * wide = _Matrix->create(2, 3);
+	Matrix * tall = _Matrix->create(3, 2);
+
+	// when
+	Matrix * side = _Matrix->hconcat(wide, tall);
+	Matrix * stacked = _Matrix->vconcat(wide, tall);
+	Matrix * transposed = _Matrix->transpose(wide);
+	Matrix * both = _Matrix->hconcat(tall, transposed);
+
+	// then
+	cr_expect_null(side, "Heights differ");
+	cr_expect_null(stacked, "Widths differ");
+	cr_expect_null(_Matrix->vconcat(wide, NULL));
+	cr_assert_not_null(both);
+	cr_expect_eq(3, _Matrix->height(both));
+	cr_expect_eq(4, _Matrix->width(both));
+
+	// teardown
+	_Matrix->delete(& wide);
+	_Matrix->delete(& tall);
+	_Matrix->delete(& transposed);
+	_Matrix->delete(& both);
+}
+
+
+Test(Matrix, blockAssemble_fills_missing_blocks_with_zeros)
+{
+	// given
+	Matrix * corner = _Matrix->fromRows(1, 1, (double[]) { 9 });
+	Matrix * row = _Matrix->fromRows(1, 2, (double[]) { 1, 2 });
+	Matrix * column = _Matrix->fromRows(2, 1, (double[]) { 3 }, (double[]) { 4 });
+	Matrix const * grid[] = {
+		corner, row,
+		column, NULL,
+	};
+	Matrix const * empty[] = {
+		corner, NULL,
+		column, NULL,
+	};
+	Matrix * expected = _Matrix->fromRows(3, 3,
+		(double[]) { 9, 1, 2 },
+		(double[]) { 3, 0, 0 },
+		(double[]) { 4, 0, 0 });
+
+	// when
+	Matrix * assembled = _Matrix->blockAssemble(2, 2, grid);
+	Matrix * unsized = _Matrix->blockAssemble(2, 2, empty);
+	Matrix * mismatched = _Matrix->blockAssemble(1, 2, (Matrix const *[]) { column, row });
+
+	// then
+	expect_same_cells(assembled, expected);
+	cr_expect_null(unsized, "The second grid column has no width");
+	cr_expect_null(mismatched, "Heights differ in the grid row");
+
+	// teardown
+	_Matrix->delete(& corner);
+	_Matrix->delete(& row);
+	_Matrix->delete(& column);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& assembled);
+}
+
+
+Test(Matrix, isInvertible_false_if_not_square)
+{
+	// given
+	Matrix * this = _Matrix->create(1, 2);
+
+	// when
+	int invertible = _Matrix->isInvertible(this);
+
+	// then
+	cr_expect_not(invertible, "Matrix can only be inverted if it's square");
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, isInvertible_if_determinant_is_not_zero)
+{
+	// given
+	double rows[][2] = {
+		{ 0, 0 },
+		{ 0, 0 },
+	};
+	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+
+	// when
+	int invertible = _Matrix->isInvertible(this);
+
+	// then
+	cr_expect_not(invertible, "Matrix can only be inverted if it's square");
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, inverse_NULL_if_not_invertible)
+{
+	// given
+	double rows[2][2] = {
+		{ 0, 0 },
+		{ 0, 0 },
+	};
+	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+
+	// when
+	Matrix * inverse = _Matrix->inverse(this);
+
+	// then
+	cr_expect_null(inverse, "Matrix can only be inverted if it's square");
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, inverse_multiplied_by_matrix_gives_identity)
+{
+	// given
+	double rows[2][2] = {
+		{ 2, 3 },
+		{ 5, 7 },
+	};
+	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+
+	// when
+	Matrix * inverse = _Matrix->inverse(this);
+
+	// then
+	Matrix * product = _Matrix->product(this, inverse);
+	cr_expect(
+		_Matrix->isIdentity(product),
+		"Matrix multiplied by its inverse should be equal to the identity");
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& product);
+}
+
+
+Test(Matrix, inverse)
+{
+	// given
+	double rows[2][2] = {
+			{ 2, 3 },
+			{ 5, 7 },
+	};
+	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+
+	// when
+	Matrix * inverse = _Matrix->inverse(this);
+
+	// then
+	Matrix * product = _Matrix->product(inverse, this);
+	cr_expect(
+		_Matrix->isIdentity(product),
+		"Matrix and its inverse do not commute");
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& product);
+}
+
+/**
+ * Builds a well conditioned n*n matrix, integers() shifted along the diagonal
+ */
+static Matrix * diagonallyDominant(size_t size, int seed)
+{
+	Matrix * cells = integers(size, size, seed);
+	Matrix * identity = _Matrix->identity(size);
+	Matrix * shift = _Matrix->scalarProduct(identity, 3.0 * size);
+	Matrix * result = _Matrix->sum(cells, shift);
+
+	_Matrix->delete(& cells);
+	_Matrix->delete(& identity);
+	_Matrix->delete(& shift);
+
+	return result;
+}
+
+
+Test(Matrix, determinant_factored_matches_cofactors)
+{
+	// given
+	Matrix * this = diagonallyDominant(6, 1);
+	_Matrix->tuneLU(0);
+	double expected = _Matrix->determinant(this);
+	_Matrix->tuneLU(LU_DEFAULT_THRESHOLD);
+
+	// when
+	double determinant = _Matrix->determinant(this);
+
+	// then
+	cr_expect_float_eq(expected, determinant, 1e-9 * fabs(expected));
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, isInvertible_false_for_factored_singular_matrix)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(7, 7,
+		(double[]) { 1, 2, 3, 4, 5, 6, 7 },
+		(double[]) { 0, 1, 0, 2, 0, 3, 0 },
+		(double[]) { 9, 1, 8, 2, 7, 3, 6 },
+		(double[]) { 1, 2, 3, 4, 5, 6, 7 },
+		(double[]) { 4, 4, 0, 1, 1, 5, 2 },
+		(double[]) { 2, 0, 3, 0, 4, 0, 5 },
+		(double[]) { 7, 5, 3, 1, 2, 4, 6 });
+
+	// when
+	int invertible = _Matrix->isInvertible(this);
+	Matrix * inverse = _Matrix->inverse(this);
+
+	// then
+	cr_expect_not(invertible, "Rows 0 and 3 are equal");
+	cr_expect_null(inverse);
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, column_major_matrices_invert_like_row_major_ones)
+{
+	// given
+	Matrix * this = diagonallyDominant(30, 4);
+	Matrix * columnMajor = _Matrix->toLayout(this, MATRIX_COLUMN_MAJOR);
+	Matrix * expected = _Matrix->inverse(this);
+
+	// when
+	Matrix * inverse = _Matrix->inverse(columnMajor);
+	Matrix * identity = _Matrix->product(columnMajor, inverse);
+	double determinant = _Matrix->determinant(columnMajor);
+	double one = _Matrix->norm(columnMajor, MATRIX_NORM_ONE);
+	double infinity = _Matrix->norm(columnMajor, MATRIX_NORM_INFINITY);
+	double rcond = _Matrix->rcond(columnMajor);
+
+	// then
+	cr_assert_not_null(inverse);
+	for (size_t ordinate = 0; ordinate < 30; ordinate++)
+	{
+		for (size_t abscissa = 0; abscissa < 30; abscissa++)
 		{
-			double actual = _Matrix->getCell(adjugate, rowIndex, columnIndex);
-			cr_expect_eq(
-				expected[rowIndex][columnIndex],
-				actual,
-				"At (%lu,%lu), got %lf instead of %lf",
-				rowIndex, columnIndex, actual, expected[rowIndex][columnIndex]);
+			cr_expect_float_eq(_Matrix->getCell(expected, ordinate, abscissa), _Matrix->getCell(inverse, ordinate, abscissa), 1e-12);
+			cr_expect_float_eq(ordinate == abscissa, _Matrix->getCell(identity, ordinate, abscissa), 1e-12);
 		}
 	}
+	cr_expect_float_eq(_Matrix->determinant(this), determinant, 1e-9 * fabs(determinant));
+	cr_expect_eq(_Matrix->norm(this, MATRIX_NORM_ONE), one);
+	cr_expect_eq(_Matrix->norm(this, MATRIX_NORM_INFINITY), infinity);
+	cr_expect_float_eq(_Matrix->rcond(this), rcond, 1e-12);
 
 	// teardown
-	_Matrix->delete(& adjugate);
 	_Matrix->delete(& this);
+	_Matrix->delete(& columnMajor);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& inverse);
+	_Matrix->delete(& identity);
 }
 
 
-Test(Matrix, cofactors_matrix_is_only_defined_for_square_matrix)
+Test(Matrix, norms)
 {
 	// given
-	Matrix * this = _Matrix->create(2, 3);
+	Matrix * this = _Matrix->fromRows(2, 3,
+		(double[]) { 1, -7, 3 },
+		(double[]) { -4, 5, -6 });
 
 	// when
-	Matrix * cofactors = _Matrix->cofactors(this);
+	double one = _Matrix->norm(this, MATRIX_NORM_ONE);
+	double infinity = _Matrix->norm(this, MATRIX_NORM_INFINITY);
+	double frobenius = _Matrix->norm(this, MATRIX_NORM_FROBENIUS);
+	double max = _Matrix->norm(this, MATRIX_NORM_MAX);
 
 	// then
-	cr_expect_null(cofactors, "Cofactors matrix is only defined for square matrix");
+	cr_expect_eq(12, one);
+	cr_expect_eq(15, infinity);
+	cr_expect_float_eq(sqrt(136), frobenius, 1e-14);
+	cr_expect_eq(7, max);
 
+	// teardown
 	_Matrix->delete(& this);
 }
 
 
-Test(Matrix, cofactors_matrix_is_only_defined_for_matrix_size_greater_than_1)
+Test(Matrix, rcond_bounds_exact_condition)
 {
 	// given
-	Matrix * this = _Matrix->create(1, 1);
+	Matrix * this = integers(40, 40, 5);
+	Matrix * identity = _Matrix->identity(40);
+	Matrix * shift = _Matrix->scalarProduct(identity, 0.5);
+	Matrix * shifted = _Matrix->sum(this, shift);
+	Matrix * inverse = _Matrix->inverse(shifted);
+	Matrix * wide = _Matrix->create(2, 3);
+	double exact = 1 / (_Matrix->norm(shifted, MATRIX_NORM_ONE) * _Matrix->norm(inverse, MATRIX_NORM_ONE));
 
 	// when
-	Matrix * cofactors = _Matrix->cofactors(this);
+	double estimate = _Matrix->rcond(shifted);
+	double perfect = _Matrix->rcond(identity);
+	double notSquare = _Matrix->rcond(wide);
 
 	// then
-	cr_expect_null(cofactors, "Cofactors matrix is only defined for square matrix size greater than 1");
+	cr_expect_geq(estimate, exact * (1 - 1e-12), "||A^(-1)||1 is estimated from below");
+	cr_expect_leq(estimate, 3 * exact);
+	cr_expect_float_eq(1, perfect, 1e-15);
+	cr_expect_eq(MATRIX_IS_NOT_SQUARE, notSquare);
 
+	// teardown
 	_Matrix->delete(& this);
+	_Matrix->delete(& identity);
+	_Matrix->delete(& shift);
+	_Matrix->delete(& shifted);
+	_Matrix->delete(& inverse);
+	_Matrix->delete(& wide);
 }
 
 
-Test(Matrix, scalarProduct)
+Test(Matrix, isWellConditioned_rejects_ill_conditioned_matrix)
 {
 	// given
-	double rows[][2] = {
-		{ 1, 2 },
-		{ 4, 5 },
-	};
-	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+	Matrix * this = _Matrix->fromRows(6, 6,
+		(double[]) { 1, 0, 0, 0, 0, 0 },
+		(double[]) { 0, 1, 0, 0, 0, 0 },
+		(double[]) { 0, 0, 1, 0, 0, 0 },
+		(double[]) { 0, 0, 0, 1, 0, 0 },
+		(double[]) { 0, 0, 0, 0, 1, 1 },
+		(double[]) { 0, 0, 0, 0, 1, 1 + 1e-10 });
 
 	// when
-	double scalar = 3;
-	Matrix * product = _Matrix->scalarProduct(this, scalar);
+	double estimate = _Matrix->rcond(this);
+	int exact = _Matrix->isInvertible(this);
+	int loose = _Matrix->isWellConditioned(this, 1e-14);
+	int strict = _Matrix->isWellConditioned(this, 1e-8);
 
 	// then
-	for (size_t rowIndex = 0; rowIndex < 2; rowIndex++)
+	cr_expect_lt(estimate, 1e-9);
+	cr_expect(exact, "The determinant isn't exactly 0");
+	cr_expect(loose);
+	cr_expect_not(strict, "About 10 digits would be lost");
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(Matrix, svd_reconstructs_tall_and_wide_matrices)
+{
+	// given
+	Matrix * tall = _Matrix->fromRows(5, 3,
+		(double[]) { 4, 1, -2 },
+		(double[]) { 1, 3, 0 },
+		(double[]) { -2, 0, 5 },
+		(double[]) { 1, -1, 2 },
+		(double[]) { 0, 2, 1 });
+	Matrix * wide = _Matrix->transpose(tall);
+	Matrix * left;
+	Matrix * right;
+	Matrix * fullLeft;
+	Matrix * fullRight;
+
+	// when
+	Matrix * values = _Matrix->svd(tall, 0, & left, & right);
+	Matrix * wideValues = _Matrix->svd(wide, 1, & fullLeft, & fullRight);
+
+	// then
+	cr_assert_not_null(values);
+	cr_assert_not_null(wideValues);
+	cr_assert_eq(3, _Matrix->height(values));
+	cr_assert_eq(5, _Matrix->height(left));
+	cr_assert_eq(3, _Matrix->width(left));
+	cr_assert_eq(3, _Matrix->height(right));
+	cr_assert_eq(3, _Matrix->height(fullLeft));
+	cr_assert_eq(5, _Matrix->width(fullRight));
+	for (size_t index = 0; index < 3; index++)
 	{
-		for (size_t columnIndex = 0; columnIndex < 2; columnIndex++)
+		cr_expect_float_eq(_Matrix->getCell(values, index, 0), _Matrix->getCell(wideValues, index, 0), 1e-12);
+		if (index > 0)
+			cr_expect_geq(_Matrix->getCell(values, index - 1, 0), _Matrix->getCell(values, index, 0));
+	}
+	for (size_t row = 0; row < 5; row++)
+	{
+		for (size_t column = 0; column < 3; column++)
 		{
-			cr_expect_eq(
-				scalar * rows[rowIndex][columnIndex],
-				_Matrix->getCell(product, rowIndex, columnIndex),
-				"At (%lu,%lu), got %lf instead of %lf",
-				rowIndex, columnIndex,
-				_Matrix->getCell(product, rowIndex, columnIndex), scalar * rows[rowIndex][columnIndex]);
+			double thin = 0;
+			double full = 0;
+			for (size_t index = 0; index < 3; index++)
+			{
+				thin += _Matrix->getCell(left, row, index) * _Matrix->getCell(values, index, 0) * _Matrix->getCell(right, column, index);
+				full += _Matrix->getCell(fullLeft, column, index) * _Matrix->getCell(values, index, 0) * _Matrix->getCell(fullRight, row, index);
+			}
+			cr_expect_float_eq(_Matrix->getCell(tall, row, column), thin, 1e-12);
+			cr_expect_float_eq(_Matrix->getCell(tall, row, column), full, 1e-12);
 		}
 	}
+	Matrix * gram = _Matrix->create(5, 5);
+	_Matrix->gemm(1, fullRight, 1, fullRight, 0, 0, gram);
+	for (size_t row = 0; row < 5; row++)
+		for (size_t column = 0; column < 5; column++)
+			cr_expect_float_eq((row == column) ? 1 : 0, _Matrix->getCell(gram, row, column), 1e-12, "V of the full decomposition is orthogonal");
+	cr_expect_null(_Matrix->svd(NULL, 0, & left, NULL));
+
+	// teardown
+	_Matrix->delete(& tall);
+	_Matrix->delete(& wide);
+	_Matrix->delete(& values);
+	_Matrix->delete(& wideValues);
+	_Matrix->delete(& right);
+	_Matrix->delete(& fullLeft);
+	_Matrix->delete(& fullRight);
+	_Matrix->delete(& gram);
 }
 
 
-Test(Matrix, isInvertible_false_if_not_square)
+Test(Matrix, svd_of_rank_deficient_matrix_does_not_depend_on_threads)
 {
 	// given
-	Matrix * this = _Matrix->create(1, 2);
+	Matrix * this = integers(256, 128, 4);
+	Matrix * sequentialLeft;
+	Matrix * parallelLeft;
 
 	// when
-	int invertible = _Matrix->isInvertible(this);
+	_Matrix->setThreads(1);
+	Matrix * sequential = _Matrix->svd(this, 0, & sequentialLeft, NULL);
+	_Matrix->setThreads(4);
+	Matrix * parallel = _Matrix->svd(this, 0, & parallelLeft, NULL);
+	_Matrix->setThreads(1);
 
 	// then
-	cr_expect_not(invertible, "Matrix can only be inverted if it's square");
+	cr_assert_not_null(sequential);
+	cr_assert_not_null(parallel);
+	expect_same_cells(parallel, sequential);
+	expect_same_cells(parallelLeft, sequentialLeft);
+	cr_expect_gt(_Matrix->getCell(sequential, 2, 0), 1, "A sum of 3 outer products has rank 3");
+	cr_expect_float_eq(0, _Matrix->getCell(sequential, 3, 0), 1e-9);
+	Matrix * gram = _Matrix->create(128, 128);
+	_Matrix->gemm(1, sequentialLeft, 1, sequentialLeft, 0, 0, gram);
+	for (size_t row = 0; row < 128; row++)
+		for (size_t column = 0; column < 128; column++)
+			cr_expect_float_eq((row == column) ? 1 : 0, _Matrix->getCell(gram, row, column), 1e-12, "Columns of zero singular values are completed");
 
 	// teardown
 	_Matrix->delete(& this);
+	_Matrix->delete(& sequential);
+	_Matrix->delete(& parallel);
+	_Matrix->delete(& sequentialLeft);
+	_Matrix->delete(& parallelLeft);
+	_Matrix->delete(& gram);
 }
 
 
-Test(Matrix, isInvertible_if_determinant_is_not_zero)
+Test(Matrix, pinv_and_lowRank_of_rank_deficient_matrices)
 {
 	// given
-	double rows[][2] = {
-		{ 0, 0 },
-		{ 0, 0 },
-	};
-	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+	Matrix * column = _Matrix->fromRows(3, 2,
+		(double[]) { 1, 2 },
+		(double[]) { 2, 4 },
+		(double[]) { 3, 6 });
+	Matrix * this = integers(6, 5, 2);
+	Matrix * values = _Matrix->svd(this, 0, NULL, NULL);
 
 	// when
-	int invertible = _Matrix->isInvertible(this);
+	Matrix * inverse = _Matrix->pinv(column, 0);
+	Matrix * rankTwo = _Matrix->lowRank(this, 2);
+	Matrix * rebuilt = _Matrix->lowRank(this, 10);
+	Matrix * none = _Matrix->lowRank(this, 0);
 
 	// then
-	cr_expect_not(invertible, "Matrix can only be inverted if it's square");
+	cr_assert_not_null(inverse);
+	cr_assert_eq(2, _Matrix->height(inverse));
+	cr_assert_eq(3, _Matrix->width(inverse));
+	for (size_t row = 0; row < 2; row++)
+		for (size_t index = 0; index < 3; index++)
+			cr_expect_float_eq(_Matrix->getCell(column, index, row) / 70, _Matrix->getCell(inverse, row, index), 1e-14, "A rank 1 A has A+ = ^t A / ||A||^2");
+
+	Matrix * negated = _Matrix->scalarProduct(rankTwo, -1);
+	Matrix * error = _Matrix->sum(this, negated);
+	cr_expect_float_eq(_Matrix->getCell(values, 2, 0), _Matrix->frobeniusNorm(error), 1e-10, "Eckart-Young");
+	for (size_t row = 0; row < 6; row++)
+	{
+		for (size_t index = 0; index < 5; index++)
+		{
+			cr_expect_float_eq(_Matrix->getCell(this, row, index), _Matrix->getCell(rebuilt, row, index), 1e-12);
+			cr_expect_eq(0, _Matrix->getCell(none, row, index));
+		}
+	}
 
 	// teardown
+	_Matrix->delete(& column);
 	_Matrix->delete(& this);
+	_Matrix->delete(& values);
+	_Matrix->delete(& inverse);
+	_Matrix->delete(& rankTwo);
+	_Matrix->delete(& rebuilt);
+	_Matrix->delete(& none);
+	_Matrix->delete(& negated);
+	_Matrix->delete(& error);
 }
 
 
-Test(Matrix, inverse_NULL_if_not_invertible)
+Test(Matrix, inverseRankUpdate_matches_inverse_of_updated_matrix)
 {
 	// given
-	double rows[2][2] = {
-		{ 0, 0 },
-		{ 0, 0 },
-	};
-	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+	Matrix * this = diagonallyDominant(8, 2);
+	Matrix * inverse = _Matrix->inverse(this);
+	Matrix * cells = integers(8, 2, 5);
+	Matrix * thin = _Matrix->scalarProduct(cells, 0.25);
+	Matrix * right = integers(8, 2, 3);
+	Matrix * wide = integers(8, 3, 1);
+	Matrix * update = _Matrix->create(8, 8);
+	_Matrix->gemm(1, thin, 0, right, 1, 0, update);
+	Matrix * updated = _Matrix->sum(this, update);
+	Matrix * expected = _Matrix->inverse(updated);
+	double determinant = _Matrix->determinant(this);
 
 	// when
-	Matrix * inverse = _Matrix->inverse(this);
+	double updatedDeterminant = _Matrix->determinantRankUpdate(inverse, determinant, thin, right);
+	int result = _Matrix->inverseRankUpdate(inverse, thin, right);
 
 	// then
-	cr_expect_null(inverse, "Matrix can only be inverted if it's square");
+	cr_assert_eq(1, result);
+	cr_expect_float_eq(_Matrix->determinant(updated), updatedDeterminant, 1e-12 * fabs(updatedDeterminant));
+	for (size_t row = 0; row < 8; row++)
+		for (size_t column = 0; column < 8; column++)
+			cr_expect_float_eq(_Matrix->getCell(expected, row, column), _Matrix->getCell(inverse, row, column), 1e-14);
+	cr_expect_eq(0, _Matrix->inverseRankUpdate(inverse, wide, right), "Sizes of U and V don't match");
+	cr_expect_eq(0, _Matrix->inverseRankUpdate(NULL, thin, right));
+	cr_expect_eq(NO_VALUE, _Matrix->determinantRankUpdate(inverse, NO_VALUE, thin, right));
 
 	// teardown
 	_Matrix->delete(& this);
+	_Matrix->delete(& inverse);
+	_Matrix->delete(& cells);
+	_Matrix->delete(& thin);
+	_Matrix->delete(& right);
+	_Matrix->delete(& wide);
+	_Matrix->delete(& update);
+	_Matrix->delete(& updated);
+	_Matrix->delete(& expected);
 }
 
 
-Test(Matrix, inverse_multiplied_by_matrix_gives_identity)
+Test(Matrix, inverseRankUpdate_refuses_singular_and_unsafe_updates)
 {
 	// given
-	double rows[2][2] = {
-		{ 2, 3 },
-		{ 5, 7 },
-	};
-	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+	Matrix * inverse = _Matrix->identity(3);
+	Matrix * left = _Matrix->fromColumns(3, 1, (double[]) { 1, 0, 0 });
+	Matrix * singular = _Matrix->fromColumns(3, 1, (double[]) { -1, 0, 0 });
+	Matrix * unsafe = _Matrix->fromColumns(3, 1, (double[]) { -1 + 1e-12, 0, 0 });
+	Matrix * safe = _Matrix->fromColumns(3, 1, (double[]) { 1, 2, 0 });
+	Matrix * expected = _Matrix->fromRows(3, 3,
+		(double[]) { 0.5, -1, 0 },
+		(double[]) { 0, 1, 0 },
+		(double[]) { 0, 0, 1 });
+
+	// when
+	double singularDeterminant = _Matrix->determinantRankUpdate(inverse, 1, left, singular);
+	int singularResult = _Matrix->inverseRankUpdate(inverse, left, singular);
+	int unsafeResult = _Matrix->inverseRankUpdate(inverse, left, unsafe);
+	int identityResult = _Matrix->isIdentity(inverse);
+	double safeDeterminant = _Matrix->determinantRankUpdate(inverse, 1, left, safe);
+	int safeResult = _Matrix->inverseRankUpdate(inverse, left, safe);
+
+	// then
+	cr_expect_eq(0, singularDeterminant, "Id - e1 ^t e1 is singular");
+	cr_expect_eq(0, singularResult);
+	cr_expect_eq(0, unsafeResult, "1 - (1 - 1e-12) cancels out");
+	cr_expect(identityResult, "A refused update leaves the inverse unchanged");
+	cr_expect_float_eq(2, safeDeterminant, 1e-15);
+	cr_expect_eq(1, safeResult);
+	for (size_t row = 0; row < 3; row++)
+		for (size_t column = 0; column < 3; column++)
+			cr_expect_float_eq(_Matrix->getCell(expected, row, column), _Matrix->getCell(inverse, row, column), 1e-15);
+
+	// teardown
+	_Matrix->delete(& inverse);
+	_Matrix->delete(& left);
+	_Matrix->delete(& singular);
+	_Matrix->delete(& unsafe);
+	_Matrix->delete(& safe);
+	_Matrix->delete(& expected);
+}
+
+
+Test(Matrix, inverse_factored_does_not_depend_on_threads)
+{
+	// given
+	size_t size = 200;
+	Matrix * this = diagonallyDominant(size, 3);
+	Matrix * expected = _Matrix->inverse(this);
+	_Matrix->setThreads(3);
 
 	// when
 	Matrix * inverse = _Matrix->inverse(this);
 
 	// then
+	expect_same_cells(inverse, expected);
 	Matrix * product = _Matrix->product(this, inverse);
-	cr_expect(
-		_Matrix->isIdentity(product),
-		"Matrix multiplied by its inverse should be equal to the identity");
+	for (size_t ordinate = 0; ordinate < size; ordinate++)
+		for (size_t abscissa = 0; abscissa < size; abscissa++)
+			cr_expect_float_eq(ordinate == abscissa, _Matrix->getCell(product, ordinate, abscissa), 1e-12);
 
 	// teardown
+	_Matrix->setThreads(1);
 	_Matrix->delete(& this);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& inverse);
 	_Matrix->delete(& product);
 }
 
 
-Test(Matrix, inverse)
+Test(Matrix, power_requires_square_matrix)
 {
 	// given
-	double rows[2][2] = {
-			{ 2, 3 },
-			{ 5, 7 },
-	};
-	Matrix * this = _Matrix->fromRows(2, 2, rows[0], rows[1]);
+	Matrix * this = _Matrix->create(2, 3);
 
 	// when
-	Matrix * inverse = _Matrix->inverse(this);
+	Matrix * power = _Matrix->power(this, 2);
 
 	// then
-	Matrix * product = _Matrix->product(inverse, this);
-	cr_expect(
-		_Matrix->isIdentity(product),
-		"Matrix and its inverse do not commute");
+	cr_expect_null(power, "Power is only defined for square matrix");
 
 	// teardown
 	_Matrix->delete(& this);
-	_Matrix->delete(& product);
 }
 
+
+Test(Matrix, power_zero_is_identity)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(2, 2, (double[]) { 2, 3 }, (double[]) { 5, 7 });
+
+	// when
+	Matrix * power = _Matrix->power(this, 0);
+
+	// then
+	cr_expect(_Matrix->isIdentity(power), "A^0 should be the identity");
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& power);
+}
+
+
+Test(Matrix, power_matches_repeated_products)
+{
+	// given
+	Matrix * this = integers(5, 5, 7);
+	Matrix * expected = _Matrix->copy(this);
+	for (int exponent = 1; exponent < 7; exponent++)
+	{
+		Matrix * next = _Matrix->product(expected, this);
+		_Matrix->delete(& expected);
+		expected = next;
+	}
+
+	// when
+	Matrix * power = _Matrix->power(this, 7);
+
+	// then
+	expect_same_cells(power, expected);
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& power);
+}
+
+
+Test(Matrix, power_on_strassen_and_parallel_paths_matches_repeated_products)
+{
+	// given
+	Matrix * this = integers(16, 16, 5);
+	Matrix * expected = _Matrix->copy(this);
+	for (int exponent = 1; exponent < 5; exponent++)
+	{
+		Matrix * next = _Matrix->product(expected, this);
+		_Matrix->delete(& expected);
+		expected = next;
+	}
+	_Matrix->tuneStrassen(4, 8);
+	_Matrix->setThreads(3);
+
+	// when
+	Matrix * strassen = _Matrix->power(this, 5);
+	_Matrix->tuneStrassen(STRASSEN_DEFAULT_CROSSOVER, 0);
+	Matrix * tiled = _Matrix->power(this, 5);
+
+	// then
+	expect_same_cells(strassen, expected);
+	expect_same_cells(tiled, expected);
+
+	// teardown
+	_Matrix->tuneStrassen(STRASSEN_DEFAULT_CROSSOVER, STRASSEN_DEFAULT_THRESHOLD);
+	_Matrix->setThreads(1);
+	_Matrix->delete(& this);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& strassen);
+	_Matrix->delete(& tiled);
+}
+
+
+Test(Matrix, exponential_of_zero_is_identity)
+{
+	// given
+	Matrix * this = _Matrix->create(3, 3);
+
+	// when
+	Matrix * exponential = _Matrix->exponential(this);
+
+	// then
+	cr_expect(_Matrix->isIdentity(exponential), "exp(0) should be the identity");
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& exponential);
+}
+
+
+Test(Matrix, exponential_of_diagonal_matrix)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(2, 2, (double[]) { 3, 0 }, (double[]) { 0, -1.5 });
+
+	// when
+	Matrix * exponential = _Matrix->exponential(this);
+
+	// then
+	cr_expect_float_eq(exp(3), _Matrix->getCell(exponential, 0, 0), 1e-12 * exp(3));
+	cr_expect_float_eq(0, _Matrix->getCell(exponential, 0, 1), 1e-12);
+	cr_expect_float_eq(0, _Matrix->getCell(exponential, 1, 0), 1e-12);
+	cr_expect_float_eq(exp(-1.5), _Matrix->getCell(exponential, 1, 1), 1e-12);
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& exponential);
+}
+
+
+Test(Matrix, exponential_of_rotation_generator)
+{
+	// given
+	double angle = 10;
+	Matrix * this = _Matrix->fromRows(2, 2, (double[]) { 0, -angle }, (double[]) { angle, 0 });
+
+	// when
+	Matrix * exponential = _Matrix->exponential(this);
+
+	// then
+	cr_expect_float_eq(cos(angle), _Matrix->getCell(exponential, 0, 0), 1e-12);
+	cr_expect_float_eq(-sin(angle), _Matrix->getCell(exponential, 0, 1), 1e-12);
+	cr_expect_float_eq(sin(angle), _Matrix->getCell(exponential, 1, 0), 1e-12);
+	cr_expect_float_eq(cos(angle), _Matrix->getCell(exponential, 1, 1), 1e-12);
+
+	// teardown
+	_Matrix->delete(& this);
+	_Matrix->delete(& exponential);
+}
+
+
+Test(Matrix, exponential_does_not_depend_on_product_path)
+{
+	// given
+	size_t size = 80;
+	Matrix * dominant = diagonallyDominant(size, 4);
+	Matrix * this = _Matrix->scalarProduct(dominant, 1.0 / size);
+	Matrix * expected = _Matrix->exponential(this);
+	_Matrix->tuneStrassen(8, 16);
+	_Matrix->setThreads(3);
+
+	// when
+	Matrix * exponential = _Matrix->exponential(this);
+
+	// then
+	cr_assert_not_null(exponential);
+	for (size_t ordinate = 0; ordinate < size; ordinate++)
+		for (size_t abscissa = 0; abscissa < size; abscissa++)
+		{
+			double value = _Matrix->getCell(expected, ordinate, abscissa);
+			cr_expect_float_eq(value, _Matrix->getCell(exponential, ordinate, abscissa), 1e-9 * (1 + fabs(value)));
+		}
+
+	// teardown
+	_Matrix->tuneStrassen(STRASSEN_DEFAULT_CROSSOVER, STRASSEN_DEFAULT_THRESHOLD);
+	_Matrix->setThreads(1);
+	_Matrix->delete(& dominant);
+	_Matrix->delete(& this);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& exponential);
+}
+
+
 Test(Matrix, isIdentity_false_is_not_square)
 {
 	// given
@@ -0,0 +1,198 @@
+#include "../../src/Matrix.h"
+#include "../../src/MatrixAsync.h"
+#include "../../src/Vector.h"
+
+#include <criterion/criterion.h>
+
+
+
+
+typedef struct
+{
+	int calls;
+	MatrixAsyncStatus status;
+	Matrix * result;
+} Completion;
+
+
+static void complete(MatrixHandle * handle, void * context)
+{
+	Completion * completion = context;
+
+	completion->calls++;
+	completion->status = _MatrixAsync->status(handle);
+	completion->result = _MatrixAsync->takeMatrix(handle);
+}
+
+
+
+
+Test(MatrixAsync, productAsync_reports_invalid_operands_through_handle)
+{
+	// given
+	Matrix * left = _Matrix->create(2, 3);
+	Matrix * right = _Matrix->create(2, 2);
+
+	// when
+	MatrixHandle * missing = _MatrixAsync->productAsync(left, NULL);
+	MatrixHandle * mismatched = _MatrixAsync->productAsync(left, right);
+
+	// then
+	cr_assert_not_null(missing);
+	cr_assert_not_null(mismatched);
+	cr_expect(_MatrixAsync->poll(missing), "Rejected operations are over at once");
+	cr_expect_eq(MATRIX_ASYNC_INVALID_ARGUMENT, _MatrixAsync->wait(missing));
+	cr_expect_eq(MATRIX_ASYNC_SIZE_MISMATCH, _MatrixAsync->wait(mismatched));
+	cr_expect_null(_MatrixAsync->takeMatrix(mismatched));
+
+	// teardown
+	_MatrixAsync->delete(& missing);
+	_MatrixAsync->delete(& mismatched);
+	cr_expect_null(missing);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+}
+
+
+Test(MatrixAsync, productAsync_matches_product)
+{
+	// given
+	Matrix * left = _Matrix->fromRows(2, 3,
+		(double[]) { 1, 2, 3 },
+		(double[]) { 4, 5, 6 });
+	Matrix * right = _Matrix->fromRows(3, 2,
+		(double[]) { 7, 8 },
+		(double[]) { 9, 10 },
+		(double[]) { 11, 12 });
+	Matrix * expected = _Matrix->product(left, right);
+
+	// when
+	MatrixHandle * handle = _MatrixAsync->productAsync(left, right);
+
+	// then
+	cr_assert_eq(MATRIX_ASYNC_DONE, _MatrixAsync->wait(handle));
+	cr_expect(_MatrixAsync->poll(handle));
+	cr_expect_null(_MatrixAsync->takeVector(handle), "Products give matrices");
+	Matrix * product = _MatrixAsync->takeMatrix(handle);
+	cr_assert_not_null(product);
+	cr_expect_null(_MatrixAsync->takeMatrix(handle), "The result is taken once");
+	for (size_t ordinate = 0; ordinate < 2; ordinate++)
+		for (size_t abscissa = 0; abscissa < 2; abscissa++)
+			cr_expect_eq(_Matrix->getCell(expected, ordinate, abscissa), _Matrix->getCell(product, ordinate, abscissa));
+
+	// teardown
+	_MatrixAsync->delete(& handle);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& product);
+}
+
+
+Test(MatrixAsync, inverseAsync_reports_singular_matrix)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(2, 2,
+		(double[]) { 1, 2 },
+		(double[]) { 2, 4 });
+	Completion completion = { 0, MATRIX_ASYNC_PENDING, NULL };
+
+	// when
+	MatrixHandle * handle = _MatrixAsync->inverseAsync(this);
+	_MatrixAsync->onCompletion(handle, complete, & completion);
+	MatrixAsyncStatus status = _MatrixAsync->wait(handle);
+
+	// then
+	cr_expect_eq(MATRIX_ASYNC_SINGULAR, status);
+	cr_expect_eq(1, completion.calls, "wait returns once the callback did");
+	cr_expect_eq(MATRIX_ASYNC_SINGULAR, completion.status);
+	cr_expect_null(completion.result);
+
+	// teardown
+	_MatrixAsync->delete(& handle);
+	_Matrix->delete(& this);
+}
+
+
+Test(MatrixAsync, onCompletion_after_completion_calls_back_at_once)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(2, 2,
+		(double[]) { 2, 0 },
+		(double[]) { 0, 4 });
+	Completion completion = { 0, MATRIX_ASYNC_PENDING, NULL };
+	MatrixHandle * handle = _MatrixAsync->inverseAsync(this);
+	_MatrixAsync->wait(handle);
+
+	// when
+	int registered = _MatrixAsync->onCompletion(handle, complete, & completion);
+
+	// then
+	cr_expect(registered);
+	cr_expect_eq(1, completion.calls);
+	cr_expect_eq(MATRIX_ASYNC_DONE, completion.status);
+	cr_assert_not_null(completion.result);
+	cr_expect_eq(0.5, _Matrix->getCell(completion.result, 0, 0));
+	cr_expect_eq(0.25, _Matrix->getCell(completion.result, 1, 1));
+
+	// teardown
+	_MatrixAsync->delete(& handle);
+	_Matrix->delete(& this);
+	_Matrix->delete(& completion.result);
+}
+
+
+Test(MatrixAsync, solveAsync_solves_system)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(3, 3,
+		(double[]) { 4, 1, 0 },
+		(double[]) { 1, 3, 1 },
+		(double[]) { 0, 1, 2 });
+	Vector * rightHand = _Vector->fromArray(3, (double[]) { 5, 5, 3 });
+	Vector * shorter = _Vector->fromArray(2, (double[]) { 5, 5 });
+
+	// when
+	MatrixHandle * handle = _MatrixAsync->solveAsync(this, rightHand);
+	MatrixHandle * mismatched = _MatrixAsync->solveAsync(this, shorter);
+
+	// then
+	cr_assert_eq(MATRIX_ASYNC_DONE, _MatrixAsync->wait(handle));
+	cr_expect_eq(MATRIX_ASYNC_SIZE_MISMATCH, _MatrixAsync->wait(mismatched));
+	Vector * solution = _MatrixAsync->takeVector(handle);
+	cr_assert_not_null(solution);
+	for (size_t index = 0; index < 3; index++)
+		cr_expect_float_eq(1, _Vector->getCell(solution, index), 1e-12);
+
+	// teardown
+	_MatrixAsync->delete(& handle);
+	_MatrixAsync->delete(& mismatched);
+	_Matrix->delete(& this);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& shorter);
+	_Vector->delete(& solution);
+}
+
+
+Test(MatrixAsync, solveAsync_reports_singular_matrix)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(3, 3,
+		(double[]) { 2, 1, 0 },
+		(double[]) { 1, 3, 1 },
+		(double[]) { 4, 2, 0 });
+	Vector * rightHand = _Vector->fromArray(3, (double[]) { 1, 1, 1 });
+
+	// when
+	MatrixHandle * handle = _MatrixAsync->solveAsync(this, rightHand);
+	MatrixAsyncStatus status = _MatrixAsync->wait(handle);
+
+	// then
+	cr_expect_eq(MATRIX_ASYNC_SINGULAR, status);
+	cr_expect_null(_MatrixAsync->takeVector(handle));
+
+	// teardown
+	_MatrixAsync->delete(& handle);
+	_Matrix->delete(& this);
+	_Vector->delete(& rightHand);
+}
@@ -0,0 +1,218 @@
+#include "../../src/Matrix.h"
+#include "../../src/MatrixExpression.h"
+
+#include <criterion/criterion.h>
+
+
+
+
+static void expect_cells(Matrix const * actual, Matrix const * expected)
+{
+	cr_assert_not_null(actual);
+	cr_assert_eq(_Matrix->height(expected), _Matrix->height(actual), "Incorrect height");
+	cr_assert_eq(_Matrix->width(expected), _Matrix->width(actual), "Incorrect width");
+
+	for (size_t ordinate = 0; ordinate < _Matrix->height(expected); ordinate++)
+	{
+		for (size_t abscissa = 0; abscissa < _Matrix->width(expected); abscissa++)
+		{
+			double actualValue = _Matrix->getCell(actual, ordinate, abscissa);
+			double expectedValue = _Matrix->getCell(expected, ordinate, abscissa);
+			cr_expect_eq(
+				expectedValue, actualValue,
+				"Incorrect cell at (%zu,%zu), got %lf instead of %lf",
+				ordinate, abscissa, actualValue, expectedValue);
+		}
+	}
+}
+
+
+Test(MatrixExpression, sum_requires_equal_sizes)
+{
+	// given
+	Matrix * left = _Matrix->create(2, 3);
+	Matrix * right = _Matrix->create(3, 2);
+
+	// when
+	MatrixExpression * sum = _MatrixExpression->sum(
+		_MatrixExpression->leaf(left),
+		_MatrixExpression->leaf(right));
+
+	// then
+	cr_expect_null(sum, "Adding expressions should not be possible from different sizes");
+
+	// teardown
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+}
+
+
+Test(MatrixExpression, product_requires_left_width_equal_to_right_height)
+{
+	// given
+	Matrix * left = _Matrix->create(2, 3);
+	Matrix * right = _Matrix->create(2, 3);
+
+	// when
+	MatrixExpression * product = _MatrixExpression->product(
+		_MatrixExpression->leaf(left),
+		_MatrixExpression->leaf(right));
+
+	// then
+	cr_expect_null(product, "Multiplying expressions should fail on invalid operands size");
+
+	// teardown
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+}
+
+
+Test(MatrixExpression, transpose_has_inverse_dimensions)
+{
+	// given
+	Matrix * this = _Matrix->create(2, 3);
+
+	// when
+	MatrixExpression * transpose = _MatrixExpression->transpose(_MatrixExpression->leaf(this));
+
+	// then
+	cr_expect_eq(3, _MatrixExpression->height(transpose));
+	cr_expect_eq(2, _MatrixExpression->width(transpose));
+
+	// teardown
+	_MatrixExpression->delete(& transpose);
+	_Matrix->delete(& this);
+}
+
+
+Test(MatrixExpression, evaluate_matches_eager_operations)
+{
+	// given
+	Matrix * a = _Matrix->fromRows(2, 2, (double[]) { 1, 2 }, (double[]) { 3, 4 });
+	Matrix * b = _Matrix->fromRows(2, 3, (double[]) { 5, 6, 7 }, (double[]) { 8, 9, 10 });
+	Matrix * c = _Matrix->fromRows(3, 2, (double[]) { 1, 0 }, (double[]) { 2, 1 }, (double[]) { 0, 3 });
+	MatrixExpression * expression = _MatrixExpression->sum(
+		_MatrixExpression->scalarProduct(_MatrixExpression->leaf(a), 2),
+		_MatrixExpression->scalarProduct(
+			_MatrixExpression->product(_MatrixExpression->leaf(b), _MatrixExpression->leaf(c)),
+			-0.5));
+
+	// when
+	Matrix * actual = _MatrixExpression->evaluate(expression);
+
+	// then
+	Matrix * scaledA = _Matrix->scalarProduct(a, 2);
+	Matrix * bc = _Matrix->product(b, c);
+	Matrix * scaledBc = _Matrix->scalarProduct(bc, -0.5);
+	Matrix * expected = _Matrix->sum(scaledA, scaledBc);
+	expect_cells(actual, expected);
+
+	// teardown
+	_MatrixExpression->delete(& expression);
+	_Matrix->delete(& a);
+	_Matrix->delete(& b);
+	_Matrix->delete(& c);
+	_Matrix->delete(& actual);
+	_Matrix->delete(& scaledA);
+	_Matrix->delete(& bc);
+	_Matrix->delete(& scaledBc);
+	_Matrix->delete(& expected);
+}
+
+
+Test(MatrixExpression, transpose_folds_into_product_operands)
+{
+	// given
+	Matrix * a = _Matrix->fromRows(3, 2, (double[]) { 2, 3 }, (double[]) { 5, 7 }, (double[]) { 11, 13 });
+	Matrix * b = _Matrix->fromRows(2, 3, (double[]) { 17, 19, 23 }, (double[]) { 29, 31, 37 });
+	MatrixExpression * expression = _MatrixExpression->transpose(
+		_MatrixExpression->product(
+			_MatrixExpression->transpose(_MatrixExpression->leaf(b)),
+			_MatrixExpression->transpose(_MatrixExpression->leaf(a))));
+
+	// when
+	Matrix * actual = _MatrixExpression->evaluate(expression);
+
+	// then
+	Matrix * expected = _Matrix->product(a, b);
+	expect_cells(actual, expected);
+
+	// teardown
+	_MatrixExpression->delete(& expression);
+	_Matrix->delete(& a);
+	_Matrix->delete(& b);
+	_Matrix->delete(& actual);
+	_Matrix->delete(& expected);
+}
+
+
+Test(MatrixExpression, product_of_sums)
+{
+	// given
+	Matrix * a = _Matrix->fromRows(2, 2, (double[]) { 1, 2 }, (double[]) { 3, 4 });
+	Matrix * b = _Matrix->fromRows(2, 2, (double[]) { 0, 1 }, (double[]) { 1, 0 });
+	MatrixExpression * expression = _MatrixExpression->product(
+		_MatrixExpression->sum(_MatrixExpression->leaf(a), _MatrixExpression->leaf(b)),
+		_MatrixExpression->transpose(_MatrixExpression->leaf(a)));
+
+	// when
+	Matrix * actual = _MatrixExpression->evaluate(expression);
+
+	// then
+	Matrix * aPlusB = _Matrix->sum(a, b);
+	Matrix * transposeA = _Matrix->transpose(a);
+	Matrix * expected = _Matrix->product(aPlusB, transposeA);
+	expect_cells(actual, expected);
+
+	// teardown
+	_MatrixExpression->delete(& expression);
+	_Matrix->delete(& a);
+	_Matrix->delete(& b);
+	_Matrix->delete(& actual);
+	_Matrix->delete(& aPlusB);
+	_Matrix->delete(& transposeA);
+	_Matrix->delete(& expected);
+}
+
+
+Test(MatrixExpression, evaluateInto_requires_matching_destination)
+{
+	// given
+	Matrix * a = _Matrix->create(2, 3);
+	Matrix * destination = _Matrix->create(3, 2);
+	MatrixExpression * expression = _MatrixExpression->leaf(a);
+
+	// when
+	int succeeded = _MatrixExpression->evaluateInto(expression, destination);
+
+	// then
+	cr_expect_not(succeeded, "Destination must have the size of the result");
+
+	// teardown
+	_MatrixExpression->delete(& expression);
+	_Matrix->delete(& a);
+	_Matrix->delete(& destination);
+}
+
+
+Test(MatrixExpression, evaluateInto_destination_read_by_expression)
+{
+	// given
+	Matrix * a = _Matrix->fromRows(2, 2, (double[]) { 1, 2 }, (double[]) { 3, 4 });
+	Matrix * expected = _Matrix->fromRows(2, 2, (double[]) { 8, 13 }, (double[]) { 17, 26 });
+	MatrixExpression * expression = _MatrixExpression->sum(
+		_MatrixExpression->product(_MatrixExpression->leaf(a), _MatrixExpression->leaf(a)),
+		_MatrixExpression->transpose(_MatrixExpression->leaf(a)));
+
+	// when
+	int succeeded = _MatrixExpression->evaluateInto(expression, a);
+
+	// then
+	cr_expect(succeeded);
+	expect_cells(a, expected);
+
+	// teardown
+	_MatrixExpression->delete(& expression);
+	_Matrix->delete(& a);
+	_Matrix->delete(& expected);
+}
@@ -0,0 +1,164 @@
+#include "../../src/Matrix.h"
+
+#include <criterion/criterion.h>
+
+
+
+
+Test(MatrixF, create_returns_zero_filled_matrix)
+{
+	// when
+	MatrixF * this = _MatrixF->create(2, 2);
+
+	// then
+	cr_assert_not_null(this);
+	cr_expect_eq(0, _MatrixF->getCell(this, 0, 0));
+	cr_expect_eq(0, _MatrixF->getCell(this, 1, 1));
+
+	// teardown
+	_MatrixF->delete(& this);
+	cr_expect_null(this);
+}
+
+
+Test(MatrixF, fromRows_stores_given_values)
+{
+	// given
+	float rows[][3] = {
+		{ 1, 2, 3 },
+		{ 4, 5, 6 },
+	};
+
+	// when
+	MatrixF * this = _MatrixF->fromRows(2, 3, rows[0], rows[1]);
+
+	// then
+	for (size_t rowIndex = 0; rowIndex < 2; rowIndex++)
+	{
+		for (size_t columnIndex = 0; columnIndex < 3; columnIndex++)
+		{
+			float actual = _MatrixF->getCell(this, rowIndex, columnIndex);
+			float expected = rows[rowIndex][columnIndex];
+			cr_expect_eq(
+				expected,
+				actual,
+				"Incorrect value at (%lu,%lu), got %f instead of %f",
+				rowIndex,
+				columnIndex,
+				actual,
+				expected);
+		}
+	}
+
+	// teardown
+	_MatrixF->delete(& this);
+}
+
+
+Test(MatrixF, determinant_of_non_square_matrix_is_not_defined)
+{
+	// given
+	MatrixF * this = _MatrixF->create(2, 3);
+
+	// when
+	float determinant = _MatrixF->determinant(this);
+
+	// then
+	cr_expect_eq((float) MATRIX_IS_NOT_SQUARE, determinant, "Sentinels are rounded to float");
+
+	// teardown
+	_MatrixF->delete(& this);
+}
+
+
+Test(MatrixF, product)
+{
+	// given
+	MatrixF * left = _MatrixF->fromRows(
+		3, 2,
+		(float[]) { 2, 3 },
+		(float[]) { 5, 7 },
+		(float[]) { 11, 13 });
+	MatrixF * right = _MatrixF->fromRows(
+		2, 4,
+		(float[]) { 17, 19, 23, 29 },
+		(float[]) { 31, 37, 41, 43 });
+
+	// when
+	MatrixF * product = _MatrixF->product(left, right);
+
+	// then
+	float expected[][4] = {
+		{ 127, 149, 169, 187 },
+		{ 302, 354, 402, 446 },
+		{ 590, 690, 786, 878 }};
+	for (size_t ordinate = 0; ordinate < 3; ordinate++)
+	{
+		for (size_t abscissa = 0; abscissa < 4; abscissa++)
+			cr_expect_eq(expected[ordinate][abscissa], _MatrixF->getCell(product, ordinate, abscissa));
+	}
+
+	// teardown
+	_MatrixF->delete(& left);
+	_MatrixF->delete(& right);
+	_MatrixF->delete(& product);
+}
+
+
+Test(MatrixF, inverse_multiplied_by_matrix_gives_identity)
+{
+	// given
+	MatrixF * this = _MatrixF->fromRows(2, 2, (float[]) { 2, 3 }, (float[]) { 5, 7 });
+
+	// when
+	MatrixF * inverse = _MatrixF->inverse(this);
+
+	// then
+	MatrixF * product = _MatrixF->product(this, inverse);
+	cr_expect(_MatrixF->isIdentity(product), "Matrix multiplied by its inverse should be equal to the identity");
+
+	// teardown
+	_MatrixF->delete(& this);
+	_MatrixF->delete(& inverse);
+	_MatrixF->delete(& product);
+}
+
+
+Test(MatrixF, toFloat_rounds_cells)
+{
+	// given
+	Matrix * this = _Matrix->fromRows(1, 2, (double[]) { 0.1, 1.5 });
+
+	// when
+	MatrixF * converted = _Matrix->toFloat(this);
+
+	// then
+	cr_assert_not_null(converted);
+	cr_expect_eq(1, _MatrixF->height(converted));
+	cr_expect_eq(2, _MatrixF->width(converted));
+	cr_expect_eq(0.1f, _MatrixF->getCell(converted, 0, 0));
+	cr_expect_eq(1.5f, _MatrixF->getCell(converted, 0, 1));
+
+	// teardown
+	_Matrix->delete(& this);
+	_MatrixF->delete(& converted);
+}
+
+
+Test(MatrixF, toDouble_is_exact)
+{
+	// given
+	MatrixF * this = _MatrixF->fromRows(1, 2, (float[]) { 0.1f, -3 });
+
+	// when
+	Matrix * converted = _MatrixF->toDouble(this);
+
+	// then
+	cr_assert_not_null(converted);
+	cr_expect_eq((double) 0.1f, _Matrix->getCell(converted, 0, 0));
+	cr_expect_eq(-3, _Matrix->getCell(converted, 0, 1));
+
+	// teardown
+	_MatrixF->delete(& this);
+	_Matrix->delete(& converted);
+}
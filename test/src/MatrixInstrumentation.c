@@ -0,0 +1,271 @@
+#include "../../src/Matrix.h"
+#include "../../src/MatrixInstrumentation.h"
+
+#include <criterion/criterion.h>
+#include <pthread.h>
+
+
+
+
+Test(MatrixInstrumentation, disabled_by_default)
+{
+	// then
+	cr_expect_not(_MatrixInstrumentation->isEnabled(), "Instrumentation must cost nothing until enabled");
+}
+
+
+Test(MatrixInstrumentation, counts_calls_per_operation)
+{
+	// given
+	MatrixStatistics statistics;
+	Matrix * this;
+	_MatrixInstrumentation->reset();
+	cr_assert(_MatrixInstrumentation->enable());
+
+	// when
+	this = _Matrix->create(2, 2);
+	_Matrix->trace(this);
+	_Matrix->trace(this);
+	_Matrix->delete(& this);
+	_MatrixInstrumentation->snapshot(& statistics);
+
+	// then
+	cr_expect_eq(1, statistics.operations[MATRIX_CREATE].calls, "create was called once");
+	cr_expect_eq(2, statistics.operations[MATRIX_TRACE].calls, "trace was called twice");
+	cr_expect_eq(1, statistics.operations[MATRIX_DELETE].calls, "delete was called once");
+	cr_expect_eq(0, statistics.operations[MATRIX_PRODUCT].calls, "product was never called");
+
+	// teardown
+	_MatrixInstrumentation->disable();
+}
+
+
+static void * createAndDelete(void * unused)
+{
+	(void) unused;
+
+	for (size_t index = 0; index < 1000; index++)
+	{
+		Matrix * this = _Matrix->create(2, 2);
+		_Matrix->trace(this);
+		_Matrix->delete(& this);
+	}
+
+	return NULL;
+}
+
+
+Test(MatrixInstrumentation, counts_calls_from_several_threads)
+{
+	// given
+	MatrixStatistics statistics;
+	pthread_t threads[4];
+	_MatrixInstrumentation->reset();
+	cr_assert(_MatrixInstrumentation->enable());
+
+	// when
+	for (size_t index = 0; index < 4; index++)
+		cr_assert_eq(0, pthread_create(& threads[index], NULL, createAndDelete, NULL));
+	for (size_t index = 0; index < 4; index++)
+		pthread_join(threads[index], NULL);
+	_MatrixInstrumentation->snapshot(& statistics);
+
+	// then
+	cr_expect_eq(4000, statistics.operations[MATRIX_CREATE].calls, "no call is lost to a concurrent one");
+	cr_expect_eq(4000, statistics.operations[MATRIX_TRACE].calls);
+	cr_expect_float_eq(4 * 1000 * 2, statistics.operations[MATRIX_TRACE].flops, 1e-9);
+	cr_expect_eq(0, statistics.liveMatrices, "every matrix was deleted");
+	cr_expect_leq(statistics.peakLiveMatrices, 4, "each thread has one matrix at most");
+	cr_expect_eq(
+		statistics.operations[MATRIX_DELETE].bytesFreed,
+		statistics.operations[MATRIX_CREATE].bytesAllocated,
+		"each thread frees what it allocated");
+
+	// teardown
+	_MatrixInstrumentation->disable();
+}
+
+
+Test(MatrixInstrumentation, counts_nested_calls)
+{
+	// given
+	MatrixStatistics statistics;
+	Matrix * this = _Matrix->fromRows(
+		3, 3,
+		(double[]) { 2, 0, 1 },
+		(double[]) { 1, 3, 2 },
+		(double[]) { 1, 1, 1 });
+	_MatrixInstrumentation->reset();
+	cr_assert(_MatrixInstrumentation->enable());
+
+	// when
+	_Matrix->determinant(this);
+	_MatrixInstrumentation->snapshot(& statistics);
+
+	// then
+	cr_expect_eq(1, statistics.operations[MATRIX_COFACTORS].calls, "determinant expands along cofactors once");
+	cr_expect_eq(9, statistics.operations[MATRIX_MINOR].calls, "each cofactor needs a minor");
+	cr_expect_eq(10, statistics.operations[MATRIX_DETERMINANT].calls, "each minor has its own determinant");
+	cr_expect_gt(statistics.operations[MATRIX_DETERMINANT].bytesAllocated, 0, "minors are allocated while determinant runs");
+	cr_expect_eq(
+		statistics.operations[MATRIX_DETERMINANT].bytesAllocated,
+		statistics.operations[MATRIX_DETERMINANT].bytesFreed,
+		"determinant frees every intermediate matrix");
+
+	// teardown
+	_MatrixInstrumentation->disable();
+	_Matrix->delete(& this);
+}
+
+
+Test(MatrixInstrumentation, accounts_block_a_copy_is_detached_into)
+{
+	// given
+	MatrixStatistics statistics;
+	Matrix * this = _Matrix->create(3, 5);
+	Matrix * copy;
+	_MatrixInstrumentation->reset();
+	cr_assert(_MatrixInstrumentation->enable());
+
+	// when
+	copy = _Matrix->copy(this);
+	cr_assert(_Matrix->detach(copy));
+	_Matrix->delete(& copy);
+	_MatrixInstrumentation->snapshot(& statistics);
+
+	// then
+	cr_expect_gt(
+		statistics.operations[MATRIX_DETACH].bytesAllocated,
+		statistics.operations[MATRIX_COPY].bytesAllocated,
+		"detach allocates a whole block, copy a structure alone");
+	cr_expect_eq(
+		statistics.operations[MATRIX_COPY].bytesAllocated + statistics.operations[MATRIX_DETACH].bytesAllocated,
+		statistics.operations[MATRIX_DELETE].bytesFreed,
+		"a detached copy frees its structure and the block it was detached into");
+
+	// teardown
+	_MatrixInstrumentation->disable();
+	_Matrix->delete(& this);
+}
+
+
+Test(MatrixInstrumentation, estimates_product_flops)
+{
+	// given
+	MatrixStatistics statistics;
+	Matrix * left = _Matrix->create(2, 3);
+	Matrix * right = _Matrix->create(3, 4);
+	Matrix * product;
+	_MatrixInstrumentation->reset();
+	cr_assert(_MatrixInstrumentation->enable());
+
+	// when
+	product = _Matrix->product(left, right);
+	_MatrixInstrumentation->snapshot(& statistics);
+
+	// then
+	cr_expect_eq(2 * 2 * 3 * 4, statistics.operations[MATRIX_PRODUCT].flops, "product does one multiply-add per term");
+
+	// teardown
+	_MatrixInstrumentation->disable();
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& product);
+}
+
+
+Test(MatrixInstrumentation, product_delegates_to_strassen_above_threshold)
+{
+	// given
+	MatrixStatistics statistics;
+	Matrix * left = _Matrix->create(8, 8);
+	Matrix * right = _Matrix->create(8, 8);
+	Matrix * product;
+	_Matrix->tuneStrassen(2, 8);
+	_MatrixInstrumentation->reset();
+	cr_assert(_MatrixInstrumentation->enable());
+
+	// when
+	product = _Matrix->product(left, right);
+	_MatrixInstrumentation->snapshot(& statistics);
+
+	// then
+	cr_expect_eq(1, statistics.operations[MATRIX_STRASSEN_PRODUCT].calls, "8*8 operands reach the threshold");
+	cr_expect_eq(0, statistics.operations[MATRIX_PRODUCT].flops, "flops are accounted to strassenProduct");
+
+	// teardown
+	_MatrixInstrumentation->disable();
+	_Matrix->tuneStrassen(STRASSEN_DEFAULT_CROSSOVER, STRASSEN_DEFAULT_THRESHOLD);
+	_Matrix->delete(& left);
+	_Matrix->delete(& right);
+	_Matrix->delete(& product);
+}
+
+
+Test(MatrixInstrumentation, tracks_live_matrices_peak)
+{
+	// given
+	MatrixStatistics statistics;
+	Matrix * first;
+	Matrix * second;
+	_MatrixInstrumentation->reset();
+	cr_assert(_MatrixInstrumentation->enable());
+
+	// when
+	first = _Matrix->identity(2);
+	second = _Matrix->copy(first);
+	_Matrix->delete(& first);
+	_Matrix->delete(& second);
+	_MatrixInstrumentation->snapshot(& statistics);
+
+	// then
+	cr_expect_eq(0, statistics.liveMatrices, "Every matrix was deleted");
+	cr_expect_eq(2, statistics.peakLiveMatrices, "Two matrices were alive at once");
+
+	// teardown
+	_MatrixInstrumentation->disable();
+}
+
+
+Test(MatrixInstrumentation, disable_stops_counting)
+{
+	// given
+	MatrixStatistics statistics;
+	Matrix * this = _Matrix->create(1, 1);
+	_MatrixInstrumentation->reset();
+	cr_assert(_MatrixInstrumentation->enable());
+	_MatrixInstrumentation->disable();
+
+	// when
+	_Matrix->trace(this);
+	_MatrixInstrumentation->snapshot(& statistics);
+
+	// then
+	cr_expect_not(_MatrixInstrumentation->isEnabled());
+	cr_expect_eq(0, statistics.operations[MATRIX_TRACE].calls, "Disabled instrumentation must not count");
+
+	// teardown
+	_Matrix->delete(& this);
+}
+
+
+Test(MatrixInstrumentation, reset_zeroes_counters)
+{
+	// given
+	MatrixStatistics statistics;
+	Matrix * this;
+	cr_assert(_MatrixInstrumentation->enable());
+	this = _Matrix->identity(3);
+	_Matrix->delete(& this);
+
+	// when
+	_MatrixInstrumentation->reset();
+	_MatrixInstrumentation->snapshot(& statistics);
+
+	// then
+	cr_expect_eq(0, statistics.operations[MATRIX_IDENTITY].calls);
+	cr_expect_eq(0, statistics.peakLiveMatrices);
+
+	// teardown
+	_MatrixInstrumentation->disable();
+}
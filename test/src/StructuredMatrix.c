@@ -0,0 +1,292 @@
+#include "../../src/Matrix.h"
+#include "../../src/StructuredMatrix.h"
+#include "../../src/Vector.h"
+
+#include <criterion/criterion.h>
+#include <math.h>
+
+
+
+
+Test(StructuredMatrix, banded_requires_bands_inside_matrix)
+{
+	// when
+	StructuredMatrix * this = _StructuredMatrix->banded(3, 3, 0);
+
+	// then
+	cr_assert_null(this, "A 3*3 matrix has only 2 diagonals below the main one");
+}
+
+
+Test(StructuredMatrix, setCell_rejects_non_zero_structural_zeros)
+{
+	// given
+	StructuredMatrix * this = _StructuredMatrix->create(STRUCTURE_UPPER_TRIANGULAR, 3);
+
+	// when
+	int below = _StructuredMatrix->setCell(this, 2, 0, 1);
+	int zero = _StructuredMatrix->setCell(this, 2, 0, 0);
+	int above = _StructuredMatrix->setCell(this, 0, 2, 1);
+
+	// then
+	cr_expect_not(below);
+	cr_expect(zero);
+	cr_expect(above);
+	cr_expect_eq(1, _StructuredMatrix->getCell(this, 0, 2));
+	cr_expect_eq(0, _StructuredMatrix->getCell(this, 2, 0));
+
+	// teardown
+	_StructuredMatrix->delete(& this);
+	cr_expect_null(this);
+}
+
+
+Test(StructuredMatrix, symmetric_setCell_sets_both_cells)
+{
+	// given
+	StructuredMatrix * this = _StructuredMatrix->create(STRUCTURE_SYMMETRIC, 3);
+
+	// when
+	_StructuredMatrix->setCell(this, 0, 2, 5);
+
+	// then
+	cr_expect_eq(5, _StructuredMatrix->getCell(this, 0, 2));
+	cr_expect_eq(5, _StructuredMatrix->getCell(this, 2, 0));
+
+	// teardown
+	_StructuredMatrix->delete(& this);
+}
+
+
+Test(StructuredMatrix, fromDense_toDense_keeps_band)
+{
+	// given
+	Matrix * dense = _Matrix->fromRows(3, 3,
+		(double[]) { 1, 2, 3 },
+		(double[]) { 4, 5, 6 },
+		(double[]) { 7, 8, 9 });
+
+	// when
+	StructuredMatrix * this = _StructuredMatrix->fromDense(dense, STRUCTURE_BANDED, 1, 0);
+	Matrix * unpacked = _StructuredMatrix->toDense(this);
+
+	// then
+	cr_assert_not_null(unpacked);
+	for (size_t rowIndex = 0; rowIndex < 3; rowIndex++)
+		for (size_t columnIndex = 0; columnIndex < 3; columnIndex++)
+		{
+			double expected = ((columnIndex <= rowIndex) && (rowIndex - columnIndex <= 1))
+				? _Matrix->getCell(dense, rowIndex, columnIndex)
+				: 0;
+			cr_expect_eq(expected, _Matrix->getCell(unpacked, rowIndex, columnIndex));
+		}
+
+	// teardown
+	_Matrix->delete(& dense);
+	_Matrix->delete(& unpacked);
+	_StructuredMatrix->delete(& this);
+}
+
+
+Test(StructuredMatrix, product_matches_dense_product)
+{
+	// given
+	Matrix * dense = _Matrix->fromRows(3, 3,
+		(double[]) { 2, 1, 0 },
+		(double[]) { 1, 3, 1 },
+		(double[]) { 0, 1, 4 });
+	Matrix * right = _Matrix->fromRows(3, 2,
+		(double[]) { 1, 2 },
+		(double[]) { 3, 4 },
+		(double[]) { 5, 6 });
+	StructuredMatrix * symmetric = _StructuredMatrix->fromDense(dense, STRUCTURE_SYMMETRIC, 0, 0);
+	StructuredMatrix * band = _StructuredMatrix->fromDense(dense, STRUCTURE_BANDED, 1, 1);
+	Matrix * expected = _Matrix->product(dense, right);
+
+	// when
+	Matrix * fromSymmetric = _StructuredMatrix->product(symmetric, right);
+	Matrix * fromBand = _StructuredMatrix->product(band, right);
+
+	// then
+	for (size_t rowIndex = 0; rowIndex < 3; rowIndex++)
+		for (size_t columnIndex = 0; columnIndex < 2; columnIndex++)
+		{
+			cr_expect_eq(_Matrix->getCell(expected, rowIndex, columnIndex), _Matrix->getCell(fromSymmetric, rowIndex, columnIndex));
+			cr_expect_eq(_Matrix->getCell(expected, rowIndex, columnIndex), _Matrix->getCell(fromBand, rowIndex, columnIndex));
+		}
+
+	// teardown
+	_Matrix->delete(& dense);
+	_Matrix->delete(& right);
+	_Matrix->delete(& expected);
+	_Matrix->delete(& fromSymmetric);
+	_Matrix->delete(& fromBand);
+	_StructuredMatrix->delete(& symmetric);
+	_StructuredMatrix->delete(& band);
+}
+
+
+Test(StructuredMatrix, sum_with_diagonal_keeps_structure)
+{
+	// given
+	StructuredMatrix * lower = _StructuredMatrix->create(STRUCTURE_LOWER_TRIANGULAR, 2);
+	StructuredMatrix * diagonal = _StructuredMatrix->create(STRUCTURE_DIAGONAL, 2);
+	StructuredMatrix * upper = _StructuredMatrix->create(STRUCTURE_UPPER_TRIANGULAR, 2);
+	_StructuredMatrix->setCell(lower, 1, 0, 3);
+	_StructuredMatrix->setCell(lower, 1, 1, 1);
+	_StructuredMatrix->setCell(diagonal, 1, 1, 2);
+
+	// when
+	StructuredMatrix * sum = _StructuredMatrix->sum(diagonal, lower);
+	StructuredMatrix * mixed = _StructuredMatrix->sum(lower, upper);
+
+	// then
+	cr_assert_not_null(sum);
+	cr_expect_eq(STRUCTURE_LOWER_TRIANGULAR, _StructuredMatrix->structure(sum));
+	cr_expect_eq(3, _StructuredMatrix->getCell(sum, 1, 0));
+	cr_expect_eq(3, _StructuredMatrix->getCell(sum, 1, 1));
+	cr_expect_null(mixed, "Triangles of opposite sides have no common packed structure");
+
+	// teardown
+	_StructuredMatrix->delete(& lower);
+	_StructuredMatrix->delete(& diagonal);
+	_StructuredMatrix->delete(& upper);
+	_StructuredMatrix->delete(& sum);
+}
+
+
+Test(StructuredMatrix, transpose_swaps_triangles_and_bands)
+{
+	// given
+	StructuredMatrix * upper = _StructuredMatrix->create(STRUCTURE_UPPER_TRIANGULAR, 3);
+	StructuredMatrix * band = _StructuredMatrix->banded(3, 2, 0);
+	_StructuredMatrix->setCell(upper, 0, 2, 7);
+	_StructuredMatrix->setCell(band, 2, 0, 4);
+
+	// when
+	StructuredMatrix * lower = _StructuredMatrix->transpose(upper);
+	StructuredMatrix * transposedBand = _StructuredMatrix->transpose(band);
+
+	// then
+	cr_expect_eq(STRUCTURE_LOWER_TRIANGULAR, _StructuredMatrix->structure(lower));
+	cr_expect_eq(7, _StructuredMatrix->getCell(lower, 2, 0));
+	cr_expect_eq(4, _StructuredMatrix->getCell(transposedBand, 0, 2));
+	cr_expect(_StructuredMatrix->setCell(transposedBand, 0, 2, 1), "Upper bandwidth is now 2");
+
+	// teardown
+	_StructuredMatrix->delete(& upper);
+	_StructuredMatrix->delete(& band);
+	_StructuredMatrix->delete(& lower);
+	_StructuredMatrix->delete(& transposedBand);
+}
+
+
+Test(StructuredMatrix, determinant_matches_dense_determinant)
+{
+	// given
+	Matrix * positive = _Matrix->fromRows(3, 3,
+		(double[]) { 4, 2, 0 },
+		(double[]) { 2, 5, 1 },
+		(double[]) { 0, 1, 3 });
+	Matrix * indefinite = _Matrix->fromRows(3, 3,
+		(double[]) { 0, 1, 2 },
+		(double[]) { 1, 0, 3 },
+		(double[]) { 2, 3, 0 });
+	StructuredMatrix * cholesky = _StructuredMatrix->fromDense(positive, STRUCTURE_SYMMETRIC, 0, 0);
+	StructuredMatrix * pivoted = _StructuredMatrix->fromDense(indefinite, STRUCTURE_SYMMETRIC, 0, 0);
+	StructuredMatrix * band = _StructuredMatrix->fromDense(indefinite, STRUCTURE_BANDED, 2, 2);
+	StructuredMatrix * upper = _StructuredMatrix->fromDense(positive, STRUCTURE_UPPER_TRIANGULAR, 0, 0);
+
+	// when
+	double fromCholesky = _StructuredMatrix->determinant(cholesky);
+	double fromPivoting = _StructuredMatrix->determinant(pivoted);
+	double fromBand = _StructuredMatrix->determinant(band);
+	double fromDiagonal = _StructuredMatrix->determinant(upper);
+
+	// then
+	cr_expect_float_eq(_Matrix->determinant(positive), fromCholesky, 1e-12);
+	cr_expect_float_eq(_Matrix->determinant(indefinite), fromPivoting, 1e-12);
+	cr_expect_float_eq(_Matrix->determinant(indefinite), fromBand, 1e-12);
+	cr_expect_eq(60, fromDiagonal);
+
+	// teardown
+	_Matrix->delete(& positive);
+	_Matrix->delete(& indefinite);
+	_StructuredMatrix->delete(& cholesky);
+	_StructuredMatrix->delete(& pivoted);
+	_StructuredMatrix->delete(& band);
+	_StructuredMatrix->delete(& upper);
+}
+
+
+Test(StructuredMatrix, solve_tridiagonal)
+{
+	// given
+	size_t size = 50;
+	StructuredMatrix * this = _StructuredMatrix->banded(size, 1, 1);
+	Vector * expected = _Vector->create(size);
+	for (size_t index = 0; index < size; index++)
+	{
+		_StructuredMatrix->setCell(this, index, index, (index % 2) ? 0.5 : -3);
+		if (index > 0)
+			_StructuredMatrix->setCell(this, index, index - 1, 2);
+		if (index + 1 < size)
+			_StructuredMatrix->setCell(this, index, index + 1, 1);
+		_Vector->setCell(expected, index, (double) index);
+	}
+	Matrix * dense = _StructuredMatrix->toDense(this);
+	Vector * rightHand = _Vector->create(size);
+	_Vector->gemv(1, dense, expected, 0, rightHand);
+
+	// when
+	Vector * solution = _StructuredMatrix->solve(this, rightHand);
+
+	// then
+	cr_assert_not_null(solution);
+	for (size_t index = 0; index < size; index++)
+		cr_expect_float_eq((double) index, _Vector->getCell(solution, index), 1e-9);
+
+	// teardown
+	_StructuredMatrix->delete(& this);
+	_Matrix->delete(& dense);
+	_Vector->delete(& expected);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& solution);
+}
+
+
+Test(StructuredMatrix, solve_triangular_and_symmetric)
+{
+	// given
+	Matrix * dense = _Matrix->fromRows(3, 3,
+		(double[]) { 4, 2, 0 },
+		(double[]) { 2, 5, 1 },
+		(double[]) { 0, 1, 3 });
+	StructuredMatrix * symmetric = _StructuredMatrix->fromDense(dense, STRUCTURE_SYMMETRIC, 0, 0);
+	StructuredMatrix * lower = _StructuredMatrix->fromDense(dense, STRUCTURE_LOWER_TRIANGULAR, 0, 0);
+	StructuredMatrix * singular = _StructuredMatrix->create(STRUCTURE_DIAGONAL, 3);
+	Vector * rightHand = _Vector->fromArray(3, (double[]) { 6, 8, 4 });
+
+	// when
+	Vector * fromSymmetric = _StructuredMatrix->solve(symmetric, rightHand);
+	Vector * fromLower = _StructuredMatrix->solve(lower, rightHand);
+	Vector * fromSingular = _StructuredMatrix->solve(singular, rightHand);
+
+	// then
+	cr_expect_float_eq(1, _Vector->getCell(fromSymmetric, 0), 1e-12);
+	cr_expect_float_eq(1, _Vector->getCell(fromSymmetric, 1), 1e-12);
+	cr_expect_float_eq(1, _Vector->getCell(fromSymmetric, 2), 1e-12);
+	cr_expect_float_eq(1.5, _Vector->getCell(fromLower, 0), 1e-12);
+	cr_expect_float_eq(1, _Vector->getCell(fromLower, 1), 1e-12);
+	cr_expect_float_eq(1, _Vector->getCell(fromLower, 2), 1e-12);
+	cr_expect_null(fromSingular);
+
+	// teardown
+	_Matrix->delete(& dense);
+	_StructuredMatrix->delete(& symmetric);
+	_StructuredMatrix->delete(& lower);
+	_StructuredMatrix->delete(& singular);
+	_Vector->delete(& rightHand);
+	_Vector->delete(& fromSymmetric);
+	_Vector->delete(& fromLower);
+}
@@ -0,0 +1,193 @@
+#include "../../src/TaskGraph.h"
+
+#include <criterion/criterion.h>
+#include <pthread.h>
+
+
+
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	size_t order[256];
+	size_t count;
+} Journal;
+
+
+static void record(void * context, size_t index)
+{
+	Journal * journal = context;
+
+	pthread_mutex_lock(& journal->lock);
+	journal->order[journal->count++] = index;
+	pthread_mutex_unlock(& journal->lock);
+}
+
+
+static size_t positionOf(Journal const * journal, size_t index)
+{
+	for (size_t position = 0; position < journal->count; position++)
+		if (journal->order[position] == index)
+			return position;
+
+	return NO_TASK;
+}
+
+
+
+
+Test(TaskGraph, depend_requires_earlier_prerequisite)
+{
+	// given
+	Journal journal = { PTHREAD_MUTEX_INITIALIZER, { 0 }, 0 };
+	TaskGraph * this = _TaskGraph->create(& journal);
+	size_t first = _TaskGraph->add(this, record, 0);
+	size_t second = _TaskGraph->add(this, record, 1);
+
+	// when
+	int forward = _TaskGraph->depend(this, second, first);
+	int backward = _TaskGraph->depend(this, first, second);
+	int itself = _TaskGraph->depend(this, second, second);
+	int missing = _TaskGraph->depend(this, 2, first);
+
+	// then
+	cr_expect(forward);
+	cr_expect_not(backward, "Cycles can't be made");
+	cr_expect_not(itself, "Cycles can't be made");
+	cr_expect_not(missing, "Task 2 doesn't exist");
+
+	// teardown
+	_TaskGraph->delete(& this);
+	cr_expect_null(this);
+}
+
+
+Test(TaskGraph, run_with_one_worker_keeps_order)
+{
+	// given
+	Journal journal = { PTHREAD_MUTEX_INITIALIZER, { 0 }, 0 };
+	TaskGraph * this = _TaskGraph->create(& journal);
+	for (size_t index = 0; index < 5; index++)
+		_TaskGraph->add(this, record, 10 * index);
+
+	// when
+	_TaskGraph->run(this, 1);
+
+	// then
+	cr_assert_eq(5, journal.count);
+	for (size_t index = 0; index < 5; index++)
+		cr_expect_eq(10 * index, journal.order[index]);
+
+	// teardown
+	_TaskGraph->delete(& this);
+}
+
+
+Test(TaskGraph, run_respects_dependencies)
+{
+	// given
+	size_t size = 12;
+	Journal journal = { PTHREAD_MUTEX_INITIALIZER, { 0 }, 0 };
+	TaskGraph * this = _TaskGraph->create(& journal);
+	/* the tasks of a tiled factorization: (k, j) for j >= k waits for (k - 1, j) and (k, k) */
+	size_t tasks[12][12];
+	for (size_t panel = 0; panel < size; panel++)
+	{
+		for (size_t block = panel; block < size; block++)
+		{
+			tasks[panel][block] = _TaskGraph->add(this, record, panel * size + block);
+			if (panel > 0)
+				_TaskGraph->depend(this, tasks[panel][block], tasks[panel - 1][block]);
+			if (block > panel)
+				_TaskGraph->depend(this, tasks[panel][block], tasks[panel][panel]);
+		}
+	}
+
+	// when
+	_TaskGraph->run(this, 4);
+
+	// then
+	cr_assert_eq(size * (size + 1) / 2, journal.count, "Every task runs once");
+	for (size_t panel = 0; panel < size; panel++)
+	{
+		for (size_t block = panel; block < size; block++)
+		{
+			size_t position = positionOf(& journal, panel * size + block);
+			cr_assert_neq(NO_TASK, position);
+			if (panel > 0)
+				cr_expect_lt(positionOf(& journal, (panel - 1) * size + block), position);
+			if (block > panel)
+				cr_expect_lt(positionOf(& journal, panel * size + panel), position);
+		}
+	}
+
+	// teardown
+	_TaskGraph->delete(& this);
+}
+
+
+Test(TaskGraph, run_independent_tasks_on_more_workers_than_tasks)
+{
+	// given
+	Journal journal = { PTHREAD_MUTEX_INITIALIZER, { 0 }, 0 };
+	TaskGraph * this = _TaskGraph->create(& journal);
+	for (size_t index = 0; index < 3; index++)
+		_TaskGraph->add(this, record, index);
+
+	// when
+	_TaskGraph->run(this, 100);
+
+	// then
+	cr_assert_eq(3, journal.count);
+	for (size_t index = 0; index < 3; index++)
+		cr_expect_neq(NO_TASK, positionOf(& journal, index));
+
+	// teardown
+	_TaskGraph->delete(& this);
+}
+
+
+static void * runRepeatedly(void * context)
+{
+	TaskGraph * this = context;
+
+	for (size_t time = 0; time < 50; time++)
+		_TaskGraph->run(this, 4);
+
+	return NULL;
+}
+
+
+Test(TaskGraph, run_again_and_from_several_threads)
+{
+	// given
+	Journal first = { PTHREAD_MUTEX_INITIALIZER, { 0 }, 0 };
+	Journal second = { PTHREAD_MUTEX_INITIALIZER, { 0 }, 0 };
+	TaskGraph * graphs[2] = { _TaskGraph->create(& first), _TaskGraph->create(& second) };
+	pthread_t threads[2];
+	for (size_t graph = 0; graph < 2; graph++)
+	{
+		_TaskGraph->add(graphs[graph], record, 0);
+		for (size_t index = 1; index < 5; index++)
+			_TaskGraph->depend(graphs[graph], _TaskGraph->add(graphs[graph], record, index), 0);
+	}
+
+	// when
+	for (size_t graph = 0; graph < 2; graph++)
+		cr_assert_eq(0, pthread_create(& threads[graph], NULL, runRepeatedly, graphs[graph]));
+	for (size_t graph = 0; graph < 2; graph++)
+		pthread_join(threads[graph], NULL);
+
+	// then
+	cr_assert_eq(5 * 50, first.count, "Every task runs once per run, whether the pool is free or not");
+	cr_assert_eq(5 * 50, second.count);
+	for (size_t time = 0; time < 50; time++)
+	{
+		cr_expect_eq(0, first.order[5 * time], "Tasks wait for their prerequisite of the same run");
+		cr_expect_eq(0, second.order[5 * time]);
+	}
+
+	// teardown
+	_TaskGraph->delete(& graphs[0]);
+	_TaskGraph->delete(& graphs[1]);
+}
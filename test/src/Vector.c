@@ -0,0 +1,248 @@
+#include "../../src/Matrix.h"
+#include "../../src/Vector.h"
+
+#include <criterion/criterion.h>
+
+
+
+
+Test(Vector, create_requires_positive_size)
+{
+	// when
+	Vector * this = _Vector->create(0);
+
+	// then
+	cr_assert_null(this, "Vector with no size makes no sense");
+}
+
+
+Test(Vector, create_returns_zero_filled_vector)
+{
+	// when
+	Vector * this = _Vector->create(3);
+
+	// then
+	for (size_t index = 0; index < 3; index++)
+		cr_expect_eq(0, _Vector->getCell(this, index), "Value at %zu is non-zero", index);
+
+	// teardown
+	_Vector->delete(& this);
+	cr_expect_null(this);
+}
+
+
+Test(Vector, getCell_error_on_out_of_bounds)
+{
+	// given
+	Vector * this = _Vector->create(2);
+
+	// when
+	double cell = _Vector->getCell(this, 2);
+
+	// then
+	cr_expect_eq(NO_VALUE, cell);
+
+	// teardown
+	_Vector->delete(& this);
+}
+
+
+Test(Vector, dot_requires_equal_sizes)
+{
+	// given
+	Vector * left = _Vector->create(2);
+	Vector * right = _Vector->create(3);
+
+	// when
+	double dot = _Vector->dot(left, right);
+
+	// then
+	cr_expect_eq(NO_VALUE, dot, "Dot product is only defined for vectors of the same size");
+
+	// teardown
+	_Vector->delete(& left);
+	_Vector->delete(& right);
+}
+
+
+Test(Vector, dot)
+{
+	// given
+	Vector * left = _Vector->fromArray(5, (double[]) { 1, 2, 3, 4, 5 });
+	Vector * right = _Vector->fromArray(5, (double[]) { 6, 7, 8, 9, 10 });
+
+	// when
+	double dot = _Vector->dot(left, right);
+
+	// then
+	cr_expect_eq(130, dot);
+
+	// teardown
+	_Vector->delete(& left);
+	_Vector->delete(& right);
+}
+
+
+Test(Vector, norm)
+{
+	// given
+	Vector * this = _Vector->fromArray(2, (double[]) { 3, -4 });
+
+	// when
+	double norm = _Vector->norm(this);
+
+	// then
+	cr_expect_eq(5, norm);
+
+	// teardown
+	_Vector->delete(& this);
+}
+
+
+Test(Vector, axpy)
+{
+	// given
+	Vector * x = _Vector->fromArray(3, (double[]) { 1, 2, 3 });
+	Vector * y = _Vector->fromArray(3, (double[]) { 10, 20, 30 });
+
+	// when
+	int succeeded = _Vector->axpy(2, x, y);
+
+	// then
+	cr_expect(succeeded);
+	cr_expect_eq(12, _Vector->getCell(y, 0));
+	cr_expect_eq(24, _Vector->getCell(y, 1));
+	cr_expect_eq(36, _Vector->getCell(y, 2));
+
+	// teardown
+	_Vector->delete(& x);
+	_Vector->delete(& y);
+}
+
+
+Test(Vector, gemv_requires_matching_sizes)
+{
+	// given
+	Matrix * matrix = _Matrix->create(2, 3);
+	Vector * x = _Vector->create(2);
+	Vector * y = _Vector->create(2);
+
+	// when
+	int succeeded = _Vector->gemv(1, matrix, x, 0, y);
+
+	// then
+	cr_expect_not(succeeded, "x must have as many cells as the matrix has columns");
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Vector->delete(& x);
+	_Vector->delete(& y);
+}
+
+
+Test(Vector, gemv)
+{
+	// given
+	Matrix * matrix = _Matrix->fromRows(2, 3, (double[]) { 1, 2, 3 }, (double[]) { 4, 5, 6 });
+	Vector * x = _Vector->fromArray(3, (double[]) { 1, 0, -1 });
+	Vector * y = _Vector->fromArray(2, (double[]) { 1, 1 });
+
+	// when
+	int succeeded = _Vector->gemv(2, matrix, x, 3, y);
+
+	// then
+	cr_expect(succeeded);
+	cr_expect_eq(2 * -2 + 3, _Vector->getCell(y, 0));
+	cr_expect_eq(2 * -2 + 3, _Vector->getCell(y, 1));
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Vector->delete(& x);
+	_Vector->delete(& y);
+}
+
+
+Test(Vector, gemvTransposed)
+{
+	// given
+	Matrix * matrix = _Matrix->fromRows(2, 3, (double[]) { 1, 2, 3 }, (double[]) { 4, 5, 6 });
+	Vector * x = _Vector->fromArray(2, (double[]) { 1, -1 });
+	Vector * y = _Vector->create(3);
+
+	// when
+	int succeeded = _Vector->gemvTransposed(1, matrix, x, 0, y);
+
+	// then
+	cr_expect(succeeded);
+	cr_expect_eq(-3, _Vector->getCell(y, 0));
+	cr_expect_eq(-3, _Vector->getCell(y, 1));
+	cr_expect_eq(-3, _Vector->getCell(y, 2));
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Vector->delete(& x);
+	_Vector->delete(& y);
+}
+
+
+Test(Vector, gemv_reads_column_major_matrix)
+{
+	// given
+	Matrix * matrix = _Matrix->fromColumns(2, 3, (double[]) { 1, 4 }, (double[]) { 2, 5 }, (double[]) { 3, 6 });
+	Vector * x = _Vector->fromArray(3, (double[]) { 1, 0, -1 });
+	Vector * y = _Vector->create(2);
+	Vector * transposed = _Vector->create(3);
+
+	// when
+	int succeeded = _Vector->gemv(1, matrix, x, 0, y);
+	int transposedSucceeded = _Vector->gemvTransposed(1, matrix, y, 0, transposed);
+
+	// then
+	cr_expect(succeeded);
+	cr_expect(transposedSucceeded);
+	cr_expect_eq(-2, _Vector->getCell(y, 0));
+	cr_expect_eq(-2, _Vector->getCell(y, 1));
+	cr_expect_eq(-10, _Vector->getCell(transposed, 0));
+	cr_expect_eq(-14, _Vector->getCell(transposed, 1));
+	cr_expect_eq(-18, _Vector->getCell(transposed, 2));
+
+	// teardown
+	_Matrix->delete(& matrix);
+	_Vector->delete(& x);
+	_Vector->delete(& y);
+	_Vector->delete(& transposed);
+}
+
+
+Test(Vector, threaded_gemv_matches_single_threaded)
+{
+	// given
+	size_t size = 400;
+	Matrix * matrix = _Matrix->identity(size);
+	Matrix * scaled = _Matrix->scalarProduct(matrix, 3);
+	Vector * x = _Vector->create(size);
+	Vector * y = _Vector->create(size);
+	Vector * transposed = _Vector->create(size);
+	for (size_t index = 0; index < size; index++)
+		_Vector->setCell(x, index, (double) index);
+	_Matrix->setThreads(4);
+
+	// when
+	_Vector->gemv(1, scaled, x, 0, y);
+	_Vector->gemvTransposed(1, scaled, x, 0, transposed);
+
+	// then
+	for (size_t index = 0; index < size; index++)
+	{
+		cr_expect_eq(3.0 * index, _Vector->getCell(y, index));
+		cr_expect_eq(3.0 * index, _Vector->getCell(transposed, index));
+	}
+
+	// teardown
+	_Matrix->setThreads(1);
+	_Matrix->delete(& matrix);
+	_Matrix->delete(& scaled);
+	_Vector->delete(& x);
+	_Vector->delete(& y);
+	_Vector->delete(& transposed);
+}